@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file abr-replay.cc
+ * \brief Offline replay of the adaptation algorithms on a throughput trace
+ *
+ * Each algorithm is replayed by an AbrReplayEngine on the same throughput
+ * trace, without any network stack, and the QoE summary of each replay is
+ * written as CSV, one row per algorithm:
+ *
+ *   algorithm,qoe,throughputMbps,avgRateMbps,avgDelayMs,successRate,freezeTimeMs,frames,
+ *   lateFrames,rateSwitches,decisionsPerSecond
+ *
+ * The trace is read from a CSV file (e.g., the MeasuredRate_bps column of
+ * the rateDecisions.csv of a vr-a-rev-back run, filtered on a single flow),
+ * or generated as a random walk of the throughput if no file is given.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "abr-replay --trace=rateDecisions.csv --timeColumn=0 --throughputColumn=2
+    --timeScale=1e-9 --algorithms=fuzzy,google"
+    \endcode
+ */
+
+#include "ns3/abr-replay-engine.h"
+#include "ns3/bitrate-ladder.h"
+#include "ns3/bola.h"
+#include "ns3/core-module.h"
+#include "ns3/csv-reader.h"
+#include "ns3/festive.h"
+#include "ns3/fuzzy-algorithm-server.h"
+#include "ns3/google-algorithm-server.h"
+#include "ns3/mpc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AbrReplay");
+
+namespace
+{
+
+/**
+ * \brief Create an adaptation algorithm
+ * \param name the name of the algorithm, as the burstGeneratorType of vr-a-rev-back
+ * \return the algorithm
+ */
+Ptr<AdaptationAlgorithmServer>
+CreateAlgorithm(const std::string& name)
+{
+    if (name == "fuzzy")
+    {
+        return CreateObject<FuzzyAlgorithmServer>();
+    }
+    else if (name == "google")
+    {
+        return CreateObject<GoogleAlgorithmServer>();
+    }
+    else if (name == "bola")
+    {
+        return CreateObject<BolaAlgo>(0, 0);
+    }
+    else if (name == "mpc")
+    {
+        return CreateObject<MPCAlgo>(0, 0);
+    }
+    else if (name == "festive")
+    {
+        return CreateObject<FestiveAlgorithm>(0, 0);
+    }
+    NS_ABORT_MSG("Unknown algorithm: " << name);
+    return nullptr;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string trace = "";
+    uint32_t timeColumn = 0;
+    uint32_t throughputColumn = 1;
+    double timeScale = 1;
+    std::string algorithms = "fuzzy,google,bola,mpc,festive";
+    std::string bitrateLadder = "";
+    double frameRate = 60;
+    std::string initialRate = "50Mbps";
+    double deadline = 0;
+    double duration = 0;
+    double syntheticDuration = 600;
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("trace",
+                 "CSV file with the throughput trace, empty for a random walk of the throughput",
+                 trace);
+    cmd.AddValue("timeColumn", "the column of the time in the trace", timeColumn);
+    cmd.AddValue("throughputColumn",
+                 "the column of the throughput in the trace [bps]",
+                 throughputColumn);
+    cmd.AddValue("timeScale", "the seconds per unit of the time column", timeScale);
+    cmd.AddValue("algorithms",
+                 "comma separated algorithms to replay {\"fuzzy\", \"google\", \"bola\", "
+                 "\"mpc\", \"festive\"}",
+                 algorithms);
+    cmd.AddValue("bitrateLadder",
+                 "Bitrate ladder of the algorithms, a list of rates (e.g., \"5Mbps 10Mbps\"), "
+                 "empty for the default ladder",
+                 bitrateLadder);
+    cmd.AddValue("frameRate", "the frame rate [FPS]", frameRate);
+    cmd.AddValue("initialRate",
+                 "the target data rate of the generator, capping the rate",
+                 initialRate);
+    cmd.AddValue("deadline", "the delay beyond which a frame is lost [s], 0 for none", deadline);
+    cmd.AddValue("duration", "the duration of the replay [s], 0 for the whole trace", duration);
+    cmd.AddValue("syntheticDuration",
+                 "the duration of the random walk trace, if no trace is given [s]",
+                 syntheticDuration);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    // the trace is parsed once and shared by the replays
+    std::vector<std::pair<Time, DataRate>> samples;
+    if (trace.empty())
+    {
+        // log-normal random walk between 5 and 200 Mbps, one sample per frame
+        Ptr<NormalRandomVariable> step = CreateObjectWithAttributes<NormalRandomVariable>(
+            "Mean",
+            DoubleValue(0),
+            "Variance",
+            DoubleValue(0.05 * 0.05));
+        double logRate = std::log(60e6);
+        for (double t = 0; t <= syntheticDuration; t += 1 / frameRate)
+        {
+            logRate = std::min(std::max(logRate + step->GetValue(), std::log(5e6)),
+                               std::log(200e6));
+            samples.emplace_back(Seconds(t), DataRate(uint64_t(std::exp(logRate))));
+        }
+    }
+    else
+    {
+        CsvReader csv(trace);
+        while (csv.FetchNextRow())
+        {
+            double time;
+            double throughput;
+            if (!csv.IsBlankRow() && csv.GetValue(timeColumn, time) &&
+                csv.GetValue(throughputColumn, throughput))
+            {
+                samples.emplace_back(Seconds(time * timeScale), DataRate(uint64_t(throughput)));
+            }
+        }
+        NS_ABORT_MSG_IF(samples.empty(), "No throughput sample in " << trace);
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "algorithm,qoe,throughputMbps,avgRateMbps,avgDelayMs,successRate,freezeTimeMs,frames,"
+          "lateFrames,rateSwitches,decisionsPerSecond"
+       << std::endl;
+
+    std::istringstream names(algorithms);
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        Ptr<AdaptationAlgorithmServer> algorithm = CreateAlgorithm(name);
+        if (!bitrateLadder.empty())
+        {
+            algorithm->SetBitrateLadder(
+                CreateObjectWithAttributes<BitrateLadder>("Bitrates", StringValue(bitrateLadder)));
+        }
+
+        Ptr<AbrReplayEngine> engine = CreateObjectWithAttributes<AbrReplayEngine>(
+            "FrameRate",
+            DoubleValue(frameRate),
+            "InitialRate",
+            DataRateValue(DataRate(initialRate)),
+            "Deadline",
+            TimeValue(Seconds(deadline)),
+            "Duration",
+            TimeValue(Seconds(duration)));
+        engine->SetAlgorithm(algorithm);
+        for (const auto& sample : samples)
+        {
+            engine->AddSample(sample.first, sample.second);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        engine->Start();
+        Simulator::Run();
+        auto stop = std::chrono::steady_clock::now();
+
+        AbrReplayEngine::Summary summary = engine->GetSummary();
+        double elapsed = std::chrono::duration<double>(stop - start).count();
+        os << name << "," << summary.qoe << "," << summary.throughputMbps << ","
+           << summary.avgRateMbps << "," << summary.avgDelayMs << "," << summary.successRate << ","
+           << summary.freezeTimeMs << "," << summary.frames << "," << summary.lateFrames << ","
+           << summary.rateSwitches << "," << summary.frames / elapsed << std::endl;
+
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
@@ -44,6 +44,11 @@ def check_stderr(result):
 
 
 def compute_qoe(results):
+    if 'qoe.csv' in results['output']:
+        # computed by ns3::QoeMonitor during the simulation
+        summary = results['output']['qoe.csv'].split('\n')
+        return float(summary[1].split(',')[0])
+
     trace = results['output']['burstTrace.csv']
 
     # SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,BurstSize
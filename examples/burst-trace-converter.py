@@ -0,0 +1,100 @@
+# Converts the binary columnar traces written by ns3::BurstTraceWriter into
+# the CSV layout of burstTrace.csv/fragmentTrace.csv, so that the existing
+# analysis scripts can be used unchanged.
+#
+# Usage:
+#   python3 burst-trace-converter.py burstTrace.bin burstTrace.csv
+#   python3 burst-trace-converter.py fragmentTrace.bin fragmentTrace.csv
+#
+# See model/burst-trace-writer.h for a description of the file format.
+
+import argparse
+import struct
+import sys
+from array import array
+
+MAGIC = b'VRBTRC01'
+BURST_RECORDS = 0
+FRAGMENT_RECORDS = 1
+
+# (array typecode, item size) of each column, in file order
+COLUMNS = [('I', 4),  # flow id
+           ('q', 8),  # tx time [ns]
+           ('q', 8),  # rx time [ns]
+           ('Q', 8),  # burst seq
+           ('H', 2),  # fragment seq
+           ('H', 2),  # total fragments
+           ('I', 4)]  # size [B]
+
+
+def read_exactly(f, n):
+    data = f.read(n)
+    if len(data) != n:
+        raise ValueError('Truncated trace file')
+    return data
+
+
+def read_column(f, typecode, itemsize, n):
+    column = array(typecode)
+    if column.itemsize != itemsize:
+        raise ValueError('Unsupported platform for typecode ' + typecode)
+    column.frombytes(read_exactly(f, itemsize * n))
+    if sys.byteorder != 'little':
+        column.byteswap()
+    return column
+
+
+def read_trace(filename):
+    """Return (kind, blocks, flow names), where each block is a list of columns"""
+    with open(filename, 'rb') as f:
+        if read_exactly(f, len(MAGIC)) != MAGIC:
+            raise ValueError(filename + ' is not a BurstTraceWriter file')
+        kind, _ = struct.unpack('<II', read_exactly(f, 8))
+
+        blocks = []
+        while True:
+            (n,) = struct.unpack('<I', read_exactly(f, 4))
+            if n == 0:
+                break
+            blocks.append([read_column(f, tc, size, n) for (tc, size) in COLUMNS])
+
+        (num_flows,) = struct.unpack('<I', read_exactly(f, 4))
+        flows = []
+        for _ in range(num_flows):
+            (length,) = struct.unpack('<H', read_exactly(f, 2))
+            flows.append(read_exactly(f, length).decode('ascii'))
+
+    return kind, blocks, flows
+
+
+def write_csv(kind, blocks, flows, out):
+    if kind == BURST_RECORDS:
+        out.write('SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,BurstSize\n')
+    elif kind == FRAGMENT_RECORDS:
+        out.write('SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,FragSeq,TotFrags,FragSize\n')
+    else:
+        raise ValueError('Unknown record kind ' + str(kind))
+
+    for flow, tx, rx, seq, frag_seq, frags, size in blocks:
+        if kind == BURST_RECORDS:
+            for i in range(len(flow)):
+                out.write('%s,%d,%d,%d,%d\n' % (flows[flow[i]], tx[i], rx[i], seq[i], size[i]))
+        else:
+            for i in range(len(flow)):
+                out.write('%s,%d,%d,%d,%d,%d,%d\n' % (flows[flow[i]], tx[i], rx[i], seq[i],
+                                                      frag_seq[i], frags[i], size[i]))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Convert a BurstTraceWriter file to CSV')
+    parser.add_argument('input', help='binary trace file')
+    parser.add_argument('output', nargs='?', default='-',
+                        help='output CSV file (default: standard output)')
+    args = parser.parse_args()
+
+    kind, blocks, flows = read_trace(args.input)
+    if args.output == '-':
+        write_csv(kind, blocks, flows, sys.stdout)
+    else:
+        with open(args.output, 'w') as out:
+            write_csv(kind, blocks, flows, out)
@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file fuzzy-engine-validation.cc
+ * \brief Validation of the default FuzzyEngine rules of the fuzzy algorithms
+ *
+ * The engines of FuzzyAlgorithmServer and FuzzyAlgorithm, evaluated through
+ * the unrolled FuzzyEngine::Evaluate<2>, are compared with the hand-coded
+ * inference they replaced, on the breakpoints of their partitions and on
+ * nSamples random inputs spanning all their fuzzy sets. For each engine, a
+ * CSV row is written:
+ *
+ *   engine,samples,maxAbsDiff,tolerance,result
+ *
+ * and the program exits with status 1 if any difference exceeds tolerance.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "fuzzy-engine-validation --nSamples=1000000"
+    \endcode
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/fuzzy-algorithm-server.h"
+#include "ns3/fuzzy-algorithm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("FuzzyEngineValidation");
+
+namespace
+{
+
+/**
+ * \brief The inference of FuzzyAlgorithmServer before FuzzyEngine
+ * \param buffOcc the send buffer occupancy [B]
+ * \param diffBuffOcc the variation of the send buffer occupancy [B]
+ * \return the factor applied to the last rate
+ */
+double
+ReferenceServer(double buffOcc, double diffBuffOcc)
+{
+    double empty = 0, ok = 0, full = 0, falling = 0, steady = 0, rising = 0;
+    double targetBuffOcc = 2000;
+
+    if (buffOcc == 0)
+    {
+        empty = 1.0;
+    }
+    else if (buffOcc < targetBuffOcc)
+    {
+        empty = 1.0 - buffOcc / targetBuffOcc;
+        ok = buffOcc / targetBuffOcc;
+    }
+    else if (buffOcc < 2 * targetBuffOcc)
+    {
+        ok = 1 - (buffOcc - targetBuffOcc) / targetBuffOcc;
+        full = (buffOcc - targetBuffOcc) / targetBuffOcc;
+    }
+    else
+    {
+        full = 1;
+    }
+
+    if (diffBuffOcc < -targetBuffOcc)
+    {
+        falling = 1;
+    }
+    else if (diffBuffOcc < 0)
+    {
+        falling = -diffBuffOcc / targetBuffOcc;
+        steady = 1 + diffBuffOcc / targetBuffOcc;
+    }
+    else if (diffBuffOcc < targetBuffOcc)
+    {
+        steady = 1 - diffBuffOcc / targetBuffOcc;
+        rising = diffBuffOcc / targetBuffOcc;
+    }
+    else
+    {
+        rising = 1;
+    }
+
+    double r1 = std::min(full, rising);
+    double r2 = std::min(ok, rising);
+    double r3 = std::min(empty, rising);
+    double r4 = std::min(full, steady);
+    double r5 = std::min(ok, steady);
+    double r6 = std::min(empty, steady);
+    double r7 = std::min(full, falling);
+    double r8 = std::min(ok, falling);
+    double r9 = std::min(empty, falling);
+
+    double R = std::sqrt(std::pow(r1, 2));
+    double SR = std::sqrt(std::pow(r2, 2) + std::pow(r4, 2));
+    double NC = std::sqrt(std::pow(r3, 2) + std::pow(r5, 2) + std::pow(r7, 2));
+    double SI = std::sqrt(std::pow(r6, 2) + std::pow(r8, 2));
+    double I = std::sqrt(std::pow(r9, 2));
+
+    double N2 = 0.25, N1 = 0.5, Z = 1, P1 = 2, P2 = 4;
+    return (R * N2 + SR * N1 + NC * Z + SI * P1 + I * P2) / (R + SR + NC + SI + I);
+}
+
+/**
+ * \brief The inference of FuzzyAlgorithm before FuzzyEngine
+ * \param currDt the average delay [s]
+ * \param diff the delay trend [s]
+ * \return the factor applied to the received rate
+ */
+double
+ReferenceClient(double currDt, double diff)
+{
+    double slow = 0, ok = 0, fast = 0, falling = 0, steady = 0, rising = 0;
+    double t = MilliSeconds(10).GetSeconds();
+    double t_diff = t;
+
+    if (currDt < 2 * t / 3)
+    {
+        slow = 1.0;
+    }
+    else if (currDt < t)
+    {
+        slow = 1 - 1 / (t / 3) * (currDt - 2 * t / 3);
+        ok = 1 / (t / 3) * (currDt - 2 * t / 3);
+    }
+    else if (currDt < 4 * t)
+    {
+        ok = 1 - 1 / (3 * t) * (currDt - t);
+        fast = 1 / (3 * t) * (currDt - t);
+    }
+    else
+    {
+        fast = 1;
+    }
+
+    if (diff < -2 * t_diff / 3)
+    {
+        falling = 1;
+    }
+    else if (diff < 0)
+    {
+        falling = 1 - 1 / (2 * t_diff / 3) * (diff + 2 * t_diff / 3);
+        steady = 1 / (2 * t_diff / 3) * (diff + 2 * t_diff / 3);
+    }
+    else if (diff < 4 * t_diff)
+    {
+        steady = 1 - 1 / (4 * t_diff) * diff;
+        rising = 1 / (4 * t_diff) * diff;
+    }
+    else
+    {
+        rising = 1;
+    }
+
+    double r9 = std::min(slow, falling);
+    double r8 = std::min(ok, falling);
+    double r7 = std::min(fast, falling);
+    double r6 = std::min(slow, steady);
+    double r5 = std::min(ok, steady);
+    double r4 = std::min(fast, steady);
+    double r3 = std::min(slow, rising);
+    double r2 = std::min(ok, rising);
+    double r1 = std::min(fast, rising);
+
+    double p2 = std::sqrt(std::pow(r9, 2));
+    double p1 = std::sqrt(std::pow(r6, 2) + std::pow(r8, 2));
+    double z = std::sqrt(std::pow(r3, 2) + std::pow(r5, 2) + std::pow(r7, 2));
+    double n1 = std::sqrt(std::pow(r2, 2) + std::pow(r4, 2));
+    double n2 = std::sqrt(std::pow(r1, 2));
+
+    return (n2 * 0.25 + n1 * 0.5 + z * 1 + p1 * 2 + p2 * 4) / (n2 + n1 + z + p1 + p2);
+}
+
+/**
+ * \brief Inputs at the breakpoints of two partitions, and random ones
+ * \param x the breakpoints of the first input
+ * \param y the breakpoints of the second input
+ * \param xMax the random first inputs are drawn in [0, xMax]
+ * \param yMin the random second inputs are drawn in [yMin, yMax]
+ * \param yMax the random second inputs are drawn in [yMin, yMax]
+ * \param nSamples the number of random inputs
+ * \return the inputs
+ */
+std::vector<std::pair<double, double>>
+GetInputs(const std::vector<double>& x,
+          const std::vector<double>& y,
+          double xMax,
+          double yMin,
+          double yMax,
+          uint32_t nSamples)
+{
+    std::vector<std::pair<double, double>> inputs;
+    for (double xi : x)
+    {
+        for (double yi : y)
+        {
+            inputs.emplace_back(xi, yi);
+        }
+    }
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+    for (uint32_t i = 0; i < nSamples; i++)
+    {
+        double xi = rv->GetValue(0, xMax);
+        inputs.emplace_back(xi, rv->GetValue(yMin, yMax));
+    }
+    return inputs;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nSamples = 1000000;
+    double tolerance = 1e-12;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nSamples", "Number of random inputs of each engine", nSamples);
+    cmd.AddValue("tolerance", "Largest absolute difference with the reference", tolerance);
+    cmd.Parse(argc, argv);
+
+    std::cout << "engine,samples,maxAbsDiff,tolerance,result" << std::endl;
+    bool failed = false;
+
+    // send buffer occupancy and its variation [B]
+    Ptr<FuzzyEngine> server = CreateObject<FuzzyAlgorithmServer>()->GetFuzzyEngine();
+    double maxDiff = 0;
+    auto inputs = GetInputs({0, 1000, 2000, 4000, 6000},
+                            {-4000, -2000, -1000, 0, 1000, 2000, 4000},
+                            6000,
+                            -4000,
+                            4000,
+                            nSamples);
+    for (const auto& input : inputs)
+    {
+        double diff = std::abs(server->Evaluate<2>({input.first, input.second}) -
+                               ReferenceServer(input.first, input.second));
+        maxDiff = std::max(maxDiff, diff);
+    }
+    failed |= maxDiff > tolerance;
+    std::cout << "FuzzyAlgorithmServer," << inputs.size() << "," << maxDiff << "," << tolerance
+              << "," << (maxDiff > tolerance ? "FAIL" : "OK") << std::endl;
+
+    // the engine takes the delay and its trend in ms, the reference in s
+    Ptr<FuzzyEngine> client = CreateObject<FuzzyAlgorithm>()->GetFuzzyEngine();
+    maxDiff = 0;
+    inputs = GetInputs({0, 20.0 / 3, 10, 40, 60},
+                       {-20, -20.0 / 3, -5, 0, 20, 40, 60},
+                       60,
+                       -20,
+                       60,
+                       nSamples);
+    for (const auto& input : inputs)
+    {
+        double diff = std::abs(client->Evaluate<2>({input.first, input.second}) -
+                               ReferenceClient(input.first / 1e3, input.second / 1e3));
+        maxDiff = std::max(maxDiff, diff);
+    }
+    failed |= maxDiff > tolerance;
+    std::cout << "FuzzyAlgorithm," << inputs.size() << "," << maxDiff << "," << tolerance << ","
+              << (maxDiff > tolerance ? "FAIL" : "OK") << std::endl;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file qoe-monitor-validation.cc
+ * \brief Validation of QoeMonitor against the reference run of qoe-validation.py
+ *
+ * The bursts of the burstTrace.csv of a run directory are replayed through
+ * the BurstRx sink of a QoeMonitor, each at its reception time and with its
+ * transmission timestamp, and the transmitted bursts of txBurstsBySta.csv
+ * are added at the end. The summary of the monitor is written as the qoe.csv
+ * of vr-a-rev-back and compared, column by column, with expected.csv: the
+ * program exits with status 1 if any relative difference exceeds tolerance.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "qoe-monitor-validation
+    --runDir=contrib/vr-app/examples/qoe-validation-reference"
+    \endcode
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/csv-reader.h"
+#include "ns3/network-module.h"
+#include "ns3/qoe-monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("QoeMonitorValidation");
+
+namespace
+{
+
+/**
+ * \brief Deliver a replayed burst to the monitor
+ * \param monitor the monitor
+ * \param flow the receiver address, identifying the flow
+ * \param header the header of the burst, timestamped at its transmission
+ */
+void
+DeliverBurst(Ptr<QoeMonitor> monitor, Address flow, SeqTsSizeFragHeader header)
+{
+    monitor->BurstRx(Create<Packet>(0), Address(), flow, header);
+}
+
+/**
+ * \brief Stamp a replayed burst at its transmission and schedule its reception
+ * \param monitor the monitor
+ * \param flow the receiver address, identifying the flow
+ * \param seq the sequence number of the burst
+ * \param size the size of the burst [B]
+ * \param transit the time from transmission to reception
+ */
+void
+SendBurst(Ptr<QoeMonitor> monitor, Address flow, uint64_t seq, uint32_t size, Time transit)
+{
+    SeqTsSizeFragHeader header;
+    header.SetSeq(seq);
+    header.SetSize(size);
+    header.SetFrags(1);
+    header.SetFragSeq(0);
+    Simulator::Schedule(transit, &DeliverBurst, monitor, flow, header);
+}
+
+/**
+ * \brief Read the two-line CSV of QoeMonitor::WriteSummary
+ * \param path the file
+ * \param columns the names of the columns
+ * \param values the values of the columns
+ */
+void
+ReadSummary(const std::string& path, std::vector<std::string>& columns, std::vector<double>& values)
+{
+    CsvReader csv(path);
+    NS_ABORT_MSG_IF(!csv.FetchNextRow(), "No header in " << path);
+    for (std::size_t i = 0; i < csv.ColumnCount(); i++)
+    {
+        std::string column;
+        csv.GetValue(i, column);
+        columns.push_back(column);
+    }
+    NS_ABORT_MSG_IF(!csv.FetchNextRow(), "No values in " << path);
+    for (std::size_t i = 0; i < csv.ColumnCount(); i++)
+    {
+        std::string value;
+        csv.GetValue(i, value);
+        values.push_back(std::stod(value));
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string runDir = "contrib/vr-app/examples/qoe-validation-reference";
+    std::string expected = "";
+    double simulationTime = 1;
+    uint32_t nStas = 2;
+    double frameRate = 60;
+    double tolerance = 1e-6;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("runDir", "Directory with burstTrace.csv and txBurstsBySta.csv", runDir);
+    cmd.AddValue("expected", "Expected summary, runDir/expected.csv if empty", expected);
+    cmd.AddValue("simulationTime", "Simulation time of the run [s]", simulationTime);
+    cmd.AddValue("nStas", "Number of flows of the run", nStas);
+    cmd.AddValue("frameRate", "Frame rate of the run [FPS]", frameRate);
+    cmd.AddValue("tolerance", "Largest relative difference with the expected summary", tolerance);
+    cmd.Parse(argc, argv);
+    if (expected.empty())
+    {
+        expected = runDir + "/expected.csv";
+    }
+
+    // same configuration as in vr-a-rev-back
+    Ptr<QoeMonitor> monitor =
+        CreateObjectWithAttributes<QoeMonitor>("Duration",
+                                               TimeValue(Seconds(simulationTime)),
+                                               "NumFlows",
+                                               UintegerValue(nStas),
+                                               "FrameInterval",
+                                               TimeValue(Seconds(1 / frameRate)),
+                                               "KeyByDestination",
+                                               BooleanValue(true));
+
+    CsvReader bursts(runDir + "/burstTrace.csv");
+    while (bursts.FetchNextRow())
+    {
+        std::string address;
+        int64_t txTime;
+        int64_t rxTime;
+        uint64_t seq;
+        uint32_t size;
+        if (bursts.IsBlankRow() || !bursts.GetValue(0, address) || !bursts.GetValue(1, txTime) ||
+            !bursts.GetValue(2, rxTime) || !bursts.GetValue(3, seq) || !bursts.GetValue(4, size))
+        {
+            continue; // header
+        }
+        Address flow = InetSocketAddress(Ipv4Address(address.c_str()), 0);
+        Simulator::Schedule(NanoSeconds(txTime),
+                            &SendBurst,
+                            monitor,
+                            flow,
+                            seq,
+                            size,
+                            NanoSeconds(rxTime - txTime));
+    }
+    Simulator::Run();
+
+    CsvReader txBursts(runDir + "/txBurstsBySta.csv");
+    while (txBursts.FetchNextRow())
+    {
+        uint64_t sent;
+        if (!txBursts.IsBlankRow() && txBursts.GetValue(0, sent))
+        {
+            monitor->AddTxBursts(sent);
+        }
+    }
+
+    std::ostringstream summary;
+    monitor->WriteSummary(summary);
+    std::cout << summary.str();
+    Simulator::Destroy();
+
+    std::vector<std::string> columns;
+    std::vector<double> values;
+    std::vector<std::string> expectedColumns;
+    std::vector<double> expectedValues;
+    std::istringstream lines(summary.str());
+    std::string header;
+    std::string row;
+    std::getline(lines, header);
+    std::getline(lines, row);
+    std::istringstream headerStream(header);
+    std::istringstream rowStream(row);
+    std::string cell;
+    while (std::getline(headerStream, cell, ','))
+    {
+        columns.push_back(cell);
+    }
+    while (std::getline(rowStream, cell, ','))
+    {
+        values.push_back(std::stod(cell));
+    }
+    ReadSummary(expected, expectedColumns, expectedValues);
+    NS_ABORT_MSG_IF(columns != expectedColumns, "Unexpected columns in " << expected);
+
+    bool failed = false;
+    for (std::size_t i = 0; i < columns.size(); i++)
+    {
+        double a = values[i];
+        double b = expectedValues[i];
+        bool match = (std::isnan(a) || std::isnan(b))
+                         ? (std::isnan(a) && std::isnan(b))
+                         : std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+        if (!match)
+        {
+            std::cerr << columns[i] << "=" << a << ", expected " << b << std::endl;
+            failed = true;
+        }
+    }
+    std::cerr << (failed ? "MISMATCH" : "OK") << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+# Validates the QoE computed during the simulation by ns3::QoeMonitor
+# (qoe.csv) against the reference post-processing of compute_qoe in
+# adaptive-sem-simulations.py, for one or more recorded runs.
+#
+# Each run directory must contain burstTrace.csv, txBurstsBySta.csv,
+# rxBursts.csv and qoe.csv, as written by vr-a-rev-back. Every column of
+# qoe.csv is recomputed from the traces, and checked to be in its valid
+# range.
+#
+# --selfTest checks the computation from the traces against the hand-derived
+# metrics of qoe-validation-reference/expected.csv (see the README there).
+# With --monitorSummary, it also checks the summary written by the C++
+# QoeMonitor on the same traces, i.e., the output of qoe-monitor-validation.
+#
+# Usage:
+#   python3 qoe-validation.py --simulationTime 10 --nStas 4 run1/ run2/ ...
+#   python3 qoe-validation.py --selfTest
+#   ./ns3 run qoe-monitor-validation > monitor.csv
+#   python3 qoe-validation.py --selfTest --monitorSummary monitor.csv
+
+import argparse
+import math
+import os
+import sys
+
+COLUMNS = ['Qoe', 'Throughput_Mbps', 'AvgDelay_ms', 'SuccessRate', 'StallPenalty',
+           'FreezeTime_ms', 'SkippedFrames', 'RxBursts', 'TxBursts', 'Flows']
+
+REFERENCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             'qoe-validation-reference')
+REFERENCE_PARAMS = {'simulationTime': 1, 'nStas': 2, 'frameRate': 60}
+
+
+def reference_qoe(run_dir, simulation_time, n_stas, frame_rate):
+    """Same computation as compute_qoe in adaptive-sem-simulations.py, plus
+    the frame-level metrics of QoeMonitor"""
+    with open(os.path.join(run_dir, 'burstTrace.csv')) as f:
+        rows = [row.split(',') for row in f.read().split('\n')[1:-1]]
+    bytes_recv = [float(row[4]) * 8 / 1e6 for row in rows]  # Mb
+    delays = [(float(row[2]) - float(row[1])) / 1e6 for row in rows]  # ms
+
+    with open(os.path.join(run_dir, 'txBurstsBySta.csv')) as f:
+        tot_tx = sum([float(n) for n in f.read().split('\n')[:-1]])
+    with open(os.path.join(run_dir, 'rxBursts.csv')) as f:
+        tot_rx = float(f.read().rstrip('\n'))
+
+    succ = tot_rx / tot_tx if tot_rx > 0 else 0
+
+    # per flow, in order of reception: freeze time beyond a frame interval
+    # and sequence numbers never received
+    frame_interval = 1e3 / frame_rate  # ms
+    flows = {}
+    for row in rows:
+        rx, seq = float(row[2]) / 1e6, int(row[3])
+        flow = flows.setdefault(row[0], {'lastRx': None, 'nextSeq': 0,
+                                         'freeze': 0.0, 'skipped': 0})
+        if flow['lastRx'] is not None:
+            flow['freeze'] += max(0.0, rx - flow['lastRx'] - frame_interval)
+        if seq >= flow['nextSeq']:
+            flow['skipped'] += seq - flow['nextSeq']
+            flow['nextSeq'] = seq + 1
+        flow['lastRx'] = rx
+
+    metrics = {'SuccessRate': succ,
+               'StallPenalty': (1 - succ) * 1000,
+               'FreezeTime_ms': sum([f['freeze'] for f in flows.values()]) / max(len(flows), 1),
+               'SkippedFrames': sum([f['skipped'] for f in flows.values()]),
+               'RxBursts': len(rows),
+               'TxBursts': tot_tx,
+               'Flows': n_stas}
+    if len(bytes_recv) == 0:
+        metrics.update({'Qoe': float('nan'), 'Throughput_Mbps': float('nan'),
+                        'AvgDelay_ms': float('nan')})
+        return metrics
+
+    avg_throughput = sum(bytes_recv) / simulation_time / n_stas
+    avg_delay = sum(delays) / len(delays)
+    metrics.update({'Qoe': 60 * math.log10(avg_throughput) - avg_delay - metrics['StallPenalty'],
+                    'Throughput_Mbps': avg_throughput,
+                    'AvgDelay_ms': avg_delay})
+    return metrics
+
+
+def read_summary(path):
+    """Read a summary with the columns of QoeMonitor::WriteSummary"""
+    with open(path) as f:
+        lines = f.read().split('\n')
+    header = lines[0].split(',')
+    assert header == COLUMNS, '%s: unexpected columns %s' % (path, header)
+    return dict(zip(header, [float(v) for v in lines[1].split(',')]))
+
+
+def check_ranges(summary):
+    """Return the violated constraints between the columns of a summary"""
+    errors = []
+    if not 0 <= summary['SuccessRate'] <= 1:
+        errors.append('SuccessRate not in [0, 1]')
+    if summary['RxBursts'] > summary['TxBursts']:
+        errors.append('RxBursts > TxBursts')
+    if not summary['AvgDelay_ms'] >= 0 and not math.isnan(summary['AvgDelay_ms']):
+        errors.append('AvgDelay_ms < 0')
+    if summary['FreezeTime_ms'] < 0 or summary['SkippedFrames'] < 0:
+        errors.append('negative FreezeTime_ms or SkippedFrames')
+    if not close(summary['StallPenalty'], (1 - summary['SuccessRate']) * 1000, 1e-6):
+        errors.append('StallPenalty != (1 - SuccessRate) * 1000')
+    return errors
+
+
+def close(a, b, tolerance):
+    if math.isnan(a) or math.isnan(b):
+        return math.isnan(a) and math.isnan(b)
+    return abs(a - b) <= tolerance * max(1.0, abs(b))
+
+
+def validate(name, summary, ref, tolerance):
+    errors = check_ranges(summary)
+    errors += ['%s=%.9g, expected %.9g' % (column, summary[column], ref[column])
+               for column in COLUMNS if not close(summary[column], ref[column], tolerance)]
+    print('%s: Qoe reference=%.9f monitor=%.9f %s'
+          % (name, ref['Qoe'], summary['Qoe'], 'OK' if not errors else 'MISMATCH'))
+    for error in errors:
+        print('  ' + error)
+    return not errors
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Compare QoeMonitor with compute_qoe')
+    parser.add_argument('--simulationTime', type=float)
+    parser.add_argument('--nStas', type=int)
+    parser.add_argument('--frameRate', type=float, default=60)
+    parser.add_argument('--tolerance', type=float, default=1e-6,
+                        help='maximum relative difference')
+    parser.add_argument('--selfTest', action='store_true',
+                        help='check the reference computation on qoe-validation-reference')
+    parser.add_argument('--monitorSummary',
+                        help='with --selfTest, the QoeMonitor summary of the reference run')
+    parser.add_argument('runs', nargs='*', help='run directories')
+    args = parser.parse_args()
+
+    failed = 0
+    if args.selfTest:
+        ref = reference_qoe(REFERENCE_DIR, REFERENCE_PARAMS['simulationTime'],
+                            REFERENCE_PARAMS['nStas'], REFERENCE_PARAMS['frameRate'])
+        expected = read_summary(os.path.join(REFERENCE_DIR, 'expected.csv'))
+        failed += not validate('self-test', expected, ref, args.tolerance)
+        if args.monitorSummary:
+            failed += not validate('QoeMonitor', read_summary(args.monitorSummary), expected,
+                                   args.tolerance)
+    elif args.monitorSummary:
+        parser.error('--monitorSummary requires --selfTest')
+
+    if args.runs and (args.simulationTime is None or args.nStas is None):
+        parser.error('--simulationTime and --nStas are required to validate runs')
+    for run_dir in args.runs:
+        ref = reference_qoe(run_dir, args.simulationTime, args.nStas, args.frameRate)
+        summary = read_summary(os.path.join(run_dir, 'qoe.csv'))
+        failed += not validate(run_dir, summary, ref, args.tolerance)
+
+    sys.exit(1 if failed else 0)
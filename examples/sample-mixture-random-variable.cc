@@ -19,6 +19,7 @@
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/object-factory.h"
 #include "ns3/command-line.h"
 #include "ns3/random-variable-stream.h"
@@ -39,12 +40,15 @@ int
 main (int argc, char *argv[])
 {
   uint32_t nSamples = 1000000;
+  bool fused = false;
 
   CommandLine cmd (__FILE__);
   cmd.AddValue ("nSamples", "Number of samples", nSamples);
+  cmd.AddValue ("fused", "Sample the normal components inline, in a batch", fused);
   cmd.Parse (argc, argv);
 
-  Ptr<MixtureRandomVariable> x = CreateObject<MixtureRandomVariable> ();
+  Ptr<MixtureRandomVariable> x =
+      CreateObjectWithAttributes<MixtureRandomVariable> ("Fused", BooleanValue (fused));
 
   // setup weights cdf
   std::vector<double> w{0.7, 1.0}; // p1 = 0.7, p2 = 0.3
@@ -56,10 +60,23 @@ main (int argc, char *argv[])
                                                                    "Variance", DoubleValue (4)));
 
   x->SetRvs (w, rvs);
+  x->AssignStreams (0);
 
-  for (uint32_t i = 0; i < nSamples; i++)
+  if (fused)
     {
-      std::cout << x->GetValue () << std::endl;
+      std::vector<double> values (nSamples);
+      x->GetValues (values);
+      for (double value : values)
+        {
+          std::cout << value << std::endl;
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < nSamples; i++)
+        {
+          std::cout << x->GetValue () << std::endl;
+        }
     }
 
   return 0;
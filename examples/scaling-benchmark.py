@@ -0,0 +1,196 @@
+# Scaling benchmark: wall-clock and memory cost of simulating VR stations.
+#
+# Runs vr-app-n-stas (UDP) and vr-adaptive-app-n-stas (TCP, tcp_adaptive)
+# for a sweep of nStas and burst generator types, and writes a single table
+# with wall time, CPU time, peak RSS, events processed and derived rates.
+# Each run must report server and client applications of the benchmarked
+# transport (TCP variants for TCP and tcp_adaptive), or the script fails.
+# The examples must already be built; only the Python standard library is
+# needed.
+#
+# To use it as a before/after gate, save the table of the baseline build and
+# pass it with --baseline: runs whose wall time per simulated second grew more
+# than --threshold are reported and the script exits with status 1.
+#
+# Usage:
+#   python3 scaling-benchmark.py --ns3Path ~/ns-3-dev --nStas 1 2 4 8 \
+#       --output after.csv --baseline before.csv
+
+import argparse
+import csv
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# protocol -> (example, burstGeneratorType values)
+CONFIGURATIONS = {
+    'UDP': ('vr-app-n-stas', ['model', 'trace', 'deterministic']),
+    'TCP': ('vr-adaptive-app-n-stas', ['tcp']),
+    'tcp_adaptive': ('vr-adaptive-app-n-stas', ['tcp_adaptive']),
+}
+
+FIELDS = ['Example', 'Protocol', 'Generator', 'nStas', 'SimulationTime_s', 'Wall_s', 'Cpu_s',
+          'PeakRss_MB', 'Events', 'EventsPerSimSecond', 'WallPerSimSecond_s',
+          'StaSimSecondsPerCpuHour']
+
+
+def find_executable(ns3_path, example):
+    """Find the binary of an example in the ns-3 build tree"""
+    # e.g., ns3.40-vr-app-n-stas-default, ns3-dev-vr-app-n-stas-optimized
+    name = re.compile(r'^ns3[^-]*(-dev)?-' + re.escape(example) +
+                      r'(-(default|debug|release|optimized))?$')
+    candidates = [f for f in glob.glob(os.path.join(ns3_path, 'build', '**', 'ns3*'), recursive=True)
+                  if name.match(os.path.basename(f)) and os.path.isfile(f) and os.access(f, os.X_OK)]
+    if not candidates:
+        raise FileNotFoundError('Executable of ' + example + ' not found in ' + ns3_path +
+                                '/build: build the examples first')
+    # prefer the most recently built one
+    return max(candidates, key=os.path.getmtime)
+
+
+def check_protocol(apps, protocol):
+    """Check that both ends of a run use the benchmarked transport"""
+    tcp = protocol != 'UDP'
+    for end in ['serverApp', 'clientApp']:
+        if end not in apps:
+            raise RuntimeError('the example did not print ' + end)
+        if apps[end].endswith('Tcp') != tcp:
+            raise RuntimeError('%s row runs %s=%s' % (protocol, end, apps[end]))
+
+
+def run_once(executable, args, workdir, protocol):
+    """Run a simulation, return (wall [s], cpu [s], peak RSS [MB], events)"""
+    stdout_file = os.path.join(workdir, 'stdout.txt')
+    stderr_file = os.path.join(workdir, 'stderr.txt')
+    start = time.monotonic()
+    with open(stdout_file, 'w') as out, open(stderr_file, 'w') as err:
+        proc = subprocess.Popen([executable] + args, cwd=workdir, stdout=out, stderr=err)
+        # wait4 returns the resource usage of this child only
+        _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.monotonic() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    if proc.returncode != 0:
+        with open(stderr_file) as err:
+            raise RuntimeError(' '.join([executable] + args) + ' failed:\n' + err.read())
+
+    events = None
+    apps = {}
+    with open(stdout_file) as out:
+        for line in out:
+            if line.startswith('eventCount='):
+                events = int(line.split('=')[1])
+            elif line.startswith('serverApp='):
+                apps = dict(field.split('=') for field in line.split())
+    if events is None:
+        raise RuntimeError(executable + ' did not print eventCount')
+    check_protocol(apps, protocol)
+
+    # ru_maxrss is in kB on Linux
+    return wall, usage.ru_utime + usage.ru_stime, usage.ru_maxrss / 1024, events
+
+
+def benchmark(executable, example, protocol, generator, n_stas, simulation_time, runs):
+    args = ['--nStas=%d' % n_stas, '--burstGeneratorType=' + generator,
+            '--simulationTime=%g' % simulation_time]
+    best = None
+    for _ in range(runs):
+        with tempfile.TemporaryDirectory() as workdir:
+            result = run_once(executable, args, workdir, protocol)
+        # keep the fastest run, the least perturbed by the rest of the system
+        if best is None or result[0] < best[0]:
+            best = result
+    wall, cpu, rss, events = best
+    return {
+        'Example': example,
+        'Protocol': protocol,
+        'Generator': generator,
+        'nStas': n_stas,
+        'SimulationTime_s': simulation_time,
+        'Wall_s': '%.3f' % wall,
+        'Cpu_s': '%.3f' % cpu,
+        'PeakRss_MB': '%.1f' % rss,
+        'Events': events,
+        'EventsPerSimSecond': '%.0f' % (events / simulation_time),
+        'WallPerSimSecond_s': '%.6f' % (wall / simulation_time),
+        'StaSimSecondsPerCpuHour': '%.0f' % (n_stas * simulation_time / cpu * 3600 if cpu > 0 else 0),
+    }
+
+
+def key(row):
+    return (row['Example'], row['Protocol'], row['Generator'], str(row['nStas']),
+            str(float(row['SimulationTime_s'])))
+
+
+def compare(rows, baseline_file, threshold):
+    """Print the ratio with the baseline, return the number of regressions"""
+    with open(baseline_file) as f:
+        baseline = {key(row): row for row in csv.DictReader(f)}
+
+    regressions = 0
+    print('\n%-24s %-12s %-14s %6s %10s %10s %8s' % ('Example', 'Protocol', 'Generator', 'nStas',
+                                                     'Before_s', 'After_s', 'Ratio'))
+    for row in rows:
+        old = baseline.get(key(row))
+        if old is None:
+            continue
+        before = float(old['WallPerSimSecond_s'])
+        after = float(row['WallPerSimSecond_s'])
+        ratio = after / before if before > 0 else float('inf')
+        regressed = ratio > 1 + threshold
+        regressions += regressed
+        print('%-24s %-12s %-14s %6s %10.6f %10.6f %8.3f%s' % (
+            row['Example'], row['Protocol'], row['Generator'], row['nStas'], before, after, ratio,
+            ' REGRESSION' if regressed else ''))
+    return regressions
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='VR station scaling benchmark')
+    parser.add_argument('--ns3Path', default=os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                                                          '..', '..', '..'),
+                        help='root of the ns-3 tree (default: the one containing this module)')
+    parser.add_argument('--nStas', type=int, nargs='+', default=[1, 2, 4, 8, 16])
+    parser.add_argument('--protocols', nargs='+', default=list(CONFIGURATIONS.keys()),
+                        choices=list(CONFIGURATIONS.keys()))
+    parser.add_argument('--generators', nargs='+', default=None,
+                        help='restrict the UDP burst generator types')
+    parser.add_argument('--simulationTime', type=float, default=5)
+    parser.add_argument('--runs', type=int, default=1,
+                        help='repetitions of each point, the fastest is kept')
+    parser.add_argument('--output', default='scaling-benchmark.csv')
+    parser.add_argument('--baseline', default=None, help='table of a previous run to compare with')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='relative slowdown reported as a regression')
+    args = parser.parse_args()
+
+    rows = []
+    for protocol in args.protocols:
+        example, generators = CONFIGURATIONS[protocol]
+        if protocol == 'UDP' and args.generators:
+            generators = args.generators
+        executable = find_executable(os.path.realpath(args.ns3Path), example)
+        for generator in generators:
+            for n_stas in args.nStas:
+                row = benchmark(executable, example, protocol, generator, n_stas,
+                                args.simulationTime, args.runs)
+                rows.append(row)
+                print('%-24s %-12s %-14s nStas=%-4d wall=%ss cpu=%ss rss=%sMB events=%s' % (
+                    example, protocol, generator, n_stas, row['Wall_s'], row['Cpu_s'],
+                    row['PeakRss_MB'], row['Events']))
+                sys.stdout.flush()
+
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+    print('Results written to ' + args.output)
+
+    if args.baseline:
+        regressions = compare(rows, args.baseline, args.threshold)
+        if regressions:
+            print('%d regressions above %.0f%%' % (regressions, args.threshold * 100))
+            sys.exit(1)
@@ -20,23 +20,30 @@
 
 #include "ns3/boolean.h"
 #include "ns3/applications-module.h"
+#include "ns3/bitrate-ladder.h"
 #include "ns3/bursty-application-client-helper.h"
 #include "ns3/bursty-application-server-helper.h"
 #include "ns3/bursty-application-server-instance.h"
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/encoder-rate-control.h"
+#include "ns3/fuzzy-engine.h"
+#include "ns3/head-motion-model.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/log.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/pointer.h"
+#include "ns3/qoe-monitor.h"
+#include "ns3/burst-latency-breakdown.h"
 #include "ns3/ssid.h"
 #include "ns3/string.h"
 #include "ns3/system-path.h"
 #include "ns3/trace-file-burst-generator.h"
 #include "ns3/trace-helper.h"
 #include "ns3/uinteger.h"
+#include "ns3/vr-app-profiler.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/yans-wifi-helper.h"
 
@@ -194,6 +201,34 @@ ClientEmbeddedObjectReceived(Ptr<OutputStreamWrapper> traceFile, Ptr<const Three
     }
 }
 
+void
+RateDecisionTaken(Ptr<OutputStreamWrapper> traceFile, const RateDecision& decision)
+{
+    *traceFile->GetStream() << decision.time.GetNanoSeconds() << ","
+                            << AddressToString(decision.flow) << ","
+                            << decision.measuredRate.GetBitRate() << ","
+                            << decision.bufferOccupancy << "," << decision.chosenRate.GetBitRate()
+                            << "," << decision.cappedRate.GetBitRate() << "\n";
+}
+
+void
+HeadPoseComputed(Ptr<OutputStreamWrapper> traceFile, const Address& flow, const HeadPose& pose)
+{
+    *traceFile->GetStream() << pose.time.GetNanoSeconds() << "," << AddressToString(flow) << ","
+                            << pose.yaw << "," << pose.pitch << "," << pose.speed << "\n";
+}
+
+void
+FrameEncoded(Ptr<OutputStreamWrapper> traceFile,
+             const Address& flow,
+             const RateControlSample& sample)
+{
+    *traceFile->GetStream() << sample.time.GetNanoSeconds() << "," << AddressToString(flow) << ","
+                            << sample.frameSize << "," << sample.fullness << ","
+                            << sample.bufferSize << "," << sample.qp << ","
+                            << sample.targetRate.GetBitRate() << "\n";
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -205,6 +240,19 @@ main(int argc, char* argv[])
     std::string burstGeneratorType =
         "model";                // type of burst generator {"model", "trace", "deterministic"}
     double simulationTime = 10; // simulation time in seconds
+    bool latencyBreakdown = false; // write per-burst latency breakdowns
+    bool sendBufferSamples = false; // write the send buffer occupancy of each flow
+    bool rateDecisions = false;     // write the rate adaptation decisions
+    bool profile = false;           // report allocation and copy counters at the end
+    std::string rateAllocator = ""; // joint rate allocator of the server, empty for none
+    std::string rateAllocatorCapacity = "0bps"; // capacity shared by the allocator, 0 to estimate it
+    std::string bandwidthEstimator = ""; // throughput estimator, empty for the algorithm default
+    std::string fuzzyRuleFile = ""; // rules of the fuzzy algorithm, empty for the default ones
+    std::string bitrateLadder = ""; // bitrate ladder of the server, empty for the default one
+    bool headMotion = false;        // modulate the frame sizes with the head motion of the users
+    bool headPoses = false;         // write the head poses of the users
+    bool rateControl = false;       // encode the frames with a VBV rate control
+    bool rateControlSamples = false; // write the state of the rate controls
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("nStas", "the number of STAs around the AP", nStas);
@@ -213,9 +261,59 @@ main(int argc, char* argv[])
     cmd.AddValue("frameRate", "the app frame rate [FPS]", frameRate);
     cmd.AddValue("vrAppName", "the app name", vrAppName);
     cmd.AddValue("burstGeneratorType",
-                 "type of burst generator {\"model\", \"google\", \"fuzzy\"}",
+                 "type of burst generator {\"model\", \"google\", \"fuzzy\", \"bola\", "
+                 "\"mpc\", \"festive\", \"delivery\"}",
                  burstGeneratorType);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("latencyBreakdown",
+                 "Write the per-burst latency breakdown to latencyBreakdown.csv",
+                 latencyBreakdown);
+    cmd.AddValue("sendBufferSamples",
+                 "Write the send buffer occupancy of each flow to sendBuffer.csv",
+                 sendBufferSamples);
+    cmd.AddValue("rateDecisions",
+                 "Write the rate adaptation decisions to rateDecisions.csv",
+                 rateDecisions);
+    cmd.AddValue("rateAllocator",
+                 "Joint rate allocator of the server {\"\", \"MaxMinRateAllocator\", "
+                 "\"ProportionalFairRateAllocator\"}, requires an adaptive burstGeneratorType",
+                 rateAllocator);
+    cmd.AddValue("rateAllocatorCapacity",
+                 "Capacity shared by the joint rate allocator, 0bps to estimate it from the "
+                 "throughputs measured by the clients",
+                 rateAllocatorCapacity);
+    cmd.AddValue("bandwidthEstimator",
+                 "Throughput estimator of the adaptation algorithms {\"\", "
+                 "\"EwmaBandwidthEstimator\", \"DualEwmaBandwidthEstimator\", "
+                 "\"HarmonicBandwidthEstimator\", \"SlidingPercentileBandwidthEstimator\", "
+                 "\"KalmanBandwidthEstimator\"}, empty for the default of the algorithm",
+                 bandwidthEstimator);
+    cmd.AddValue("fuzzyRuleFile",
+                 "CSV file with the partitions, rules and outputs of the fuzzy algorithm (see "
+                 "FuzzyEngine), empty for the default rules",
+                 fuzzyRuleFile);
+    cmd.AddValue("bitrateLadder",
+                 "Bitrate ladder shared by the adaptation algorithms and the burst generators, "
+                 "either a list of rates (e.g., \"5Mbps 10Mbps 20Mbps\") or a CSV file with one "
+                 "rate per row, empty for the default ladder",
+                 bitrateLadder);
+    cmd.AddValue("headMotion",
+                 "Modulate the frame sizes of each user with a HeadMotionModel",
+                 headMotion);
+    cmd.AddValue("headPoses",
+                 "Write the head poses of each user to headPoses.csv, requires headMotion",
+                 headPoses);
+    cmd.AddValue("rateControl",
+                 "Encode the frames of each user with an EncoderRateControl",
+                 rateControl);
+    cmd.AddValue("rateControlSamples",
+                 "Write the VBV buffer fullness and QP after each frame to rateControl.csv, "
+                 "requires rateControl",
+                 rateControlSamples);
+    cmd.AddValue("profile",
+                 "Report the allocations and copies of each component of the module at the end "
+                 "of the run (requires a build with NS3_VR_APP_PROFILING or logging enabled)",
+                 profile);
     cmd.Parse(argc, argv);
 
     uint32_t fragmentSize = 1472; // bytes
@@ -411,6 +509,12 @@ main(int argc, char* argv[])
         Config::SetDefault("ns3::BurstyApplicationServer::adaptationAlgorithm",
                            StringValue("FestiveAlgorithm"));
     }
+    else if (burstGeneratorType == "delivery")
+    {
+        protocol = "ns3::TcpSocketFactory";
+        Config::SetDefault("ns3::BurstyApplicationServer::adaptationAlgorithm",
+                           StringValue("TcpDeliveryRateAlgorithmServer"));
+    }
     else
     {
         NS_ABORT_MSG("Wrong burstGeneratorType type");
@@ -420,10 +524,68 @@ main(int argc, char* argv[])
     Config::SetDefault("ns3::VrBurstGenerator::TargetDataRate", DataRateValue(DataRate(appRate)));
     Config::SetDefault("ns3::VrBurstGenerator::VrAppName", StringValue(vrAppName));
     Config::SetDefault("ns3::BurstyApplicationServer::FragmentSize", UintegerValue(fragmentSize));
+    Config::SetDefault("ns3::BurstyApplicationServer::EnableSendBufferSampler",
+                       BooleanValue(sendBufferSamples));
+    Config::SetDefault("ns3::BurstyApplicationServer::RateAllocator", StringValue(rateAllocator));
+    Config::SetDefault("ns3::JointRateAllocator::Capacity",
+                       DataRateValue(DataRate(rateAllocatorCapacity)));
+    Config::SetDefault("ns3::BurstyApplicationServer::EnableHeadMotion", BooleanValue(headMotion));
+    Config::SetDefault("ns3::BurstyApplicationServer::EnableRateControl",
+                       BooleanValue(rateControl));
+    Config::SetDefault("ns3::BurstyApplicationServer::BandwidthEstimator",
+                       StringValue(bandwidthEstimator));
+    if (!fuzzyRuleFile.empty())
+    {
+        // the engine keeps no state between evaluations, all the flows share it
+        Config::SetDefault("ns3::FuzzyAlgorithmServer::FuzzyEngine",
+                           PointerValue(CreateObjectWithAttributes<FuzzyEngine>(
+                               "RuleFile",
+                               StringValue(fuzzyRuleFile))));
+    }
+    if (!bitrateLadder.empty())
+    {
+        Ptr<BitrateLadder> ladder = CreateObject<BitrateLadder>();
+        if (bitrateLadder.find(".csv") != std::string::npos)
+        {
+            ladder->Load(bitrateLadder);
+        }
+        else
+        {
+            ladder->SetBitrates(bitrateLadder);
+        }
+        Config::SetDefault("ns3::BurstyApplicationServer::BitrateLadder", PointerValue(ladder));
+    }
 
     BurstyApplicationServerHelper server(protocol, InetSocketAddress(Ipv4Address::GetAny(), port));
 
     ApplicationContainer serverApp = server.Install(wifiApNode);
+    if (rateDecisions)
+    {
+        Ptr<OutputStreamWrapper> rateDecisionTrace = ascii.CreateFileStream("rateDecisions.csv");
+        *rateDecisionTrace->GetStream()
+            << "Time_ns,Flow,MeasuredRate_bps,BufferOccupancy,ChosenRate_bps,CappedRate_bps"
+            << std::endl;
+        serverApp.Get(0)->TraceConnectWithoutContext(
+            "RateDecision",
+            MakeBoundCallback(&RateDecisionTaken, rateDecisionTrace));
+    }
+    if (headPoses)
+    {
+        Ptr<OutputStreamWrapper> headPoseTrace = ascii.CreateFileStream("headPoses.csv");
+        *headPoseTrace->GetStream() << "Time_ns,Flow,Yaw_deg,Pitch_deg,Speed_degps" << std::endl;
+        serverApp.Get(0)->TraceConnectWithoutContext(
+            "HeadPose",
+            MakeBoundCallback(&HeadPoseComputed, headPoseTrace));
+    }
+    if (rateControlSamples)
+    {
+        Ptr<OutputStreamWrapper> rateControlTrace = ascii.CreateFileStream("rateControl.csv");
+        *rateControlTrace->GetStream()
+            << "Time_ns,Flow,FrameSize_B,Fullness_B,BufferSize_B,Qp,TargetRate_bps" << std::endl;
+        serverApp.Get(0)->TraceConnectWithoutContext(
+            "RateControl",
+            MakeBoundCallback(&FrameEncoded, rateControlTrace));
+    }
     serverApp.Start(Seconds(0.0));
     serverApp.Stop(Seconds(simulationTime + 19));
 
@@ -447,6 +609,30 @@ main(int argc, char* argv[])
     *fragmentTrace->GetStream()
         << "SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,FragSeq,TotFrags,FragSize" << std::endl;
 
+    Ptr<QoeMonitor> qoeMonitor =
+        CreateObjectWithAttributes<QoeMonitor>("Duration",
+                                               TimeValue(Seconds(simulationTime)),
+                                               "NumFlows",
+                                               UintegerValue(nStas),
+                                               "FrameInterval",
+                                               TimeValue(Seconds(1 / frameRate)),
+                                               "KeyByDestination",
+                                               BooleanValue(true));
+
+    // the server fires its "BurstRx" trace source when a burst is sent
+    serverApp.Get(0)->TraceConnectWithoutContext("BurstRx",
+                                                 MakeCallback(&QoeMonitor::BurstTx, qoeMonitor));
+
+    Ptr<BurstLatencyCollector> latencyCollector;
+    if (latencyBreakdown)
+    {
+        latencyCollector = CreateObject<BurstLatencyCollector>();
+        latencyCollector->SetOutputStream(ascii.CreateFileStream("latencyBreakdown.csv"));
+        serverApp.Get(0)->TraceConnectWithoutContext(
+            "BurstLatencyBreakdown",
+            MakeCallback(&BurstLatencyCollector::SenderBreakdown, latencyCollector));
+    }
+
     for (uint32_t i = 0; i < nStas; i++)
     {
         Time startTime = Seconds(x->GetValue());
@@ -458,9 +644,22 @@ main(int argc, char* argv[])
         app->TraceConnectWithoutContext("BurstRx", MakeBoundCallback(&BurstRx, burstTrace));
         app->TraceConnectWithoutContext("FragmentRx",
                                         MakeBoundCallback(&FragmentRx, fragmentTrace));
+        app->TraceConnectWithoutContext("BurstRx",
+                                        MakeCallback(&QoeMonitor::BurstRx, qoeMonitor));
+        if (latencyCollector)
+        {
+            app->TraceConnectWithoutContext(
+                "BurstLatencyBreakdown",
+                MakeCallback(&BurstLatencyCollector::ReceiverBreakdown, latencyCollector));
+        }
     }
     clientApps.Stop(Seconds(simulationTime + 19));
 
+    if (profile)
+    {
+        VrAppProfiler::Enable();
+    }
+
     // Start simulation
     Simulator::Stop(Seconds(simulationTime + 10));
     Simulator::Run();
@@ -490,6 +689,20 @@ main(int argc, char* argv[])
               << double(burstsReceived) / totBurstSent * 100 << "%)" << std::endl;
     *rxBursts->GetStream() << burstsReceived << std::endl;
 
+    if (sendBufferSamples)
+    {
+        Ptr<OutputStreamWrapper> sendBuffer = ascii.CreateFileStream("sendBuffer.csv");
+        bool header = true;
+        for (auto& kv : (DynamicCast<BurstyApplicationServer>(serverApp.Get(0)))->GetInstances())
+        {
+            kv.second.GetSendBufferSampler()->Dump(*sendBuffer->GetStream(), header);
+            header = false;
+        }
+    }
+
+    Ptr<OutputStreamWrapper> qoe = ascii.CreateFileStream("qoe.csv");
+    qoeMonitor->WriteSummary(*qoe->GetStream());
+
     // fragment info
     Ptr<OutputStreamWrapper> txFragmentsBySta = ascii.CreateFileStream("txFragmentsBySta.csv");
     Ptr<OutputStreamWrapper> rxFragments = ascii.CreateFileStream("rxFragments.csv");
@@ -102,10 +102,15 @@ AddressToString (const Address &addr)
   return addressStr.str ();
 }
 
+uint64_t g_rxBurstBytes = 0; // bytes of the successfully received bursts
+Time g_burstDelaySum; // sum of the delays of the successfully received bursts
+
 void
 BurstRx (Ptr<OutputStreamWrapper> traceFile, Ptr<const Packet> burst, const Address &from,
          const Address &to, const SeqTsSizeFragHeader &header)
 {
+  g_rxBurstBytes += header.GetSize ();
+  g_burstDelaySum += Simulator::Now () - header.GetTs ();
   *traceFile->GetStream () << AddressToString (from) << "," << header.GetTs ().GetNanoSeconds ()
                            << "," << Simulator::Now ().GetNanoSeconds () << "," << header.GetSeq ()
                            << "," << header.GetSize () << "\n";
@@ -132,6 +137,8 @@ main (int argc, char *argv[])
   std::string burstGeneratorType =
       "model"; // type of burst generator {"model", "trace", "deterministic"}
   double simulationTime = 10; // simulation time in seconds
+  std::string rateController =
+      "FuzzyAlgorithm"; // receiver-side rate controller {"FuzzyAlgorithm", "GccRateController"}
 
   CommandLine cmd (__FILE__);
   cmd.AddValue ("nStas", "the number of STAs around the AP", nStas);
@@ -143,6 +150,10 @@ main (int argc, char *argv[])
                 "type of burst generator {\"model\", \"trace\", \"deterministic\"}",
                 burstGeneratorType);
   cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("rateController",
+                "receiver-side rate controller of the adaptive sinks {\"FuzzyAlgorithm\", "
+                "\"GccRateController\"}",
+                rateController);
   cmd.Parse (argc, argv);
 
   uint32_t fragmentSize = 1472; //bytes
@@ -160,6 +171,12 @@ main (int argc, char *argv[])
   // LogComponentEnable ("VrAdaptiveBurstSinkTcp", LOG_DEBUG);
   // LogComponentEnable ("VrAdaptiveBurstyApplicationTcp", LOG_ALL);
   LogComponentEnable ("FuzzyAlgorithm", LOG_DEBUG);
+  // LogComponentEnable ("GccRateController", LOG_DEBUG);
+
+  Config::SetDefault ("ns3::VrAdaptiveBurstSink::RateController",
+                      StringValue ("ns3::" + rateController));
+  Config::SetDefault ("ns3::VrAdaptiveBurstSinkTcp::RateController",
+                      StringValue ("ns3::" + rateController));
 
   Config::SetDefault ("ns3::TcpL4Protocol::SocketType",
                       TypeIdValue (TypeId::LookupByName ("ns3::TcpHtcp")));
@@ -252,7 +269,7 @@ main (int argc, char *argv[])
                            : "ns3::UdpSocketFactory",
                        InetSocketAddress (ApInterface.GetAddress (0), port),
                        burstGeneratorType == "adaptive" ? "ns3::VrAdaptiveBurstyApplication"
-                       : burstGeneratorType == "tcp "   ? "ns3::BurstyApplicationTcp"
+                       : burstGeneratorType == "tcp"    ? "ns3::BurstyApplicationTcp"
                        : burstGeneratorType == "tcp_adaptive"
                            ? "ns3::VrAdaptiveBurstyApplicationTcp"
                            : "ns3::BurstyApplication");
@@ -326,6 +343,9 @@ main (int argc, char *argv[])
 
   // Saturated UDP traffic from stations to AP
   ApplicationContainer clientApps = client.Install (wifiStaNodes);
+  // checked by scaling-benchmark.py
+  std::cout << "serverApp=" << serverApp.Get (0)->GetInstanceTypeId ().GetName ()
+            << " clientApp=" << clientApps.Get (0)->GetInstanceTypeId ().GetName () << std::endl;
   Ptr<UniformRandomVariable> x = CreateObjectWithAttributes<UniformRandomVariable> (
       "Min", DoubleValue (0), "Max", DoubleValue (1));
   Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
@@ -368,6 +388,7 @@ main (int argc, char *argv[])
   // Start simulation
   Simulator::Stop (Seconds (simulationTime + 10));
   Simulator::Run ();
+  std::cout << "eventCount=" << Simulator::GetEventCount () << std::endl;
 
   // burst info
   Ptr<OutputStreamWrapper> txBurstsBySta = ascii.CreateFileStream ("txBurstsBySta.csv");
@@ -389,6 +410,11 @@ main (int argc, char *argv[])
             << double (burstsReceived) / totBurstSent * 100 << "%)" << std::endl;
   *rxBursts->GetStream () << burstsReceived << std::endl;
 
+  std::cout << "rxThroughput=" << g_rxBurstBytes * 8 / simulationTime / 1e6 << " Mbps, "
+            << "avgBurstDelay="
+            << (burstsReceived > 0 ? g_burstDelaySum.GetSeconds () * 1e3 / burstsReceived : 0)
+            << " ms" << std::endl;
+
   // fragment info
   Ptr<OutputStreamWrapper> txFragmentsBySta = ascii.CreateFileStream ("txFragmentsBySta.csv");
   Ptr<OutputStreamWrapper> rxFragments = ascii.CreateFileStream ("rxFragments.csv");
@@ -0,0 +1,731 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file vr-app-microbenchmarks.cc
+ * \brief Microbenchmarks for the hot paths of the burst pipeline
+ *
+ * Each benchmark exercises a single component in isolation, without any
+ * network stack: sockets are replaced by an in-memory BenchSocket, and
+ * protected methods are reached through thin subclasses.
+ *
+ * Results are written as CSV, one row per benchmark:
+ *
+ *   Benchmark,Iterations,NsPerOp,AllocsPerOp
+ *
+ * where an operation is a header, a burst, a fragment, a generated frame or
+ * a rate decision depending on the benchmark. Allocations are counted by
+ * replacing the global operator new.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "vr-app-microbenchmarks --scale=0.1 --filter=BurstSink"
+    \endcode
+ */
+
+#include "ns3/bola.h"
+#include "ns3/burst-sink.h"
+#include "ns3/bursty-application-client.h"
+#include "ns3/bursty-application-server-instance.h"
+#include "ns3/bursty-application.h"
+#include "ns3/core-module.h"
+#include "ns3/festive.h"
+#include "ns3/fuzzy-algorithm-server.h"
+#include "ns3/google-algorithm-server.h"
+#include "ns3/mpc.h"
+#include "ns3/network-module.h"
+#include "ns3/peer-descriptor.h"
+#include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/vr-burst-generator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VrAppMicrobenchmarks");
+
+namespace
+{
+uint64_t g_allocations = 0; //!< number of calls to the global operator new
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+    g_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+
+/// Result of a benchmark
+struct BenchmarkResult
+{
+    std::string name;    //!< benchmark name
+    uint64_t operations; //!< measured operations
+    double nsPerOp;      //!< wall time per operation [ns]
+    double allocsPerOp;  //!< heap allocations per operation
+};
+
+/**
+ * Accumulates wall time and allocations over the measured sections of a
+ * benchmark, so that setup code can be excluded.
+ */
+class Stopwatch
+{
+  public:
+    void Start()
+    {
+        m_allocationsAtStart = g_allocations;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    void Stop()
+    {
+        auto stop = std::chrono::steady_clock::now();
+        m_allocations += g_allocations - m_allocationsAtStart;
+        m_elapsedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(stop - m_start).count();
+    }
+
+    BenchmarkResult Result(const std::string& name, uint64_t operations) const
+    {
+        return BenchmarkResult{name,
+                               operations,
+                               double(m_elapsedNs) / operations,
+                               double(m_allocations) / operations};
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_allocationsAtStart{0};
+    uint64_t m_allocations{0};
+    int64_t m_elapsedNs{0};
+};
+
+/**
+ * In-memory socket: sent packets are counted and dropped, received packets
+ * are taken from a queue filled by the benchmark.
+ */
+class BenchSocket : public Socket
+{
+  public:
+    BenchSocket()
+        : m_local(InetSocketAddress(Ipv4Address("10.0.0.1"), 9)),
+          m_peer(InetSocketAddress(Ipv4Address("10.0.0.2"), 49153))
+    {
+    }
+
+    void PushRx(Ptr<Packet> packet)
+    {
+        m_rxQueue.push_back(packet);
+    }
+
+    uint64_t GetTxBytes() const
+    {
+        return m_txBytes;
+    }
+
+    SocketErrno GetErrno() const override
+    {
+        return ERROR_NOTERROR;
+    }
+
+    SocketType GetSocketType() const override
+    {
+        return NS3_SOCK_STREAM;
+    }
+
+    Ptr<Node> GetNode() const override
+    {
+        return nullptr;
+    }
+
+    int Bind(const Address& address) override
+    {
+        return 0;
+    }
+
+    int Bind() override
+    {
+        return 0;
+    }
+
+    int Bind6() override
+    {
+        return 0;
+    }
+
+    int Close() override
+    {
+        return 0;
+    }
+
+    int ShutdownSend() override
+    {
+        return 0;
+    }
+
+    int ShutdownRecv() override
+    {
+        return 0;
+    }
+
+    int Connect(const Address& address) override
+    {
+        return 0;
+    }
+
+    int Listen() override
+    {
+        return 0;
+    }
+
+    uint32_t GetTxAvailable() const override
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    int Send(Ptr<Packet> p, uint32_t flags) override
+    {
+        m_txBytes += p->GetSize();
+        return p->GetSize();
+    }
+
+    int SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress) override
+    {
+        return Send(p, flags);
+    }
+
+    uint32_t GetRxAvailable() const override
+    {
+        return m_rxQueue.empty() ? 0 : m_rxQueue.front()->GetSize();
+    }
+
+    Ptr<Packet> Recv(uint32_t maxSize, uint32_t flags) override
+    {
+        if (m_rxQueue.empty())
+        {
+            return nullptr;
+        }
+        Ptr<Packet> packet = m_rxQueue.front();
+        m_rxQueue.pop_front();
+        return packet;
+    }
+
+    Ptr<Packet> RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress) override
+    {
+        fromAddress = m_peer;
+        return Recv(maxSize, flags);
+    }
+
+    int GetSockName(Address& address) const override
+    {
+        address = m_local;
+        return 0;
+    }
+
+    int GetPeerName(Address& address) const override
+    {
+        address = m_peer;
+        return 0;
+    }
+
+    bool SetAllowBroadcast(bool allowBroadcast) override
+    {
+        return false;
+    }
+
+    bool GetAllowBroadcast() const override
+    {
+        return false;
+    }
+
+  private:
+    Address m_local;                    //!< local address
+    Address m_peer;                     //!< peer address
+    std::deque<Ptr<Packet>> m_rxQueue;  //!< packets to be received
+    uint64_t m_txBytes{0};              //!< bytes sent
+};
+
+/// Exposes the fragmentation of BurstyApplicationServerInstance
+class BenchServerInstance : public BurstyApplicationServerInstance
+{
+  public:
+    BenchServerInstance(Ptr<Socket> socket)
+    {
+        m_socket = socket;
+        socket->GetPeerName(m_peer);
+    }
+
+    using BurstyApplicationServerInstance::SendFragmentedBurst;
+};
+
+/// Exposes the fragmentation of BurstyApplication
+class BenchBurstyApplication : public BurstyApplication
+{
+  public:
+    BenchBurstyApplication(Ptr<Socket> socket)
+    {
+        m_socket = socket;
+        socket->GetPeerName(m_peer);
+    }
+
+    using BurstyApplication::SendFragmentedBurst;
+};
+
+/// Exposes the reassembly of BurstSink
+class BenchBurstSink : public BurstSink
+{
+  public:
+    using BurstSink::BurstHandler;
+    using BurstSink::FragmentReceived;
+};
+
+/// Exposes the TCP deframing of BurstyApplicationClient
+class BenchBurstyApplicationClient : public BurstyApplicationClient
+{
+  public:
+    using BurstyApplicationClient::HandleRead;
+};
+
+const uint32_t BURST_SIZE = 100000; //!< burst size [B], about 50 Mbps at 60 FPS
+const uint32_t FRAG_SIZE = 1200;    //!< fragment size, including the header [B]
+const uint32_t TCP_SEGMENT = 1448;  //!< TCP segment size used for deframing [B]
+
+/**
+ * \brief Fragment a burst as SendFragmentedBurst does
+ * \param seq the burst sequence number
+ * \return the fragments, with SeqTsSizeFragHeader
+ */
+std::vector<Ptr<Packet>>
+MakeFragments(uint64_t seq)
+{
+    SeqTsSizeFragHeader header;
+    uint32_t payload = FRAG_SIZE - header.GetSerializedSize();
+    uint16_t frags = (BURST_SIZE + FRAG_SIZE - 1) / FRAG_SIZE;
+    uint64_t burstPayload = BURST_SIZE - frags * header.GetSerializedSize();
+
+    std::vector<Ptr<Packet>> fragments;
+    uint64_t remaining = burstPayload;
+    for (uint16_t fragSeq = 0; fragSeq < frags; fragSeq++)
+    {
+        uint32_t size = std::min<uint64_t>(payload, remaining);
+        remaining -= size;
+        Ptr<Packet> fragment = Create<Packet>(size);
+        header.SetSeq(seq);
+        header.SetSize(burstPayload);
+        header.SetFrags(frags);
+        header.SetFragSeq(fragSeq);
+        header.SetFragBytes(size + header.GetSerializedSize());
+        fragment->AddHeader(header);
+        fragments.push_back(fragment);
+    }
+    return fragments;
+}
+
+BenchmarkResult
+BenchHeaderSerialize(uint64_t iterations)
+{
+    SeqTsSizeFragHeader header;
+    header.SetSeq(1234);
+    header.SetSize(BURST_SIZE);
+    header.SetFrags(84);
+    header.SetFragSeq(42);
+    header.SetFragBytes(FRAG_SIZE);
+    Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        header.SetFragSeq(i);
+        header.Serialize(buffer.Begin());
+    }
+    stopwatch.Stop();
+    return stopwatch.Result("HeaderSerialize", iterations);
+}
+
+BenchmarkResult
+BenchHeaderDeserialize(uint64_t iterations)
+{
+    SeqTsSizeFragHeader header;
+    header.SetSeq(1234);
+    header.SetSize(BURST_SIZE);
+    header.SetFrags(84);
+    header.SetFragBytes(FRAG_SIZE);
+    Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+    header.Serialize(buffer.Begin());
+
+    uint64_t checksum = 0;
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        SeqTsSizeFragHeader received;
+        received.Deserialize(buffer.Begin());
+        checksum += received.GetFragBytes();
+    }
+    stopwatch.Stop();
+    NS_ABORT_IF(checksum != iterations * FRAG_SIZE);
+    return stopwatch.Result("HeaderDeserialize", iterations);
+}
+
+/**
+ * Cost of describing the peer of a fragment for logging: the legacy
+ * per-fragment std::stringstream against a PeerDescriptor cached with the flow.
+ */
+BenchmarkResult
+BenchPeerAddress(uint64_t iterations, bool cached, const std::string& name)
+{
+    Address from = InetSocketAddress(Ipv4Address("10.0.0.2"), 49153);
+    PeerDescriptor peer(from, VrAppProfiler::CLIENT);
+
+    uint64_t checksum = 0;
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        if (cached)
+        {
+            checksum += peer.Get().size();
+        }
+        else
+        {
+            std::stringstream addressStr;
+            addressStr << InetSocketAddress::ConvertFrom(from).GetIpv4() << " port "
+                       << InetSocketAddress::ConvertFrom(from).GetPort();
+            checksum += addressStr.str().size();
+        }
+    }
+    stopwatch.Stop();
+    NS_ABORT_IF(checksum != iterations * peer.Get().size());
+    return stopwatch.Result(name, iterations);
+}
+
+BenchmarkResult
+BenchServerInstanceFragmentation(uint64_t iterations)
+{
+    Ptr<BenchSocket> socket = CreateObject<BenchSocket>();
+    BenchServerInstance instance(socket);
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        instance.SendFragmentedBurst(BURST_SIZE);
+    }
+    stopwatch.Stop();
+    NS_ABORT_IF(socket->GetTxBytes() != iterations * BURST_SIZE);
+    return stopwatch.Result("ServerInstanceSendFragmentedBurst", iterations);
+}
+
+BenchmarkResult
+BenchBurstyApplicationFragmentation(uint64_t iterations)
+{
+    Ptr<BenchSocket> socket = CreateObject<BenchSocket>();
+    Ptr<BenchBurstyApplication> app = CreateObject<BenchBurstyApplication>(socket);
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        app->SendFragmentedBurst(BURST_SIZE);
+    }
+    stopwatch.Stop();
+    NS_ABORT_IF(socket->GetTxBytes() != iterations * BURST_SIZE);
+    return stopwatch.Result("BurstyApplicationSendFragmentedBurst", iterations);
+}
+
+/// Fragment stream fed to the reassembly benchmarks
+enum class FragmentOrder
+{
+    IN_ORDER,     //!< fragments in order
+    OUT_OF_ORDER, //!< fragments shuffled within each burst
+    LOSSY         //!< fragments in order, 5% of them lost
+};
+
+BenchmarkResult
+BenchBurstSinkReassembly(uint64_t iterations, FragmentOrder order, const std::string& name)
+{
+    Ptr<BenchBurstSink> sink = CreateObject<BenchBurstSink>();
+    BenchBurstSink::BurstHandler handler;
+    Address from = InetSocketAddress(Ipv4Address("10.0.0.1"), 9);
+    Address local = InetSocketAddress(Ipv4Address("10.0.0.2"), 49153);
+    std::mt19937 rng(1);
+    std::bernoulli_distribution loss(0.05);
+
+    Stopwatch stopwatch;
+    uint64_t fragments = 0;
+    for (uint64_t seq = 0; fragments < iterations; seq++)
+    {
+        // FragmentReceived removes the header, thus use fresh fragments each burst
+        std::vector<Ptr<Packet>> burst = MakeFragments(seq);
+        if (order == FragmentOrder::OUT_OF_ORDER)
+        {
+            std::shuffle(burst.begin(), burst.end(), rng);
+        }
+        else if (order == FragmentOrder::LOSSY)
+        {
+            burst.erase(std::remove_if(burst.begin(),
+                                       burst.end(),
+                                       [&](const Ptr<Packet>&) { return loss(rng); }),
+                        burst.end());
+        }
+
+        stopwatch.Start();
+        for (const auto& fragment : burst)
+        {
+            sink->FragmentReceived(handler, fragment, from, local);
+        }
+        stopwatch.Stop();
+        fragments += burst.size();
+    }
+    return stopwatch.Result(name, fragments);
+}
+
+BenchmarkResult
+BenchClientTcpDeframing(uint64_t iterations)
+{
+    Ptr<BenchSocket> socket = CreateObject<BenchSocket>();
+    Ptr<BenchBurstyApplicationClient> client = CreateObject<BenchBurstyApplicationClient>();
+
+    Stopwatch stopwatch;
+    uint64_t fragments = 0;
+    for (uint64_t seq = 0; fragments < iterations; seq++)
+    {
+        // serialize the burst as a byte stream and split it into TCP segments
+        std::vector<Ptr<Packet>> burst = MakeFragments(seq);
+        Ptr<Packet> stream = Create<Packet>();
+        for (const auto& fragment : burst)
+        {
+            stream->AddAtEnd(fragment);
+        }
+        for (uint32_t start = 0; start < stream->GetSize(); start += TCP_SEGMENT)
+        {
+            uint32_t length = std::min(TCP_SEGMENT, stream->GetSize() - start);
+            socket->PushRx(stream->CreateFragment(start, length));
+        }
+
+        stopwatch.Start();
+        client->HandleRead(socket);
+        stopwatch.Stop();
+        fragments += burst.size();
+    }
+    NS_ABORT_IF(client->GetTotalRxFragments() != fragments);
+    return stopwatch.Result("ClientTcpDeframing", fragments);
+}
+
+BenchmarkResult
+BenchVrBurstGenerator(uint64_t iterations, bool setTargetDataRate, const std::string& name)
+{
+    Ptr<VrBurstGenerator> generator = CreateObject<VrBurstGenerator>();
+    generator->SetFrameRate(60);
+    generator->SetTargetDataRate(DataRate("50Mbps"));
+
+    uint64_t totBytes = 0;
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        if (setTargetDataRate)
+        {
+            // as done by BurstyApplicationServerInstance::AdaptRate before each frame
+            generator->SetTargetDataRate(DataRate(40000000 + (i % 2) * 10000000));
+        }
+        totBytes += generator->GenerateBurst().first;
+    }
+    stopwatch.Stop();
+    NS_ABORT_IF(totBytes == 0);
+    return stopwatch.Result(name, iterations);
+}
+
+BenchmarkResult
+BenchAlgorithm(uint64_t iterations, Ptr<AdaptationAlgorithmServer> algorithm, const std::string& name)
+{
+    // a standalone TCP socket, only used to read SndBufSize and GetTxAvailable
+    Ptr<TcpSocketBase> socket = CreateObject<TcpSocketBase>();
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint64_t> bytes(20000, 200000);
+    std::uniform_int_distribution<int64_t> txTimeUs(2000, 16000);
+
+    uint64_t totRate = 0;
+    Stopwatch stopwatch;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        uint64_t bytesAddedToSocket = bytes(rng);
+        Time txTime = MicroSeconds(txTimeUs(rng));
+        stopwatch.Start();
+        totRate += algorithm->nextBurstRate(socket, bytesAddedToSocket, txTime).GetBitRate();
+        stopwatch.Stop();
+    }
+    NS_ABORT_IF(totRate == 0);
+    return stopwatch.Result("Algorithm/" + name, iterations);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    double scale = 1;
+    std::string filter = "";
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scale", "Multiplier of the number of iterations of each benchmark", scale);
+    cmd.AddValue("filter", "Only run benchmarks whose name contains this string", filter);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    auto n = [scale](uint64_t iterations) {
+        return std::max<uint64_t>(1, iterations * scale);
+    };
+
+    std::vector<std::pair<std::string, std::function<BenchmarkResult()>>> benchmarks = {
+        {"HeaderSerialize", [&]() { return BenchHeaderSerialize(n(10000000)); }},
+        {"HeaderDeserialize", [&]() { return BenchHeaderDeserialize(n(10000000)); }},
+        {"PeerAddress/PerFragmentStringstream",
+         [&]() {
+             return BenchPeerAddress(n(1000000), false, "PeerAddress/PerFragmentStringstream");
+         }},
+        {"PeerAddress/PeerDescriptor",
+         [&]() { return BenchPeerAddress(n(10000000), true, "PeerAddress/PeerDescriptor"); }},
+        {"ServerInstanceSendFragmentedBurst",
+         [&]() { return BenchServerInstanceFragmentation(n(20000)); }},
+        {"BurstyApplicationSendFragmentedBurst",
+         [&]() { return BenchBurstyApplicationFragmentation(n(20000)); }},
+        {"BurstSinkReassemblyInOrder",
+         [&]() {
+             return BenchBurstSinkReassembly(n(1000000),
+                                             FragmentOrder::IN_ORDER,
+                                             "BurstSinkReassemblyInOrder");
+         }},
+        {"BurstSinkReassemblyOutOfOrder",
+         [&]() {
+             return BenchBurstSinkReassembly(n(1000000),
+                                             FragmentOrder::OUT_OF_ORDER,
+                                             "BurstSinkReassemblyOutOfOrder");
+         }},
+        {"BurstSinkReassemblyLossy",
+         [&]() {
+             return BenchBurstSinkReassembly(n(1000000),
+                                             FragmentOrder::LOSSY,
+                                             "BurstSinkReassemblyLossy");
+         }},
+        {"ClientTcpDeframing", [&]() { return BenchClientTcpDeframing(n(1000000)); }},
+        {"VrBurstGenerator",
+         [&]() { return BenchVrBurstGenerator(n(1000000), false, "VrBurstGenerator"); }},
+        {"VrBurstGeneratorWithRateChange",
+         [&]() {
+             return BenchVrBurstGenerator(n(100000), true, "VrBurstGeneratorWithRateChange");
+         }},
+        {"Algorithm/FuzzyAlgorithmServer",
+         [&]() {
+             return BenchAlgorithm(n(100000),
+                                   CreateObject<FuzzyAlgorithmServer>(),
+                                   "FuzzyAlgorithmServer");
+         }},
+        {"Algorithm/GoogleAlgorithmServer",
+         [&]() {
+             return BenchAlgorithm(n(100000),
+                                   CreateObject<GoogleAlgorithmServer>(),
+                                   "GoogleAlgorithmServer");
+         }},
+        {"Algorithm/BolaAlgo",
+         [&]() { return BenchAlgorithm(n(20000), CreateObject<BolaAlgo>(0, 0), "BolaAlgo"); }},
+        {"Algorithm/MPCAlgo",
+         [&]() { return BenchAlgorithm(n(2000), CreateObject<MPCAlgo>(0, 0), "MPCAlgo"); }},
+        {"Algorithm/FestiveAlgorithm",
+         [&]() {
+             return BenchAlgorithm(n(20000),
+                                   CreateObject<FestiveAlgorithm>(0, 0),
+                                   "FestiveAlgorithm");
+         }},
+    };
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_IF(!file.is_open(), "Can't open file " << output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+
+    os << "Benchmark,Iterations,NsPerOp,AllocsPerOp" << std::endl;
+    for (const auto& benchmark : benchmarks)
+    {
+        if (benchmark.first.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        BenchmarkResult result = benchmark.second();
+        os << result.name << "," << result.operations << "," << result.nsPerOp << ","
+           << result.allocsPerOp << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
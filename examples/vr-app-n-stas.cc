@@ -308,6 +308,9 @@ main (int argc, char *argv[])
 
   // Saturated UDP traffic from stations to AP
   ApplicationContainer clientApps = client.Install (wifiStaNodes);
+  // checked by scaling-benchmark.py
+  std::cout << "serverApp=" << serverApp.Get (0)->GetInstanceTypeId ().GetName ()
+            << " clientApp=" << clientApps.Get (0)->GetInstanceTypeId ().GetName () << std::endl;
   Ptr<UniformRandomVariable> x = CreateObjectWithAttributes<UniformRandomVariable> (
       "Min", DoubleValue (0), "Max", DoubleValue (1));
   Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
@@ -350,6 +353,7 @@ main (int argc, char *argv[])
   // Start simulation
   Simulator::Stop (Seconds (simulationTime + 1));
   Simulator::Run ();
+  std::cout << "eventCount=" << Simulator::GetEventCount () << std::endl;
 
   // burst info
   Ptr<OutputStreamWrapper> txBurstsBySta = ascii.CreateFileStream ("txBurstsBySta.csv");
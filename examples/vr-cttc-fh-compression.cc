@@ -51,6 +51,7 @@ $ ./ns3 run "cttc-fh-compression --PrintHelp"
  */
 
 #include "ns3/applications-module.h"
+#include "ns3/burst-trace-writer.h"
 #include "ns3/bursty-application-client-helper.h"
 #include "ns3/bursty-application-server-helper.h"
 #include "ns3/bursty-application-server-instance.h"
@@ -1043,6 +1044,7 @@ main(int argc, char* argv[])
     double frameRate = 60;                 // the app frame rate [FPS]
     std::string vrAppName = "VirusPopper"; // the app name
     std::string burstGeneratorType = "model";
+    bool binaryTraces = false; // write burst/fragment traces with BurstTraceWriter
 
     /*
      * From here, we instruct the ns3::CommandLine class of all the input parameters
@@ -1094,6 +1096,10 @@ main(int argc, char* argv[])
     cmd.AddValue("burstGeneratorType",
                  "type of burst generator {\"model\", \"adaptive\"}",
                  burstGeneratorType);
+    cmd.AddValue("binaryTraces",
+                 "Write burstTrace.bin/fragmentTrace.bin in the binary columnar format instead "
+                 "of the CSV traces (see examples/burst-trace-converter.py)",
+                 binaryTraces);
 
     // Parse the command line
     cmd.Parse(argc, argv);
@@ -1523,6 +1529,8 @@ main(int argc, char* argv[])
     Ptr<ThreeGppFtpM1Helper> ftpHelperSector3;
 
     AsciiTraceHelper ascii;
+    Ptr<BurstTraceWriter> burstTraceWriter;
+    Ptr<BurstTraceWriter> fragmentTraceWriter;
 
     if (ftpM1Enabled)
     {
@@ -1557,12 +1565,27 @@ main(int argc, char* argv[])
         clientApps.Start(MilliSeconds(ftpClientAppStartTimeMs));
 
         // Setup traces
-        Ptr<OutputStreamWrapper> burstTrace = ascii.CreateFileStream("burstTrace.csv");
-        *burstTrace->GetStream() << "SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,BurstSize"
-                                 << std::endl;
-        Ptr<OutputStreamWrapper> fragmentTrace = ascii.CreateFileStream("fragmentTrace.csv");
-        *fragmentTrace->GetStream()
-            << "SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,FragSeq,TotFrags,FragSize" << std::endl;
+        Ptr<OutputStreamWrapper> burstTrace;
+        Ptr<OutputStreamWrapper> fragmentTrace;
+        if (binaryTraces)
+        {
+            burstTraceWriter = CreateObject<BurstTraceWriter>();
+            burstTraceWriter->SetAttribute("KeyByDestination", BooleanValue(true));
+            burstTraceWriter->Open("burstTrace.bin", BurstTraceWriter::BURST_RECORDS);
+            fragmentTraceWriter = CreateObject<BurstTraceWriter>();
+            fragmentTraceWriter->SetAttribute("KeyByDestination", BooleanValue(true));
+            fragmentTraceWriter->Open("fragmentTrace.bin", BurstTraceWriter::FRAGMENT_RECORDS);
+        }
+        else
+        {
+            burstTrace = ascii.CreateFileStream("burstTrace.csv");
+            *burstTrace->GetStream() << "SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,BurstSize"
+                                     << std::endl;
+            fragmentTrace = ascii.CreateFileStream("fragmentTrace.csv");
+            *fragmentTrace->GetStream()
+                << "SrcAddress,TxTime_ns,RxTime_ns,BurstSeq,FragSeq,TotFrags,FragSize"
+                << std::endl;
+        }
 
         for (uint32_t i = 0; i < clientApps.GetN(); i++)
         {
@@ -1573,9 +1596,22 @@ main(int argc, char* argv[])
             // app->SetStartTime (startTime);
             app->SetAttribute("Local", AddressValue(InetSocketAddress(clientIps.GetAddress(i), 0)));
 
-            app->TraceConnectWithoutContext("BurstRx", MakeBoundCallback(&BurstRx, burstTrace));
-            app->TraceConnectWithoutContext("FragmentRx",
-                                            MakeBoundCallback(&FragmentRx, fragmentTrace));
+            if (binaryTraces)
+            {
+                app->TraceConnectWithoutContext(
+                    "BurstRx",
+                    MakeCallback(&BurstTraceWriter::BurstRx, burstTraceWriter));
+                app->TraceConnectWithoutContext(
+                    "FragmentRx",
+                    MakeCallback(&BurstTraceWriter::FragmentRx, fragmentTraceWriter));
+            }
+            else
+            {
+                app->TraceConnectWithoutContext("BurstRx",
+                                                MakeBoundCallback(&BurstRx, burstTrace));
+                app->TraceConnectWithoutContext("FragmentRx",
+                                                MakeBoundCallback(&FragmentRx, fragmentTrace));
+            }
             // app->SetStartTime(udpAppStartTime + Seconds(i * 0.2));
         }
 
@@ -1797,6 +1833,12 @@ main(int argc, char* argv[])
     Simulator::Stop(Seconds(simulationTime + 5));
     Simulator::Run();
 
+    if (binaryTraces)
+    {
+        burstTraceWriter->Close();
+        fragmentTraceWriter->Close();
+    }
+
     Ptr<OutputStreamWrapper> txBurstsBySta = ascii.CreateFileStream("txBurstsBySta.csv");
     Ptr<OutputStreamWrapper> rxBursts = ascii.CreateFileStream("rxBursts.csv");
 
@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file vr-frame-size-validation.cc
+ * \brief Validation of the VrBurstGenerator against the bundled traces
+ *
+ * The frames of a trace of BurstGeneratorTraces, or of any trace in the same
+ * format (traceFile), are compared to as many
+ * frames generated by a VrBurstGenerator with the same application, frame
+ * rate and target data rate, with i.i.d. and with correlated (Correlated=true)
+ * frame sizes and inter-frame intervals. For each source, a CSV row is written:
+ *
+ *   source,frames,avgRateMbps,acfSize1..acfSizeN,acfIfi1..acfIfiN,avgDelayMs,p99DelayMs
+ *
+ * with the autocorrelation of the frame sizes and of the inter-frame
+ * intervals at lags 1 to N (maxLag), and the queueing delay of the frames
+ * through a FIFO link serving capacityFactor times the target data rate,
+ * computed with the Lindley recursion. The queueing delay is the metric
+ * most sensitive to the correlation of the frame sizes: bursts of large
+ * frames build up a queue that i.i.d. frames of the same marginal do not.
+ *
+ * At frame rates without bundled traces (e.g., 72, 90 or 120 FPS), the
+ * generators use coefficients interpolated from the 30 and 60 FPS fits, or
+ * those of coefficientFile (see VrBurstGenerator::SetCoefficientFile), so
+ * that a trace captured on such a headset validates either of them.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "vr-frame-size-validation --vrAppName=Minecraft --appRate=30Mbps --frameRate=60"
+$ ./ns3 run "vr-frame-size-validation --vrAppName=Minecraft --appRate=30Mbps --frameRate=90
+    --traceFile=mc_30mbps_90fps.csv"
+    \endcode
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/trace-file-burst-generator.h"
+#include "ns3/vr-burst-generator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VrFrameSizeValidation");
+
+namespace
+{
+
+/**
+ * \brief Autocorrelation of a series
+ * \param x the series
+ * \param lag the lag, in samples
+ * \return the sample autocorrelation of x at lag
+ */
+double
+Autocorrelation(const std::vector<double>& x, std::size_t lag)
+{
+    if (x.size() <= lag)
+    {
+        return 0;
+    }
+    double mean = 0;
+    for (double v : x)
+    {
+        mean += v;
+    }
+    mean /= x.size();
+
+    double var = 0;
+    for (double v : x)
+    {
+        var += (v - mean) * (v - mean);
+    }
+    if (var == 0)
+    {
+        return 0;
+    }
+
+    double cov = 0;
+    for (std::size_t i = 0; i + lag < x.size(); ++i)
+    {
+        cov += (x[i] - mean) * (x[i + lag] - mean);
+    }
+    return cov / var;
+}
+
+/**
+ * \brief Write the statistics of a sequence of frames as a CSV row
+ * \param os the output stream
+ * \param source the name of the source of the frames
+ * \param frames the frames, as (size [B], time to the next frame) pairs
+ * \param maxLag the largest lag of the autocorrelations
+ * \param capacity the rate of the link serving the frames
+ */
+void
+WriteStats(std::ostream& os,
+           const std::string& source,
+           const std::vector<std::pair<uint32_t, Time>>& frames,
+           std::size_t maxLag,
+           DataRate capacity)
+{
+    std::vector<double> sizes;
+    std::vector<double> ifis;
+    sizes.reserve(frames.size());
+    ifis.reserve(frames.size());
+    double bytes = 0;
+    double duration = 0;
+    for (const auto& frame : frames)
+    {
+        sizes.push_back(frame.first);
+        ifis.push_back(frame.second.GetSeconds());
+        bytes += frame.first;
+        duration += frame.second.GetSeconds();
+    }
+
+    // Lindley recursion: the waiting time of a frame is the one of the
+    // previous frame, plus its transmission time, minus the time in between
+    std::vector<double> delays;
+    delays.reserve(frames.size());
+    double wait = 0;
+    for (const auto& frame : frames)
+    {
+        double txTime = capacity.CalculateBytesTxTime(frame.first).GetSeconds();
+        delays.push_back(wait + txTime);
+        wait = std::max(0.0, wait + txTime - frame.second.GetSeconds());
+    }
+    double avgDelay = 0;
+    for (double d : delays)
+    {
+        avgDelay += d;
+    }
+    avgDelay /= std::max<std::size_t>(delays.size(), 1);
+    double p99Delay = 0;
+    if (!delays.empty())
+    {
+        auto p99 = delays.begin() + delays.size() * 99 / 100;
+        std::nth_element(delays.begin(), p99, delays.end());
+        p99Delay = *p99;
+    }
+
+    os << source << "," << frames.size() << "," << (duration > 0 ? bytes * 8 / duration / 1e6 : 0);
+    for (std::size_t lag = 1; lag <= maxLag; ++lag)
+    {
+        os << "," << Autocorrelation(sizes, lag);
+    }
+    for (std::size_t lag = 1; lag <= maxLag; ++lag)
+    {
+        os << "," << Autocorrelation(ifis, lag);
+    }
+    os << "," << avgDelay * 1e3 << "," << p99Delay * 1e3 << std::endl;
+}
+
+/**
+ * \brief Generate frames with a burst generator
+ * \param generator the generator
+ * \param n the maximum number of frames
+ * \return the frames, as (size [B], time to the next frame) pairs
+ */
+std::vector<std::pair<uint32_t, Time>>
+Generate(Ptr<BurstGenerator> generator, std::size_t n)
+{
+    std::vector<std::pair<uint32_t, Time>> frames;
+    frames.reserve(n);
+    while (frames.size() < n && generator->HasNextBurst())
+    {
+        frames.push_back(generator->GenerateBurst());
+    }
+    return frames;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string vrAppName = "VirusPopper";
+    std::string appRate = "30Mbps";
+    double frameRate = 60;
+    std::string traceFolder = "contrib/vr-app/model/BurstGeneratorTraces/";
+    std::string traceFile = "";
+    std::string coefficientFile = "";
+    uint32_t maxLag = 10;
+    double capacityFactor = 1.2;
+    uint32_t seed = 1;
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("vrAppName",
+                 "VR application {VirusPopper, Minecraft, GoogleEarthVrCities, "
+                 "GoogleEarthVrTour}",
+                 vrAppName);
+    cmd.AddValue("appRate", "Target data rate, one of the traces (10 to 50 Mbps)", appRate);
+    cmd.AddValue("frameRate",
+                 "Frame rate of the application [FPS], bundled traces only at 30 and 60",
+                 frameRate);
+    cmd.AddValue("traceFolder",
+                 "Folder of the VR traces, relative to the working directory",
+                 traceFolder);
+    cmd.AddValue("traceFile",
+                 "Trace to compare to, instead of the bundled trace of the application, "
+                 "data rate and frame rate",
+                 traceFile);
+    cmd.AddValue("coefficientFile",
+                 "CSV file with more fitted model coefficients, empty for the bundled ones",
+                 coefficientFile);
+    cmd.AddValue("maxLag", "Largest lag of the autocorrelations [frames]", maxLag);
+    cmd.AddValue("capacityFactor",
+                 "Ratio between the capacity of the link and the target data rate",
+                 capacityFactor);
+    cmd.AddValue("seed", "Seed of the generators", seed);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    RngSeedManager::SetSeed(seed);
+
+    std::string appAbbrev;
+    if (vrAppName == "VirusPopper")
+    {
+        appAbbrev = "vp";
+    }
+    else if (vrAppName == "Minecraft")
+    {
+        appAbbrev = "mc";
+    }
+    else if (vrAppName == "GoogleEarthVrCities")
+    {
+        appAbbrev = "ge_cities";
+    }
+    else if (vrAppName == "GoogleEarthVrTour")
+    {
+        appAbbrev = "ge_tour";
+    }
+    else
+    {
+        NS_ABORT_MSG("vrAppName=" << vrAppName << " was not recognized");
+    }
+
+    if (traceFile.empty())
+    {
+        std::ostringstream filenameSs;
+        filenameSs << traceFolder << appAbbrev << "_"
+                   << uint32_t(DataRate(appRate).GetBitRate() / 1e6) << "mbps_"
+                   << uint32_t(frameRate) << "fps.csv";
+        traceFile = filenameSs.str();
+    }
+    Ptr<TraceFileBurstGenerator> traceGenerator =
+        CreateObjectWithAttributes<TraceFileBurstGenerator>("TraceFile", StringValue(traceFile));
+    std::vector<std::pair<uint32_t, Time>> traceFrames =
+        Generate(traceGenerator, std::numeric_limits<std::size_t>::max());
+    NS_ABORT_MSG_IF(traceFrames.empty(), "No frame in " << traceFile);
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "source,frames,avgRateMbps";
+    for (uint32_t lag = 1; lag <= maxLag; ++lag)
+    {
+        os << ",acfSize" << lag;
+    }
+    for (uint32_t lag = 1; lag <= maxLag; ++lag)
+    {
+        os << ",acfIfi" << lag;
+    }
+    os << ",avgDelayMs,p99DelayMs" << std::endl;
+
+    DataRate capacity(uint64_t(DataRate(appRate).GetBitRate() * capacityFactor));
+    WriteStats(os, "trace", traceFrames, maxLag, capacity);
+
+    for (bool correlated : {false, true})
+    {
+        Ptr<VrBurstGenerator> generator =
+            CreateObjectWithAttributes<VrBurstGenerator>("FrameRate",
+                                                         DoubleValue(frameRate),
+                                                         "TargetDataRate",
+                                                         DataRateValue(DataRate(appRate)),
+                                                         "VrAppName",
+                                                         StringValue(vrAppName),
+                                                         "Correlated",
+                                                         BooleanValue(correlated),
+                                                         "CoefficientFile",
+                                                         StringValue(coefficientFile));
+        generator->AssignStreams(0);
+        WriteStats(os,
+                   correlated ? "correlated" : "iid",
+                   Generate(generator, traceFrames.size()),
+                   maxLag,
+                   capacity);
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
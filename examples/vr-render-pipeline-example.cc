@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file vr-render-pipeline-example.cc
+ * \brief Latency budget of cloud VR frames, from rendering to reception
+ *
+ * A BurstyApplicationServer renders and encodes the frames of nUsers
+ * BurstyApplicationClient, with up to pipelineDepth frames in flight, and
+ * streams them over a point-to-point link. A BurstLatencyCollector joins the
+ * timestamps of the server and of the clients, and the average of each stage
+ * over all the video frames is written as CSV:
+ *
+ *   PipelineDepth,Frames,FrameRate_fps,Render_ms,Encode_ms,Pipeline_ms,
+ *   Queueing_ms,Transit_ms,Reassembly_ms,EndToEnd_ms
+ *
+ * where Pipeline_ms includes the waits for the renderer and the encoder. With
+ * the defaults, a frame takes longer than a frame interval to be rendered and
+ * encoded: with pipelineDepth=1 the frames pile up until maxQueuedFrames
+ * wait for the renderer, and the following ones are dropped, while with 2
+ * the render of a frame overlaps the encoding of the previous one.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "vr-render-pipeline-example --pipelineDepth=1"
+$ ./ns3 run "vr-render-pipeline-example --pipelineDepth=2"
+    \endcode
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/burst-latency-breakdown.h"
+#include "ns3/bursty-application-client-helper.h"
+#include "ns3/bursty-application-server-helper.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VrRenderPipelineExample");
+
+/// Running sums of the stages of the joined frames [ns]
+struct LatencyBudget
+{
+    uint64_t frames{0};    //!< joined video frames
+    int64_t render{0};     //!< render times
+    int64_t encode{0};     //!< encode times
+    int64_t pipeline{0};   //!< generation to enqueue
+    int64_t queueing{0};   //!< application queueing
+    int64_t transit{0};    //!< socket buffer and network
+    int64_t reassembly{0}; //!< first to last fragment received
+    int64_t endToEnd{0};   //!< generation to reception
+};
+
+void
+FrameJoined(LatencyBudget* budget, const Address& flow, const BurstLatencyBreakdown& breakdown)
+{
+    if (breakdown.stream != SeqTsSizeFragHeader::VIDEO_STREAM)
+    {
+        return;
+    }
+    budget->frames++;
+    budget->render += breakdown.GetRender().GetNanoSeconds();
+    budget->encode += breakdown.GetEncode().GetNanoSeconds();
+    budget->pipeline += breakdown.GetPipeline().GetNanoSeconds();
+    budget->queueing += breakdown.GetApplicationQueueing().GetNanoSeconds();
+    budget->transit += breakdown.GetTransit().GetNanoSeconds();
+    budget->reassembly += breakdown.GetReassembly().GetNanoSeconds();
+    budget->endToEnd += (breakdown.completed - breakdown.generated).GetNanoSeconds();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nUsers = 2;
+    double simTime = 10;
+    double frameRate = 90;
+    std::string targetDataRate = "30Mbps";
+    std::string vrAppName = "VirusPopper";
+    double renderTime = 8;
+    std::string encoderThroughput = "50Mbps";
+    uint32_t pipelineDepth = 2;
+    uint32_t maxQueuedFrames = 4;
+    std::string protocol = "ns3::UdpSocketFactory";
+    std::string linkRate = "200Mbps";
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nUsers", "Number of users", nUsers);
+    cmd.AddValue("simTime", "Length of simulation [s]", simTime);
+    cmd.AddValue("frameRate", "VR application frame rate [FPS]", frameRate);
+    cmd.AddValue("targetDataRate", "Target data rate of the video of each user", targetDataRate);
+    cmd.AddValue("vrAppName", "The VR application on which the model is based upon", vrAppName);
+    cmd.AddValue("renderTime", "Render time of a frame [ms]", renderTime);
+    cmd.AddValue("encoderThroughput",
+                 "Bits produced by the encoder per second of encode time",
+                 encoderThroughput);
+    cmd.AddValue("pipelineDepth",
+                 "Largest number of frames being rendered or encoded",
+                 pipelineDepth);
+    cmd.AddValue("maxQueuedFrames",
+                 "Largest number of frames waiting for the renderer, 0 for no limit",
+                 maxQueuedFrames);
+    cmd.AddValue("protocol", "ns3::UdpSocketFactory or ns3::TcpSocketFactory", protocol);
+    cmd.AddValue("linkRate", "Data rate of the shared link", linkRate);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::VrBurstGenerator::FrameRate", DoubleValue(frameRate));
+    Config::SetDefault("ns3::VrBurstGenerator::TargetDataRate",
+                       DataRateValue(DataRate(targetDataRate)));
+    Config::SetDefault("ns3::VrBurstGenerator::VrAppName", StringValue(vrAppName));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue(linkRate));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("2ms"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    uint16_t port = 50000;
+    BurstyApplicationServerHelper serverHelper(protocol,
+                                               InetSocketAddress(Ipv4Address::GetAny(), port));
+    serverHelper.SetAttribute("appDuration", TimeValue(Seconds(simTime)));
+    serverHelper.SetAttribute("EnableRenderPipeline", BooleanValue(true));
+    serverHelper.SetAttribute(
+        "RenderTime",
+        StringValue("ns3::ConstantRandomVariable[Constant=" + std::to_string(renderTime / 1e3) +
+                    "]"));
+    serverHelper.SetAttribute("EncoderThroughput", DataRateValue(DataRate(encoderThroughput)));
+    serverHelper.SetAttribute("PipelineDepth", UintegerValue(pipelineDepth));
+    serverHelper.SetAttribute("MaxQueuedFrames", UintegerValue(maxQueuedFrames));
+    ApplicationContainer serverApps = serverHelper.Install(nodes.Get(1));
+
+    LatencyBudget budget;
+    Ptr<BurstLatencyCollector> collector = CreateObject<BurstLatencyCollector>();
+    collector->TraceConnectWithoutContext("Breakdown", MakeBoundCallback(&FrameJoined, &budget));
+    serverApps.Get(0)->TraceConnectWithoutContext(
+        "BurstLatencyBreakdown",
+        MakeCallback(&BurstLatencyCollector::SenderBreakdown, collector));
+
+    BurstyApplicationClientHelper clientHelper(protocol,
+                                               InetSocketAddress(interfaces.GetAddress(1), port));
+    for (uint32_t user = 0; user < nUsers; ++user)
+    {
+        ApplicationContainer clientApps = clientHelper.Install(nodes.Get(0));
+        clientApps.Start(MilliSeconds(100 + user));
+        clientApps.Stop(Seconds(simTime + 1));
+        clientApps.Get(0)->TraceConnectWithoutContext(
+            "BurstLatencyBreakdown",
+            MakeCallback(&BurstLatencyCollector::ReceiverBreakdown, collector));
+    }
+
+    Simulator::Stop(Seconds(simTime + 2));
+    Simulator::Run();
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "PipelineDepth,Frames,FrameRate_fps,Render_ms,Encode_ms,Pipeline_ms,Queueing_ms,"
+          "Transit_ms,Reassembly_ms,EndToEnd_ms"
+       << std::endl;
+    double n = std::max<uint64_t>(budget.frames, 1) * 1e6;
+    os << pipelineDepth << "," << budget.frames << "," << budget.frames / simTime / nUsers << ","
+       << budget.render / n << "," << budget.encode / n << "," << budget.pipeline / n << ","
+       << budget.queueing / n << "," << budget.transit / n << "," << budget.reassembly / n << ","
+       << budget.endToEnd / n << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file vr-session-example.cc
+ * \brief Multiplexed VR sessions: video, audio, haptics and uplink poses
+ *
+ * A BurstyApplicationServer streams to nUsers BurstyApplicationClient over a
+ * point-to-point link a session made of the VR video and of two sub-streams,
+ * audio frames and haptic feedback, served before the video. Each client
+ * sends its poses to the server at poseRate, and the server tags the video
+ * frames with the last pose received, for a motion-to-photon estimate.
+ * A SessionLatencyMonitor writes the latency of each stream as CSV:
+ *
+ *   Stream,Bursts,MeanLatency_ms,MaxLatency_ms,MotionToPhotonBursts,
+ *   MeanMotionToPhoton_ms,MaxMotionToPhoton_ms
+ *
+ * where stream 0 is the video, 1 the audio, 2 the haptics and 3 the poses.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "vr-session-example --nUsers=4 --poseRate=500 --linkRate=200Mbps"
+    \endcode
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/bursty-application-client-helper.h"
+#include "ns3/bursty-application-server-helper.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/session-latency-monitor.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VrSessionExample");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nUsers = 4;
+    double simTime = 10;
+    double frameRate = 60;
+    std::string targetDataRate = "30Mbps";
+    std::string vrAppName = "VirusPopper";
+    double poseRate = 500;
+    uint32_t poseSize = 64;
+    uint32_t audioSize = 200;
+    double audioInterval = 20;
+    uint32_t hapticSize = 64;
+    double hapticInterval = 4;
+    uint32_t videoPriority = 1;
+    std::string protocol = "ns3::UdpSocketFactory";
+    std::string linkRate = "200Mbps";
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nUsers", "Number of users", nUsers);
+    cmd.AddValue("simTime", "Length of simulation [s]", simTime);
+    cmd.AddValue("frameRate", "VR application frame rate [FPS]", frameRate);
+    cmd.AddValue("targetDataRate", "Target data rate of the video of each user", targetDataRate);
+    cmd.AddValue("vrAppName", "The VR application on which the model is based upon", vrAppName);
+    cmd.AddValue("poseRate", "Poses sent by each user per second, 0 for none", poseRate);
+    cmd.AddValue("poseSize", "Size of a pose message [B]", poseSize);
+    cmd.AddValue("audioSize", "Size of an audio frame [B]", audioSize);
+    cmd.AddValue("audioInterval", "Time between two audio frames [ms]", audioInterval);
+    cmd.AddValue("hapticSize", "Size of a haptic message [B]", hapticSize);
+    cmd.AddValue("hapticInterval", "Time between two haptic messages [ms]", hapticInterval);
+    cmd.AddValue("videoPriority",
+                 "Priority of the video, 0 being the highest; audio and haptics have priority 0",
+                 videoPriority);
+    cmd.AddValue("protocol", "ns3::UdpSocketFactory or ns3::TcpSocketFactory", protocol);
+    cmd.AddValue("linkRate", "Data rate of the shared link", linkRate);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::VrBurstGenerator::FrameRate", DoubleValue(frameRate));
+    Config::SetDefault("ns3::VrBurstGenerator::TargetDataRate",
+                       DataRateValue(DataRate(targetDataRate)));
+    Config::SetDefault("ns3::VrBurstGenerator::VrAppName", StringValue(vrAppName));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue(linkRate));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("2ms"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    uint16_t port = 50000;
+    BurstyApplicationServerHelper serverHelper(protocol,
+                                               InetSocketAddress(Ipv4Address::GetAny(), port));
+    serverHelper.SetAttribute("appDuration", TimeValue(Seconds(simTime)));
+    serverHelper.SetAttribute("VideoPriority", UintegerValue(videoPriority));
+    ApplicationContainer serverApps = serverHelper.Install(nodes.Get(1));
+    Ptr<BurstyApplicationServer> server = DynamicCast<BurstyApplicationServer>(serverApps.Get(0));
+
+    ObjectFactory audio("ns3::SimpleBurstGenerator");
+    audio.Set("BurstSizeRv",
+              StringValue("ns3::ConstantRandomVariable[Constant=" + std::to_string(audioSize) +
+                          "]"));
+    audio.Set("PeriodRv",
+              StringValue("ns3::ConstantRandomVariable[Constant=" +
+                          std::to_string(audioInterval / 1e3) + "]"));
+    server->AddStream(SeqTsSizeFragHeader::AUDIO_STREAM, audio, 0);
+
+    ObjectFactory haptic("ns3::SimpleBurstGenerator");
+    haptic.Set("BurstSizeRv",
+               StringValue("ns3::ConstantRandomVariable[Constant=" + std::to_string(hapticSize) +
+                           "]"));
+    haptic.Set("PeriodRv",
+               StringValue("ns3::ConstantRandomVariable[Constant=" +
+                           std::to_string(hapticInterval / 1e3) + "]"));
+    server->AddStream(SeqTsSizeFragHeader::HAPTIC_STREAM, haptic, 0);
+
+    Ptr<SessionLatencyMonitor> monitor = CreateObject<SessionLatencyMonitor>();
+    server->TraceConnectWithoutContext("UplinkRx",
+                                       MakeCallback(&SessionLatencyMonitor::UplinkRx, monitor));
+
+    BurstyApplicationClientHelper clientHelper(protocol,
+                                               InetSocketAddress(interfaces.GetAddress(1), port));
+    clientHelper.SetAttribute("PoseRate", DoubleValue(poseRate));
+    clientHelper.SetAttribute("PoseSize", UintegerValue(poseSize));
+    for (uint32_t user = 0; user < nUsers; ++user)
+    {
+        ApplicationContainer clientApps = clientHelper.Install(nodes.Get(0));
+        clientApps.Start(MilliSeconds(100 + user));
+        clientApps.Stop(Seconds(simTime + 1));
+        clientApps.Get(0)->TraceConnectWithoutContext(
+            "BurstLatencyBreakdown",
+            MakeCallback(&SessionLatencyMonitor::Breakdown, monitor));
+    }
+
+    Simulator::Stop(Seconds(simTime + 2));
+    Simulator::Run();
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    monitor->WriteSummary(output.empty() ? std::cout : file);
+
+    Simulator::Destroy();
+    return 0;
+}
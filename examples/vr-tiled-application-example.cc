@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file vr-tiled-application-example.cc
+ * \brief Viewport-adaptive streaming of tiled 360 degrees VR frames
+ *
+ * nUsers BurstyApplication, each with a TiledVrBurstGenerator driven by the
+ * HeadMotionModel of its user, stream over a shared point-to-point link to
+ * as many BurstSink. A TileQualityMonitor per user computes the viewport
+ * quality and the missing tile rate, written as CSV, one row per user:
+ *
+ *   user,frames,viewportQuality,missingTileRate,viewportTiles,missingTiles,lateTiles
+ *
+ * \code{.unparsed}
+$ ./ns3 run "vr-tiled-application-example --nUsers=50 --rows=8 --columns=12 --frameRate=90"
+    \endcode
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/burst-sink-helper.h"
+#include "ns3/bursty-helper.h"
+#include "ns3/core-module.h"
+#include "ns3/head-motion-model.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/tile-quality-monitor.h"
+#include "ns3/tiled-vr-burst-generator.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VrTiledApplicationExample");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nUsers = 4;
+    double simTime = 10;
+    double frameRate = 90;
+    std::string targetDataRate = "40Mbps";
+    std::string vrAppName = "VirusPopper";
+    uint32_t rows = 8;
+    uint32_t columns = 12;
+    double predictionHorizon = 50;
+    std::string linkRate = "1Gbps";
+    std::string output = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nUsers", "Number of users", nUsers);
+    cmd.AddValue("simTime", "Length of simulation [s]", simTime);
+    cmd.AddValue("frameRate", "VR application frame rate [FPS]", frameRate);
+    cmd.AddValue("targetDataRate", "Target data rate of each user", targetDataRate);
+    cmd.AddValue("vrAppName", "The VR application on which the model is based upon", vrAppName);
+    cmd.AddValue("rows", "Rows of tiles", rows);
+    cmd.AddValue("columns", "Columns of tiles", columns);
+    cmd.AddValue("predictionHorizon",
+                 "How far ahead the viewport is predicted, and display delay [ms]",
+                 predictionHorizon);
+    cmd.AddValue("linkRate", "Data rate of the shared link", linkRate);
+    cmd.AddValue("output", "CSV output file, standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::TiledVrBurstGenerator::Rows", UintegerValue(rows));
+    Config::SetDefault("ns3::TiledVrBurstGenerator::Columns", UintegerValue(columns));
+    Config::SetDefault("ns3::TiledVrBurstGenerator::PredictionHorizon",
+                       TimeValue(MilliSeconds(predictionHorizon)));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue(linkRate));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("2ms"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    std::vector<Ptr<TileQualityMonitor>> monitors;
+    for (uint32_t user = 0; user < nUsers; ++user)
+    {
+        uint16_t portNumber = 50000 + user;
+
+        BurstyHelper burstyHelper("ns3::UdpSocketFactory",
+                                  InetSocketAddress(interfaces.GetAddress(0), portNumber));
+        burstyHelper.SetAttribute("FragmentSize", UintegerValue(1200));
+        burstyHelper.SetBurstGenerator("ns3::TiledVrBurstGenerator",
+                                       "FrameRate",
+                                       DoubleValue(frameRate),
+                                       "TargetDataRate",
+                                       DataRateValue(DataRate(targetDataRate)),
+                                       "VrAppName",
+                                       StringValue(vrAppName));
+        ApplicationContainer serverApps = burstyHelper.Install(nodes.Get(1));
+        Ptr<BurstyApplication> burstyApp = serverApps.Get(0)->GetObject<BurstyApplication>();
+
+        BurstSinkHelper burstSinkHelper("ns3::UdpSocketFactory",
+                                        InetSocketAddress(Ipv4Address::GetAny(), portNumber));
+        ApplicationContainer clientApps = burstSinkHelper.Install(nodes.Get(0));
+        Ptr<BurstSink> burstSink = clientApps.Get(0)->GetObject<BurstSink>();
+
+        Ptr<TiledVrBurstGenerator> generator =
+            DynamicCast<TiledVrBurstGenerator>(burstyApp->GetBurstGenerator());
+        Ptr<HeadMotionModel> headMotion = CreateObject<HeadMotionModel>();
+        generator->SetHeadMotionModel(headMotion);
+
+        Ptr<TileQualityMonitor> monitor = CreateObject<TileQualityMonitor>();
+        monitor->SetGenerator(generator);
+        burstyApp->TraceConnectWithoutContext(
+            "BurstTx",
+            MakeCallback(&TileQualityMonitor::BurstTx, monitor));
+        burstSink->TraceConnectWithoutContext(
+            "BurstRx",
+            MakeCallback(&TileQualityMonitor::BurstRx, monitor));
+        headMotion->TraceConnectWithoutContext("Pose",
+                                               MakeCallback(&TileQualityMonitor::Pose, monitor));
+        monitors.push_back(monitor);
+
+        serverApps.Stop(Seconds(simTime));
+    }
+
+    Simulator::Run();
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "user,frames,viewportQuality,missingTileRate,viewportTiles,missingTiles,lateTiles"
+       << std::endl;
+    for (uint32_t user = 0; user < monitors.size(); ++user)
+    {
+        TileQualityMonitor::Summary summary = monitors[user]->GetSummary();
+        os << user << "," << summary.frames << "," << summary.viewportQuality << ","
+           << summary.missingTileRate << "," << summary.viewportTiles << ","
+           << summary.missingTiles << "," << summary.lateTiles << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "abr-replay-engine.h"
+
+#include "ns3/abort.h"
+#include "ns3/csv-reader.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AbrReplayEngine");
+
+NS_OBJECT_ENSURE_REGISTERED(AbrReplayEngine);
+
+TypeId
+AbrReplayEngine::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AbrReplayEngine")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<AbrReplayEngine>()
+            .AddAttribute("Algorithm",
+                          "The adaptation algorithm replayed",
+                          PointerValue(0),
+                          MakePointerAccessor(&AbrReplayEngine::m_algorithm),
+                          MakePointerChecker<AdaptationAlgorithmServer>())
+            .AddAttribute("TimeColumn",
+                          "The column of the time in the trace file",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&AbrReplayEngine::m_timeColumn),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ThroughputColumn",
+                          "The column of the throughput in the trace file",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&AbrReplayEngine::m_throughputColumn),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TimeScale",
+                          "The seconds per unit of the time column, e.g., 1e-9 for the "
+                          "Time_ns column of rateDecisions.csv",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&AbrReplayEngine::m_timeScale),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("ThroughputScale",
+                          "The bit/s per unit of the throughput column",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&AbrReplayEngine::m_throughputScale),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("TraceFile",
+                          "A CSV file with the throughput trace, see Load",
+                          StringValue(""),
+                          MakeStringAccessor(&AbrReplayEngine::Load),
+                          MakeStringChecker())
+            .AddAttribute("FrameRate",
+                          "The frames per second",
+                          DoubleValue(60),
+                          MakeDoubleAccessor(&AbrReplayEngine::m_frameRate),
+                          MakeDoubleChecker<double>(1))
+            .AddAttribute("InitialRate",
+                          "The target data rate of the generator, which caps the rate chosen by "
+                          "the algorithm as in BurstyApplicationServerInstance",
+                          DataRateValue(DataRate("20Mbps")),
+                          MakeDataRateAccessor(&AbrReplayEngine::m_initialRate),
+                          MakeDataRateChecker())
+            .AddAttribute("Deadline",
+                          "The delay beyond which a frame is considered lost, zero to receive "
+                          "every frame delivered before the end of the replay",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&AbrReplayEngine::m_deadline),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("Duration",
+                          "The duration of the replay, zero to stop at the last sample of the "
+                          "trace; longer replays loop over the trace",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&AbrReplayEngine::m_duration),
+                          MakeTimeChecker(Seconds(0)))
+            .AddTraceSource("RateDecision",
+                            "The rate of a frame has been chosen",
+                            MakeTraceSourceAccessor(&AbrReplayEngine::m_rateDecisionTrace),
+                            "ns3::RateDecision::TracedCallback")
+            .AddTraceSource("FrameDelivered",
+                            "The last byte of a frame has left the send buffer",
+                            MakeTraceSourceAccessor(&AbrReplayEngine::m_frameDeliveredTrace),
+                            "ns3::AbrReplayEngine::FrameDeliveredTracedCallback");
+    return tid;
+}
+
+AbrReplayEngine::AbrReplayEngine()
+    : m_traceIndex(0),
+      m_enqueued(0),
+      m_drained(0),
+      m_bytesAdded(0),
+      m_frames(0),
+      m_onTimeFrames(0),
+      m_rateSwitches(0),
+      m_rateSum(0),
+      m_rxBytes(0),
+      m_delaySumMs(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AbrReplayEngine::~AbrReplayEngine()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+AbrReplayEngine::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_stepEvent.Cancel();
+    m_algorithm = 0;
+    m_pending.clear();
+    Object::DoDispose();
+}
+
+void
+AbrReplayEngine::SetAlgorithm(Ptr<AdaptationAlgorithmServer> algorithm)
+{
+    NS_LOG_FUNCTION(this << algorithm);
+    m_algorithm = algorithm;
+}
+
+Ptr<AdaptationAlgorithmServer>
+AbrReplayEngine::GetAlgorithm() const
+{
+    return m_algorithm;
+}
+
+void
+AbrReplayEngine::Load(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (filename.empty())
+    {
+        return;
+    }
+
+    CsvReader csv(filename);
+    while (csv.FetchNextRow())
+    {
+        double time;
+        double throughput;
+        if (csv.IsBlankRow() || !csv.GetValue(m_timeColumn, time) ||
+            !csv.GetValue(m_throughputColumn, throughput))
+        {
+            continue;
+        }
+        AddSample(Seconds(time * m_timeScale), DataRate(uint64_t(throughput * m_throughputScale)));
+    }
+    NS_ABORT_MSG_IF(m_trace.empty(), "No throughput sample in file " << filename);
+    NS_LOG_INFO("Loaded " << m_trace.size() << " samples from file " << filename);
+}
+
+void
+AbrReplayEngine::AddSample(Time time, DataRate throughput)
+{
+    if (m_trace.empty())
+    {
+        // the trace starts at its first sample
+        m_traceStart = time;
+    }
+    NS_ABORT_MSG_IF(!m_trace.empty() && time - m_traceStart < m_trace.back().time,
+                    "Throughput samples must be in increasing time order, instead "
+                        << time << " after " << m_trace.back().time + m_traceStart);
+    m_trace.push_back({time - m_traceStart, double(throughput.GetBitRate())});
+}
+
+void
+AbrReplayEngine::Start()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_algorithm, "No adaptation algorithm to replay");
+    NS_ABORT_MSG_IF(m_trace.empty(), "No throughput trace to replay");
+
+    m_start = Simulator::Now();
+    m_end = m_start + (m_duration.IsZero() ? m_trace.back().time : m_duration);
+    NS_ABORT_MSG_IF(m_end == m_start, "A trace with a single sample needs a Duration");
+    m_traceIndex = 0;
+    m_stepEvent = Simulator::ScheduleNow(&AbrReplayEngine::Step, this);
+}
+
+void
+AbrReplayEngine::Step()
+{
+    Time now = Simulator::Now();
+    Time next = std::min(now + Seconds(1 / m_frameRate), m_end);
+
+    // same floor and cap as BurstyApplicationServerInstance::AdaptRate
+    uint64_t buffOcc = std::llround(m_enqueued - m_drained);
+    DataRate rate = std::max(m_algorithm->nextBurstRate(buffOcc, m_bytesAdded, m_busyTime),
+                             m_algorithm->GetBitrateLadder()->GetMinRate());
+    DataRate cappedRate = std::min(rate, m_initialRate);
+
+    RateDecision decision = m_algorithm->GetLastDecision();
+    decision.cappedRate = cappedRate;
+    m_rateDecisionTrace(decision);
+
+    if (m_frames > 0 && cappedRate != m_lastRate)
+    {
+        m_rateSwitches++;
+    }
+    m_lastRate = cappedRate;
+    m_rateSum += cappedRate.GetBitRate();
+
+    uint32_t size = cappedRate.GetBitRate() / 8 / m_frameRate;
+    m_enqueued += size;
+    m_pending.push_back({m_frames++, size, now, m_enqueued});
+    m_bytesAdded = size;
+    m_busyTime = Drain(now, next);
+
+    if (next < m_end)
+    {
+        m_stepEvent = Simulator::Schedule(next - now, &AbrReplayEngine::Step, this);
+    }
+    else
+    {
+        NS_LOG_INFO("Replay of " << m_frames << " frames done, " << m_pending.size()
+                                 << " frames left in the send buffer");
+    }
+}
+
+Time
+AbrReplayEngine::Drain(Time from, Time to)
+{
+    Time busy;
+    Time t = from;
+    Time traceLength = m_trace.back().time;
+    while (t < to && !m_pending.empty())
+    {
+        // find the sample of t, looping over the trace if the replay is longer
+        Time offset = t - m_start;
+        if (!traceLength.IsZero() && offset >= traceLength)
+        {
+            offset = TimeStep(offset.GetTimeStep() % traceLength.GetTimeStep());
+            if (offset < m_trace[m_traceIndex].time)
+            {
+                m_traceIndex = 0;
+            }
+        }
+        while (m_traceIndex + 1 < m_trace.size() && m_trace[m_traceIndex + 1].time <= offset)
+        {
+            m_traceIndex++;
+        }
+        Time segmentEnd = to;
+        if (m_traceIndex + 1 < m_trace.size())
+        {
+            segmentEnd = std::min(to, t + m_trace[m_traceIndex + 1].time - offset);
+        }
+
+        double rate = m_trace[m_traceIndex].rate / 8; // bytes per second
+        double backlog = m_enqueued - m_drained;
+        double capacity = rate * (segmentEnd - t).GetSeconds();
+        if (capacity >= backlog)
+        {
+            // the buffer empties within the segment
+            for (const auto& frame : m_pending)
+            {
+                Deliver(frame, t + Seconds((frame.end - m_drained) / rate));
+            }
+            m_pending.clear();
+            m_drained = m_enqueued;
+            busy += Seconds(backlog / rate);
+        }
+        else
+        {
+            while (m_pending.front().end <= m_drained + capacity)
+            {
+                Deliver(m_pending.front(), t + Seconds((m_pending.front().end - m_drained) / rate));
+                m_pending.pop_front();
+            }
+            m_drained += capacity;
+            busy += segmentEnd - t;
+        }
+        t = segmentEnd;
+    }
+    return busy;
+}
+
+void
+AbrReplayEngine::Deliver(const PendingFrame& frame, Time time)
+{
+    Time delay = time - frame.sent;
+    m_frameDeliveredTrace(frame.seq, frame.size, delay);
+    if (!m_deadline.IsZero() && delay > m_deadline)
+    {
+        return;
+    }
+
+    // same freeze time as QoeMonitor
+    Time frameInterval = Seconds(1 / m_frameRate);
+    if (m_onTimeFrames > 0 && time - m_lastDelivery > frameInterval)
+    {
+        m_freezeTime += time - m_lastDelivery - frameInterval;
+    }
+    m_lastDelivery = time;
+    m_onTimeFrames++;
+    m_rxBytes += frame.size;
+    m_delaySumMs += delay.GetSeconds() * 1000;
+}
+
+AbrReplayEngine::Summary
+AbrReplayEngine::GetSummary() const
+{
+    Summary summary;
+    summary.frames = m_frames;
+    summary.lateFrames = m_frames - m_onTimeFrames;
+    summary.rateSwitches = m_rateSwitches;
+    summary.avgRateMbps = m_frames > 0 ? m_rateSum / m_frames / 1e6 : 0;
+    summary.freezeTimeMs = m_freezeTime.GetSeconds() * 1000;
+
+    double duration = (std::min(Simulator::Now(), m_end) - m_start).GetSeconds();
+    if (m_onTimeFrames > 0 && duration > 0)
+    {
+        summary.throughputMbps = m_rxBytes * 8 / duration / 1e6;
+        summary.avgDelayMs = m_delaySumMs / m_onTimeFrames;
+        summary.successRate = double(m_onTimeFrames) / m_frames;
+        summary.qoe = 60 * std::log10(summary.throughputMbps) - summary.avgDelayMs -
+                      (1 - summary.successRate) * 1000;
+    }
+    else
+    {
+        summary.throughputMbps = 0;
+        summary.avgDelayMs = 0;
+        summary.successRate = 0;
+        summary.qoe = std::numeric_limits<double>::quiet_NaN();
+    }
+    return summary;
+}
+
+void
+AbrReplayEngine::WriteSummary(std::ostream& os) const
+{
+    Summary summary = GetSummary();
+    os << "qoe,throughputMbps,avgRateMbps,avgDelayMs,successRate,freezeTimeMs,frames,lateFrames,"
+          "rateSwitches"
+       << std::endl;
+    os << summary.qoe << "," << summary.throughputMbps << "," << summary.avgRateMbps << ","
+       << summary.avgDelayMs << "," << summary.successRate << "," << summary.freezeTimeMs << ","
+       << summary.frames << "," << summary.lateFrames << "," << summary.rateSwitches << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABR_REPLAY_ENGINE_H
+#define ABR_REPLAY_ENGINE_H
+
+#include "ns3/adaptation-algorithm-server.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Replays a throughput trace through an adaptation algorithm without a network stack
+ *
+ * The engine emulates a BurstyApplicationServerInstance and its TCP send
+ * buffer on a recorded throughput trace, e.g., the MeasuredRate_bps column
+ * of the rateDecisions.csv written by vr-a-rev-back. Every frame period
+ * (FrameRate), the engine asks the algorithm for the rate of the next frame
+ * through the socket-free AdaptationAlgorithmServer::nextBurstRate, with the
+ * same floor (lowest rung of the ladder of the algorithm) and cap
+ * (InitialRate) as the server instance, and enqueues a frame of rate /
+ * FrameRate bytes. The send buffer is a fluid FIFO queue drained at the
+ * throughput of the trace, which is piecewise constant between samples, so
+ * that the delivery time of each frame, the time the buffer was busy and its
+ * occupancy are computed analytically, in O(1) amortized per frame.
+ *
+ * Time advances with one simulator event per frame, so that the algorithms
+ * relying on Simulator::Now behave as in a packet-level simulation, and
+ * nothing else is scheduled: a replay processes millions of frames per
+ * second for the lightweight algorithms.
+ *
+ * The QoE is computed as in QoeMonitor, a frame being received if it is
+ * delivered within Deadline. TcpDeliveryRateAlgorithmServer needs a TCP
+ * socket and cannot be replayed.
+ */
+class AbrReplayEngine : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    AbrReplayEngine();
+    ~AbrReplayEngine() override;
+
+    /// End-of-replay summary
+    struct Summary
+    {
+        double qoe;            //!< QoE, as computed by QoeMonitor
+        double throughputMbps; //!< delivered payload over the replay duration [Mbps]
+        double avgRateMbps;    //!< average rate of the frames [Mbps]
+        double avgDelayMs;     //!< average delay of the delivered frames [ms]
+        double successRate;    //!< ratio between frames delivered within Deadline and frames
+        double freezeTimeMs;   //!< freeze time, as computed by QoeMonitor [ms]
+        uint64_t frames;       //!< frames sent
+        uint64_t lateFrames;   //!< frames delivered after Deadline, or never
+        uint64_t rateSwitches; //!< changes of the rate of the frames
+    };
+
+    /**
+     * TracedCallback signature for delivered frames.
+     *
+     * \param [in] seq the sequence number of the frame
+     * \param [in] size the size of the frame, in bytes
+     * \param [in] delay the time between the frame was sent and delivered
+     */
+    typedef void (*FrameDeliveredTracedCallback)(uint64_t seq, uint32_t size, Time delay);
+
+    /**
+     * \brief Set the algorithm to replay
+     * \param algorithm the algorithm, never shared with a server instance
+     */
+    void SetAlgorithm(Ptr<AdaptationAlgorithmServer> algorithm);
+
+    /**
+     * \return the algorithm replayed
+     */
+    Ptr<AdaptationAlgorithmServer> GetAlgorithm() const;
+
+    /**
+     * \brief Load the throughput trace from a CSV file
+     *
+     * The time and the throughput are read from the TimeColumn and
+     * ThroughputColumn columns of each row; rows where they are not numbers,
+     * e.g., a header, are skipped.
+     *
+     * \param filename the file, ignored if empty
+     */
+    void Load(std::string filename);
+
+    /**
+     * \brief Append a throughput sample to the trace
+     * \param time the time of the sample, not before the previous one
+     * \param throughput the throughput from time until the next sample
+     */
+    void AddSample(Time time, DataRate throughput);
+
+    /**
+     * \brief Start the replay at the current simulation time
+     *
+     * The trace is shifted so that its first sample is now, and the replay
+     * stops at the last sample of the trace, or after Duration. An engine
+     * replays its trace once.
+     */
+    void Start();
+
+    /**
+     * \return the summary of the replay so far
+     */
+    Summary GetSummary() const;
+
+    /**
+     * \brief Write the summary as a two-line CSV (header and values)
+     * \param os the output stream
+     */
+    void WriteSummary(std::ostream& os) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A throughput sample of the trace
+    struct Sample
+    {
+        Time time;   //!< start of the sample, relative to the first one
+        double rate; //!< throughput, in bit/s
+    };
+
+    /// A frame in the send buffer
+    struct PendingFrame
+    {
+        uint64_t seq;  //!< sequence number
+        uint32_t size; //!< size, in bytes
+        Time sent;     //!< time the frame was added to the send buffer
+        double end;    //!< bytes enqueued up to the end of the frame
+    };
+
+    /**
+     * \brief Send a frame, drain the send buffer until the next one, and schedule it
+     */
+    void Step();
+
+    /**
+     * \brief Drain the send buffer at the throughput of the trace
+     * \param from the start of the interval
+     * \param to the end of the interval
+     * \return the time the send buffer was not empty
+     */
+    Time Drain(Time from, Time to);
+
+    /**
+     * \brief Account for a delivered frame
+     * \param frame the frame
+     * \param time the delivery time
+     */
+    void Deliver(const PendingFrame& frame, Time time);
+
+    Ptr<AdaptationAlgorithmServer> m_algorithm; //!< algorithm replayed
+    uint32_t m_timeColumn;                      //!< column of the time in the trace file
+    uint32_t m_throughputColumn;                //!< column of the throughput in the trace file
+    double m_timeScale;                         //!< seconds per unit of the time column
+    double m_throughputScale;                   //!< bit/s per unit of the throughput column
+    double m_frameRate;                         //!< frames per second
+    DataRate m_initialRate;                     //!< rate of the generator, and cap of the rate
+    Time m_deadline;                            //!< delay beyond which a frame is lost
+    Time m_duration;                            //!< duration of the replay, zero for the trace
+
+    std::vector<Sample> m_trace; //!< throughput trace
+    Time m_traceStart;           //!< time of the first sample of the trace
+    std::size_t m_traceIndex;    //!< sample of the current time
+    Time m_start;                //!< start of the replay
+    Time m_end;                  //!< end of the replay
+    EventId m_stepEvent;         //!< next frame
+
+    std::deque<PendingFrame> m_pending; //!< frames in the send buffer
+    double m_enqueued;                  //!< bytes enqueued since the start
+    double m_drained;                   //!< bytes drained since the start
+    uint64_t m_bytesAdded;              //!< bytes enqueued since the last decision
+    Time m_busyTime;                    //!< time the buffer was busy since the last decision
+    DataRate m_lastRate;                //!< rate of the last frame
+
+    uint64_t m_frames;       //!< frames sent
+    uint64_t m_onTimeFrames; //!< frames delivered within the deadline
+    uint64_t m_rateSwitches; //!< changes of the rate of the frames
+    double m_rateSum;        //!< sum of the rates of the frames, in bit/s
+    uint64_t m_rxBytes;      //!< bytes of the frames delivered within the deadline
+    double m_delaySumMs;     //!< sum of the delays of the delivered frames, in ms
+    Time m_lastDelivery;     //!< delivery time of the last frame
+    Time m_freezeTime;       //!< freeze time
+
+    /// Rate chosen for a frame
+    ns3::TracedCallback<const RateDecision&> m_rateDecisionTrace;
+    /// Frame delivered
+    ns3::TracedCallback<uint64_t, uint32_t, Time> m_frameDeliveredTrace;
+};
+
+} // namespace ns3
+
+#endif /* ABR_REPLAY_ENGINE_H */
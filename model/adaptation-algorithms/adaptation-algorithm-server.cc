@@ -1,6 +1,8 @@
 #include "adaptation-algorithm-server.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
 
@@ -12,9 +14,25 @@ TypeId
 AdaptationAlgorithmServer::GetTypeId (void)
 {
   static TypeId tid =
-      TypeId ("ns3::AdaptationAlgorithmServer").SetParent<Object> ().SetGroupName ("Applications")
-      // .AddConstructor<AdaptationAlgorithmServer> ()
-      ;
+      TypeId ("ns3::AdaptationAlgorithmServer")
+          .SetParent<Object> ()
+          .SetGroupName ("Applications")
+          // .AddConstructor<AdaptationAlgorithmServer> ()
+          .AddAttribute ("BandwidthEstimator",
+                         "The throughput estimator used by the algorithm, null for the "
+                         "default estimator of the algorithm",
+                         PointerValue (0),
+                         MakePointerAccessor (&AdaptationAlgorithmServer::m_bandwidthEstimator),
+                         MakePointerChecker<BandwidthEstimator> ())
+          .AddAttribute ("BitrateLadder",
+                         "The bitrate ladder the algorithm chooses from, null for the default "
+                         "ladder",
+                         PointerValue (0),
+                         MakePointerAccessor (&AdaptationAlgorithmServer::m_bitrateLadder),
+                         MakePointerChecker<BitrateLadder> ())
+          .AddTraceSource ("RateDecision", "A new burst rate has been chosen",
+                           MakeTraceSourceAccessor (&AdaptationAlgorithmServer::m_rateDecisionTrace),
+                           "ns3::RateDecision::TracedCallback");
   return tid;
 }
 
@@ -28,21 +46,88 @@ AdaptationAlgorithmServer::~AdaptationAlgorithmServer ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+AdaptationAlgorithmServer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_bandwidthEstimator = 0;
+  m_bitrateLadder = 0;
+  Object::DoDispose ();
+}
+
+void
+AdaptationAlgorithmServer::SetBandwidthEstimator (Ptr<BandwidthEstimator> estimator)
+{
+  NS_LOG_FUNCTION (this << estimator);
+  m_bandwidthEstimator = estimator;
+}
+
+Ptr<BandwidthEstimator>
+AdaptationAlgorithmServer::GetBandwidthEstimator (void)
+{
+  if (!m_bandwidthEstimator)
+    {
+      m_bandwidthEstimator = CreateBandwidthEstimator ();
+    }
+  return m_bandwidthEstimator;
+}
+
+void
+AdaptationAlgorithmServer::SetBitrateLadder (Ptr<BitrateLadder> ladder)
+{
+  NS_LOG_FUNCTION (this << ladder);
+  m_bitrateLadder = ladder;
+}
+
+Ptr<BitrateLadder>
+AdaptationAlgorithmServer::GetBitrateLadder (void)
+{
+  if (!m_bitrateLadder)
+    {
+      m_bitrateLadder = CreateObject<BitrateLadder> ();
+    }
+  return m_bitrateLadder;
+}
+
+Ptr<BandwidthEstimator>
+AdaptationAlgorithmServer::CreateBandwidthEstimator (void) const
+{
+  return CreateObject<EwmaBandwidthEstimator> ();
+}
+
+void
+AdaptationAlgorithmServer::UpdateBandwidthEstimate (uint64_t bytesAddedToSocket,
+                                                    uint64_t bytesSent, Time txTime)
+{
+  GetBandwidthEstimator ()->AddSample (bytesSent, txTime);
+}
+
 DataRate
 AdaptationAlgorithmServer::nextBurstRate (Ptr<Socket> socket, uint64_t bytesAddedToSocket,
                                           Time txTime)
 {
   NS_LOG_FUNCTION (this << socket << bytesAddedToSocket);
 
+  if (m_lastDecision.flow.IsInvalid ())
+    {
+      socket->GetPeerName (m_lastDecision.flow);
+    }
+
   UintegerValue buf_size;
   DynamicCast<TcpSocketBase> (socket)->GetAttribute ("SndBufSize", buf_size);
-  
 
+  return nextBurstRate (buf_size.Get () - socket->GetTxAvailable (), bytesAddedToSocket, txTime);
+}
+
+DataRate
+AdaptationAlgorithmServer::nextBurstRate (uint64_t buffOcc, uint64_t bytesAddedToSocket,
+                                          Time txTime)
+{
+  NS_LOG_FUNCTION (this << buffOcc << bytesAddedToSocket);
 
   Time dt = Simulator::Now () - m_lastBurstTime;
   m_lastBurstTime = Simulator::Now ();
 
-  uint64_t buffOcc = buf_size.Get () - socket->GetTxAvailable ();
   int128_t diffBuffOcc = buffOcc - m_lastBufferOcc;
   m_lastBufferOcc = buffOcc;
 
@@ -50,20 +135,39 @@ AdaptationAlgorithmServer::nextBurstRate (Ptr<Socket> socket, uint64_t bytesAdde
   // DataRate lastRate = DataRate (bytesSent * 8 / dt.GetSeconds ());
   DataRate lastRate = DataRate (bytesSent * 8 / txTime.GetSeconds ());
 
-  std::cout << "bytesSent " << bytesSent << " txTime " << txTime.GetSeconds () << " dt "
-            << dt.GetSeconds () << std::endl;
-
-  NS_LOG_DEBUG ("buffOcc " << buffOcc << " diffBuffOcc " << (int) diffBuffOcc << " lastRate "
-                            << lastRate.GetBitRate () / 1e6);
+  NS_LOG_DEBUG ("bytesSent " << bytesSent << " txTime " << txTime.GetSeconds () << " dt "
+                             << dt.GetSeconds () << " buffOcc " << buffOcc << " diffBuffOcc "
+                             << (int) diffBuffOcc << " lastRate " << lastRate.GetBitRate () / 1e6);
 
   if (txTime > Seconds (0))
     {
-      return adaptation_algorithm (buffOcc, diffBuffOcc, lastRate);
+      UpdateBandwidthEstimate (bytesAddedToSocket, bytesSent, txTime);
+      return NotifyDecision (lastRate, buffOcc,
+                             adaptation_algorithm (buffOcc, diffBuffOcc, lastRate));
     }
   else
     {
-      return DataRate ("10Mbps");
+      return NotifyDecision (lastRate, buffOcc, DataRate ("10Mbps"));
     }
 }
 
+const RateDecision &
+AdaptationAlgorithmServer::GetLastDecision (void) const
+{
+  return m_lastDecision;
+}
+
+DataRate
+AdaptationAlgorithmServer::NotifyDecision (DataRate measuredRate, uint64_t bufferOccupancy,
+                                           DataRate chosenRate)
+{
+  m_lastDecision.time = Simulator::Now ();
+  m_lastDecision.measuredRate = measuredRate;
+  m_lastDecision.bufferOccupancy = bufferOccupancy;
+  m_lastDecision.chosenRate = chosenRate;
+  m_lastDecision.cappedRate = chosenRate;
+  m_rateDecisionTrace (m_lastDecision);
+  return chosenRate;
+}
+
 } // namespace ns3
@@ -1,13 +1,38 @@
 #ifndef ADAPTATION_ALGORITHM_SERVER_H
 #define ADAPTATION_ALGORITHM_SERVER_H
 
+#include "bandwidth-estimator.h"
+
+#include "ns3/address.h"
+#include "ns3/bitrate-ladder.h"
 #include "ns3/data-rate.h"
 #include "ns3/tcp-socket-base.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
 
 namespace ns3 {
 
+/**
+ * \brief A rate adaptation decision
+ */
+struct RateDecision
+{
+  Time time; //!< time of the decision
+  Address flow; //!< address of the peer
+  DataRate measuredRate; //!< rate measured since the previous decision
+  uint64_t bufferOccupancy{0}; //!< bytes in the send buffer
+  DataRate chosenRate; //!< rate chosen by the adaptation algorithm
+  DataRate cappedRate; //!< rate actually set on the generator
+
+  /**
+   * TracedCallback signature for rate decisions.
+   *
+   * \param [in] decision the decision
+   */
+  typedef void (*TracedCallback) (const RateDecision &decision);
+};
+
 class AdaptationAlgorithmServer : public Object
 {
 public:
@@ -19,13 +44,102 @@ public:
   virtual DataRate nextBurstRate (Ptr<Socket> socket, uint64_t bytesAddedToSocket,
                                   Time txTime);
 
+  /**
+   * \brief Choose the rate of the next burst without a socket
+   *
+   * Same as the socket version, which reads the send buffer occupancy from
+   * the socket and calls this method, so that the algorithms can be driven
+   * by recorded traces (see AbrReplayEngine). Algorithms relying on the
+   * socket itself, i.e., TcpDeliveryRateAlgorithmServer, only work through
+   * the socket version.
+   *
+   * \param buffOcc the bytes in the send buffer
+   * \param bytesAddedToSocket the bytes added to the send buffer since the last decision
+   * \param txTime the time the send buffer was not empty since the last decision
+   * \return the rate of the next burst
+   */
+  virtual DataRate nextBurstRate (uint64_t buffOcc, uint64_t bytesAddedToSocket, Time txTime);
+
+  /**
+   * \return the last decision taken by nextBurstRate
+   */
+  const RateDecision &GetLastDecision (void) const;
+
+  /**
+   * \brief Set the throughput estimator used by the algorithm
+   * \param estimator the estimator, null to use the default one of the algorithm
+   */
+  void SetBandwidthEstimator (Ptr<BandwidthEstimator> estimator);
+
+  /**
+   * \return the throughput estimator used by the algorithm, created with the
+   * defaults of the algorithm on first use if none was set
+   */
+  Ptr<BandwidthEstimator> GetBandwidthEstimator (void);
+
+  /**
+   * \brief Set the bitrate ladder the algorithm chooses from
+   * \param ladder the ladder, null to use the default ladder
+   *
+   * The ladder must be set before the first decision.
+   */
+  void SetBitrateLadder (Ptr<BitrateLadder> ladder);
+
+  /**
+   * \return the bitrate ladder the algorithm chooses from, created with its
+   * default attributes on first use if none was set
+   */
+  Ptr<BitrateLadder> GetBitrateLadder (void);
+
 protected:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief Create the estimator used when none is set
+   *
+   * The default is an EWMA of the measured rate. Algorithms override it to
+   * keep the estimator they were designed with.
+   *
+   * \return the estimator
+   */
+  virtual Ptr<BandwidthEstimator> CreateBandwidthEstimator (void) const;
+
+  /**
+   * \brief Feed the throughput estimator with the last burst
+   *
+   * The default uses the bytes that left the send buffer over the
+   * transmission time, i.e., the measured rate passed to adaptation_algorithm.
+   *
+   * \param bytesAddedToSocket the bytes of the burst
+   * \param bytesSent the bytes that left the send buffer during the burst
+   * \param txTime the transmission time of the burst
+   */
+  virtual void UpdateBandwidthEstimate (uint64_t bytesAddedToSocket, uint64_t bytesSent,
+                                        Time txTime);
+
   virtual DataRate adaptation_algorithm (double buff_occ, double diff_buff_occ,
                                          DataRate lastRate) = 0;
 
   Time m_lastBurstTime = Seconds (0);
 
   uint64_t m_lastBufferOcc = 0;
+
+  /**
+   * \brief Record a decision and fire the RateDecision trace
+   * \param measuredRate the rate measured since the previous decision
+   * \param bufferOccupancy the bytes in the send buffer
+   * \param chosenRate the rate chosen by the algorithm
+   * \return chosenRate
+   */
+  DataRate NotifyDecision (DataRate measuredRate, uint64_t bufferOccupancy, DataRate chosenRate);
+
+  RateDecision m_lastDecision; //!< last decision taken
+
+  Ptr<BandwidthEstimator> m_bandwidthEstimator; //!< throughput estimator, null until first use
+  Ptr<BitrateLadder> m_bitrateLadder; //!< bitrate ladder, null until first use
+
+  /// Callback for rate decisions
+  ns3::TracedCallback<const RateDecision &> m_rateDecisionTrace;
 };
 
 } // namespace ns3
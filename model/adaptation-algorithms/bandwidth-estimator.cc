@@ -0,0 +1,472 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bandwidth-estimator.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BandwidthEstimator");
+
+NS_OBJECT_ENSURE_REGISTERED(BandwidthEstimator);
+NS_OBJECT_ENSURE_REGISTERED(EwmaBandwidthEstimator);
+NS_OBJECT_ENSURE_REGISTERED(DualEwmaBandwidthEstimator);
+NS_OBJECT_ENSURE_REGISTERED(HarmonicBandwidthEstimator);
+NS_OBJECT_ENSURE_REGISTERED(SlidingPercentileBandwidthEstimator);
+NS_OBJECT_ENSURE_REGISTERED(KalmanBandwidthEstimator);
+
+TypeId
+BandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BandwidthEstimator")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddAttribute("ErrorWindow",
+                          "The number of samples over which the largest prediction error is "
+                          "reported as the error of the estimate",
+                          UintegerValue(5),
+                          MakeUintegerAccessor(&BandwidthEstimator::m_errorWindow),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Estimate",
+                            "The estimate has been updated with a new sample",
+                            MakeTraceSourceAccessor(&BandwidthEstimator::m_estimateTrace),
+                            "ns3::BandwidthEstimator::EstimateTracedCallback");
+    return tid;
+}
+
+BandwidthEstimator::BandwidthEstimator()
+    : m_estimate(0),
+      m_samples(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BandwidthEstimator::~BandwidthEstimator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BandwidthEstimator::AddSample(uint64_t bytes, Time duration)
+{
+    NS_LOG_FUNCTION(this << bytes << duration);
+
+    double seconds = duration.GetSeconds();
+    if (seconds <= 0 || bytes == 0)
+    {
+        // an empty transfer tells nothing about the bandwidth, and its zero
+        // rate would have an infinite weight in the harmonic mean
+        NS_LOG_LOGIC("Ignoring sample of " << bytes << " B in " << duration);
+        return;
+    }
+    double rate = bytes * 8 / seconds;
+
+    if (m_samples > 0)
+    {
+        double error = std::abs(m_estimate - rate) / rate;
+        while (!m_errors.empty() && m_errors.back().second <= error)
+        {
+            m_errors.pop_back();
+        }
+        m_errors.emplace_back(m_samples, error);
+        while (m_errors.front().first + m_errorWindow <= m_samples)
+        {
+            m_errors.pop_front();
+        }
+    }
+
+    m_estimate = DoAddSample(rate, bytes, seconds);
+    m_samples++;
+
+    NS_LOG_DEBUG("sample " << rate << " estimate " << m_estimate << " error " << GetError());
+    m_estimateTrace(DataRate(uint64_t(rate)), GetEstimate());
+}
+
+DataRate
+BandwidthEstimator::GetEstimate() const
+{
+    return DataRate(uint64_t(std::max(m_estimate, 0.0)));
+}
+
+double
+BandwidthEstimator::GetError() const
+{
+    return m_errors.empty() ? 0 : m_errors.front().second;
+}
+
+uint64_t
+BandwidthEstimator::GetSampleCount() const
+{
+    return m_samples;
+}
+
+void
+BandwidthEstimator::Reset()
+{
+    NS_LOG_FUNCTION(this);
+    m_estimate = 0;
+    m_samples = 0;
+    m_errors.clear();
+    DoReset();
+}
+
+TypeId
+EwmaBandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EwmaBandwidthEstimator")
+            .SetParent<BandwidthEstimator>()
+            .SetGroupName("Applications")
+            .AddConstructor<EwmaBandwidthEstimator>()
+            .AddAttribute("Alpha",
+                          "The weight of a new sample",
+                          DoubleValue(0.125),
+                          MakeDoubleAccessor(&EwmaBandwidthEstimator::m_alpha),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("InitialEstimate",
+                          "The estimate the average starts from, zero to start from the first "
+                          "sample",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&EwmaBandwidthEstimator::m_initialEstimate),
+                          MakeDataRateChecker());
+    return tid;
+}
+
+EwmaBandwidthEstimator::EwmaBandwidthEstimator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+EwmaBandwidthEstimator::DoAddSample(double rate, uint64_t bytes, double seconds)
+{
+    double previous = m_estimate;
+    if (GetSampleCount() == 0)
+    {
+        if (m_initialEstimate.GetBitRate() == 0)
+        {
+            return rate;
+        }
+        previous = m_initialEstimate.GetBitRate();
+    }
+    return (1 - m_alpha) * previous + m_alpha * rate;
+}
+
+void
+EwmaBandwidthEstimator::DoReset()
+{
+}
+
+TypeId
+DualEwmaBandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DualEwmaBandwidthEstimator")
+            .SetParent<BandwidthEstimator>()
+            .SetGroupName("Applications")
+            .AddConstructor<DualEwmaBandwidthEstimator>()
+            .AddAttribute("SlowAlpha",
+                          "The weight of a new sample in the slow average",
+                          DoubleValue(0.01),
+                          MakeDoubleAccessor(&DualEwmaBandwidthEstimator::m_slowAlpha),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("FastAlpha",
+                          "The weight of a new sample in the fast average",
+                          DoubleValue(0.02),
+                          MakeDoubleAccessor(&DualEwmaBandwidthEstimator::m_fastAlpha),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("InitialEstimate",
+                          "The estimate both averages start from, zero to start from the first "
+                          "sample",
+                          DataRateValue(DataRate("100kbps")),
+                          MakeDataRateAccessor(&DualEwmaBandwidthEstimator::m_initialEstimate),
+                          MakeDataRateChecker());
+    return tid;
+}
+
+DualEwmaBandwidthEstimator::DualEwmaBandwidthEstimator()
+    : m_slow(0),
+      m_fast(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+DualEwmaBandwidthEstimator::DoAddSample(double rate, uint64_t bytes, double seconds)
+{
+    if (GetSampleCount() == 0)
+    {
+        double initial = m_initialEstimate.GetBitRate();
+        m_slow = initial > 0 ? initial : rate;
+        m_fast = m_slow;
+    }
+    m_slow = (1 - m_slowAlpha) * m_slow + m_slowAlpha * rate;
+    m_fast = (1 - m_fastAlpha) * m_fast + m_fastAlpha * rate;
+    return std::min(m_slow, m_fast);
+}
+
+void
+DualEwmaBandwidthEstimator::DoReset()
+{
+    m_slow = 0;
+    m_fast = 0;
+}
+
+TypeId
+HarmonicBandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HarmonicBandwidthEstimator")
+            .SetParent<BandwidthEstimator>()
+            .SetGroupName("Applications")
+            .AddConstructor<HarmonicBandwidthEstimator>()
+            .AddAttribute("WindowSize",
+                          "The number of samples the mean is computed on",
+                          UintegerValue(5),
+                          MakeUintegerAccessor(&HarmonicBandwidthEstimator::m_windowSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("ByteWeighted",
+                          "If true, samples are weighted by their bytes, i.e., the estimate is "
+                          "the bytes over the transfer time of the window",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&HarmonicBandwidthEstimator::m_byteWeighted),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+HarmonicBandwidthEstimator::HarmonicBandwidthEstimator()
+    : m_next(0),
+      m_sumWeight(0),
+      m_sumWeightPerRate(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+HarmonicBandwidthEstimator::DoAddSample(double rate, uint64_t bytes, double seconds)
+{
+    Sample sample;
+    sample.weight = m_byteWeighted ? bytes * 8 : 1;
+    sample.weightPerRate = m_byteWeighted ? seconds : 1 / rate;
+
+    if (m_window.size() < m_windowSize)
+    {
+        m_window.push_back(sample);
+    }
+    else
+    {
+        m_sumWeight -= m_window[m_next].weight;
+        m_sumWeightPerRate -= m_window[m_next].weightPerRate;
+        m_window[m_next] = sample;
+    }
+    m_next = (m_next + 1) % m_windowSize;
+    m_sumWeight += sample.weight;
+    m_sumWeightPerRate += sample.weightPerRate;
+
+    return m_sumWeightPerRate > 0 ? m_sumWeight / m_sumWeightPerRate : 0;
+}
+
+void
+HarmonicBandwidthEstimator::DoReset()
+{
+    m_window.clear();
+    m_next = 0;
+    m_sumWeight = 0;
+    m_sumWeightPerRate = 0;
+}
+
+TypeId
+SlidingPercentileBandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SlidingPercentileBandwidthEstimator")
+            .SetParent<BandwidthEstimator>()
+            .SetGroupName("Applications")
+            .AddConstructor<SlidingPercentileBandwidthEstimator>()
+            .AddAttribute("WindowSize",
+                          "The number of samples the percentile is computed on",
+                          UintegerValue(20),
+                          MakeUintegerAccessor(&SlidingPercentileBandwidthEstimator::m_windowSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Percentile",
+                          "The percentile of the samples used as estimate",
+                          DoubleValue(20),
+                          MakeDoubleAccessor(&SlidingPercentileBandwidthEstimator::m_percentile),
+                          MakeDoubleChecker<double>(0, 100));
+    return tid;
+}
+
+SlidingPercentileBandwidthEstimator::SlidingPercentileBandwidthEstimator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+SlidingPercentileBandwidthEstimator::DoAddSample(double rate, uint64_t bytes, double seconds)
+{
+    if (m_window.size() == m_windowSize)
+    {
+        double oldest = m_window.front();
+        m_window.pop_front();
+        if (!m_low.empty() && oldest <= *m_low.rbegin())
+        {
+            m_low.erase(m_low.find(oldest));
+        }
+        else
+        {
+            m_high.erase(m_high.find(oldest));
+        }
+    }
+
+    m_window.push_back(rate);
+    if (m_low.empty() || rate <= *m_low.rbegin())
+    {
+        m_low.insert(rate);
+    }
+    else
+    {
+        m_high.insert(rate);
+    }
+    Rebalance();
+
+    return *m_low.rbegin();
+}
+
+void
+SlidingPercentileBandwidthEstimator::Rebalance()
+{
+    // nearest rank: the percentile is the k-th smallest sample
+    std::size_t k = std::ceil(m_percentile / 100 * m_window.size());
+    k = std::max<std::size_t>(k, 1);
+
+    while (m_low.size() > k)
+    {
+        auto last = std::prev(m_low.end());
+        m_high.insert(*last);
+        m_low.erase(last);
+    }
+    while (m_low.size() < k)
+    {
+        m_low.insert(*m_high.begin());
+        m_high.erase(m_high.begin());
+    }
+}
+
+void
+SlidingPercentileBandwidthEstimator::DoReset()
+{
+    m_window.clear();
+    m_low.clear();
+    m_high.clear();
+}
+
+TypeId
+KalmanBandwidthEstimator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::KalmanBandwidthEstimator")
+            .SetParent<BandwidthEstimator>()
+            .SetGroupName("Applications")
+            .AddConstructor<KalmanBandwidthEstimator>()
+            .AddAttribute("ProcessNoise",
+                          "The standard deviation of the change of the throughput between two "
+                          "samples",
+                          DataRateValue(DataRate("1Mbps")),
+                          MakeDataRateAccessor(&KalmanBandwidthEstimator::m_processNoise),
+                          MakeDataRateChecker())
+            .AddAttribute("MeasurementNoise",
+                          "The standard deviation of the noise of a sample",
+                          DataRateValue(DataRate("5Mbps")),
+                          MakeDataRateAccessor(&KalmanBandwidthEstimator::m_measurementNoise),
+                          MakeDataRateChecker())
+            .AddAttribute("InnovationGain",
+                          "The weight of a new innovation in the average of the squared "
+                          "innovations the error is computed from",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&KalmanBandwidthEstimator::m_innovationGain),
+                          MakeDoubleChecker<double>(0, 1));
+    return tid;
+}
+
+KalmanBandwidthEstimator::KalmanBandwidthEstimator()
+    : m_variance(0),
+      m_innovationVariance(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+KalmanBandwidthEstimator::GetError() const
+{
+    if (GetSampleCount() == 0 || m_estimate <= 0)
+    {
+        return 0;
+    }
+    return std::sqrt(m_innovationVariance) / m_estimate;
+}
+
+double
+KalmanBandwidthEstimator::GetVariance() const
+{
+    return m_variance;
+}
+
+double
+KalmanBandwidthEstimator::DoAddSample(double rate, uint64_t bytes, double seconds)
+{
+    double q = std::pow(double(m_processNoise.GetBitRate()), 2);
+    double r = std::pow(double(m_measurementNoise.GetBitRate()), 2);
+
+    if (GetSampleCount() == 0)
+    {
+        m_variance = r;
+        m_innovationVariance = r;
+        return rate;
+    }
+
+    // predict: random walk
+    double variance = m_variance + q;
+
+    // update
+    double innovation = rate - m_estimate;
+    double innovationVariance = variance + r;
+    double gain = innovationVariance > 0 ? variance / innovationVariance : 1;
+    m_variance = (1 - gain) * variance;
+    m_innovationVariance = (1 - m_innovationGain) * m_innovationVariance +
+                           m_innovationGain * innovation * innovation;
+
+    return m_estimate + gain * innovation;
+}
+
+void
+KalmanBandwidthEstimator::DoReset()
+{
+    m_variance = 0;
+    m_innovationVariance = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BANDWIDTH_ESTIMATOR_H
+#define BANDWIDTH_ESTIMATOR_H
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Incremental estimator of the throughput of a flow
+ *
+ * The adaptation algorithms feed the estimator with one sample per burst (or
+ * per segment), i.e., the bytes transferred and the transfer time, and read
+ * back the estimate when taking a decision. Every update is O(1) (amortized,
+ * O(log W) for SlidingPercentileBandwidthEstimator), so that no algorithm has
+ * to scan the throughput history.
+ *
+ * Besides the estimate, the base class tracks the relative prediction error
+ * of the estimator, |estimate - sample| / sample, where the estimate is the
+ * one available before the sample, and reports the largest error over the
+ * last ErrorWindow samples (as in robust MPC). Subclasses may report a
+ * different error, see KalmanBandwidthEstimator.
+ */
+class BandwidthEstimator : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    BandwidthEstimator();
+    ~BandwidthEstimator() override;
+
+    /**
+     * \brief Add a throughput sample
+     * \param bytes the bytes transferred, samples without bytes are ignored
+     * \param duration the transfer time, samples with a non positive duration are ignored
+     */
+    void AddSample(uint64_t bytes, Time duration);
+
+    /**
+     * \return the current estimate, zero before the first sample
+     */
+    DataRate GetEstimate() const;
+
+    /**
+     * \return the relative error of the estimate, zero before the second sample
+     */
+    virtual double GetError() const;
+
+    /**
+     * \return the number of samples since the last reset
+     */
+    uint64_t GetSampleCount() const;
+
+    /**
+     * \brief Forget all the samples
+     */
+    void Reset();
+
+    /**
+     * TracedCallback signature for estimate updates.
+     *
+     * \param [in] sample the throughput of the sample
+     * \param [in] estimate the updated estimate
+     */
+    typedef void (*EstimateTracedCallback)(DataRate sample, DataRate estimate);
+
+  protected:
+    /**
+     * \brief Update the estimate with a sample
+     * \param rate the throughput of the sample, in bit/s, positive
+     * \param bytes the bytes transferred
+     * \param seconds the transfer time, in seconds
+     * \return the updated estimate, in bit/s
+     */
+    virtual double DoAddSample(double rate, uint64_t bytes, double seconds) = 0;
+
+    /**
+     * \brief Forget all the samples
+     */
+    virtual void DoReset() = 0;
+
+    double m_estimate; //!< current estimate, in bit/s
+
+  private:
+    uint32_t m_errorWindow; //!< number of prediction errors the error is computed on
+    uint64_t m_samples;     //!< samples since the last reset
+
+    /// prediction errors in decreasing order, with their sample number (monotonic queue)
+    std::deque<std::pair<uint64_t, double>> m_errors;
+
+    /// Estimate updated
+    ns3::TracedCallback<DataRate, DataRate> m_estimateTrace;
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Exponentially weighted moving average of the samples
+ *
+ * estimate = (1 - Alpha) * estimate + Alpha * sample, starting from
+ * InitialEstimate, or from the first sample if InitialEstimate is zero.
+ */
+class EwmaBandwidthEstimator : public BandwidthEstimator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    EwmaBandwidthEstimator();
+
+  protected:
+    double DoAddSample(double rate, uint64_t bytes, double seconds) override;
+    void DoReset() override;
+
+  private:
+    double m_alpha;             //!< weight of the new sample
+    DataRate m_initialEstimate; //!< estimate before the first sample, zero to use the first sample
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Minimum of a slow and a fast EWMA
+ *
+ * The fast average reacts quickly to a drop of the throughput, the slow one
+ * prevents overshooting after a short spike: taking the minimum of the two
+ * is conservative on both sides.
+ */
+class DualEwmaBandwidthEstimator : public BandwidthEstimator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    DualEwmaBandwidthEstimator();
+
+  protected:
+    double DoAddSample(double rate, uint64_t bytes, double seconds) override;
+    void DoReset() override;
+
+  private:
+    double m_slowAlpha;         //!< weight of the new sample in the slow average
+    double m_fastAlpha;         //!< weight of the new sample in the fast average
+    DataRate m_initialEstimate; //!< estimate before the first sample, zero to use the first sample
+    double m_slow;              //!< slow average, in bit/s
+    double m_fast;              //!< fast average, in bit/s
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Harmonic mean of the last WindowSize samples
+ *
+ * The harmonic mean is robust to outliers on the high side. If ByteWeighted
+ * is true, each sample is weighted by its bytes, i.e., the estimate is the
+ * total bytes over the total transfer time of the window. The sums over the
+ * window are kept up to date when samples enter and leave it.
+ */
+class HarmonicBandwidthEstimator : public BandwidthEstimator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    HarmonicBandwidthEstimator();
+
+  protected:
+    double DoAddSample(double rate, uint64_t bytes, double seconds) override;
+    void DoReset() override;
+
+  private:
+    /// A sample in the window
+    struct Sample
+    {
+        double weight;        //!< weight of the sample
+        double weightPerRate; //!< weight of the sample over its rate
+    };
+
+    uint32_t m_windowSize; //!< number of samples in the window
+    bool m_byteWeighted;   //!< whether samples are weighted by their bytes
+
+    std::vector<Sample> m_window; //!< circular buffer of the samples in the window
+    uint32_t m_next;              //!< position of the next sample in m_window
+    double m_sumWeight;           //!< sum of the weights in the window
+    double m_sumWeightPerRate;    //!< sum of the weights over the rates in the window
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Percentile of the last WindowSize samples
+ *
+ * A low percentile gives a conservative estimate: it follows a drop of the
+ * throughput once the drop covers Percentile % of the window, and ignores
+ * the spikes covering less than the rest of the window. The window is split
+ * in two ordered sets, the samples up to the percentile and the ones above
+ * it, so that each update costs O(log WindowSize) and the estimate is the
+ * largest sample of the lower set.
+ */
+class SlidingPercentileBandwidthEstimator : public BandwidthEstimator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SlidingPercentileBandwidthEstimator();
+
+  protected:
+    double DoAddSample(double rate, uint64_t bytes, double seconds) override;
+    void DoReset() override;
+
+  private:
+    /**
+     * \brief Move samples between the two sets to have the percentile on top of m_low
+     */
+    void Rebalance();
+
+    uint32_t m_windowSize; //!< number of samples in the window
+    double m_percentile;   //!< percentile, between 0 and 100
+
+    std::deque<double> m_window;  //!< samples in the window, in arrival order
+    std::multiset<double> m_low;  //!< samples up to the percentile
+    std::multiset<double> m_high; //!< samples above the percentile
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Scalar Kalman filter on a random walk model of the throughput
+ *
+ * The throughput is modeled as a random walk with standard deviation
+ * ProcessNoise per sample, observed with a measurement noise of standard
+ * deviation MeasurementNoise. The error bars are innovation based: the error
+ * is the square root of an EWMA (gain InnovationGain) of the squared
+ * innovations, i.e., of the differences between the samples and the
+ * predictions, relative to the estimate. When the measurements agree with the
+ * model the error is close to sqrt(P + R) / estimate, and it widens as soon
+ * as the throughput becomes less predictable.
+ */
+class KalmanBandwidthEstimator : public BandwidthEstimator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    KalmanBandwidthEstimator();
+
+    double GetError() const override;
+
+    /**
+     * \return the variance of the estimate, in (bit/s)^2
+     */
+    double GetVariance() const;
+
+  protected:
+    double DoAddSample(double rate, uint64_t bytes, double seconds) override;
+    void DoReset() override;
+
+  private:
+    DataRate m_processNoise;     //!< standard deviation of the throughput change per sample
+    DataRate m_measurementNoise; //!< standard deviation of the measurement noise
+    double m_innovationGain;     //!< gain of the EWMA of the squared innovations
+
+    double m_variance;           //!< variance of the estimate, in (bit/s)^2
+    double m_innovationVariance; //!< EWMA of the squared innovations, in (bit/s)^2
+};
+
+} // namespace ns3
+
+#endif /* BANDWIDTH_ESTIMATOR_H */
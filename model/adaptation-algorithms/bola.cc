@@ -5,6 +5,8 @@ Bola ABR (based on dash.js implementation)
 **/
 
 #include "bola.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include <math.h>
 
 namespace ns3 {
@@ -12,10 +14,15 @@ namespace ns3 {
   NS_LOG_COMPONENT_DEFINE ("BolaAlgo");
   NS_OBJECT_ENSURE_REGISTERED (BolaAlgo);
 
-  BolaAlgo::BolaAlgo (int chunks, int cmaf) : AdaptationAlgorithm (), m_highestRepIndex (7),
+  BolaAlgo::BolaAlgo (int chunks, int cmaf) : AdaptationAlgorithm (),
 	chunks(chunks), cmaf(cmaf) {
     NS_LOG_INFO (this);
-    NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+    SetThroughputSampling (cmaf == 2 ? 0 : chunks, cmaf == 3, false);
+  }
+
+  Ptr<BandwidthEstimator> BolaAlgo::CreateBandwidthEstimator (void) const {
+    return CreateObjectWithAttributes<HarmonicBandwidthEstimator> ("WindowSize", UintegerValue (5),
+                                                                   "ByteWeighted", BooleanValue (true));
   }
 
   algorithmReply BolaAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clientId) {
@@ -49,6 +56,8 @@ namespace ns3 {
 
     if(state == BOLA_STATE_INIT) {
       
+      bitrates.resize(m_highestRepIndex+1);
+      utilities.resize(m_highestRepIndex+1);
       for(int i=0; i<=m_highestRepIndex; i++) {
         bitrates[i] = m_videoData.averageBitrate.at(i)/1000;
       }
@@ -67,7 +76,7 @@ namespace ns3 {
 
     }
 
-    double throughput = AverageSegmentThroughput(segmentCounter)/1000;
+    double throughput = GetBandwidthEstimator ()->GetEstimate ().GetBitRate ()/(double)1000;
     
     
     algorithmReply answer;
@@ -115,51 +124,6 @@ namespace ns3 {
     return answer;
   }
 
-  double BolaAlgo::AverageSegmentThroughput (int64_t currentSegment) {
-
-    double lengthOfInterval;
-    double sumThroughput = 0.0;
-    double transmissionTime = 0.0;
-
-    int count = 0;
-    for(int index=currentSegment-1; index>=0; index--)
-    {
-      lengthOfInterval = (m_throughput.transmissionEnd.at (index) - m_throughput.transmissionStart.at (index))/(double)1000000;
-      sumThroughput += m_throughput.bytesReceived.at(index);
-      transmissionTime += lengthOfInterval;
-      count++;
-      if((chunks == 0 && count > 4) || (chunks > 0 && count >= (5*chunks))) break;
-    }
-    if(cmaf == 3) {
-      count = 0;
-    	sumThroughput = 0.0;
-      transmissionTime = 0.0;
-      double start = 0.0;
-      double end = 0.0;
-      double segBytes = 0.0;
-      int countChunks = 0;
-      for(int index=currentSegment-1; index>=0; index--)
-      {
-        if(countChunks == 0) { end = m_throughput.transmissionEnd.at (index)/(double)1000000; }
-        segBytes += m_throughput.bytesReceived.at(index);
-        countChunks++;
-        if(countChunks >= chunks) {
-          start = m_throughput.transmissionRequested.at (index)/(double)1000000;
-          lengthOfInterval = end - start;
-          transmissionTime += lengthOfInterval;
-          sumThroughput += segBytes;
-          segBytes = 0.0;
-          countChunks = 0;
-        }
-        count++;
-        if((chunks == 0 && count > 4) || (chunks > 0 && count >= (5*chunks))) break;
-      }      
-    }
-
-    return (sumThroughput*8 / (double)transmissionTime);
-
-  }
-
   void BolaAlgo::calculateBolaParameters() {
       
     int highestUtilityIndex = 0;
@@ -218,7 +182,7 @@ namespace ns3 {
         break;
       }
     }
-    if(std::isnan(bitrate)) { quality = 0; }
+    if(std::isnan(bitrate) || quality < 0) { quality = 0; }
     return quality;
   }
   
@@ -12,9 +12,14 @@ public:
 
   algorithmReply GetNextRep ( const int64_t segmentCounter, int64_t clientId);
 
+protected:
+  /**
+   * \return a byte weighted harmonic mean of the last 5 segments
+   */
+  Ptr<BandwidthEstimator> CreateBandwidthEstimator (void) const;
+
 private:
 
-  const int64_t m_highestRepIndex;
   int64_t m_lastRepIndex;
   
   const int BOLA_STATE_INIT = -1;
@@ -28,10 +33,9 @@ private:
   double Vp = 0;
   double gp = 0;
   
-  double utilities [10];
-  double bitrates [10];
+  std::vector<double> utilities;
+  std::vector<double> bitrates;
   
-  double AverageSegmentThroughput (int64_t currentSegment);
   void calculateBolaParameters();
   int getQualityFromBufferLevel(double bufferLevel);
   double maxBufferLevelForQuality(int quality);
@@ -17,6 +17,7 @@
  */
 
 #include "festive.h"
+#include "ns3/uinteger.h"
 
 namespace ns3 {
 
@@ -29,7 +30,6 @@ FestiveAlgorithm::FestiveAlgorithm (int64_t chunks, int cmaf) :
   m_targetBuf (30000000),
   m_delta (m_videoData.segmentDuration),
   m_alpha (12.0),
-  m_highestRepIndex (8 - 1),
   m_thrptThrsh (0.85),
   chunks(chunks),
   cmaf(cmaf)
@@ -37,7 +37,13 @@ FestiveAlgorithm::FestiveAlgorithm (int64_t chunks, int cmaf) :
   NS_LOG_INFO (this);
   m_smooth.push_back (1);  // after how many steps switch up is possible
   m_smooth.push_back (1);  // switch up by how many representatations at once
-  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be => 0");
+  SetThroughputSampling (cmaf == 2 ? 0 : chunks, cmaf == 3, true);
+}
+
+Ptr<BandwidthEstimator>
+FestiveAlgorithm::CreateBandwidthEstimator (void) const
+{
+  return CreateObjectWithAttributes<HarmonicBandwidthEstimator> ("WindowSize", UintegerValue (20));
 }
 
 algorithmReply
@@ -79,106 +85,7 @@ FestiveAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
     return answer;
   }
 
-  std::vector<double> thrptEstimationTmp;
-  if(chunks > 0) {
-	  
-	  double tempBytes = 0;
-	  double tempTime = 0;
-	  
-	  
-	  if(cmaf == 3) {
-		  
-		  double startTime = 0;
-		  double endTime = 0;
-		  bool last = true;
-		  for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; )
-			{
-
-			  if (m_throughput.bytesReceived.at (sd) == 0)
-				{
-				  continue;
-				}
-			  else
-				{
-				  if((sd % chunks) == 0) {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  startTime = m_throughput.transmissionRequested.at (sd);
-					  double time = (endTime-startTime) / 1000000.0;
-					  thrptEstimationTmp.push_back((8*tempBytes)/(time));
-					  tempBytes = 0;
-					  last = true;
-				  }
-				  else {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  if(last) {
-						  endTime = m_throughput.transmissionEnd.at (sd);
-						  last = false;
-					  }
-				  }
-
-				}
-			  if (thrptEstimationTmp.size () == 20)
-				{
-				  break;
-				}
-			}
-		  
-	  } else {
-	  
-		  for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; )
-			{
-			  if (m_throughput.bytesReceived.at (sd) == 0)
-				{
-				  continue;
-				}
-			  else
-				{
-				  if((sd % chunks) == 0) {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  tempTime += ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0));
-					  thrptEstimationTmp.push_back((8*tempBytes)/(tempTime));
-					  tempBytes = 0;
-					  tempTime = 0;
-				  }
-				  else {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  tempTime += ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0));
-				  }
-
-				}
-			  if (thrptEstimationTmp.size () == 20)
-				{
-				  break;
-				}
-			}
-	    }
-	  
-  } else {
-	  for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; )
-		{
-		  if (m_throughput.bytesReceived.at (sd) == 0)
-			{
-			  continue;
-			}
-		  else
-			{
-			  thrptEstimationTmp.push_back ((8.0 * m_throughput.bytesReceived.at (sd))
-											/ ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0)));
-			}
-		  if (thrptEstimationTmp.size () == 20)
-			{
-			  break;
-			}
-		}
-  }
-  // calculate harmonic mean of values in thrptEstimationTmp
-  double harmonicMeanDenominator = 0;
-  for (uint i = 0; i < thrptEstimationTmp.size (); i++)
-  {
-    harmonicMeanDenominator += 1 / (thrptEstimationTmp.at (i));
-  }
-  double thrptEstimation = thrptEstimationTmp.size () / harmonicMeanDenominator;
-  thrptEstimation = thrptEstimation * m_thrptThrsh;
+  double thrptEstimation = GetBandwidthEstimator ()->GetEstimate ().GetBitRate () * m_thrptThrsh;
   answer.bandwidthEstimate = thrptEstimation/(double)1000000;
 
   // compute b_delay
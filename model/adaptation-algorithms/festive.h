@@ -34,11 +34,16 @@ public:
 
   algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
 
+protected:
+  /**
+   * \return a harmonic mean of the last 20 segments
+   */
+  Ptr<BandwidthEstimator> CreateBandwidthEstimator (void) const;
+
 private:
   const int64_t m_targetBuf;
   int64_t m_delta;
   const double m_alpha;
-  const int64_t m_highestRepIndex;
   const double m_thrptThrsh;
   std::vector<int> m_smooth;
   std::list<int>  switchHistory;
@@ -1,5 +1,6 @@
 #include "fuzzy-algorithm-server.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
 
 namespace ns3 {
@@ -14,7 +15,13 @@ FuzzyAlgorithmServer::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::FuzzyAlgorithmServer")
                           .SetParent<AdaptationAlgorithmServer> ()
                           .SetGroupName ("Applications")
-                          .AddConstructor<FuzzyAlgorithmServer> ();
+                          .AddConstructor<FuzzyAlgorithmServer> ()
+                          .AddAttribute ("FuzzyEngine",
+                                         "The fuzzy engine of the algorithm, null for the "
+                                         "default rules",
+                                         PointerValue (0),
+                                         MakePointerAccessor (&FuzzyAlgorithmServer::m_engine),
+                                         MakePointerChecker<FuzzyEngine> ());
   return tid;
 }
 
@@ -28,87 +35,41 @@ FuzzyAlgorithmServer::~FuzzyAlgorithmServer ()
   NS_LOG_FUNCTION (this);
 }
 
-DataRate
-FuzzyAlgorithmServer::adaptation_algorithm (double buffOcc, double diffBuffOcc, DataRate lastRate)
+void
+FuzzyAlgorithmServer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_engine = 0;
+  AdaptationAlgorithmServer::DoDispose ();
+}
 
-  double empty = 0, ok = 0, full = 0, falling = 0, steady = 0, rising = 0;
-
-  double targetBuffOcc = 2000; //bytes
-
-  if (buffOcc == 0)
-    {
-      empty = 1.0;
-    }
-  else if (buffOcc < targetBuffOcc)
-    {
-      empty = 1.0 - ((double) buffOcc) / targetBuffOcc;
-      ok = ((double) buffOcc) / targetBuffOcc;
-    }
-  else if (buffOcc < 2 * targetBuffOcc)
-    {
-      ok = 1 - ((double) buffOcc - targetBuffOcc) / targetBuffOcc;
-      full = ((double) buffOcc - targetBuffOcc) / targetBuffOcc;
-    }
-  else
-    {
-      full = 1;
-    }
-
-  if (diffBuffOcc < -targetBuffOcc)
-    {
-      falling = 1;
-    }
-  else if (diffBuffOcc < 0)
-    {
-      falling = -((double) diffBuffOcc) / targetBuffOcc;
-      steady = 1 + ((double) diffBuffOcc) / targetBuffOcc;
-    }
-  else if (diffBuffOcc < targetBuffOcc)
-    {
-      steady = 1 - ((double) diffBuffOcc) / targetBuffOcc;
-      rising = ((double) diffBuffOcc) / targetBuffOcc;
-    }
-  else
+Ptr<FuzzyEngine>
+FuzzyAlgorithmServer::GetFuzzyEngine (void)
+{
+  if (!m_engine)
     {
-      rising = 1;
+      // buffer occupancy {empty, ok, full} and its variation {falling,
+      // steady, rising} around a 2000 bytes target
+      m_engine = CreateObject<FuzzyEngine> ();
+      m_engine->SetPartitions ("0 2000 4000; -2000 0 2000");
+      m_engine->SetRules ("4 3 2 "
+                          "3 2 1 "
+                          "2 1 0");
+      m_engine->SetOutputs ("0.25 0.5 1 2 4");
     }
+  return m_engine;
+}
 
-  double r1 = std::min (full, rising);
-  double r2 = std::min (ok, rising);
-  double r3 = std::min (empty, rising);
-  double r4 = std::min (full, steady);
-  double r5 = std::min (ok, steady);
-  double r6 = std::min (empty, steady);
-  double r7 = std::min (full, falling);
-  double r8 = std::min (ok, falling);
-  double r9 = std::min (empty, falling);
-
-  double R = std::sqrt (std::pow (r1, 2));
-  double SR = std::sqrt (std::pow (r2, 2) + std::pow (r4, 2));
-  double NC = std::sqrt (std::pow (r3, 2) + std::pow (r5, 2) + std::pow (r7, 2));
-  double SI = std::sqrt (std::pow (r6, 2) + std::pow (r8, 2));
-  double I = std::sqrt (std::pow (r9, 2));
-
-  double N2 = 0.25, N1 = 0.5, Z = 1, P1 = 2, P2 = 4;
-
-  double output = (R * N2 + SR * N1 + NC * Z + SI * P1 + I * P2) / (R + SR + NC + SI + I);
-
-  NS_LOG_DEBUG ("empty " << empty << " ok " << ok << " full " << full << " falling " << falling
-                         << " steady " << steady << " rising " << rising << " output " << output);
-
-  DataRate result_non_quant = DataRate(output * lastRate.GetBitRate ());
+DataRate
+FuzzyAlgorithmServer::adaptation_algorithm (double buffOcc, double diffBuffOcc, DataRate lastRate)
+{
+  NS_LOG_FUNCTION (this);
 
-  std::vector<DataRate> averageBitrate = { 3128000, 3254000, 3974000, 4496000, 6408000, 10938000, 17156000, 35018000 };
+  double output = GetFuzzyEngine ()->Evaluate (buffOcc, diffBuffOcc);
 
-  for (uint32_t i = 1; i < averageBitrate.size(); i++) {
-    if (averageBitrate[i] > result_non_quant) {
-      return averageBitrate[i - 1];
-    }
-  }
+  NS_LOG_DEBUG ("buffOcc " << buffOcc << " diffBuffOcc " << diffBuffOcc << " output " << output);
 
-  return averageBitrate[averageBitrate.size() - 1];
+  return GetBitrateLadder ()->Quantize (DataRate (output * lastRate.GetBitRate ()));
 }
 
 } // namespace ns3
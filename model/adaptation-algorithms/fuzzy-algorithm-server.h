@@ -5,6 +5,7 @@
 #include "ns3/tcp-socket-base.h"
 #include "ns3/packet.h"
 #include "adaptation-algorithm-server.h"
+#include "fuzzy-engine.h"
 
 namespace ns3 {
 
@@ -16,8 +17,22 @@ public:
   FuzzyAlgorithmServer ();
   virtual ~FuzzyAlgorithmServer ();
 
+  /**
+   * \return the fuzzy engine of the algorithm, created with the default
+   * rules on first use if none was set
+   *
+   * The inputs of the engine are the send buffer occupancy and its variation,
+   * in bytes, and its output multiplies the last rate.
+   */
+  Ptr<FuzzyEngine> GetFuzzyEngine (void);
+
+protected:
+  virtual void DoDispose (void);
+
 private:
   DataRate adaptation_algorithm (double buffOcc, double diffBuffOcc, DataRate lastRate);
+
+  Ptr<FuzzyEngine> m_engine; //!< fuzzy engine, null until first use
 };
 
 } // namespace ns3
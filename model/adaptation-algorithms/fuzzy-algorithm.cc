@@ -1,12 +1,32 @@
 #include "fuzzy-algorithm.h"
 #include "ns3/log.h"
 #include "../seq-ts-size-frag-header.h"
+#include "../vr-app-profiler.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FuzzyAlgorithm");
 
+NS_OBJECT_ENSURE_REGISTERED (FuzzyAlgorithm);
+
+TypeId
+FuzzyAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FuzzyAlgorithm")
+                          .SetParent<ReceiverRateController> ()
+                          .SetGroupName ("Applications")
+                          .AddConstructor<FuzzyAlgorithm> ()
+                          .AddAttribute ("FuzzyEngine",
+                                         "The fuzzy engine of the controller, null for the "
+                                         "default rules",
+                                         PointerValue (0),
+                                         MakePointerAccessor (&FuzzyAlgorithm::m_engine),
+                                         MakePointerChecker<FuzzyEngine> ());
+  return tid;
+}
+
 FuzzyAlgorithm::FuzzyAlgorithm ()
 {
   NS_LOG_FUNCTION (this);
@@ -17,6 +37,31 @@ FuzzyAlgorithm::~FuzzyAlgorithm ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+FuzzyAlgorithm::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_engine = 0;
+  ReceiverRateController::DoDispose ();
+}
+
+Ptr<FuzzyEngine>
+FuzzyAlgorithm::GetFuzzyEngine (void)
+{
+  if (!m_engine)
+    {
+      // delay {slow, ok, fast} and delay trend {falling, steady, rising}
+      // around a 10 ms target
+      m_engine = CreateObject<FuzzyEngine> ();
+      m_engine->SetPartitions ("6.666666666666667 10 40; -6.666666666666667 0 40");
+      m_engine->SetRules ("4 3 2 "
+                          "3 2 1 "
+                          "2 1 0");
+      m_engine->SetOutputs ("0.25 0.5 1 2 4");
+    }
+  return m_engine;
+}
+
 DataRate
 FuzzyAlgorithm::fragmentReceived (const Ptr<Packet> &f)
 {
@@ -34,6 +79,7 @@ FuzzyAlgorithm::fragmentReceived (const Ptr<Packet> &f)
 
   m_rateBuffer.insert (std::pair<Time, std::pair<uint32_t, Time>> (
       Simulator::Now (), std::pair<uint32_t, Time> (m_fragment_size, delay)));
+  VR_APP_PROFILE (ALGORITHM, MAP_INSERTION);
 
   DataRate instant_throughput = DataRate (
       m_fragment_size * 8 / (Simulator::Now () - m_lastFragmentTime).GetSeconds ());
@@ -106,77 +152,11 @@ FuzzyAlgorithm::fuzzyAlgorithm (Time delay, Time diffDelay, DataRate avgRate)
 {
   NS_LOG_FUNCTION (this << delay << diffDelay << avgRate);
 
-  double slow = 0, ok = 0, fast = 0, falling = 0, steady = 0, rising = 0, r1 = 0, r2 = 0, r3 = 0,
-         r4 = 0, r5 = 0, r6 = 0, r7 = 0, r8 = 0, r9 = 0, p2 = 0, p1 = 0, z = 0, n1 = 0, n2 = 0,
-         output = 0;
-
-  Time target_delay = MilliSeconds (10);
-
-  double t = target_delay.GetSeconds ();
-  double t_diff = target_delay.GetSeconds ();
-
-  double currDt = delay.GetSeconds ();
-  double diff = diffDelay.GetSeconds ();
-
-  if (currDt < 2 * t / 3)
-    {
-      slow = 1.0;
-    }
-  else if (currDt < t)
-    {
-      slow = 1 - 1 / (t / 3) * (currDt - 2 * t / 3);
-      ok = 1 / (t / 3) * (currDt - 2 * t / 3);
-    }
-  else if (currDt < 4 * t)
-    {
-      ok = 1 - 1 / (3 * t) * (currDt - t);
-      fast = 1 / (3 * t) * (currDt - t);
-    }
-  else
-    {
-      fast = 1;
-    }
-
-  if (diff < -2 * t_diff / 3)
-    {
-      falling = 1;
-    }
-  else if (diff < 0)
-    {
-      falling = 1 - 1 / (2 * t_diff / 3) * (diff + 2 * t_diff / 3);
-      steady = 1 / (2 * t_diff / 3) * (diff + 2 * t_diff / 3);
-    }
-  else if (diff < 4 * t_diff)
-    {
-      steady = 1 - 1 / (4 * t_diff) * diff;
-      rising = 1 / (4 * t_diff) * diff;
-    }
-  else
-    {
-      rising = 1;
-    }
+  double output =
+      GetFuzzyEngine ()->Evaluate (delay.GetSeconds () * 1e3, diffDelay.GetSeconds () * 1e3);
 
-  r9 = std::min (slow, falling);
-  r8 = std::min (ok, falling);
-  r7 = std::min (fast, falling);
-  r6 = std::min (slow, steady);
-  r5 = std::min (ok, steady);
-  r4 = std::min (fast, steady);
-  r3 = std::min (slow, rising);
-  r2 = std::min (ok, rising);
-  r1 = std::min (fast, rising);
-
-  p2 = std::sqrt (std::pow (r9, 2));
-  p1 = std::sqrt (std::pow (r6, 2) + std::pow (r8, 2));
-  z = std::sqrt (std::pow (r3, 2) + std::pow (r5, 2) + std::pow (r7, 2));
-  n1 = std::sqrt (std::pow (r2, 2) + std::pow (r4, 2));
-  n2 = std::sqrt (std::pow (r1, 2));
-
-  /*output = (n2 * 0.25 + n1 * 0.5 + z * 1 + p1 * 1.4 + p2 * 2)*/
-  output = (n2 * 0.25 + n1 * 0.5 + z * 1 + p1 * 2 + p2 * 4) / (n2 + n1 + z + p1 + p2);
-
-  NS_LOG_DEBUG ("slow " << slow << " ok " << ok << " fast " << fast << " falling " << falling
-                        << " steady " << steady << " rising " << rising << " output " << output);
+  NS_LOG_DEBUG ("delay " << delay.As (Time::MS) << " diff " << diffDelay.As (Time::MS)
+                         << " output " << output);
 
   return DataRate (output * avgRate.GetBitRate ());
 }
@@ -1,23 +1,45 @@
 #ifndef FUZZY_ALGORITHM_H
 #define FUZZY_ALGORITHM_H
 
+#include "fuzzy-engine.h"
+#include "receiver-rate-controller.h"
 #include "ns3/data-rate.h"
 #include "ns3/packet.h"
 #include <map>
 
 namespace ns3 {
 
-class FuzzyAlgorithm
+class FuzzyAlgorithm : public ReceiverRateController
 {
 public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
   FuzzyAlgorithm ();
   virtual ~FuzzyAlgorithm ();
 
-  DataRate fragmentReceived (const Ptr<Packet> &f);
+  virtual DataRate fragmentReceived (const Ptr<Packet> &f);
+
+  /**
+   * \return the fuzzy engine of the controller, created with the default
+   * rules on first use if none was set
+   *
+   * The inputs of the engine are the average delay and the delay trend over
+   * the last 140 ms, in ms, and its output multiplies the received rate.
+   */
+  Ptr<FuzzyEngine> GetFuzzyEngine (void);
+
+protected:
+  virtual void DoDispose (void);
 
 private:
   DataRate fuzzyAlgorithm (Time delay, Time diffDelay, DataRate avgRate);
 
+  Ptr<FuzzyEngine> m_engine; //!< fuzzy engine, null until first use
+
   Time m_lastFragmentTime;
   Time m_startedAt;
   std::multimap<Time, std::tuple<uint64_t, Time>> m_rateBuffer;
@@ -0,0 +1,278 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fuzzy-engine.h"
+
+#include "ns3/csv-reader.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FuzzyEngine");
+
+NS_OBJECT_ENSURE_REGISTERED(FuzzyEngine);
+
+namespace
+{
+
+/**
+ * \brief Parse a list of whitespace-separated numbers
+ * \param str the list
+ * \return the numbers
+ */
+template <typename T>
+std::vector<T>
+ParseList(const std::string& str)
+{
+    std::istringstream is(str);
+    std::vector<T> values;
+    T value;
+    while (is >> value)
+    {
+        values.push_back(value);
+    }
+    NS_ABORT_MSG_IF(!is.eof(), "Invalid number in \"" << str << "\"");
+    return values;
+}
+
+} // namespace
+
+FuzzyPartition::FuzzyPartition(const std::vector<double>& breakpoints)
+    : m_breakpoints(breakpoints)
+{
+    NS_ABORT_MSG_IF(m_breakpoints.size() < 2, "A fuzzy partition needs at least two sets");
+    NS_ABORT_MSG_IF(std::adjacent_find(m_breakpoints.begin(),
+                                       m_breakpoints.end(),
+                                       std::greater_equal<double>()) != m_breakpoints.end(),
+                    "The breakpoints of a fuzzy partition must be increasing");
+}
+
+TypeId
+FuzzyEngine::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FuzzyEngine")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<FuzzyEngine>()
+            .AddAttribute("Partitions",
+                          "The breakpoints of the fuzzy sets of each input, separated by ';'",
+                          StringValue(""),
+                          MakeStringAccessor(&FuzzyEngine::SetPartitions),
+                          MakeStringChecker())
+            .AddAttribute("Rules",
+                          "The output index of each rule, row-major over the input sets",
+                          StringValue(""),
+                          MakeStringAccessor(&FuzzyEngine::SetRules),
+                          MakeStringChecker())
+            .AddAttribute("Outputs",
+                          "The output singletons",
+                          StringValue(""),
+                          MakeStringAccessor(&FuzzyEngine::SetOutputs),
+                          MakeStringChecker())
+            .AddAttribute("Aggregation",
+                          "The aggregation of the strengths of the rules sharing an output",
+                          EnumValue(FuzzyEngine::ROOT_SUM_SQUARE),
+                          MakeEnumAccessor<Aggregation>(&FuzzyEngine::SetAggregation),
+                          MakeEnumChecker(FuzzyEngine::ROOT_SUM_SQUARE,
+                                          "RootSumSquare",
+                                          FuzzyEngine::MAXIMUM,
+                                          "Maximum",
+                                          FuzzyEngine::SUM,
+                                          "Sum"))
+            .AddAttribute("RuleFile",
+                          "A CSV file with the whole configuration, overriding the other "
+                          "attributes",
+                          StringValue(""),
+                          MakeStringAccessor(&FuzzyEngine::Load),
+                          MakeStringChecker());
+    return tid;
+}
+
+FuzzyEngine::FuzzyEngine()
+    : m_aggregation(ROOT_SUM_SQUARE),
+      m_valid(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FuzzyEngine::~FuzzyEngine()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FuzzyEngine::SetPartitions(std::string partitions)
+{
+    NS_LOG_FUNCTION(this << partitions);
+    if (partitions.empty())
+    {
+        return;
+    }
+    m_partitions.clear();
+    std::istringstream is(partitions);
+    std::string partition;
+    while (std::getline(is, partition, ';'))
+    {
+        m_partitions.emplace_back(ParseList<double>(partition));
+    }
+    Update();
+}
+
+void
+FuzzyEngine::SetRules(std::string rules)
+{
+    NS_LOG_FUNCTION(this << rules);
+    if (rules.empty())
+    {
+        return;
+    }
+    m_rules = ParseList<uint32_t>(rules);
+    Update();
+}
+
+void
+FuzzyEngine::SetOutputs(std::string outputs)
+{
+    NS_LOG_FUNCTION(this << outputs);
+    if (outputs.empty())
+    {
+        return;
+    }
+    m_outputs = ParseList<double>(outputs);
+    m_strengths.assign(m_outputs.size(), 0.0);
+    Update();
+}
+
+void
+FuzzyEngine::SetAggregation(Aggregation aggregation)
+{
+    NS_LOG_FUNCTION(this << aggregation);
+    m_aggregation = aggregation;
+}
+
+void
+FuzzyEngine::Load(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (filename.empty())
+    {
+        return;
+    }
+
+    std::string partitions;
+    std::string rules;
+    std::string outputs;
+    CsvReader csv(filename);
+    while (csv.FetchNextRow())
+    {
+        if (csv.IsBlankRow())
+        {
+            continue;
+        }
+
+        std::string keyword;
+        csv.GetValue(0, keyword);
+        std::string values;
+        for (std::size_t i = 1; i < csv.ColumnCount(); i++)
+        {
+            std::string value;
+            csv.GetValue(i, value);
+            values += value + " ";
+        }
+
+        if (keyword == "partition")
+        {
+            partitions += (partitions.empty() ? "" : ";") + values;
+        }
+        else if (keyword == "rules")
+        {
+            rules += values;
+        }
+        else if (keyword == "outputs")
+        {
+            outputs += values;
+        }
+        else if (keyword == "aggregation")
+        {
+            std::istringstream is(values);
+            std::string aggregation;
+            is >> aggregation;
+            if (aggregation == "rss")
+            {
+                m_aggregation = ROOT_SUM_SQUARE;
+            }
+            else if (aggregation == "max")
+            {
+                m_aggregation = MAXIMUM;
+            }
+            else if (aggregation == "sum")
+            {
+                m_aggregation = SUM;
+            }
+            else
+            {
+                NS_ABORT_MSG("Wrong aggregation: " << aggregation << " on line "
+                                                   << csv.RowNumber() << " of file "
+                                                   << filename);
+            }
+        }
+        else
+        {
+            NS_ABORT_MSG("Wrong keyword: " << keyword << " on line " << csv.RowNumber()
+                                           << " of file " << filename);
+        }
+    }
+
+    NS_ABORT_MSG_IF(partitions.empty() || rules.empty() || outputs.empty(),
+                    "Incomplete fuzzy engine configuration in file " << filename);
+    SetPartitions(partitions);
+    SetRules(rules);
+    SetOutputs(outputs);
+    NS_ABORT_MSG_IF(!m_valid, "Inconsistent fuzzy engine configuration in file " << filename);
+    NS_LOG_INFO("Loaded " << m_partitions.size() << " inputs, " << m_rules.size() << " rules and "
+                          << m_outputs.size() << " outputs from file " << filename);
+}
+
+uint32_t
+FuzzyEngine::GetInputCount() const
+{
+    return m_partitions.size();
+}
+
+void
+FuzzyEngine::Update()
+{
+    // the configuration may be inconsistent while it is being changed one
+    // attribute at a time, Evaluate aborts if it still is
+    uint32_t rules = 1;
+    m_strides.assign(m_partitions.size(), 0);
+    for (std::size_t i = m_partitions.size(); i-- > 0;)
+    {
+        m_strides[i] = rules;
+        rules *= m_partitions[i].GetSize();
+    }
+
+    m_valid = !m_partitions.empty() && !m_outputs.empty() && m_rules.size() == rules &&
+              *std::max_element(m_rules.begin(), m_rules.end()) < m_outputs.size();
+}
+
+} // namespace ns3
@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FUZZY_ENGINE_H
+#define FUZZY_ENGINE_H
+
+#include "ns3/abort.h"
+#include "ns3/object.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Fuzzy partition of an input of a FuzzyEngine
+ *
+ * The partition is defined by N increasing breakpoints b_0 .. b_{N-1}, one per
+ * fuzzy set: set k is a triangle with peak at b_k and feet at b_{k-1} and
+ * b_{k+1}, and the first and last sets are shoulders, i.e., they are 1 below
+ * b_0 and above b_{N-1}, respectively. The memberships of any value sum to 1
+ * and at most two adjacent sets are non-zero, so that fuzzifying a value is a
+ * binary search and an interpolation, whatever the number of sets.
+ */
+class FuzzyPartition
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param breakpoints the peaks of the fuzzy sets, at least two, increasing
+     */
+    FuzzyPartition(const std::vector<double>& breakpoints);
+
+    /**
+     * \return the number of fuzzy sets
+     */
+    uint32_t GetSize() const
+    {
+        return m_breakpoints.size();
+    }
+
+    /**
+     * \brief Fuzzify a value
+     * \param x the value
+     * \param [out] lower the lower of the two sets x may belong to
+     * \param [out] weight the membership of x to set lower + 1, the membership
+     *              to set lower being 1 - weight
+     */
+    void Fuzzify(double x, uint32_t& lower, double& weight) const
+    {
+        uint32_t i = std::upper_bound(m_breakpoints.begin(), m_breakpoints.end(), x) -
+                     m_breakpoints.begin();
+        if (i == 0)
+        {
+            lower = 0;
+            weight = 0;
+        }
+        else if (i == m_breakpoints.size())
+        {
+            lower = i - 2;
+            weight = 1;
+        }
+        else
+        {
+            lower = i - 1;
+            weight = (x - m_breakpoints[i - 1]) / (m_breakpoints[i] - m_breakpoints[i - 1]);
+        }
+    }
+
+  private:
+    std::vector<double> m_breakpoints; //!< peaks of the fuzzy sets
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Zero-order Sugeno fuzzy inference engine, configured by data
+ *
+ * The engine is defined by:
+ * - one FuzzyPartition per input (Partitions attribute, the breakpoints of each
+ *   input separated by ';');
+ * - a rule table, with one rule for each combination of input sets, listing
+ *   the index of the output singleton of the rule (Rules attribute, row-major,
+ *   i.e., the sets of the last input vary fastest);
+ * - the output singletons (Outputs attribute).
+ *
+ * The firing strength of a rule is the minimum of the memberships of its
+ * input sets, the strengths of the rules sharing an output are aggregated
+ * (root sum of squares, maximum or sum), and the output is the average of
+ * the singletons weighted by the aggregated strengths.
+ *
+ * The configuration can also be loaded from a CSV file (RuleFile attribute),
+ * where each row starts with a keyword: one "partition" row per input with its
+ * breakpoints, a "rules" row, an "outputs" row and an optional "aggregation"
+ * row (rss, max or sum).
+ *
+ * Since the partitions are strong, only the 2^N rules around the input point
+ * can fire: Evaluate is a template on the number of inputs N, so that the
+ * loop over these rules is unrolled at compile time, and it neither allocates
+ * nor scans the rule table.
+ */
+class FuzzyEngine : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /// Aggregation of the strengths of the rules sharing an output
+    enum Aggregation
+    {
+        ROOT_SUM_SQUARE,
+        MAXIMUM,
+        SUM
+    };
+
+    FuzzyEngine();
+    ~FuzzyEngine() override;
+
+    /**
+     * \brief Set the input partitions
+     * \param partitions the breakpoints of each input, separated by ';'
+     */
+    void SetPartitions(std::string partitions);
+
+    /**
+     * \brief Set the rule table
+     * \param rules the output index of each rule, row-major
+     */
+    void SetRules(std::string rules);
+
+    /**
+     * \brief Set the output singletons
+     * \param outputs the output values
+     */
+    void SetOutputs(std::string outputs);
+
+    /**
+     * \brief Set the aggregation of the rule strengths
+     * \param aggregation the aggregation
+     */
+    void SetAggregation(Aggregation aggregation);
+
+    /**
+     * \brief Load the configuration from a file
+     * \param filename the file, ignored if empty
+     */
+    void Load(std::string filename);
+
+    /**
+     * \return the number of inputs
+     */
+    uint32_t GetInputCount() const;
+
+    /**
+     * \brief Evaluate the engine
+     * \param inputs the value of each input
+     * \return the weighted average of the output singletons
+     */
+    template <std::size_t N>
+    double Evaluate(const std::array<double, N>& inputs) const;
+
+    /**
+     * \brief Evaluate a two-input engine
+     * \param x the first input
+     * \param y the second input
+     * \return the weighted average of the output singletons
+     */
+    double Evaluate(double x, double y) const
+    {
+        return Evaluate<2>({x, y});
+    }
+
+  private:
+    /**
+     * \brief Check the consistency of the configuration and compute the rule strides
+     */
+    void Update();
+
+    std::vector<FuzzyPartition> m_partitions; //!< partition of each input
+    std::vector<uint32_t> m_rules;            //!< output index of each rule
+    std::vector<double> m_outputs;            //!< output singletons
+    Aggregation m_aggregation;                //!< aggregation of the rule strengths
+    std::vector<uint32_t> m_strides;          //!< rule table stride of each input
+    bool m_valid;                             //!< whether the configuration is consistent
+
+    mutable std::vector<double> m_strengths; //!< aggregated strength of each output
+};
+
+template <std::size_t N>
+double
+FuzzyEngine::Evaluate(const std::array<double, N>& inputs) const
+{
+    NS_ABORT_MSG_IF(!m_valid || m_partitions.size() != N,
+                    "FuzzyEngine not configured for " << N << " inputs");
+
+    std::array<uint32_t, N> lower;
+    std::array<double, N> weight;
+    for (std::size_t i = 0; i < N; i++)
+    {
+        m_partitions[i].Fuzzify(inputs[i], lower[i], weight[i]);
+    }
+
+    std::fill(m_strengths.begin(), m_strengths.end(), 0.0);
+    for (uint32_t corner = 0; corner < (1u << N); corner++)
+    {
+        double strength = 1;
+        uint32_t rule = 0;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            uint32_t upper = (corner >> i) & 1;
+            strength = std::min(strength, upper ? weight[i] : 1 - weight[i]);
+            rule += (lower[i] + upper) * m_strides[i];
+        }
+        double& aggregated = m_strengths[m_rules[rule]];
+        switch (m_aggregation)
+        {
+        case ROOT_SUM_SQUARE:
+            aggregated += strength * strength;
+            break;
+        case MAXIMUM:
+            aggregated = std::max(aggregated, strength);
+            break;
+        case SUM:
+            aggregated += strength;
+            break;
+        }
+    }
+
+    double num = 0;
+    double den = 0;
+    for (std::size_t k = 0; k < m_outputs.size(); k++)
+    {
+        double strength = m_aggregation == ROOT_SUM_SQUARE && m_strengths[k] > 0
+                              ? std::sqrt(m_strengths[k])
+                              : m_strengths[k];
+        num += strength * m_outputs[k];
+        den += strength;
+    }
+    return num / den;
+}
+
+} // namespace ns3
+
+#endif /* FUZZY_ENGINE_H */
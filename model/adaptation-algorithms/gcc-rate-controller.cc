@@ -0,0 +1,444 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gcc-rate-controller.h"
+
+#include "../seq-ts-size-frag-header.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GccRateController");
+
+NS_OBJECT_ENSURE_REGISTERED(GccRateController);
+
+TypeId
+GccRateController::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::GccRateController")
+            .SetParent<ReceiverRateController>()
+            .SetGroupName("Applications")
+            .AddConstructor<GccRateController>()
+            .AddAttribute("ProcessNoise",
+                          "The variance of the state noise of the arrival-time filter [ms^2]",
+                          DoubleValue(1e-3),
+                          MakeDoubleAccessor(&GccRateController::m_processNoise),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("Chi",
+                          "The filter coefficient of the measurement noise variance",
+                          DoubleValue(0.01),
+                          MakeDoubleAccessor(&GccRateController::m_chi),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("InitialThreshold",
+                          "The initial over-use threshold [ms]",
+                          DoubleValue(12.5),
+                          MakeDoubleAccessor(&GccRateController::m_initialThreshold),
+                          MakeDoubleChecker<double>(6, 600))
+            .AddAttribute("ThresholdGainUp",
+                          "The gain of the adaptive threshold when the delay gradient exceeds it",
+                          DoubleValue(0.01),
+                          MakeDoubleAccessor(&GccRateController::m_thresholdGainUp),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("ThresholdGainDown",
+                          "The gain of the adaptive threshold when the delay gradient is below it",
+                          DoubleValue(0.00018),
+                          MakeDoubleAccessor(&GccRateController::m_thresholdGainDown),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("OverusingTime",
+                          "The time the delay gradient has to exceed the threshold to signal "
+                          "over-use",
+                          TimeValue(MilliSeconds(10)),
+                          MakeTimeAccessor(&GccRateController::m_overusingTime),
+                          MakeTimeChecker())
+            .AddAttribute("Beta",
+                          "The fraction of the incoming rate the rate is set to on over-use",
+                          DoubleValue(0.85),
+                          MakeDoubleAccessor(&GccRateController::m_beta),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("IncreaseFactor",
+                          "The multiplicative increase of the rate per second",
+                          DoubleValue(1.08),
+                          MakeDoubleAccessor(&GccRateController::m_increaseFactor),
+                          MakeDoubleChecker<double>(1))
+            .AddAttribute("RateWindow",
+                          "The window the incoming rate is measured over",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&GccRateController::m_rateWindow),
+                          MakeTimeChecker())
+            .AddAttribute("LossInterval",
+                          "The interval the loss fraction is computed over",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&GccRateController::m_lossInterval),
+                          MakeTimeChecker())
+            .AddAttribute("MinRate",
+                          "The lower bound of the target rate",
+                          DataRateValue(DataRate("1Mbps")),
+                          MakeDataRateAccessor(&GccRateController::m_minRate),
+                          MakeDataRateChecker())
+            .AddTraceSource("Update",
+                            "The controller has been updated with a packet group",
+                            MakeTraceSourceAccessor(&GccRateController::m_updateTrace),
+                            "ns3::GccRateController::UpdateTracedCallback");
+    return tid;
+}
+
+GccRateController::GccRateController()
+    : m_windowBytes(0),
+      m_incomingRate(0),
+      m_avgFragmentBits(0),
+      m_groupStarted(false),
+      m_groupSeq(0),
+      m_prevGroup(false),
+      m_gradient(0),
+      m_prevGradient(0),
+      m_trend(0),
+      m_deltas(0),
+      m_errorVariance(0.1),
+      m_noiseVariance(1),
+      m_threshold(12.5),
+      m_overuseStart(Seconds(-1)),
+      m_state(RC_HOLD),
+      m_rate(0),
+      m_avgMaxRate(0),
+      m_varMaxRate(0.01),
+      m_lossStarted(false),
+      m_lastSeq(0),
+      m_lastFragSeq(0),
+      m_lastFrags(0),
+      m_expected(0),
+      m_lost(0),
+      m_lossRate(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GccRateController::~GccRateController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+DataRate
+GccRateController::fragmentReceived(const Ptr<Packet>& f)
+{
+    NS_LOG_FUNCTION(this << f);
+
+    SeqTsSizeFragHeader header;
+    f->PeekHeader(header);
+    Time now = Simulator::Now();
+
+    UpdateIncomingRate(f->GetSize(), now);
+    UpdateLoss(header.GetSeq(), header.GetFragSeq(), header.GetFrags(), now);
+
+    if (!m_groupStarted)
+    {
+        m_groupStarted = true;
+        m_threshold = m_initialThreshold;
+        m_lastThresholdTime = now;
+    }
+    else if (header.GetSeq() == m_groupSeq)
+    {
+        m_groupArrival = now;
+        return GetTargetRate();
+    }
+    else if (header.GetSeq() < m_groupSeq)
+    {
+        // fragment of an older group, received out of order
+        return GetTargetRate();
+    }
+    else
+    {
+        // the first fragment of a new burst completes the current group
+        if (m_prevGroup)
+        {
+            UpdateGroups(now);
+        }
+        m_prevGroup = true;
+        m_prevSend = m_groupSend;
+        m_prevArrival = m_groupArrival;
+    }
+    m_groupSeq = header.GetSeq();
+    m_groupSend = header.GetTs();
+    m_groupArrival = now;
+
+    return GetTargetRate();
+}
+
+DataRate
+GccRateController::GetTargetRate() const
+{
+    return DataRate(uint64_t(std::min(m_rate, m_lossRate)));
+}
+
+void
+GccRateController::UpdateGroups(Time now)
+{
+    double sendDelta = (m_groupSend - m_prevSend).GetSeconds() * 1e3;
+    double arrivalDelta = (m_groupArrival - m_prevArrival).GetSeconds() * 1e3;
+    UpdateFilter(arrivalDelta - sendDelta, sendDelta);
+    BandwidthUsage usage = Detect(now);
+    UpdateRate(usage, now);
+
+    DataRate target = GetTargetRate();
+    NS_LOG_DEBUG("group " << m_groupSeq << " delta " << arrivalDelta - sendDelta
+                          << " ms trend " << m_trend << " ms threshold "
+                          << m_threshold << " ms usage " << usage << " state " << m_state
+                          << " incoming " << m_incomingRate / 1e6 << " Mbps target "
+                          << target.GetBitRate() / 1e6 << " Mbps");
+    m_updateTrace(m_trend, m_threshold, usage, target);
+}
+
+void
+GccRateController::UpdateIncomingRate(uint32_t bytes, Time now)
+{
+    if (m_arrivals.empty())
+    {
+        m_firstArrival = now;
+    }
+    m_arrivals.emplace_back(now, bytes);
+    m_windowBytes += bytes;
+    while (m_arrivals.front().first < now - m_rateWindow)
+    {
+        m_windowBytes -= m_arrivals.front().second;
+        m_arrivals.pop_front();
+    }
+
+    Time elapsed = std::min(m_rateWindow, now - m_firstArrival);
+    if (elapsed.IsStrictlyPositive())
+    {
+        m_incomingRate = m_windowBytes * 8 / elapsed.GetSeconds();
+    }
+    m_avgFragmentBits =
+        m_avgFragmentBits == 0 ? bytes * 8 : 0.9 * m_avgFragmentBits + 0.1 * bytes * 8;
+
+    if (m_rate == 0 && now - m_firstArrival >= m_rateWindow)
+    {
+        m_rate = m_incomingRate;
+        m_lossRate = m_incomingRate;
+        m_lastRateUpdate = now;
+        m_lossStart = now;
+        m_expected = 0;
+        m_lost = 0;
+    }
+}
+
+void
+GccRateController::UpdateLoss(uint64_t seq, uint16_t fragSeq, uint16_t frags, Time now)
+{
+    if (!m_lossStarted)
+    {
+        m_lossStarted = true;
+        m_lossStart = now;
+    }
+    else if (seq == m_lastSeq && fragSeq > m_lastFragSeq)
+    {
+        m_expected += fragSeq - m_lastFragSeq;
+        m_lost += fragSeq - m_lastFragSeq - 1;
+    }
+    else if (seq > m_lastSeq)
+    {
+        // tail of the last burst, whole bursts in between (assumed of the same
+        // size as the last one), and head of the new burst
+        uint64_t missing = m_lastFrags - 1 - m_lastFragSeq;
+        missing += (seq - m_lastSeq - 1) * m_lastFrags;
+        missing += fragSeq;
+        m_expected += missing + 1;
+        m_lost += missing;
+    }
+    else
+    {
+        // late fragment, already counted as lost
+        m_lost -= std::min<uint64_t>(m_lost, 1);
+        return;
+    }
+    m_lastSeq = seq;
+    m_lastFragSeq = fragSeq;
+    m_lastFrags = frags;
+
+    if (now - m_lossStart < m_lossInterval || m_expected == 0)
+    {
+        return;
+    }
+    double loss = double(m_lost) / m_expected;
+    if (m_lossRate > 0)
+    {
+        if (loss > 0.1)
+        {
+            m_lossRate *= 1 - 0.5 * loss;
+        }
+        else if (loss < 0.02)
+        {
+            m_lossRate *= 1.05;
+        }
+        m_lossRate = std::min(m_lossRate, 1.5 * m_incomingRate);
+        m_lossRate = std::max(m_lossRate, double(m_minRate.GetBitRate()));
+    }
+    NS_LOG_DEBUG("loss " << loss << " (" << m_lost << "/" << m_expected << ") loss-based rate "
+                         << m_lossRate / 1e6 << " Mbps");
+    m_expected = 0;
+    m_lost = 0;
+    m_lossStart = now;
+}
+
+void
+GccRateController::UpdateFilter(double delta, double sendDelta)
+{
+    double residual = delta - m_gradient;
+
+    // the measurement noise variance is filtered with a time constant of
+    // about 30 ms worth of groups; outliers are clamped to three standard
+    // deviations so that a single late group does not inflate it
+    double alpha = std::pow(1 - m_chi, 30 * std::max(sendDelta, 0.0) / 1e3);
+    double bound = 3 * std::sqrt(m_noiseVariance);
+    double clamped = std::max(-bound, std::min(bound, residual));
+    m_noiseVariance = std::max(alpha * m_noiseVariance + (1 - alpha) * clamped * clamped, 1.0);
+
+    double gain = (m_errorVariance + m_processNoise) /
+                  (m_noiseVariance + m_errorVariance + m_processNoise);
+    m_prevGradient = m_gradient;
+    m_gradient += gain * residual;
+    m_errorVariance = (1 - gain) * (m_errorVariance + m_processNoise);
+    m_deltas++;
+}
+
+GccRateController::BandwidthUsage
+GccRateController::Detect(Time now)
+{
+    // the gradient is scaled by the number of deltas it was estimated on, up
+    // to 60, i.e., compared with the threshold as the delay accumulated over
+    // the last groups
+    double scale = std::min<uint32_t>(m_deltas, 60);
+    m_trend = scale * m_gradient;
+
+    BandwidthUsage usage = BW_NORMAL;
+    if (m_trend > m_threshold)
+    {
+        if (m_overuseStart.IsNegative())
+        {
+            m_overuseStart = now;
+        }
+        if (now - m_overuseStart >= m_overusingTime && m_trend >= scale * m_prevGradient)
+        {
+            usage = BW_OVERUSING;
+        }
+    }
+    else
+    {
+        m_overuseStart = Seconds(-1);
+        if (m_trend < -m_threshold)
+        {
+            usage = BW_UNDERUSING;
+        }
+    }
+
+    // adaptive threshold, not updated on spikes far above it
+    double magnitude = std::abs(m_trend);
+    if (magnitude - m_threshold <= 15)
+    {
+        double dt = std::min((now - m_lastThresholdTime).GetSeconds() * 1e3, 100.0);
+        double k = magnitude < m_threshold ? m_thresholdGainDown : m_thresholdGainUp;
+        m_threshold += dt * k * (magnitude - m_threshold);
+        m_threshold = std::max(6.0, std::min(600.0, m_threshold));
+    }
+    m_lastThresholdTime = now;
+
+    return usage;
+}
+
+void
+GccRateController::UpdateRate(BandwidthUsage usage, Time now)
+{
+    switch (usage)
+    {
+    case BW_OVERUSING:
+        m_state = RC_DECREASE;
+        break;
+    case BW_UNDERUSING:
+        m_state = RC_HOLD;
+        break;
+    case BW_NORMAL:
+        if (m_state == RC_HOLD)
+        {
+            m_state = RC_INCREASE;
+        }
+        break;
+    }
+
+    if (m_rate == 0)
+    {
+        // the incoming rate has not been measured over a full window yet
+        return;
+    }
+
+    double dt = std::min((now - m_lastRateUpdate).GetSeconds(), 1.0);
+    m_lastRateUpdate = now;
+    double deviation = std::sqrt(m_varMaxRate) * m_avgMaxRate;
+
+    switch (m_state)
+    {
+    case RC_INCREASE:
+        if (m_avgMaxRate > 0 && m_incomingRate > m_avgMaxRate + 3 * deviation)
+        {
+            // the link capacity changed, forget the rate of the last over-uses
+            m_avgMaxRate = 0;
+        }
+        if (m_avgMaxRate > 0 && m_incomingRate > m_avgMaxRate - 3 * deviation)
+        {
+            // close to the rate of the last over-uses: about half a fragment
+            // per response time (100 ms)
+            double alpha = 0.5 * std::min(dt / 0.1, 1.0);
+            m_rate += std::max(1000.0, alpha * m_avgFragmentBits);
+        }
+        else
+        {
+            m_rate *= std::pow(m_increaseFactor, dt);
+        }
+        break;
+    case RC_DECREASE:
+        m_rate = m_beta * m_incomingRate;
+        if (m_avgMaxRate > 0 && m_incomingRate < m_avgMaxRate - 3 * deviation)
+        {
+            m_avgMaxRate = 0;
+        }
+        if (m_avgMaxRate == 0)
+        {
+            m_avgMaxRate = m_incomingRate;
+        }
+        else
+        {
+            m_avgMaxRate = 0.95 * m_avgMaxRate + 0.05 * m_incomingRate;
+            double relative = (m_incomingRate - m_avgMaxRate) / m_avgMaxRate;
+            m_varMaxRate = 0.95 * m_varMaxRate + 0.05 * relative * relative;
+        }
+        m_state = RC_HOLD;
+        break;
+    case RC_HOLD:
+        break;
+    }
+
+    m_rate = std::min(m_rate, 1.5 * m_incomingRate);
+    m_rate = std::max(m_rate, double(m_minRate.GetBitRate()));
+}
+
+} // namespace ns3
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GCC_RATE_CONTROLLER_H
+#define GCC_RATE_CONTROLLER_H
+
+#include "receiver-rate-controller.h"
+
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Delay-based receiver-side rate controller, modeled on Google Congestion Control
+ *
+ * The controller follows the delay-based part of GCC
+ * (draft-ietf-rmcat-gcc-02), using the bursts as packet groups: all the
+ * fragments of a burst share the send time of its SeqTsSizeFragHeader, and the
+ * arrival time of a group is the arrival of its last fragment.
+ *
+ * - Arrival-time filter: the inter-group delay variation
+ *   d = (t_i - t_{i-1}) - (T_i - T_{i-1}), between the arrival times t and the
+ *   send times T of two consecutive groups, is fed to a scalar Kalman filter
+ *   estimating the queuing delay gradient m (ProcessNoise is the variance of
+ *   the state noise, the measurement noise variance is an EWMA of the squared
+ *   residuals).
+ * - Over-use detector: as in the WebRTC implementation, m is scaled by the
+ *   number of delay variations it was estimated on (up to 60), and the result
+ *   is compared with an adaptive threshold th, which moves towards its
+ *   magnitude with gain ThresholdGainUp when above th and ThresholdGainDown
+ *   otherwise, so that the controller is not starved by concurrent loss-based
+ *   flows. Over-use is signaled when the scaled m exceeds th for at least
+ *   OverusingTime and is not decreasing, under-use when it is below -th.
+ * - AIMD rate controller: a finite state machine (Increase, Decrease, Hold)
+ *   driven by the detector signal. On over-use the rate is set to Beta times
+ *   the incoming rate (measured over RateWindow); while increasing, the rate
+ *   grows multiplicatively by IncreaseFactor per second, or additively by about
+ *   half a fragment per response time when close to the incoming rate at the
+ *   last over-uses. The rate never exceeds 1.5 times the incoming rate.
+ * - Loss-based fallback: every LossInterval, the fraction of lost fragments is
+ *   computed from the gaps in the burst and fragment sequence numbers. Above
+ *   10 % the loss-based rate is reduced by (1 - 0.5 loss), below 2 % it grows
+ *   by 5 %, up to 1.5 times the incoming rate. The target rate is the minimum
+ *   of the delay-based and loss-based rates.
+ *
+ * The target rate is zero, i.e., no feedback, until the incoming rate has been
+ * measured over a full RateWindow.
+ */
+class GccRateController : public ReceiverRateController
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    GccRateController();
+    ~GccRateController() override;
+
+    DataRate fragmentReceived(const Ptr<Packet>& f) override;
+
+    /// Signal of the over-use detector
+    enum BandwidthUsage
+    {
+        BW_NORMAL,
+        BW_UNDERUSING,
+        BW_OVERUSING
+    };
+
+    /// State of the AIMD rate controller
+    enum RateControlState
+    {
+        RC_HOLD,
+        RC_INCREASE,
+        RC_DECREASE
+    };
+
+    /**
+     * TracedCallback signature for the controller updates, once per packet group.
+     *
+     * \param [in] delayGradient the scaled queuing delay gradient, in ms
+     * \param [in] threshold the over-use threshold, in ms
+     * \param [in] usage the signal of the over-use detector
+     * \param [in] rate the target rate
+     */
+    typedef void (*UpdateTracedCallback)(double delayGradient,
+                                         double threshold,
+                                         BandwidthUsage usage,
+                                         DataRate rate);
+
+  private:
+    /**
+     * \return the minimum of the delay-based and loss-based rates
+     */
+    DataRate GetTargetRate() const;
+
+    /**
+     * \brief Run the controller on the delay variation between the current and previous groups
+     * \param now the current time
+     */
+    void UpdateGroups(Time now);
+
+    /**
+     * \brief Update the incoming rate with a fragment
+     * \param bytes the size of the fragment
+     * \param now the current time
+     */
+    void UpdateIncomingRate(uint32_t bytes, Time now);
+
+    /**
+     * \brief Account for the fragments lost before a fragment, from its sequence numbers
+     * \param seq the burst sequence number of the fragment
+     * \param fragSeq the fragment sequence number within the burst
+     * \param frags the number of fragments of the burst
+     * \param now the current time
+     */
+    void UpdateLoss(uint64_t seq, uint16_t fragSeq, uint16_t frags, Time now);
+
+    /**
+     * \brief Update the arrival-time filter with the delay variation between two groups
+     * \param delta the inter-group delay variation, in ms
+     * \param sendDelta the inter-group send time difference, in ms
+     */
+    void UpdateFilter(double delta, double sendDelta);
+
+    /**
+     * \brief Run the over-use detector on the current filter estimate
+     * \param now the current time
+     * \return the detector signal
+     */
+    BandwidthUsage Detect(Time now);
+
+    /**
+     * \brief Update the delay-based rate with the detector signal
+     * \param usage the detector signal
+     * \param now the current time
+     */
+    void UpdateRate(BandwidthUsage usage, Time now);
+
+    double m_processNoise;      //!< variance of the state noise of the filter, in ms^2
+    double m_chi;               //!< filter coefficient of the measurement noise variance
+    double m_initialThreshold;  //!< initial over-use threshold, in ms
+    double m_thresholdGainUp;   //!< threshold gain when |m| exceeds it
+    double m_thresholdGainDown; //!< threshold gain when |m| is below it
+    Time m_overusingTime;       //!< time m has to exceed the threshold to signal over-use
+    double m_beta;              //!< multiplicative decrease factor
+    double m_increaseFactor;    //!< multiplicative increase factor per second
+    Time m_rateWindow;          //!< window of the incoming rate
+    Time m_lossInterval;        //!< interval the loss fraction is computed over
+    DataRate m_minRate;         //!< lower bound of the target rate
+
+    // incoming rate
+    std::deque<std::pair<Time, uint32_t>> m_arrivals; //!< fragments in the rate window
+    uint64_t m_windowBytes;                           //!< bytes in the rate window
+    Time m_firstArrival;                              //!< arrival of the first fragment
+    double m_incomingRate;                            //!< incoming rate, in bit/s
+    double m_avgFragmentBits;                         //!< EWMA of the fragment size, in bits
+
+    // packet groups
+    bool m_groupStarted;  //!< whether a group has been received
+    uint64_t m_groupSeq;  //!< burst sequence number of the current group
+    Time m_groupSend;     //!< send time of the current group
+    Time m_groupArrival;  //!< arrival of the last fragment of the current group
+    bool m_prevGroup;     //!< whether a group has been completed
+    Time m_prevSend;      //!< send time of the previous group
+    Time m_prevArrival;   //!< arrival of the last fragment of the previous group
+
+    // arrival-time filter
+    double m_gradient;      //!< estimated queuing delay gradient, in ms
+    double m_prevGradient;  //!< previous estimate of the gradient, in ms
+    double m_trend;         //!< gradient scaled by the number of deltas, in ms
+    uint32_t m_deltas;      //!< number of inter-group delay variations received
+    double m_errorVariance; //!< variance of the estimate, in ms^2
+    double m_noiseVariance; //!< measurement noise variance, in ms^2
+
+    // over-use detector
+    double m_threshold;       //!< over-use threshold, in ms
+    Time m_lastThresholdTime; //!< last update of the threshold
+    Time m_overuseStart;      //!< start of the current over-use, negative if none
+
+    // rate controller
+    RateControlState m_state; //!< state of the rate controller
+    double m_rate;            //!< delay-based rate, in bit/s, zero until initialized
+    Time m_lastRateUpdate;    //!< last update of the delay-based rate
+    double m_avgMaxRate;      //!< EWMA of the incoming rate at over-use, in bit/s
+    double m_varMaxRate;      //!< EWMA of its squared relative deviation
+
+    // loss-based controller
+    bool m_lossStarted;     //!< whether a fragment has been received
+    uint64_t m_lastSeq;     //!< burst sequence number of the last fragment
+    uint16_t m_lastFragSeq; //!< fragment sequence number of the last fragment
+    uint16_t m_lastFrags;   //!< number of fragments of the last burst
+    uint64_t m_expected;    //!< fragments expected in the current loss interval
+    uint64_t m_lost;        //!< fragments lost in the current loss interval
+    Time m_lossStart;       //!< start of the current loss interval
+    double m_lossRate;      //!< loss-based rate, in bit/s, zero until initialized
+
+    /// Controller updated
+    ns3::TracedCallback<double, double, BandwidthUsage, DataRate> m_updateTrace;
+};
+
+} // namespace ns3
+
+#endif /* GCC_RATE_CONTROLLER_H */
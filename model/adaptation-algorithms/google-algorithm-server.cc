@@ -1,4 +1,5 @@
 #include "google-algorithm-server.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 
@@ -28,19 +29,21 @@ GoogleAlgorithmServer::~GoogleAlgorithmServer ()
   NS_LOG_FUNCTION (this);
 }
 
+Ptr<BandwidthEstimator>
+GoogleAlgorithmServer::CreateBandwidthEstimator (void) const
+{
+  return CreateObjectWithAttributes<DualEwmaBandwidthEstimator> (
+      "SlowAlpha", DoubleValue (0.01), "FastAlpha", DoubleValue (0.02), "InitialEstimate",
+      DataRateValue (DataRate ("100kbps")));
+}
+
 DataRate
 GoogleAlgorithmServer::adaptation_algorithm (double buff_occ, double diff_buff_occ,
                                              DataRate lastRate)
 {
   NS_LOG_FUNCTION (this);
 
-  double aSlow = 0.99;
-  double aFast = 0.98;
-
-  m_Eslow = DataRate (aSlow * m_Eslow.GetBitRate () + (1 - aSlow) * lastRate.GetBitRate ());
-  m_Efast = DataRate (aFast * m_Efast.GetBitRate () + (1 - aFast) * lastRate.GetBitRate ());
-
-  return DataRate (0.95 * std::min (m_Eslow, m_Efast).GetBitRate ());
+  return DataRate (0.95 * GetBandwidthEstimator ()->GetEstimate ().GetBitRate ());
 }
 
 } // namespace ns3
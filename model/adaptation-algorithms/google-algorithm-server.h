@@ -16,11 +16,14 @@ public:
   GoogleAlgorithmServer ();
   virtual ~GoogleAlgorithmServer ();
 
+protected:
+  /**
+   * \return the minimum of a slow and a fast EWMA of the measured rate
+   */
+  Ptr<BandwidthEstimator> CreateBandwidthEstimator (void) const;
+
 private:
   DataRate adaptation_algorithm (double buff_occ, double diff_buff_occ, DataRate lastRate);
-
-  DataRate m_Eslow = DataRate ("100kbps");
-  DataRate m_Efast = DataRate ("100kbps");
 };
 
 } // namespace ns3
@@ -5,17 +5,27 @@ MPC ABR (based on penseive implementation)
 **/
 
 #include "mpc.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("MPCAlgo");
 NS_OBJECT_ENSURE_REGISTERED (MPCAlgo);
 
-MPCAlgo::MPCAlgo (int chunks, int cmaf) : AdaptationAlgorithm (), m_highestRepIndex (8 - 1),
+MPCAlgo::MPCAlgo (int chunks, int cmaf) : AdaptationAlgorithm (),
 	chunks(chunks), cmaf(cmaf)
 {
   NS_LOG_INFO (this);
-  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+  SetThroughputSampling (cmaf == 2 ? 0 : chunks, cmaf == 3, true);
+}
+
+Ptr<BandwidthEstimator>
+MPCAlgo::CreateBandwidthEstimator (void) const
+{
+  return CreateObjectWithAttributes<HarmonicBandwidthEstimator> ("WindowSize", UintegerValue (5),
+                                                                 "ErrorWindow", UintegerValue (5));
 }
 
 algorithmReply MPCAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clientId)
@@ -45,229 +55,84 @@ algorithmReply MPCAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clien
 		return answer;
 	}
 	
-	// Calculate error
-	double curr_error = 0;
-	if ( past_bandwidth_ests.size() > 0 ) {
-		double lastEstimate = past_bandwidth_ests.front();
-		double lastBandwidth = (m_throughput.bytesReceived.at(segmentCounter-1)*8 / ((m_throughput.transmissionEnd.at (segmentCounter-1) - m_throughput.transmissionStart.at (segmentCounter-1))/(double)1000000));
-		if(chunks > 0) {
-			if(cmaf == 3) {
-				double bytes = 0.0;
-				double time = 0.0;
-				double start = 0.0;
-				double end = 0.0;
-				int count = 0;
-				for(int index=segmentCounter-1; index>=0; index--)
-				{
-				  if(count == 0) { end = m_throughput.transmissionEnd.at (index); }
-				  bytes += m_throughput.bytesReceived.at(index);
-				  count++;
-				  if(count > chunks) {
-					start = m_throughput.transmissionRequested.at (index+1);
-					break;
-				  }
-				}
-				time = (end - start)/(double)1000000;
-				lastBandwidth = (bytes*8 / (double)time);
-			} else {
-				double bytes = 0.0;
-				double time = 0.0;
-				int count = 0;
-				for(int index=segmentCounter-1; index>=0; index--)
-				{
-				  bytes += m_throughput.bytesReceived.at(index);
-				  time += (m_throughput.transmissionEnd.at (index) - m_throughput.transmissionStart.at (index))/(double)1000000;
-				  count++;
-				  if(count > chunks) break;
-				}
-				lastBandwidth = (bytes*8 / (double)time);
-			}
-		}
-		curr_error = abs((lastEstimate - lastBandwidth) / (double)lastBandwidth);
-	}
-	past_errors.push_front(curr_error);
-	
-	//throughput estimation
-	std::vector<double> thrptEstimationTmp;
-	if(chunks > 0) {
-		double tempBytes = 0;
-		double tempTime = 0;
-		
-		  if(cmaf == 3) {
-
-			  double startTime = 0;
-			  double endTime = 0;
-			  bool last = true;
-			  for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; )
-				{
-				  if (m_throughput.bytesReceived.at (sd) == 0)
-					{
-					  continue;
-					}
-				  else
-					{
-					  if((sd % chunks) == 0) {
-						  tempBytes += m_throughput.bytesReceived.at (sd);
-						  startTime = m_throughput.transmissionRequested.at (sd);
-						  double time = (endTime-startTime) / 1000000.0;
-						  thrptEstimationTmp.push_back((8*tempBytes)/(time));
-						  tempBytes = 0;
-						  last = true;
-					  }
-					  else {
-						  tempBytes += m_throughput.bytesReceived.at (sd);
-						  if(last) {
-							  endTime =  m_throughput.transmissionEnd.at (sd);
-							  last = false;
-						  }
-					  }
-					}
-				  if (thrptEstimationTmp.size () == 20)
-					{
-					  break;
-					}
-				}
-
-		  } else if(cmaf == 2) { 
-
-			for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; ) {
-				if (m_throughput.bytesReceived.at (sd) == 0) {
-					continue;
-				} else {
-					thrptEstimationTmp.push_back ((8.0 * m_throughput.bytesReceived.at (sd)) / ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0)));
-				}
-				if (thrptEstimationTmp.size () == 5) {
-					break;
-				}
-			}
-
-
-		  } else {
-
-			for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; ) {
-				if (m_throughput.bytesReceived.at (sd) == 0) {
-					continue;
-				} else {
-				  if((sd % chunks) == 0) {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  tempTime += ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0));
-					  thrptEstimationTmp.push_back((8*tempBytes)/(tempTime));
-					  tempBytes = 0;
-					  tempTime = 0;
-				  }
-				  else {
-					  tempBytes += m_throughput.bytesReceived.at (sd);
-					  tempTime += ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0));
-				  }
-				}
-				if (thrptEstimationTmp.size () == 5) {
-					break;
-				}
-			}
-		  
-	  	}
-		
-	} else {
-		for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; ) {
-			if (m_throughput.bytesReceived.at (sd) == 0) {
-				continue;
-			} else {
-				thrptEstimationTmp.push_back ((8.0 * m_throughput.bytesReceived.at (sd)) / ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0)));
-			}
-			if (thrptEstimationTmp.size () == 5) {
-				break;
-			}
-		}
-	}
-	double harmonicMeanDenominator = 0;
-	for (uint i = 0; i < thrptEstimationTmp.size (); i++) {
-		harmonicMeanDenominator += 1 / (thrptEstimationTmp.at (i));
-	}
-	double harmonic_bandwidth = thrptEstimationTmp.size () / harmonicMeanDenominator;
-				
 	// future bandwidth prediction
-	double max_error = 0;
-	int count = 0;
-	std::list <double> :: iterator it;
-	for(it = past_errors.begin(); it != past_errors.end(); ++it) {
-		if(*it > max_error) {
-			max_error = *it; 
-		}
-		count++;
-		if(count > 4) { break; }
-	}
-	double future_bandwidth = harmonic_bandwidth/(1+max_error); // robustMPC here
-
-	past_bandwidth_ests.push_front(harmonic_bandwidth);
+	Ptr<BandwidthEstimator> estimator = GetBandwidthEstimator ();
+	double bandwidth = estimator->GetEstimate ().GetBitRate ();
+	double future_bandwidth = bandwidth/(1+estimator->GetError ()); // robustMPC here
 
 	double max_reward = -100000000;
 	double start_buffer = (m_bufferData.bufferLevelNew.back ()/ (double)1000000 - (timeNow - m_bufferData.timeNow.back())/ (double)1000000);
 	nextRepIndex = (int)m_lastRepIndex;
 
-	int possibleCombos = (int)std::pow(5.0, m_highestRepIndex+1);
-
-	std::vector<std::vector<int>> combos(possibleCombos + 1, std::vector<int>(5));
-
-	count = 0;
-	for(int i=0; i<=m_highestRepIndex; i++) {
-		for(int j=0; j<=m_highestRepIndex; j++) {
-			for(int k=0; k<=m_highestRepIndex; k++) {
-				for(int l=0; l<=m_highestRepIndex; l++) {
-					for(int m=0; m<=m_highestRepIndex; m++) {
-						combos[count][0] = i;
-						combos[count][1] = j;
-						combos[count][2] = k;
-						combos[count][3] = l;
-						combos[count][4] = m;
-						count++;
+	// dynamic programming over the next HORIZON chunks: the plans ending at
+	// each rung are extended by one chunk at a time, and a plan is dropped
+	// as soon as another one ending at the same rung has both a higher
+	// reward and a higher buffer, since it cannot do better afterwards. A
+	// buffer covering the download of all the remaining chunks at the
+	// highest rung never rebuffers, so buffers are clipped there, which
+	// keeps few plans per rung. The work is HORIZON * rungs^2 * plans per
+	// rung, instead of rungs^HORIZON for the enumeration of all the
+	// combinations, with the same decisions unless a rung has more than
+	// MAX_PLANS plans
+	const double a = (double)segDuration/1000000;
+	const uint32_t rungs = m_highestRepIndex + 1;
+	const double max_download_time = (m_videoData.averageBitrate[m_highestRepIndex] * a) / future_bandwidth;
+	m_plans.resize (rungs);
+	m_nextPlans.resize (rungs);
+	for (auto &plans : m_plans) {
+		plans.clear ();
+	}
+	Plan start;
+	start.buffer = start_buffer-a;
+	start.rebufferTime = 0;
+	start.bitrateSum = 0;
+	start.smoothnessDiffs = 0;
+	start.reward = 0;
+	start.first = 0;
+	m_plans[m_lastRepIndex].push_back (start);
+
+	for (int j=0; j<HORIZON; j++) {
+		for (auto &plans : m_nextPlans) {
+			plans.clear ();
+		}
+		for (uint32_t last_quality=0; last_quality<rungs; last_quality++) {
+			for (const Plan &plan : m_plans[last_quality]) {
+				for (uint32_t chunk_quality=0; chunk_quality<rungs; chunk_quality++) {
+					Plan next;
+					next.first = j == 0 ? chunk_quality : plan.first;
+					double curr_buffer = plan.buffer;
+					next.rebufferTime = plan.rebufferTime;
+
+					double download_time = (m_videoData.averageBitrate[chunk_quality] * a) / future_bandwidth;
+
+					if ( curr_buffer < download_time ) {
+						next.rebufferTime += (download_time - curr_buffer);
+						curr_buffer = 0;
+					} else {
+						curr_buffer -= download_time;
 					}
+
+					next.buffer = std::min (curr_buffer + a, (HORIZON-j-1) * max_download_time);
+					next.bitrateSum = plan.bitrateSum + m_videoData.averageBitrate[chunk_quality]/1000;
+					next.smoothnessDiffs = plan.smoothnessDiffs + std::abs((m_videoData.averageBitrate[chunk_quality]/1000) - (m_videoData.averageBitrate[last_quality]/1000));
+					next.reward = (next.bitrateSum/1000) - (REBUF_PENALTY*next.rebufferTime) - (SMOOTH_PENALTY*next.smoothnessDiffs/1000);
+					AddPlan (m_nextPlans[chunk_quality], next);
 				}
 			}
 		}
+		std::swap (m_plans, m_nextPlans);
 	}
-	
-	for(int i=0; i<possibleCombos; i++) {
-
-		double curr_rebuffer_time = 0;
-		double a = (double)segDuration/1000000;
-		double curr_buffer = start_buffer-a;
-		double bitrate_sum = 0;
-		double smoothness_diffs = 0;
-		int last_quality = (int)m_lastRepIndex;
 
-		for(int j=0; j<5; j++) {
-			int chunk_quality = combos[i][j];
-			// std::cout << "possibleCombos " << possibleCombos << " i " << i << " j " << j << " chunk_quality " << chunk_quality << std::endl;
-			
-			if (chunk_quality > 7 ||chunk_quality < 0 ) {
-				continue;
-			}
-
-			double download_time = (m_videoData.averageBitrate.at(chunk_quality) * a) / future_bandwidth;
-
-			if ( curr_buffer < download_time ) {
-				curr_rebuffer_time += (download_time - curr_buffer);
-				curr_buffer = 0;
-			} else {
-				curr_buffer -= download_time;
-			}
-
-			curr_buffer += a;
-			bitrate_sum += m_videoData.averageBitrate.at(chunk_quality)/1000;
-			smoothness_diffs += abs((m_videoData.averageBitrate.at(chunk_quality)/1000) - (m_videoData.averageBitrate.at(last_quality)/1000));
-			last_quality = chunk_quality;
-		}
-				
-		double reward = (bitrate_sum/1000) - (REBUF_PENALTY*curr_rebuffer_time) - (SMOOTH_PENALTY*smoothness_diffs/1000);
-		
-
-		if ( reward >= max_reward ) {
-			max_reward = reward;
-			if (combos[i][0] <= 7 && combos[i][0] >= 0 ) {
-				nextRepIndex = combos[i][0];
+	// as the enumeration, the highest first quality among the best plans
+	bool found = false;
+	for (const auto &plans : m_plans) {
+		for (const Plan &plan : plans) {
+			if ( plan.reward > max_reward || (plan.reward == max_reward && (!found || plan.first > nextRepIndex)) ) {
+				max_reward = plan.reward;
+				nextRepIndex = plan.first;
+				found = true;
 			}
 		}
-		
 	}
 
 	m_lastRepIndex = nextRepIndex;
@@ -283,4 +148,28 @@ algorithmReply MPCAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clien
 	return answer;
 }
 
+void
+MPCAlgo::AddPlan (std::vector<Plan> &plans, const Plan &plan)
+{
+	for (const Plan &other : plans) {
+		if ( other.reward >= plan.reward && other.buffer >= plan.buffer &&
+		     (other.reward > plan.reward || other.buffer > plan.buffer || other.first >= plan.first) ) {
+			return;
+		}
+	}
+	plans.erase (std::remove_if (plans.begin (), plans.end (), [&plan] (const Plan &other) {
+		// on a tie, the enumeration chooses the highest first quality
+		return plan.reward >= other.reward && plan.buffer >= other.buffer &&
+		       (plan.reward > other.reward || plan.buffer > other.buffer || plan.first >= other.first);
+	}), plans.end ());
+	plans.push_back (plan);
+
+	// bound the work on fine-grained ladders: the plan with the lowest reward goes
+	if (plans.size () > MAX_PLANS) {
+		plans.erase (std::min_element (plans.begin (), plans.end (), [] (const Plan &x, const Plan &y) {
+			return x.reward < y.reward;
+		}));
+	}
+}
+
 } // namespace ns3
@@ -3,6 +3,8 @@
 
 #include "tcp-stream-adaptation-algorithm.h"
 
+#include <vector>
+
 namespace ns3 {
 
 class MPCAlgo : public AdaptationAlgorithm
@@ -12,13 +14,40 @@ public:
 
   algorithmReply GetNextRep ( const int64_t segmentCounter, int64_t clientId);
 
+protected:
+  /**
+   * \return a harmonic mean of the last 5 segments, with the largest
+   * prediction error over the last 5 segments as error
+   */
+  Ptr<BandwidthEstimator> CreateBandwidthEstimator (void) const;
+
 private:
 
-  const int64_t m_highestRepIndex;
   int64_t m_lastRepIndex;
-  
-  std::list<double>  past_errors;
-  std::list<double>  past_bandwidth_ests;
+
+  static const int HORIZON = 5; //!< number of future chunks the reward is computed on
+  static const uint32_t MAX_PLANS = 16; //!< plans kept per chunk and rung
+
+  /// A plan of the next chunks, as simulated up to a chunk
+  struct Plan
+  {
+    double buffer; //!< buffer level after the chunk [s]
+    double rebufferTime; //!< rebuffering time so far [s]
+    double bitrateSum; //!< sum of the bitrates so far [kbps]
+    double smoothnessDiffs; //!< sum of the bitrate changes so far [kbps]
+    double reward; //!< reward so far
+    int first; //!< quality of the first chunk
+  };
+
+  /**
+   * \brief Add a plan to the plans ending at a rung, unless another one is better
+   * \param plans the plans ending at the rung, none better than another
+   * \param plan the plan
+   */
+  static void AddPlan (std::vector<Plan> &plans, const Plan &plan);
+
+  std::vector<std::vector<Plan>> m_plans; //!< plans per rung at the current chunk, reused
+  std::vector<std::vector<Plan>> m_nextPlans; //!< plans per rung at the next chunk, reused
   
   float REBUF_PENALTY = 7;
   float SMOOTH_PENALTY = 1;
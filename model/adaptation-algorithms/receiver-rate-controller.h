@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RECEIVER_RATE_CONTROLLER_H
+#define RECEIVER_RATE_CONTROLLER_H
+
+#include "ns3/data-rate.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Receiver-side rate controller of a VR flow
+ *
+ * VrAdaptiveBurstSink and VrAdaptiveBurstSinkTcp keep one controller per
+ * sender, created from their RateController attribute. The controller is fed
+ * with every fragment received from the sender and returns the target rate
+ * that the sink sends back in a VrAdaptiveHeader. A zero rate means that the
+ * controller has no estimate yet, and is ignored by the sender.
+ */
+class ReceiverRateController : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ReceiverRateController();
+    ~ReceiverRateController() override;
+
+    /**
+     * \brief Update the controller with a received fragment
+     * \param f the fragment, starting with its SeqTsSizeFragHeader
+     * \return the target rate of the sender, zero if not available yet
+     */
+    virtual DataRate fragmentReceived(const Ptr<Packet>& f) = 0;
+};
+
+} // namespace ns3
+
+#endif /* RECEIVER_RATE_CONTROLLER_H */
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-delivery-rate-algorithm-server.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpDeliveryRateAlgorithmServer");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpDeliveryRateAlgorithmServer);
+
+TypeId
+TcpDeliveryRateAlgorithmServer::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpDeliveryRateAlgorithmServer")
+            .SetParent<AdaptationAlgorithmServer>()
+            .SetGroupName("Applications")
+            .AddConstructor<TcpDeliveryRateAlgorithmServer>()
+            .AddAttribute("BandwidthWindow",
+                          "The number of round trips the bottleneck bandwidth is the maximum "
+                          "delivery rate of",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&TcpDeliveryRateAlgorithmServer::m_bandwidthWindow),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MinRttWindow",
+                          "The time the minimum RTT is computed over",
+                          TimeValue(Seconds(10)),
+                          MakeTimeAccessor(&TcpDeliveryRateAlgorithmServer::m_minRttWindow),
+                          MakeTimeChecker())
+            .AddAttribute("Gain",
+                          "The fraction of the bottleneck bandwidth used as target rate",
+                          DoubleValue(0.9),
+                          MakeDoubleAccessor(&TcpDeliveryRateAlgorithmServer::m_gain),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("DrainThreshold",
+                          "The ratio between the RTT and the minimum RTT beyond which the rate "
+                          "is reduced to drain the queue",
+                          DoubleValue(1.25),
+                          MakeDoubleAccessor(&TcpDeliveryRateAlgorithmServer::m_drainThreshold),
+                          MakeDoubleChecker<double>(1))
+            .AddTraceSource("DeliveryRate",
+                            "A delivery rate has been sampled at the end of a round trip",
+                            MakeTraceSourceAccessor(
+                                &TcpDeliveryRateAlgorithmServer::m_deliveryRateTrace),
+                            "ns3::TcpDeliveryRateAlgorithmServer::DeliveryRateTracedCallback");
+    return tid;
+}
+
+TcpDeliveryRateAlgorithmServer::TcpDeliveryRateAlgorithmServer()
+    : m_segmentSize(0),
+      m_cwnd(0),
+      m_bytesInFlight(0),
+      m_round(0),
+      m_roundDelivered(0),
+      m_roundMaxInFlight(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpDeliveryRateAlgorithmServer::~TcpDeliveryRateAlgorithmServer()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TcpDeliveryRateAlgorithmServer::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_socket)
+    {
+        m_socket->TraceDisconnectWithoutContext(
+            "CongestionWindow",
+            MakeCallback(&TcpDeliveryRateAlgorithmServer::CwndChange, this));
+        m_socket->TraceDisconnectWithoutContext(
+            "RTT",
+            MakeCallback(&TcpDeliveryRateAlgorithmServer::RttChange, this));
+        m_socket->TraceDisconnectWithoutContext(
+            "BytesInFlight",
+            MakeCallback(&TcpDeliveryRateAlgorithmServer::BytesInFlightChange, this));
+        m_socket->TraceDisconnectWithoutContext(
+            "HighestRxAck",
+            MakeCallback(&TcpDeliveryRateAlgorithmServer::HighestRxAckChange, this));
+        m_socket = 0;
+    }
+    AdaptationAlgorithmServer::DoDispose();
+}
+
+DataRate
+TcpDeliveryRateAlgorithmServer::nextBurstRate(Ptr<Socket> socket,
+                                              uint64_t bytesAddedToSocket,
+                                              Time txTime)
+{
+    NS_LOG_FUNCTION(this << socket << bytesAddedToSocket << txTime);
+    if (!m_socket)
+    {
+        ConnectTraces(socket);
+    }
+    return AdaptationAlgorithmServer::nextBurstRate(socket, bytesAddedToSocket, txTime);
+}
+
+DataRate
+TcpDeliveryRateAlgorithmServer::GetBottleneckBandwidth() const
+{
+    return m_maxBwFilter.GetBest();
+}
+
+Time
+TcpDeliveryRateAlgorithmServer::GetMinRtt() const
+{
+    return m_minRtt;
+}
+
+void
+TcpDeliveryRateAlgorithmServer::ConnectTraces(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    m_socket = DynamicCast<TcpSocketBase>(socket);
+    NS_ABORT_MSG_IF(!m_socket, "TcpDeliveryRateAlgorithmServer requires a TCP socket");
+
+    UintegerValue segmentSize;
+    m_socket->GetAttribute("SegmentSize", segmentSize);
+    m_segmentSize = segmentSize.Get();
+    m_maxBwFilter = MaxBandwidthFilter_t(m_bandwidthWindow, DataRate(0), 0);
+
+    m_socket->TraceConnectWithoutContext(
+        "CongestionWindow",
+        MakeCallback(&TcpDeliveryRateAlgorithmServer::CwndChange, this));
+    m_socket->TraceConnectWithoutContext(
+        "RTT",
+        MakeCallback(&TcpDeliveryRateAlgorithmServer::RttChange, this));
+    m_socket->TraceConnectWithoutContext(
+        "BytesInFlight",
+        MakeCallback(&TcpDeliveryRateAlgorithmServer::BytesInFlightChange, this));
+    m_socket->TraceConnectWithoutContext(
+        "HighestRxAck",
+        MakeCallback(&TcpDeliveryRateAlgorithmServer::HighestRxAckChange, this));
+}
+
+void
+TcpDeliveryRateAlgorithmServer::StartRound(Time now)
+{
+    m_roundStart = now;
+    m_roundDelivered = 0;
+    m_roundMaxInFlight = m_bytesInFlight;
+}
+
+void
+TcpDeliveryRateAlgorithmServer::CwndChange(uint32_t oldCwnd, uint32_t newCwnd)
+{
+    m_cwnd = newCwnd;
+}
+
+void
+TcpDeliveryRateAlgorithmServer::RttChange(Time oldRtt, Time newRtt)
+{
+    Time now = Simulator::Now();
+    m_rtt = newRtt;
+    if (m_minRtt.IsZero() || newRtt <= m_minRtt || now - m_minRttStamp > m_minRttWindow)
+    {
+        m_minRtt = newRtt;
+        m_minRttStamp = now;
+    }
+}
+
+void
+TcpDeliveryRateAlgorithmServer::BytesInFlightChange(uint32_t oldBytes, uint32_t newBytes)
+{
+    m_bytesInFlight = newBytes;
+    m_roundMaxInFlight = std::max(m_roundMaxInFlight, newBytes);
+}
+
+void
+TcpDeliveryRateAlgorithmServer::HighestRxAckChange(SequenceNumber32 oldAck,
+                                                   SequenceNumber32 newAck)
+{
+    Time now = Simulator::Now();
+    Time lastAck = m_lastAck;
+    m_lastAck = now;
+
+    if (m_rtt.IsZero() || now - lastAck > m_rtt)
+    {
+        // first ACK after an idle period: the sender ran out of data, so the
+        // pending round is application limited, and this ACK acknowledges
+        // bytes sent before the new round starts
+        if (m_roundDelivered > 0 && lastAck > m_roundStart)
+        {
+            EndRound(lastAck, true);
+        }
+        StartRound(now);
+        return;
+    }
+
+    m_roundDelivered += newAck.GetValue() - oldAck.GetValue();
+    if (now - m_roundStart >= m_rtt)
+    {
+        EndRound(now, m_roundMaxInFlight + m_segmentSize <= m_cwnd);
+        StartRound(now);
+    }
+}
+
+void
+TcpDeliveryRateAlgorithmServer::EndRound(Time end, bool appLimited)
+{
+    Time elapsed = end - m_roundStart;
+    DataRate sample(uint64_t(m_roundDelivered * 8 / elapsed.GetSeconds()));
+    m_round++;
+    if (!appLimited || sample > m_maxBwFilter.GetBest())
+    {
+        m_maxBwFilter.Update(sample, m_round);
+    }
+    NS_LOG_DEBUG("round " << m_round << " delivered " << m_roundDelivered << " bytes in "
+                          << elapsed.As(Time::MS) << ": " << sample
+                          << (appLimited ? " (app limited)" : "") << ", bottleneck "
+                          << m_maxBwFilter.GetBest());
+    m_deliveryRateTrace(sample, appLimited, m_maxBwFilter.GetBest());
+}
+
+DataRate
+TcpDeliveryRateAlgorithmServer::adaptation_algorithm(double buffOcc,
+                                                     double diffBuffOcc,
+                                                     DataRate lastRate)
+{
+    NS_LOG_FUNCTION(this << buffOcc << diffBuffOcc << lastRate);
+
+    double bottleneck = m_maxBwFilter.GetBest().GetBitRate();
+    if (bottleneck == 0)
+    {
+        if (m_rtt.IsZero() || m_cwnd == 0)
+        {
+            return lastRate;
+        }
+        return DataRate(uint64_t(m_cwnd * 8 / m_rtt.GetSeconds()));
+    }
+
+    double rate = m_gain * bottleneck;
+    if (!m_minRtt.IsZero() && m_rtt.GetSeconds() > m_drainThreshold * m_minRtt.GetSeconds())
+    {
+        rate *= m_minRtt.GetSeconds() / m_rtt.GetSeconds();
+    }
+    NS_LOG_DEBUG("bottleneck " << bottleneck << " rtt " << m_rtt.As(Time::MS) << " min rtt "
+                               << m_minRtt.As(Time::MS) << " rate " << rate);
+    return DataRate(uint64_t(rate));
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_DELIVERY_RATE_ALGORITHM_SERVER_H
+#define TCP_DELIVERY_RATE_ALGORITHM_SERVER_H
+
+#include "adaptation-algorithm-server.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/traced-callback.h"
+#include "ns3/windowed-filter.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Rate adaptation driven by the congestion state of the TCP socket
+ *
+ * Instead of inferring the throughput from the send buffer occupancy, the
+ * algorithm connects to the CongestionWindow, RTT, BytesInFlight and
+ * HighestRxAck trace sources of the TcpSocketBase of the flow, and estimates
+ * the delivery rate as in BBR: the bytes acknowledged during a round trip
+ * over its duration give a delivery rate sample, and the bottleneck
+ * bandwidth is the maximum sample over the last BandwidthWindow rounds.
+ * Rounds where the sender never filled the congestion window are
+ * application limited, and their samples are only used if they raise the
+ * estimate. ACKs arriving after an idle period longer than the RTT start a
+ * new round, so that the gaps between frames do not lower the samples.
+ *
+ * The target rate is Gain times the bottleneck bandwidth. When the RTT grows
+ * above DrainThreshold times the minimum RTT (over MinRttWindow), a queue is
+ * building up and the rate is further scaled by minRtt / RTT to drain it.
+ * Until the first sample, the rate is cwnd / RTT.
+ *
+ * The estimate is updated at every ACK, so each decision reflects the last
+ * few round trips rather than the last few frames.
+ */
+class TcpDeliveryRateAlgorithmServer : public AdaptationAlgorithmServer
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpDeliveryRateAlgorithmServer();
+    ~TcpDeliveryRateAlgorithmServer() override;
+
+    using AdaptationAlgorithmServer::nextBurstRate;
+    DataRate nextBurstRate(Ptr<Socket> socket, uint64_t bytesAddedToSocket, Time txTime) override;
+
+    /**
+     * \return the current estimate of the bottleneck bandwidth
+     */
+    DataRate GetBottleneckBandwidth() const;
+
+    /**
+     * \return the minimum RTT over the last MinRttWindow
+     */
+    Time GetMinRtt() const;
+
+    /**
+     * TracedCallback signature for delivery rate samples.
+     *
+     * \param [in] sample the delivery rate of the last round
+     * \param [in] appLimited whether the round was application limited
+     * \param [in] bottleneckBandwidth the updated bottleneck bandwidth
+     */
+    typedef void (*DeliveryRateTracedCallback)(DataRate sample,
+                                               bool appLimited,
+                                               DataRate bottleneckBandwidth);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    DataRate adaptation_algorithm(double buffOcc, double diffBuffOcc, DataRate lastRate) override;
+
+    /**
+     * \brief Connect to the trace sources of the TCP socket of the flow
+     * \param socket the socket
+     */
+    void ConnectTraces(Ptr<Socket> socket);
+
+    /**
+     * \brief Start a new round trip
+     * \param now the current time
+     */
+    void StartRound(Time now);
+
+    /**
+     * \brief Sample the delivery rate of the current round and update the filter
+     * \param end the end of the round
+     * \param appLimited whether the round was application limited
+     */
+    void EndRound(Time end, bool appLimited);
+
+    /**
+     * \brief Congestion window trace sink
+     * \param oldCwnd the previous congestion window
+     * \param newCwnd the new congestion window
+     */
+    void CwndChange(uint32_t oldCwnd, uint32_t newCwnd);
+
+    /**
+     * \brief RTT trace sink
+     * \param oldRtt the previous smoothed RTT
+     * \param newRtt the new smoothed RTT
+     */
+    void RttChange(Time oldRtt, Time newRtt);
+
+    /**
+     * \brief Bytes in flight trace sink
+     * \param oldBytes the previous bytes in flight
+     * \param newBytes the new bytes in flight
+     */
+    void BytesInFlightChange(uint32_t oldBytes, uint32_t newBytes);
+
+    /**
+     * \brief Highest received ACK trace sink
+     * \param oldAck the previous highest ACK
+     * \param newAck the new highest ACK
+     */
+    void HighestRxAckChange(SequenceNumber32 oldAck, SequenceNumber32 newAck);
+
+    /// Windowed max filter of the bottleneck bandwidth, indexed by round
+    typedef WindowedFilter<DataRate, MaxFilter<DataRate>, uint32_t, uint32_t> MaxBandwidthFilter_t;
+
+    uint32_t m_bandwidthWindow; //!< rounds the bottleneck bandwidth filter spans
+    Time m_minRttWindow;        //!< time the minimum RTT filter spans
+    double m_gain;              //!< fraction of the bottleneck bandwidth used as target rate
+    double m_drainThreshold;    //!< RTT over minimum RTT beyond which the queue is drained
+
+    Ptr<TcpSocketBase> m_socket;        //!< the socket of the flow, null until the first burst
+    MaxBandwidthFilter_t m_maxBwFilter; //!< bottleneck bandwidth filter
+    uint32_t m_segmentSize;             //!< TCP segment size, in bytes
+
+    uint32_t m_cwnd;          //!< congestion window, in bytes
+    uint32_t m_bytesInFlight; //!< bytes in flight
+    Time m_rtt;               //!< smoothed RTT
+    Time m_minRtt;            //!< minimum RTT
+    Time m_minRttStamp;       //!< time the minimum RTT was measured
+
+    uint32_t m_round;            //!< round trips since the first ACK
+    Time m_roundStart;           //!< start of the current round
+    uint64_t m_roundDelivered;   //!< bytes acknowledged during the current round
+    uint32_t m_roundMaxInFlight; //!< largest bytes in flight during the current round
+    Time m_lastAck;              //!< time of the last ACK
+
+    /// Delivery rate sampled
+    ns3::TracedCallback<DataRate, bool, DataRate> m_deliveryRateTrace;
+};
+
+} // namespace ns3
+
+#endif /* TCP_DELIVERY_RATE_ALGORITHM_SERVER_H */
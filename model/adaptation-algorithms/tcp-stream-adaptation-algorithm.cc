@@ -29,33 +29,76 @@ NS_OBJECT_ENSURE_REGISTERED(AdaptationAlgorithm);
 AdaptationAlgorithm::AdaptationAlgorithm()
 {
     m_videoData.segmentDuration = 2000000;
-    m_videoData.averageBitrate = { 3128000, 3254000, 3974000, 4496000, 6408000, 10938000, 17156000, 35018000 };
 }
 
 DataRate
 AdaptationAlgorithm::adaptation_algorithm (double buffOcc, double diffBuffOcc, DataRate lastRate)
 {
+  if (m_videoData.averageBitrate.empty ())
+    {
+      // the representations are the rungs of the ladder, fixed at the first decision
+      m_videoData.averageBitrate = GetBitrateLadder ()->GetBitrates ();
+      m_highestRepIndex = m_videoData.averageBitrate.size () - 1;
+    }
   m_bufferData.bufferLevelNew.push_back(30000000 - 1000000 * 8 * (buffOcc) / lastRate.GetBitRate()  );
   // m_bufferData.bufferLevelNew.push_back(90000000);
   m_bufferData.timeNow.push_back(Simulator::Now().GetMicroSeconds());
   
   algorithmReply reply = GetNextRep(m_segmentCounter++, 0);
-  std::cout << reply.nextRepIndex << std::endl;
+  NS_LOG_DEBUG ("nextRepIndex " << reply.nextRepIndex);
   m_playbackData.playbackIndex.push_back(reply.nextRepIndex);
   return m_videoData.averageBitrate[reply.nextRepIndex];
 }
 
 DataRate
-AdaptationAlgorithm::nextBurstRate (Ptr<Socket> socket, uint64_t bytesAddedToSocket,
+AdaptationAlgorithm::nextBurstRate (uint64_t buffOcc, uint64_t bytesAddedToSocket,
                                           Time txTime)
 {
   if (bytesAddedToSocket == 0) {
-    return DataRate(100000);
+    return NotifyDecision(DataRate(0), m_lastBufferOcc, DataRate(100000));
   }
   m_throughput.bytesReceived.push_back(bytesAddedToSocket);
   m_throughput.transmissionRequested.push_back((Simulator::Now() - 1.2 * txTime).GetMicroSeconds());
   m_throughput.transmissionStart.push_back((Simulator::Now() - txTime).GetMicroSeconds());
   m_throughput.transmissionEnd.push_back(Simulator::Now().GetMicroSeconds());
-  return AdaptationAlgorithmServer::nextBurstRate(socket, bytesAddedToSocket, txTime);
+  return AdaptationAlgorithmServer::nextBurstRate(buffOcc, bytesAddedToSocket, txTime);
 }
-} // namespace ns3
\ No newline at end of file
+
+void
+AdaptationAlgorithm::UpdateBandwidthEstimate (uint64_t bytesAddedToSocket, uint64_t bytesSent,
+                                              Time txTime)
+{
+  int64_t requested = m_throughput.transmissionRequested.back ();
+  int64_t start = m_fromRequest ? requested : m_throughput.transmissionStart.back ();
+  int64_t end = m_throughput.transmissionEnd.back ();
+
+  if (m_chunksPerSegment == 0)
+    {
+      GetBandwidthEstimator ()->AddSample (bytesAddedToSocket, MicroSeconds (end - start));
+      return;
+    }
+
+  if (m_chunkCount == 0)
+    {
+      m_chunkRequest = requested;
+    }
+  m_chunkBytes += bytesAddedToSocket;
+  m_chunkTime += end - start;
+  if (++m_chunkCount == m_chunksPerSegment)
+    {
+      int64_t duration = m_segmentSpan ? end - m_chunkRequest : m_chunkTime;
+      GetBandwidthEstimator ()->AddSample (m_chunkBytes, MicroSeconds (duration));
+      m_chunkCount = 0;
+      m_chunkBytes = 0;
+      m_chunkTime = 0;
+    }
+}
+
+void
+AdaptationAlgorithm::SetThroughputSampling (int64_t chunks, bool segmentSpan, bool fromRequest)
+{
+  m_chunksPerSegment = chunks;
+  m_segmentSpan = segmentSpan;
+  m_fromRequest = fromRequest;
+}
+} // namespace ns3
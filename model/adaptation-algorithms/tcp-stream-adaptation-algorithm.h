@@ -58,16 +58,51 @@ class AdaptationAlgorithm : public AdaptationAlgorithmServer
      */
     virtual algorithmReply GetNextRep(const int64_t segmentCounter, int64_t clientId) = 0;
 
-    virtual DataRate nextBurstRate(Ptr<Socket> socket, uint64_t bytesAddedToSocket, Time txTime);
+    using AdaptationAlgorithmServer::nextBurstRate;
+    DataRate nextBurstRate(uint64_t buffOcc, uint64_t bytesAddedToSocket, Time txTime) override;
 
   protected:
     virtual DataRate adaptation_algorithm(double buff_occ, double diff_buff_occ, DataRate lastRate);
 
+    /**
+     * \brief Feed the throughput estimator with the bytes added to the socket
+     *
+     * Depending on SetThroughputSampling, each burst is a sample, or the
+     * chunks of a segment are merged into a single sample.
+     *
+     * \param bytesAddedToSocket the bytes of the burst
+     * \param bytesSent the bytes that left the send buffer during the burst
+     * \param txTime the transmission time of the burst
+     */
+    void UpdateBandwidthEstimate(uint64_t bytesAddedToSocket,
+                                 uint64_t bytesSent,
+                                 Time txTime) override;
+
+    /**
+     * \brief Set how bursts are turned into throughput samples
+     * \param chunks the number of bursts (chunks) per segment, 0 for one sample per burst
+     * \param segmentSpan if true, a segment lasts from the request of its first chunk to the
+     *        end of its last chunk, otherwise the transfer times of its chunks are summed
+     * \param fromRequest whether the transfer time of a burst starts at its request
+     *        rather than at the start of its transmission
+     */
+    void SetThroughputSampling(int64_t chunks, bool segmentSpan, bool fromRequest);
+
     videoData m_videoData;
     bufferData m_bufferData;
     throughputData m_throughput;
     playbackData m_playbackData;
     int64_t m_segmentCounter = 0;
+    int64_t m_highestRepIndex = -1; //!< index of the highest rung of the ladder, set at the first decision
+
+  private:
+    int64_t m_chunksPerSegment = 0; //!< bursts merged in a sample, 0 for one sample per burst
+    bool m_segmentSpan = false;     //!< whether a segment is timed from its first request
+    bool m_fromRequest = true;      //!< whether a burst is timed from its request
+    int64_t m_chunkCount = 0;       //!< chunks of the current segment
+    uint64_t m_chunkBytes = 0;      //!< bytes of the current segment
+    int64_t m_chunkTime = 0;        //!< summed transfer time of the current segment, in us
+    int64_t m_chunkRequest = 0;     //!< request time of the first chunk of the segment, in us
 };
 } // namespace ns3
 
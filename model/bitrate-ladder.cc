@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bitrate-ladder.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/csv-reader.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BitrateLadder");
+
+NS_OBJECT_ENSURE_REGISTERED(BitrateLadder);
+
+TypeId
+BitrateLadder::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BitrateLadder")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<BitrateLadder>()
+            .AddAttribute("Bitrates",
+                          "The rates of the rungs, separated by spaces",
+                          StringValue("3128000bps 3254000bps 3974000bps 4496000bps 6408000bps "
+                                      "10938000bps 17156000bps 35018000bps"),
+                          MakeStringAccessor(&BitrateLadder::SetBitrates),
+                          MakeStringChecker())
+            .AddAttribute("File",
+                          "A CSV file with the rate of a rung per row, overriding Bitrates if "
+                          "not empty",
+                          StringValue(""),
+                          MakeStringAccessor(&BitrateLadder::Load),
+                          MakeStringChecker());
+    return tid;
+}
+
+BitrateLadder::BitrateLadder()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BitrateLadder::~BitrateLadder()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BitrateLadder::SetBitrates(std::string bitrates)
+{
+    NS_LOG_FUNCTION(this << bitrates);
+
+    std::istringstream is(bitrates);
+    std::vector<double> rungs;
+    std::string rate;
+    while (is >> rate)
+    {
+        rungs.push_back(DataRate(rate).GetBitRate());
+    }
+    SetRungs(rungs);
+}
+
+void
+BitrateLadder::Load(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (filename.empty())
+    {
+        return;
+    }
+
+    CsvReader csv(filename);
+    std::vector<double> rungs;
+    while (csv.FetchNextRow())
+    {
+        if (csv.IsBlankRow())
+        {
+            continue;
+        }
+
+        std::string rate;
+        bool ok = csv.GetValue(0, rate);
+        NS_ABORT_MSG_IF(!ok, "Something went wrong on line " << csv.RowNumber() << " of file "
+                                                             << filename);
+        rungs.push_back(DataRate(rate).GetBitRate());
+    }
+    SetRungs(rungs);
+    NS_LOG_INFO("Loaded " << m_bitrates.size() << " rungs from file " << filename);
+}
+
+void
+BitrateLadder::SetRungs(std::vector<double> bitrates)
+{
+    NS_ABORT_MSG_IF(bitrates.empty(), "A bitrate ladder needs at least one rung");
+    std::sort(bitrates.begin(), bitrates.end());
+    bitrates.erase(std::unique(bitrates.begin(), bitrates.end()), bitrates.end());
+    NS_ABORT_MSG_IF(bitrates.front() <= 0,
+                    "The rates of a bitrate ladder must be positive, instead: " << bitrates.front());
+    m_bitrates = std::move(bitrates);
+}
+
+uint32_t
+BitrateLadder::GetSize() const
+{
+    return m_bitrates.size();
+}
+
+DataRate
+BitrateLadder::GetRate(uint32_t index) const
+{
+    NS_ASSERT_MSG(index < m_bitrates.size(), "Rung " << index << " out of " << m_bitrates.size());
+    return DataRate(uint64_t(m_bitrates[index]));
+}
+
+const std::vector<double>&
+BitrateLadder::GetBitrates() const
+{
+    return m_bitrates;
+}
+
+DataRate
+BitrateLadder::GetMinRate() const
+{
+    return GetRate(0);
+}
+
+DataRate
+BitrateLadder::GetMaxRate() const
+{
+    return GetRate(m_bitrates.size() - 1);
+}
+
+uint32_t
+BitrateLadder::GetIndex(DataRate rate) const
+{
+    auto it = std::upper_bound(m_bitrates.begin(), m_bitrates.end(), double(rate.GetBitRate()));
+    return it == m_bitrates.begin() ? 0 : it - m_bitrates.begin() - 1;
+}
+
+DataRate
+BitrateLadder::Quantize(DataRate rate) const
+{
+    return GetRate(GetIndex(rate));
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BITRATE_LADDER_H
+#define BITRATE_LADDER_H
+
+#include "ns3/data-rate.h"
+#include "ns3/object.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief The encoding bitrates a VR stream can be served at
+ *
+ * The ladder is a set of increasing bitrates (rungs), given either as a list
+ * in the Bitrates attribute or as a CSV file with one bitrate per row (File
+ * attribute). The default is the 8-rung ladder the adaptation algorithms were
+ * designed with.
+ *
+ * A single ladder can be shared by the adaptation algorithms, which choose a
+ * rung (or quantize their rate to it), and by the VrBurstGenerator, which
+ * only encodes at the rates of the ladder. Quantizing a rate is a binary
+ * search, so that fine-grained ladders have no noticeable cost.
+ */
+class BitrateLadder : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    BitrateLadder();
+    ~BitrateLadder() override;
+
+    /**
+     * \brief Set the rungs of the ladder
+     * \param bitrates the rates, separated by spaces, in any order (e.g., "3Mbps 10Mbps")
+     */
+    void SetBitrates(std::string bitrates);
+
+    /**
+     * \brief Load the rungs of the ladder from a CSV file, one rate per row
+     * \param filename the file, ignored if empty
+     */
+    void Load(std::string filename);
+
+    /**
+     * \return the number of rungs
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \param index the index of a rung
+     * \return the rate of the rung
+     */
+    DataRate GetRate(uint32_t index) const;
+
+    /**
+     * \return the rates of the rungs in increasing order, in bit/s
+     */
+    const std::vector<double>& GetBitrates() const;
+
+    /**
+     * \return the rate of the lowest rung
+     */
+    DataRate GetMinRate() const;
+
+    /**
+     * \return the rate of the highest rung
+     */
+    DataRate GetMaxRate() const;
+
+    /**
+     * \param rate a rate
+     * \return the index of the highest rung not above rate, or 0 if rate is
+     *         below the lowest rung
+     */
+    uint32_t GetIndex(DataRate rate) const;
+
+    /**
+     * \param rate a rate
+     * \return the rate of the highest rung not above rate, or the lowest rung
+     *         if rate is below it
+     */
+    DataRate Quantize(DataRate rate) const;
+
+  private:
+    /**
+     * \brief Sort the rungs and check them
+     * \param bitrates the rates of the rungs, in bit/s
+     */
+    void SetRungs(std::vector<double> bitrates);
+
+    std::vector<double> m_bitrates; //!< rates of the rungs in increasing order, in bit/s
+};
+
+} // namespace ns3
+
+#endif /* BITRATE_LADDER_H */
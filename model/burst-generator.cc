@@ -45,6 +45,25 @@ BurstGenerator::GetTypeId ()
   return tid;
 }
 
+SeqTsSizeFragHeader::FrameType
+BurstGenerator::GetLastFrameType (void) const
+{
+  return SeqTsSizeFragHeader::UNSPECIFIED_FRAME;
+}
+
+const std::vector<BurstGenerator::SubBurst> &
+BurstGenerator::GetLastSubBursts (void) const
+{
+  static const std::vector<SubBurst> noSubBursts;
+  return noSubBursts;
+}
+
+void
+BurstGenerator::TakeLastSubBursts (std::vector<SubBurst> &subBursts)
+{
+  subBursts.clear ();
+}
+
 void
 BurstGenerator::DoDispose ()
 {
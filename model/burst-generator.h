@@ -21,6 +21,9 @@
 #define BURST_GENERATOR_H
 
 #include <ns3/object.h>
+#include <ns3/seq-ts-size-frag-header.h>
+
+#include <vector>
 
 namespace ns3 {
 
@@ -45,11 +48,29 @@ class Time;
  * probability distributions for burst size and period, correlations
  * among successive burst sizes and periods, cross-correlation between
  * burst size and period, etc.
- * 
+ *
+ * Generators with a frame structure can also report the type of the last
+ * generated burst through GetLastFrameType, which the applications copy to
+ * the header of its fragments.
+ *
+ * Generators splitting a burst into sub-bursts, e.g., the tiles of a 360
+ * degrees frame, report them through GetLastSubBursts: the applications
+ * then send each sub-burst as a burst of its own, all at once, instead of
+ * the whole burst.
  */
 class BurstGenerator : public Object
 {
 public:
+  /**
+   * A part of a burst sent as a burst of its own
+   */
+  struct SubBurst
+  {
+    uint32_t size; //!< size of the sub-burst [B]
+    uint16_t tile; //!< tile carried by the sub-burst
+    uint8_t quality; //!< quality level of the tile
+  };
+
   BurstGenerator ();
   virtual ~BurstGenerator ();
 
@@ -75,6 +96,30 @@ public:
    */
   virtual bool HasNextBurst (void) = 0;
 
+  /**
+   * Get the type of the frame carried by the last generated burst.
+   *
+   * \return the frame type, UNSPECIFIED_FRAME unless overridden
+   */
+  virtual SeqTsSizeFragHeader::FrameType GetLastFrameType (void) const;
+
+  /**
+   * Get the sub-bursts of the last generated burst, whose sizes add up to
+   * the burst size.
+   *
+   * \return the sub-bursts, empty unless overridden, i.e., a single burst
+   */
+  virtual const std::vector<SubBurst> &GetLastSubBursts (void) const;
+
+  /**
+   * Move the sub-bursts of the last generated burst into subBursts, without
+   * copying them. The generator keeps the storage of subBursts for its next
+   * bursts, so GetLastSubBursts is unspecified until the next burst.
+   *
+   * \param subBursts the vector receiving the sub-bursts, cleared unless overridden
+   */
+  virtual void TakeLastSubBursts (std::vector<SubBurst> &subBursts);
+
 protected:
   virtual void DoDispose (void) override;
 };
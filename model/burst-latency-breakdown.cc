@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "burst-latency-breakdown.h"
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstLatencyBreakdown");
+
+NS_OBJECT_ENSURE_REGISTERED(BurstLatencyCollector);
+
+Time
+BurstLatencyBreakdown::GetApplicationQueueing() const
+{
+    return lastTx - enqueued;
+}
+
+Time
+BurstLatencyBreakdown::GetRender() const
+{
+    return renderStart.IsZero() ? Time(0) : rendered - renderStart;
+}
+
+Time
+BurstLatencyBreakdown::GetEncode() const
+{
+    return renderStart.IsZero() ? Time(0) : enqueued - encodeStart;
+}
+
+Time
+BurstLatencyBreakdown::GetPipeline() const
+{
+    return renderStart.IsZero() ? Time(0) : enqueued - generated;
+}
+
+Time
+BurstLatencyBreakdown::GetTransit() const
+{
+    return firstRx - firstTx;
+}
+
+Time
+BurstLatencyBreakdown::GetReassembly() const
+{
+    return completed - firstRx;
+}
+
+Time
+BurstLatencyBreakdown::GetMotionToPhoton() const
+{
+    return poseSent.IsZero() ? Time(0) : completed - poseSent;
+}
+
+TypeId
+BurstLatencyCollector::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BurstLatencyCollector")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<BurstLatencyCollector>()
+            .AddTraceSource("Breakdown",
+                            "The sender and receiver timestamps of a burst have been joined",
+                            MakeTraceSourceAccessor(&BurstLatencyCollector::m_breakdownTrace),
+                            "ns3::BurstLatencyBreakdown::TracedCallback");
+    return tid;
+}
+
+BurstLatencyCollector::BurstLatencyCollector()
+    : m_joined(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BurstLatencyCollector::~BurstLatencyCollector()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BurstLatencyCollector::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_pending.clear();
+    m_stream = nullptr;
+    Object::DoDispose();
+}
+
+void
+BurstLatencyCollector::SetOutputStream(Ptr<OutputStreamWrapper> stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_stream = stream;
+    *m_stream->GetStream() << "Flow,BurstSeq,BurstSize,TotFrags,Generated_ns,Enqueued_ns,"
+                              "FirstTx_ns,LastTx_ns,FirstRx_ns,Completed_ns,Stream,PoseSent_ns,"
+                              "RenderStart_ns,Rendered_ns,EncodeStart_ns"
+                           << std::endl;
+}
+
+void
+BurstLatencyCollector::SenderBreakdown(const Address& flow, const BurstLatencyBreakdown& breakdown)
+{
+    Join(flow, breakdown, true);
+}
+
+void
+BurstLatencyCollector::ReceiverBreakdown(const Address& flow,
+                                         const BurstLatencyBreakdown& breakdown)
+{
+    Join(flow, breakdown, false);
+}
+
+uint64_t
+BurstLatencyCollector::GetJoinedBursts() const
+{
+    return m_joined;
+}
+
+void
+BurstLatencyCollector::Join(const Address& flow,
+                            const BurstLatencyBreakdown& breakdown,
+                            bool fromSender)
+{
+    BurstKey key(flow, breakdown.stream, breakdown.seq);
+    auto it = m_pending.find(key);
+    if (it == m_pending.end())
+    {
+        m_pending.emplace(key, PendingBreakdown{breakdown, fromSender});
+        return;
+    }
+    NS_ASSERT_MSG(it->second.fromSender != fromSender,
+                  "Burst " << breakdown.seq << " traced twice by the same end");
+
+    const BurstLatencyBreakdown& sender = fromSender ? breakdown : it->second.breakdown;
+    const BurstLatencyBreakdown& receiver = fromSender ? it->second.breakdown : breakdown;
+
+    BurstLatencyBreakdown joined = sender;
+    joined.firstRx = receiver.firstRx;
+    joined.completed = receiver.completed;
+
+    // earlier bursts of this stream were dropped by the receiver
+    m_pending.erase(m_pending.lower_bound(BurstKey(flow, breakdown.stream, 0)), ++it);
+
+    m_joined++;
+    NS_LOG_LOGIC("Joined burst " << joined.seq << ": queueing "
+                                 << joined.GetApplicationQueueing().As(Time::MS) << ", transit "
+                                 << joined.GetTransit().As(Time::MS) << ", reassembly "
+                                 << joined.GetReassembly().As(Time::MS));
+    m_breakdownTrace(flow, joined);
+    if (m_stream)
+    {
+        WriteRow(flow, joined);
+    }
+}
+
+void
+BurstLatencyCollector::WriteRow(const Address& flow, const BurstLatencyBreakdown& breakdown)
+{
+    auto nameIt = m_flowNames.find(flow);
+    if (nameIt == m_flowNames.end())
+    {
+        std::stringstream name;
+        if (InetSocketAddress::IsMatchingType(flow))
+        {
+            name << InetSocketAddress::ConvertFrom(flow).GetIpv4();
+        }
+        else if (Inet6SocketAddress::IsMatchingType(flow))
+        {
+            name << Inet6SocketAddress::ConvertFrom(flow).GetIpv6();
+        }
+        else
+        {
+            name << flow;
+        }
+        nameIt = m_flowNames.emplace(flow, name.str()).first;
+    }
+
+    *m_stream->GetStream() << nameIt->second << "," << breakdown.seq << "," << breakdown.size
+                           << "," << breakdown.frags << "," << breakdown.generated.GetNanoSeconds()
+                           << "," << breakdown.enqueued.GetNanoSeconds() << ","
+                           << breakdown.firstTx.GetNanoSeconds() << ","
+                           << breakdown.lastTx.GetNanoSeconds() << ","
+                           << breakdown.firstRx.GetNanoSeconds() << ","
+                           << breakdown.completed.GetNanoSeconds() << "," << +breakdown.stream
+                           << "," << breakdown.poseSent.GetNanoSeconds() << ","
+                           << breakdown.renderStart.GetNanoSeconds() << ","
+                           << breakdown.rendered.GetNanoSeconds() << ","
+                           << breakdown.encodeStart.GetNanoSeconds() << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BURST_LATENCY_BREAKDOWN_H
+#define BURST_LATENCY_BREAKDOWN_H
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Timestamps of a burst along the send and receive pipeline
+ *
+ * The sender (BurstyApplicationServerInstance) fills the generation, render,
+ * encode, enqueue and socket hand-off times, the receiver
+ * (BurstyApplicationClient) fills the
+ * generation time carried by SeqTsSizeFragHeader and the reception times.
+ * Timestamps not known at one end are left to zero: BurstLatencyCollector
+ * joins the two halves by (flow, stream, seq).
+ */
+struct BurstLatencyBreakdown
+{
+    uint64_t seq{0};   //!< burst sequence number
+    uint64_t size{0};  //!< burst payload [B]
+    uint16_t frags{0}; //!< number of fragments of the burst
+    uint8_t stream{0}; //!< sub-stream of the burst, see SeqTsSizeFragHeader::StreamType
+    Time poseSent;     //!< the client sent the last pose known when the burst was generated
+    Time generated;    //!< the burst was produced by the BurstGenerator
+    Time renderStart;  //!< the frame started to be rendered, zero if not rendered
+    Time rendered;     //!< the frame was rendered
+    Time encodeStart;  //!< the frame started to be encoded; it was encoded when enqueued
+    Time enqueued;     //!< the fragments were pushed into the application queue
+    Time firstTx;      //!< the first fragment was handed to the socket
+    Time lastTx;       //!< the last fragment was handed to the socket
+    Time firstRx;      //!< the first fragment was received
+    Time completed;    //!< the last missing fragment was received
+
+    /**
+     * \return the time spent in the application queue, from enqueue until the
+     * last fragment was accepted by the socket
+     */
+    Time GetApplicationQueueing() const;
+
+    /**
+     * \return the render time, zero if the burst was not rendered
+     */
+    Time GetRender() const;
+
+    /**
+     * \return the encode time, zero if the burst was not rendered
+     */
+    Time GetEncode() const;
+
+    /**
+     * \return the time from the generation until the encoded frame was
+     * enqueued, including the waits for the renderer and the encoder, zero if
+     * the burst was not rendered
+     */
+    Time GetPipeline() const;
+
+    /**
+     * \return the time spent in the socket buffer and in the network by the
+     * first fragment
+     */
+    Time GetTransit() const;
+
+    /**
+     * \return the time spent waiting for the remaining fragments after the
+     * first one was received
+     */
+    Time GetReassembly() const;
+
+    /**
+     * \return the motion-to-photon latency estimate, from the time the pose
+     * was sent until the burst was completed, or zero if the burst was not
+     * generated from a pose
+     */
+    Time GetMotionToPhoton() const;
+
+    /**
+     * TracedCallback signature for burst latency breakdowns.
+     *
+     * \param [in] flow the address identifying the flow, i.e., the address of
+     * the client as seen by the server
+     * \param [in] breakdown the burst timestamps
+     */
+    typedef void (*TracedCallback)(const Address& flow, const BurstLatencyBreakdown& breakdown);
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Joins sender and receiver BurstLatencyBreakdown traces
+ *
+ * Connect SenderBreakdown to the BurstLatencyBreakdown trace source of
+ * BurstyApplicationServer and ReceiverBreakdown to the one of
+ * BurstyApplicationClient. Both ends identify the flow with the address of
+ * the client as seen by the server, even if the client socket is bound to
+ * the any-address, so each burst is matched by (flow, stream, seq) and exported
+ * through the Breakdown trace source and, optionally, as a CSV row.
+ *
+ * Bursts that are never completed are discarded as soon as a later burst of
+ * the same flow and stream is completed, since the client drops them as well.
+ */
+class BurstLatencyCollector : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    BurstLatencyCollector();
+    ~BurstLatencyCollector() override;
+
+    /**
+     * \brief Write each joined burst as a CSV row
+     * \param stream the output stream; the CSV header is written immediately
+     */
+    void SetOutputStream(Ptr<OutputStreamWrapper> stream);
+
+    /**
+     * \brief Trace sink for the sender half of the breakdown
+     * \param flow the flow
+     * \param breakdown the sender timestamps
+     */
+    void SenderBreakdown(const Address& flow, const BurstLatencyBreakdown& breakdown);
+
+    /**
+     * \brief Trace sink for the receiver half of the breakdown
+     * \param flow the flow
+     * \param breakdown the receiver timestamps
+     */
+    void ReceiverBreakdown(const Address& flow, const BurstLatencyBreakdown& breakdown);
+
+    /**
+     * \return the number of joined bursts
+     */
+    uint64_t GetJoinedBursts() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Key identifying a burst: flow, stream and sequence number
+    typedef std::tuple<Address, uint8_t, uint64_t> BurstKey;
+
+    /// A half of the breakdown waiting for the other one
+    struct PendingBreakdown
+    {
+        BurstLatencyBreakdown breakdown; //!< timestamps known so far
+        bool fromSender;                 //!< whether the timestamps come from the sender
+    };
+
+    /**
+     * \brief Store a half of the breakdown or join it with the other one
+     * \param flow the flow
+     * \param breakdown the timestamps
+     * \param fromSender whether the timestamps come from the sender
+     */
+    void Join(const Address& flow, const BurstLatencyBreakdown& breakdown, bool fromSender);
+
+    /**
+     * \brief Write a joined breakdown to the output stream
+     * \param flow the flow
+     * \param breakdown the joined timestamps
+     */
+    void WriteRow(const Address& flow, const BurstLatencyBreakdown& breakdown);
+
+    std::map<BurstKey, PendingBreakdown> m_pending; //!< halves waiting to be joined
+    std::map<Address, std::string> m_flowNames;     //!< formatted flow addresses
+    Ptr<OutputStreamWrapper> m_stream;              //!< CSV output, if any
+    uint64_t m_joined;                              //!< number of joined bursts
+
+    /// Joined breakdowns
+    ns3::TracedCallback<const Address&, const BurstLatencyBreakdown&> m_breakdownTrace;
+};
+
+} // namespace ns3
+
+#endif /* BURST_LATENCY_BREAKDOWN_H */
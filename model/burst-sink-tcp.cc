@@ -31,6 +31,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "burst-sink-tcp.h"
+#include "vr-app-profiler.h"
 #include "ns3/boolean.h"
 
 namespace ns3 {
@@ -149,30 +150,10 @@ BurstSinkTcp::HandleRead (Ptr<Socket> socket)
         {
           m_incomplete_packets[socket]->AddAtEnd (fragment);
           fragment = m_incomplete_packets[socket]->Copy ();
+          VR_APP_PROFILE (BURST_SINK, PACKET_COPY);
           m_incomplete_packets[socket] = nullptr;
         }
 
-      std::stringstream addressStr;
-      if (InetSocketAddress::IsMatchingType (from))
-        {
-          addressStr << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port "
-                     << InetSocketAddress::ConvertFrom (from).GetPort ();
-        }
-      else if (Inet6SocketAddress::IsMatchingType (from))
-        {
-          addressStr << Inet6SocketAddress::ConvertFrom (from).GetIpv6 () << " port "
-                     << Inet6SocketAddress::ConvertFrom (from).GetPort ();
-        }
-      else
-        {
-          addressStr << "UNKNOWN ADDRESS TYPE";
-        }
-
-      NS_LOG_INFO ("At time " << Simulator::Now ().As (Time::S) << " burst sink received "
-                              << fragment->GetSize () << " bytes from " << addressStr.str ()
-                              << fragment->GetSize () << " bytes from "
-                              << " total Rx " << m_totRxBytes << " bytes");
-
       socket->GetSockName (localAddress);
 
       // handle received fragment
@@ -181,8 +162,14 @@ BurstSinkTcp::HandleRead (Ptr<Socket> socket)
         {
           NS_LOG_LOGIC ("New stream from " << from);
           itBuffer = m_burstHandlerMap.insert (std::make_pair (from, BurstHandler ())).first;
+          VR_APP_PROFILE (BURST_SINK, MAP_INSERTION);
+          itBuffer->second.m_peer.SetAddress (from, VrAppProfiler::BURST_SINK);
         }
 
+      NS_LOG_INFO ("At time " << Simulator::Now ().As (Time::S) << " burst sink received "
+                              << fragment->GetSize () << " bytes from " << itBuffer->second.m_peer
+                              << " total Rx " << m_totRxBytes << " bytes");
+
       uint64_t del_size = 0;
 
       SeqTsSizeFragHeader header;
@@ -202,12 +189,15 @@ BurstSinkTcp::HandleRead (Ptr<Socket> socket)
               m_incomplete_packets[socket] =
                   fragment->Copy ()->CreateFragment (del_size, fragment->GetSize () - del_size);
               fragment = fragment->Copy ()->CreateFragment (0, del_size);
+              VR_APP_PROFILE_N (BURST_SINK, PACKET_COPY, 2);
+              VR_APP_PROFILE_N (BURST_SINK, CREATE_FRAGMENT, 2);
 
               FragmentReceived (itBuffer->second, fragment, from, localAddress);
             }
           else
             {
               m_incomplete_packets[socket] = fragment->Copy ();
+              VR_APP_PROFILE (BURST_SINK, PACKET_COPY);
             }
         }
       else
@@ -216,6 +206,7 @@ BurstSinkTcp::HandleRead (Ptr<Socket> socket)
                                                                 << " fragment serialized "
                                                                 << fragment->GetSerializedSize ());
           m_incomplete_packets[socket] = fragment->Copy ();
+          VR_APP_PROFILE (BURST_SINK, PACKET_COPY);
         }
     }
 }
@@ -31,6 +31,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "burst-sink.h"
+#include "vr-app-profiler.h"
 #include "ns3/boolean.h"
 
 namespace ns3 {
@@ -192,26 +193,6 @@ BurstSink::HandleRead (Ptr<Socket> socket)
         }
       m_totRxBytes += fragment->GetSize ();
 
-      std::stringstream addressStr;
-      if (InetSocketAddress::IsMatchingType (from))
-        {
-          addressStr << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port "
-                     << InetSocketAddress::ConvertFrom (from).GetPort ();
-        }
-      else if (Inet6SocketAddress::IsMatchingType (from))
-        {
-          addressStr << Inet6SocketAddress::ConvertFrom (from).GetIpv6 () << " port "
-                     << Inet6SocketAddress::ConvertFrom (from).GetPort ();
-        }
-      else
-        {
-          addressStr << "UNKNOWN ADDRESS TYPE";
-        }
-
-      NS_LOG_INFO ("At time " << Simulator::Now ().As (Time::S) << " burst sink received "
-                              << fragment->GetSize () << " bytes from " << addressStr.str ()
-                              << " total Rx " << m_totRxBytes << " bytes");
-
       socket->GetSockName (localAddress);
 
       // handle received fragment
@@ -220,7 +201,14 @@ BurstSink::HandleRead (Ptr<Socket> socket)
         {
           NS_LOG_LOGIC ("New stream from " << from);
           itBuffer = m_burstHandlerMap.insert (std::make_pair (from, BurstHandler ())).first;
+          VR_APP_PROFILE (BURST_SINK, MAP_INSERTION);
+          itBuffer->second.m_peer.SetAddress (from, VrAppProfiler::BURST_SINK);
         }
+
+      NS_LOG_INFO ("At time " << Simulator::Now ().As (Time::S) << " burst sink received "
+                              << fragment->GetSize () << " bytes from " << itBuffer->second.m_peer
+                              << " total Rx " << m_totRxBytes << " bytes");
+
       FragmentReceived (itBuffer->second, fragment, from, localAddress);
     }
 }
@@ -264,6 +252,7 @@ BurstSink::FragmentReceived (BurstHandler &burstHandler, const Ptr<Packet> &f, c
       burstHandler.m_fragmentsMerged = 0;
       burstHandler.m_unorderedFragments.clear ();
       burstHandler.m_burstBuffer = Create<Packet> (0);
+      VR_APP_PROFILE (BURST_SINK, PACKET_CREATION);
     }
 
   if (header.GetSeq () == burstHandler.m_currentBurstSeq)
@@ -309,6 +298,7 @@ BurstSink::FragmentReceived (BurstHandler &burstHandler, const Ptr<Packet> &f, c
                                                   << header.GetSeq () << " to buffer ");
           burstHandler.m_unorderedFragments.insert (
               std::pair<uint16_t, const Ptr<Packet>> (header.GetFragSeq (), f));
+          VR_APP_PROFILE (BURST_SINK, MAP_INSERTION);
         }
     }
 
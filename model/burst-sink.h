@@ -28,6 +28,7 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/socket.h"
 #include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/peer-descriptor.h"
 #include <unordered_map>
 #include <map>
 
@@ -160,6 +161,7 @@ protected:
     uint16_t m_fragmentsMerged{0}; //!< Number of ordered fragments received and merged for the current burst
     std::map<uint16_t, const Ptr<Packet>> m_unorderedFragments; //!< The fragments received out-of-order, still to be merged
     Ptr<Packet> m_burstBuffer{Create<Packet> (0)}; //!< The buffer containing the ordered received fragments
+    PeerDescriptor m_peer; //!< The sender, formatted only when logged
   };
 
   /**
@@ -0,0 +1,332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "burst-trace-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstTraceWriter");
+
+NS_OBJECT_ENSURE_REGISTERED(BurstTraceWriter);
+
+namespace
+{
+const char TRACE_MAGIC[8] = {'V', 'R', 'B', 'T', 'R', 'C', '0', '1'};
+
+template <typename T>
+void
+WriteValue(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void
+WriteColumn(std::ofstream& file, const std::vector<T>& column)
+{
+    file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+} // namespace
+
+TypeId
+BurstTraceWriter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BurstTraceWriter")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<BurstTraceWriter>()
+            .AddAttribute("BlockCapacity",
+                          "Number of records buffered in memory before being handed to the "
+                          "background writer",
+                          UintegerValue(65536),
+                          MakeUintegerAccessor(&BurstTraceWriter::m_blockCapacity),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("KeyByDestination",
+                          "If true, flows are identified by the receiver address of the trace, "
+                          "otherwise by the sender address",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BurstTraceWriter::m_keyByDestination),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+BurstTraceWriter::BurstTraceWriter()
+    : m_blockCapacity(65536),
+      m_keyByDestination(false),
+      m_kind(BURST_RECORDS),
+      m_open(false),
+      m_records(0),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BurstTraceWriter::~BurstTraceWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+BurstTraceWriter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+    Object::DoDispose();
+}
+
+void
+BurstTraceWriter::Open(const std::string& filename, RecordKind kind)
+{
+    NS_LOG_FUNCTION(this << filename << kind);
+    NS_ABORT_MSG_IF(m_open, "BurstTraceWriter is already open");
+
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Can't open file " << filename);
+
+    m_kind = kind;
+    m_file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    WriteValue<uint32_t>(m_file, m_kind);
+    WriteValue<uint32_t>(m_file, m_blockCapacity);
+
+    m_current = std::make_unique<ColumnBlock>();
+    m_current->Reserve(m_blockCapacity);
+    m_stop = false;
+    m_open = true;
+    m_writer = std::thread(&BurstTraceWriter::WriterLoop, this);
+}
+
+void
+BurstTraceWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_open)
+    {
+        return;
+    }
+
+    if (m_current->Size() > 0)
+    {
+        SubmitCurrentBlock();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_writer.join();
+
+    // end-of-blocks marker and flow table
+    WriteValue<uint32_t>(m_file, 0);
+    WriteValue<uint32_t>(m_file, m_flowNames.size());
+    for (const auto& name : m_flowNames)
+    {
+        WriteValue<uint16_t>(m_file, name.size());
+        m_file.write(name.data(), name.size());
+    }
+    m_file.close();
+
+    m_current.reset();
+    m_free.clear();
+    m_open = false;
+    NS_LOG_INFO("Closed trace with " << m_records << " records and " << m_flowNames.size()
+                                     << " flows");
+}
+
+void
+BurstTraceWriter::BurstRx(Ptr<const Packet> burst,
+                          const Address& from,
+                          const Address& to,
+                          const SeqTsSizeFragHeader& header)
+{
+    Append(m_keyByDestination ? to : from, header, 0, header.GetSize());
+}
+
+void
+BurstTraceWriter::FragmentRx(Ptr<const Packet> fragment,
+                             const Address& from,
+                             const Address& to,
+                             const SeqTsSizeFragHeader& header)
+{
+    Append(m_keyByDestination ? to : from, header, header.GetFragSeq(), fragment->GetSize());
+}
+
+uint64_t
+BurstTraceWriter::GetRecords() const
+{
+    return m_records;
+}
+
+void
+BurstTraceWriter::Append(const Address& flow,
+                         const SeqTsSizeFragHeader& header,
+                         uint16_t fragSeq,
+                         uint32_t size)
+{
+    NS_ASSERT_MSG(m_open, "BurstTraceWriter must be opened before connecting it to a trace");
+
+    ColumnBlock& block = *m_current;
+    block.flow.push_back(GetFlowId(flow));
+    block.txNs.push_back(header.GetTs().GetNanoSeconds());
+    block.rxNs.push_back(Simulator::Now().GetNanoSeconds());
+    block.seq.push_back(header.GetSeq());
+    block.fragSeq.push_back(fragSeq);
+    block.frags.push_back(header.GetFrags());
+    block.size.push_back(size);
+    m_records++;
+
+    if (block.Size() >= m_blockCapacity)
+    {
+        SubmitCurrentBlock();
+    }
+}
+
+uint32_t
+BurstTraceWriter::GetFlowId(const Address& flow)
+{
+    auto it = m_flowIds.find(flow);
+    if (it != m_flowIds.end())
+    {
+        return it->second;
+    }
+
+    std::stringstream name;
+    if (InetSocketAddress::IsMatchingType(flow))
+    {
+        name << InetSocketAddress::ConvertFrom(flow).GetIpv4();
+    }
+    else if (Inet6SocketAddress::IsMatchingType(flow))
+    {
+        name << Inet6SocketAddress::ConvertFrom(flow).GetIpv6();
+    }
+    else
+    {
+        name << flow;
+    }
+
+    uint32_t id = m_flowNames.size();
+    m_flowIds.emplace(flow, id);
+    m_flowNames.push_back(name.str());
+    return id;
+}
+
+void
+BurstTraceWriter::SubmitCurrentBlock()
+{
+    NS_LOG_FUNCTION(this << m_current->Size());
+
+    std::unique_ptr<ColumnBlock> next;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::move(m_current));
+        if (!m_free.empty())
+        {
+            next = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_cv.notify_one();
+
+    if (!next)
+    {
+        next = std::make_unique<ColumnBlock>();
+        next->Reserve(m_blockCapacity);
+    }
+    m_current = std::move(next);
+}
+
+void
+BurstTraceWriter::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty())
+        {
+            // m_stop is set and everything has been written
+            return;
+        }
+
+        std::unique_ptr<ColumnBlock> block = std::move(m_pending.front());
+        m_pending.pop_front();
+
+        lock.unlock();
+        WriteBlock(*block);
+        block->Clear();
+        lock.lock();
+
+        m_free.push_back(std::move(block));
+    }
+}
+
+void
+BurstTraceWriter::WriteBlock(const ColumnBlock& block)
+{
+    WriteValue<uint32_t>(m_file, block.Size());
+    WriteColumn(m_file, block.flow);
+    WriteColumn(m_file, block.txNs);
+    WriteColumn(m_file, block.rxNs);
+    WriteColumn(m_file, block.seq);
+    WriteColumn(m_file, block.fragSeq);
+    WriteColumn(m_file, block.frags);
+    WriteColumn(m_file, block.size);
+}
+
+void
+BurstTraceWriter::ColumnBlock::Reserve(uint32_t capacity)
+{
+    flow.reserve(capacity);
+    txNs.reserve(capacity);
+    rxNs.reserve(capacity);
+    seq.reserve(capacity);
+    fragSeq.reserve(capacity);
+    frags.reserve(capacity);
+    size.reserve(capacity);
+}
+
+void
+BurstTraceWriter::ColumnBlock::Clear()
+{
+    flow.clear();
+    txNs.clear();
+    rxNs.clear();
+    seq.clear();
+    fragSeq.clear();
+    frags.clear();
+    size.clear();
+}
+
+uint32_t
+BurstTraceWriter::ColumnBlock::Size() const
+{
+    return flow.size();
+}
+
+} // namespace ns3
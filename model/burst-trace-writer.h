@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BURST_TRACE_WRITER_H
+#define BURST_TRACE_WRITER_H
+
+#include "ns3/address.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/seq-ts-size-frag-header.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Writes burst and fragment reception traces in a binary columnar format
+ *
+ * Text traces written through OutputStreamWrapper format every field of every
+ * fragment on the simulation thread, which dominates the run time of large
+ * scenarios. This class instead appends fixed-width records to in-memory
+ * column blocks and hands full blocks to a background thread, which writes
+ * them to disk while the simulation keeps running.
+ *
+ * The BurstRx and FragmentRx methods have the same signature as the
+ * homonymous trace sources of BurstSink and BurstyApplicationClient, so that
+ * they can be connected with MakeCallback.
+ *
+ * File layout (all integers in host byte order, i.e., little-endian on all
+ * supported platforms):
+ *
+ * - header: 8-byte magic "VRBTRC01", uint32 record kind (0 = bursts,
+ *   1 = fragments), uint32 block capacity
+ * - zero or more blocks: uint32 number of records n > 0, followed by the
+ *   columns of the block, each one stored contiguously:
+ *   flow id (uint32 x n), tx time in ns (int64 x n), rx time in ns
+ *   (int64 x n), burst seq (uint64 x n), fragment seq (uint16 x n),
+ *   total fragments (uint16 x n), size in bytes (uint32 x n)
+ * - end-of-blocks marker: uint32 0
+ * - flow table: uint32 number of flows, then for each flow id in increasing
+ *   order a uint16 string length followed by the address string
+ *
+ * For burst records, the fragment seq column is always 0 and the size column
+ * holds the burst payload size, as in burstTrace.csv.
+ * examples/burst-trace-converter.py converts a file back to the CSV layout
+ * used by the example scripts.
+ */
+class BurstTraceWriter : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /// Kind of the records stored in a file
+    enum RecordKind
+    {
+        BURST_RECORDS = 0,
+        FRAGMENT_RECORDS = 1
+    };
+
+    BurstTraceWriter();
+    ~BurstTraceWriter() override;
+
+    /**
+     * \brief Open the output file and start the background writer
+     * \param filename the path of the output file
+     * \param kind the kind of records that will be written
+     */
+    void Open(const std::string& filename, RecordKind kind);
+
+    /**
+     * \brief Flush the pending records, write the flow table and close the file
+     *
+     * Called automatically on dispose if the user did not close the writer.
+     */
+    void Close();
+
+    /**
+     * \brief Trace sink for received bursts
+     * \param burst the received burst
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the burst header
+     */
+    void BurstRx(Ptr<const Packet> burst,
+                 const Address& from,
+                 const Address& to,
+                 const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Trace sink for received fragments
+     * \param fragment the received fragment
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the fragment header
+     */
+    void FragmentRx(Ptr<const Packet> fragment,
+                    const Address& from,
+                    const Address& to,
+                    const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Get the number of records written so far
+     * \return the number of records
+     */
+    uint64_t GetRecords() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A block of records, stored column by column
+    struct ColumnBlock
+    {
+        /**
+         * \brief Reserve space for a full block
+         * \param capacity the number of records of a full block
+         */
+        void Reserve(uint32_t capacity);
+        /// Remove all records, keeping the allocated memory
+        void Clear();
+        /// \return the number of records in the block
+        uint32_t Size() const;
+
+        std::vector<uint32_t> flow;    //!< flow id column
+        std::vector<int64_t> txNs;     //!< tx time column
+        std::vector<int64_t> rxNs;     //!< rx time column
+        std::vector<uint64_t> seq;     //!< burst seq column
+        std::vector<uint16_t> fragSeq; //!< fragment seq column
+        std::vector<uint16_t> frags;   //!< total fragments column
+        std::vector<uint32_t> size;    //!< size column
+    };
+
+    /**
+     * \brief Append a record to the current block
+     * \param flow the address identifying the flow
+     * \param header the header of the burst or fragment
+     * \param fragSeq the fragment sequence number
+     * \param size the size to store
+     */
+    void Append(const Address& flow,
+                const SeqTsSizeFragHeader& header,
+                uint16_t fragSeq,
+                uint32_t size);
+
+    /**
+     * \brief Get the id of a flow, registering it if needed
+     * \param flow the address identifying the flow
+     * \return the flow id
+     */
+    uint32_t GetFlowId(const Address& flow);
+
+    /// Hand the current block to the writer thread
+    void SubmitCurrentBlock();
+
+    /// Body of the writer thread
+    void WriterLoop();
+
+    /**
+     * \brief Write a block to the output file
+     * \param block the block to write
+     */
+    void WriteBlock(const ColumnBlock& block);
+
+    uint32_t m_blockCapacity;  //!< number of records per block
+    bool m_keyByDestination;   //!< whether flows are identified by the receiver address
+    RecordKind m_kind;         //!< kind of records written
+    std::ofstream m_file;      //!< output file
+    bool m_open;               //!< whether the writer is open
+    uint64_t m_records;        //!< number of records appended
+
+    std::map<Address, uint32_t> m_flowIds; //!< flow ids, by address
+    std::vector<std::string> m_flowNames;  //!< flow address strings, by flow id
+
+    std::unique_ptr<ColumnBlock> m_current;              //!< block being filled
+    std::deque<std::unique_ptr<ColumnBlock>> m_pending;  //!< blocks waiting to be written
+    std::vector<std::unique_ptr<ColumnBlock>> m_free;    //!< blocks ready to be reused
+    std::mutex m_mutex;                                  //!< protects m_pending and m_free
+    std::condition_variable m_cv;                        //!< wakes up the writer thread
+    bool m_stop;                                         //!< asks the writer thread to stop
+    std::thread m_writer;                                //!< background writer thread
+};
+
+} // namespace ns3
+
+#endif /* BURST_TRACE_WRITER_H */
@@ -19,11 +19,16 @@
  */
 #include "bursty-application-client.h"
 
+#include "vr-app-profiler.h"
+
 #include "ns3/address-utils.h"
 #include "ns3/address.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
+#include "ns3/ipv4-packet-info-tag.h"
+#include "ns3/ipv6-packet-info-tag.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/packet-socket-address.h"
@@ -34,6 +39,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/udp-socket.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -67,6 +73,17 @@ BurstyApplicationClient::GetTypeId(void)
                           TypeIdValue(UdpSocketFactory::GetTypeId()),
                           MakeTypeIdAccessor(&BurstyApplicationClient::m_tid),
                           MakeTypeIdChecker())
+            .AddAttribute("PoseRate",
+                          "The number of poses sent to the server per second, 0 not to send "
+                          "them",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&BurstyApplicationClient::m_poseRate),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("PoseSize",
+                          "The size of a pose message including SeqTsSizeFragHeader",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&BurstyApplicationClient::m_poseSize),
+                          MakeUintegerChecker<uint32_t>(1))
             .AddTraceSource("FragmentRx",
                             "A fragment has been received",
                             MakeTraceSourceAccessor(&BurstyApplicationClient::m_rxFragmentTrace),
@@ -74,6 +91,16 @@ BurstyApplicationClient::GetTypeId(void)
             .AddTraceSource("BurstRx",
                             "A burst has been successfully received",
                             MakeTraceSourceAccessor(&BurstyApplicationClient::m_rxBurstTrace),
+                            "ns3::BurstSink::SeqTsSizeFragCallback")
+            .AddTraceSource("BurstLatencyBreakdown",
+                            "A burst has been successfully received, the flow is identified by "
+                            "the address of the client as seen by the server",
+                            MakeTraceSourceAccessor(
+                                &BurstyApplicationClient::m_latencyBreakdownTrace),
+                            "ns3::BurstLatencyBreakdown::TracedCallback")
+            .AddTraceSource("PoseTx",
+                            "A pose has been sent to the server, header included",
+                            MakeTraceSourceAccessor(&BurstyApplicationClient::m_txPoseTrace),
                             "ns3::BurstSink::SeqTsSizeFragCallback");
     return tid;
 }
@@ -109,6 +136,13 @@ BurstyApplicationClient::GetTotalRxBursts() const
     return m_totRxBursts;
 }
 
+uint64_t
+BurstyApplicationClient::GetTotalTxPoses() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totTxPoses;
+}
+
 void
 BurstyApplicationClient::DoDispose(void)
 {
@@ -125,6 +159,11 @@ BurstyApplicationClient::StartApplication() // Called at time specified by Start
 {
     NS_LOG_FUNCTION(this);
 
+    SeqTsSizeFragHeader header;
+    NS_ABORT_MSG_IF(m_poseRate > 0 && m_poseSize <= header.GetSerializedSize(),
+                    "PoseSize " << m_poseSize << " must be larger than the header, "
+                                << header.GetSerializedSize() << " B");
+
     // Create the socket if not already
     if (!m_socket)
     {
@@ -173,12 +212,22 @@ BurstyApplicationClient::StartApplication() // Called at time specified by Start
                                     MakeCallback(&BurstyApplicationClient::HandlePeerError, this));
 
         m_socket->SetRecvCallback(MakeCallback(&BurstyApplicationClient::HandleRead, this));
+        // the destination of the first fragment completes an unbound local address
+        m_socket->SetRecvPktInfo(true);
 
         if (m_socket->GetSocketType() != Socket::NS3_SOCK_STREAM &&
             m_socket->GetSocketType() != Socket::NS3_SOCK_SEQPACKET)
         {
             Ptr<Packet> dummy = Create<Packet>(100);
             m_socket->Send(dummy);
+
+            // the dummy datagram opens the session, the poses follow
+            if (m_poseRate > 0)
+            {
+                m_poseEvent = Simulator::Schedule(Seconds(1 / m_poseRate),
+                                                  &BurstyApplicationClient::SendPose,
+                                                  this);
+            }
         }
     }
 }
@@ -187,6 +236,7 @@ void
 BurstyApplicationClient::StopApplication() // Called at time specified by Stop
 {
     NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_poseEvent);
     if (m_socket)
     {
         m_socket->Close();
@@ -210,6 +260,10 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
         { // EOF
             break;
         }
+        if (m_flowAddress.IsInvalid())
+        {
+            m_flowAddress = GetFlowAddress(socket, fragment);
+        }
 
         if (m_incomplete_packets.count(socket) == 1 && m_incomplete_packets[socket] != nullptr)
         {
@@ -218,6 +272,7 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
         else
         {
             m_incomplete_packets[socket] = fragment->Copy();
+            VR_APP_PROFILE(CLIENT, PACKET_COPY);
         }
 
         // std::cout << "Buffer has " << m_incomplete_packets[socket]->GetSize() << std::endl;
@@ -263,6 +318,7 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
                     m_incomplete_packets[socket]->CreateFragment(header.GetFragBytes(),
                                                                  extra_bytes);
                 m_incomplete_packets[socket] = frag2;
+                VR_APP_PROFILE_N(CLIENT, CREATE_FRAGMENT, 2);
                 // m_incomplete_packets[socket]->CreateFragment(header.GetFragBytes(), extra_bytes);
 
                 // SeqTsSizeFragHeader seqTs2;
@@ -272,6 +328,7 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
             if (extra_bytes == 0)
             {
                 fragment = m_incomplete_packets[socket]->Copy();
+                VR_APP_PROFILE(CLIENT, PACKET_COPY);
                 m_incomplete_packets[socket] = nullptr;
             }
             if (extra_bytes < 0)
@@ -287,35 +344,34 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
 
             m_totRxBytes += fragment->GetSize();
 
-            std::stringstream addressStr;
-            if (InetSocketAddress::IsMatchingType(from))
-            {
-                addressStr << InetSocketAddress::ConvertFrom(from).GetIpv4() << " port "
-                           << InetSocketAddress::ConvertFrom(from).GetPort();
-            }
-            else if (Inet6SocketAddress::IsMatchingType(from))
-            {
-                addressStr << Inet6SocketAddress::ConvertFrom(from).GetIpv6() << " port "
-                           << Inet6SocketAddress::ConvertFrom(from).GetPort();
-            }
-            else
-            {
-                addressStr << "UNKNOWN ADDRESS TYPE";
-            }
-
-            NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << " burst sink received "
-                                   << fragment->GetSize() << " bytes from " << addressStr.str()
-                                   << " total Rx " << m_totRxBytes << " bytes");
-
-            socket->GetSockName(localAddress);
+            localAddress = m_flowAddress;
 
             // handle received fragment
             auto itBuffer = m_burstHandlerMap.find(from); // rename m_burstBufferMap, itBuffer
             if (itBuffer == m_burstHandlerMap.end())
             {
-                NS_LOG_LOGIC("New stream from " << from);
-                itBuffer = m_burstHandlerMap.insert(std::make_pair(from, BurstHandler())).first;
+                NS_LOG_LOGIC("New session from " << from);
+                itBuffer =
+                    m_burstHandlerMap.insert(std::make_pair(from, std::vector<BurstHandler>()))
+                        .first;
+                VR_APP_PROFILE(CLIENT, MAP_INSERTION);
             }
+            std::vector<BurstHandler>& burstHandlers = itBuffer->second;
+            if (header.GetStream() >= burstHandlers.size())
+            {
+                NS_LOG_LOGIC("New stream " << +header.GetStream() << " from " << from);
+                burstHandlers.resize(header.GetStream() + 1);
+                for (auto& burstHandler : burstHandlers)
+                {
+                    burstHandler.m_peer.SetAddress(from, VrAppProfiler::CLIENT);
+                }
+            }
+            BurstHandler& burstHandler = burstHandlers[header.GetStream()];
+
+            NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << " burst sink received "
+                                   << fragment->GetSize() << " bytes from "
+                                   << burstHandler.m_peer << " total Rx " << m_totRxBytes
+                                   << " bytes");
 
             if (header.GetSeq() != UINT32_MAX)
             {
@@ -327,7 +383,8 @@ BurstyApplicationClient::HandleRead(Ptr<Socket> socket)
                 // seq " << header.GetFragSeq()<< " hsize " << header.GetSize() << " hfragbytes " <<
                 // header.GetFragBytes() << " psize " << fragment->GetSize() << std::endl;
 
-                FragmentReceived(itBuffer->second, fragment->Copy(), from, localAddress);
+                VR_APP_PROFILE(CLIENT, PACKET_COPY);
+                FragmentReceived(burstHandler, fragment->Copy(), from, localAddress);
             }
             else
             {
@@ -370,6 +427,36 @@ BurstyApplicationClient::FragmentReceived(BurstHandler& burstHandler,
         return;
     }
 
+    if (header.GetFrags() == 1)
+    {
+        // single-fragment burst, e.g., of a sub-stream: no reassembly. As for
+        // the fragments of a new burst, only a burst following the current one,
+        // or the current one if nothing of it was received, is delivered
+        if (header.GetSeq() == burstHandler.m_currentBurstSeq &&
+            (burstHandler.m_fragmentsMerged > 0 || !burstHandler.m_unorderedFragments.empty()))
+        {
+            NS_LOG_LOGIC("Ignoring stale or duplicate burst "
+                         << header.GetSeq() << ", current burst seq="
+                         << burstHandler.m_currentBurstSeq
+                         << ", fragments merged=" << burstHandler.m_fragmentsMerged);
+            return;
+        }
+        if (burstHandler.m_burstBuffer->GetSize() > 0 ||
+            !burstHandler.m_unorderedFragments.empty())
+        {
+            // discard the fragments of the previous burst: single-fragment bursts
+            // never fill the buffer, so a run of them allocates nothing
+            burstHandler.m_unorderedFragments.clear();
+            burstHandler.m_burstBuffer = Create<Packet>(0);
+            VR_APP_PROFILE(CLIENT, PACKET_CREATION);
+        }
+        burstHandler.m_currentBurstSeq = header.GetSeq();
+        burstHandler.m_fragmentsMerged = 1;
+        f->RemoveHeader(header);
+        BurstReceived(f, header, Simulator::Now(), localAddress);
+        return;
+    }
+
     if (header.GetSeq() > burstHandler.m_currentBurstSeq)
     {
         // fragment of new burst: discard previous burst if incomplete
@@ -380,11 +467,16 @@ BurstyApplicationClient::FragmentReceived(BurstHandler& burstHandler,
         burstHandler.m_fragmentsMerged = 0;
         burstHandler.m_unorderedFragments.clear();
         burstHandler.m_burstBuffer = Create<Packet>(0);
+        VR_APP_PROFILE(CLIENT, PACKET_CREATION);
     }
 
     if (header.GetSeq() == burstHandler.m_currentBurstSeq)
     {
         // fragment of current burst
+        if (burstHandler.m_fragmentsMerged == 0 && burstHandler.m_unorderedFragments.empty())
+        {
+            burstHandler.m_firstRxTime = Simulator::Now();
+        }
         NS_ASSERT_MSG(header.GetFragSeq() >= burstHandler.m_fragmentsMerged,
                       header.GetFragSeq() << " >= " << burstHandler.m_fragmentsMerged);
 
@@ -426,6 +518,7 @@ BurstyApplicationClient::FragmentReceived(BurstHandler& burstHandler,
                                                    << header.GetSeq() << " to buffer ");
             burstHandler.m_unorderedFragments.insert(
                 std::pair<uint16_t, const Ptr<Packet>>(header.GetFragSeq(), f));
+            VR_APP_PROFILE(CLIENT, MAP_INSERTION);
         }
     }
 
@@ -436,14 +529,63 @@ BurstyApplicationClient::FragmentReceived(BurstHandler& burstHandler,
         NS_ASSERT_MSG(burstHandler.m_burstBuffer->GetSize() == header.GetSize(),
                       burstHandler.m_burstBuffer->GetSize() << " == " << header.GetSize());
 
-        NS_LOG_LOGIC("Burst received: " << header.GetFrags() << " fragments for a total of "
-                                        << header.GetSize() << " B " << header.GetSeq());
+        BurstReceived(burstHandler.m_burstBuffer, header, burstHandler.m_firstRxTime, localAddress);
+    }
+}
+
+void
+BurstyApplicationClient::BurstReceived(const Ptr<Packet>& burst,
+                                       const SeqTsSizeFragHeader& header,
+                                       Time firstRx,
+                                       const Address& localAddress)
+{
+    NS_LOG_LOGIC("Burst received: " << header.GetFrags() << " fragments for a total of "
+                                    << header.GetSize() << " B " << header.GetSeq());
+    if (header.GetStream() == SeqTsSizeFragHeader::VIDEO_STREAM)
+    {
         m_totRxBursts++;
-        m_rxBurstTrace(burstHandler.m_burstBuffer,
-                       m_peer,
-                       localAddress,
-                       header); // TODO header size does not include payload, why?
     }
+    m_rxBurstTrace(burst,
+                   m_peer,
+                   localAddress,
+                   header); // TODO header size does not include payload, why?
+
+    BurstLatencyBreakdown breakdown;
+    breakdown.seq = header.GetSeq();
+    breakdown.size = header.GetSize();
+    breakdown.frags = header.GetFrags();
+    breakdown.stream = header.GetStream();
+    breakdown.poseSent = header.GetPoseTs();
+    breakdown.generated = header.GetTs();
+    breakdown.firstRx = firstRx;
+    breakdown.completed = Simulator::Now();
+    m_latencyBreakdownTrace(localAddress, breakdown);
+}
+
+Address
+BurstyApplicationClient::GetFlowAddress(Ptr<Socket> socket, Ptr<const Packet> packet) const
+{
+    Address localAddress;
+    socket->GetSockName(localAddress);
+    if (InetSocketAddress::IsMatchingType(localAddress))
+    {
+        InetSocketAddress local = InetSocketAddress::ConvertFrom(localAddress);
+        Ipv4PacketInfoTag tag;
+        if (local.GetIpv4().IsAny() && packet->PeekPacketTag(tag))
+        {
+            return InetSocketAddress(tag.GetAddress(), local.GetPort());
+        }
+    }
+    else if (Inet6SocketAddress::IsMatchingType(localAddress))
+    {
+        Inet6SocketAddress local = Inet6SocketAddress::ConvertFrom(localAddress);
+        Ipv6PacketInfoTag tag;
+        if (local.GetIpv6().IsAny() && packet->PeekPacketTag(tag))
+        {
+            return Inet6SocketAddress(tag.GetAddress(), local.GetPort());
+        }
+    }
+    return localAddress;
 }
 
 void
@@ -469,6 +611,11 @@ BurstyApplicationClient::ConnectionSucceeded(Ptr<Socket> socket)
         // Ptr<Packet> dummy = Create<Packet> (100);
         // m_socket->Send (dummy);
     }
+    else if (m_poseRate > 0)
+    {
+        m_poseEvent =
+            Simulator::Schedule(Seconds(1 / m_poseRate), &BurstyApplicationClient::SendPose, this);
+    }
 }
 
 void
@@ -476,4 +623,44 @@ BurstyApplicationClient::ConnectionFailed(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
 }
+
+void
+BurstyApplicationClient::SendPose()
+{
+    NS_LOG_FUNCTION(this);
+
+    SeqTsSizeFragHeader header;
+    header.SetSeq(m_totTxPoses);
+    header.SetSize(m_poseSize - header.GetSerializedSize());
+    header.SetFrags(1);
+    header.SetFragSeq(0);
+    header.SetFragBytes(m_poseSize);
+    header.SetStream(SeqTsSizeFragHeader::POSE_STREAM);
+
+    // a pose is stale by the time the buffer drains: skip it rather than queueing it
+    if (m_socket->GetTxAvailable() >= m_poseSize)
+    {
+        // a single packet, the payload being a zero-filled area of its buffer
+        Ptr<Packet> pose = Create<Packet>(m_poseSize - header.GetSerializedSize());
+        VR_APP_PROFILE(CLIENT, PACKET_CREATION);
+        pose->AddHeader(header);
+        m_socket->Send(pose);
+        m_totTxPoses++;
+
+        Address localAddress = m_flowAddress;
+        if (localAddress.IsInvalid())
+        {
+            // no frame yet: the address may still be the any-address
+            m_socket->GetSockName(localAddress);
+        }
+        m_txPoseTrace(pose, localAddress, m_peer, header);
+    }
+    else
+    {
+        NS_LOG_LOGIC("Send buffer full, skipping pose " << m_totTxPoses);
+    }
+
+    m_poseEvent =
+        Simulator::Schedule(Seconds(1 / m_poseRate), &BurstyApplicationClient::SendPose, this);
+}
 } // Namespace ns3
@@ -22,15 +22,18 @@
 
 #include "ns3/address.h"
 #include "ns3/application.h"
+#include "ns3/burst-latency-breakdown.h"
 #include "ns3/event-id.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/peer-descriptor.h"
 #include "ns3/ptr.h"
 #include "ns3/seq-ts-size-frag-header.h"
 #include "ns3/socket.h"
 #include "ns3/traced-callback.h"
 
-#include <unordered_map>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -73,6 +76,13 @@ class Packet;
  * Traces are sent when a fragment is received and when a whole burst is
  * successfully received.
  *
+ * Each sub-stream of a multiplexed session (see
+ * BurstyApplicationServer::AddStream) is reassembled on its own, and bursts
+ * of a single fragment are delivered without reassembly. With a positive
+ * PoseRate, the client also sends small pose messages to the server, whose
+ * send time comes back in the header of the video frames rendered with
+ * them, for a motion-to-photon estimate (see BurstLatencyBreakdown).
+ *
  */
 class BurstyApplicationClient : public Application
 {
@@ -97,10 +107,16 @@ class BurstyApplicationClient : public Application
     uint64_t GetTotalRxFragments() const;
 
     /**
-     * \return the total bursts received in this sink app
+     * \return the total video bursts received in this sink app, i.e., without
+     * the sub-streams
      */
     uint64_t GetTotalRxBursts() const;
 
+    /**
+     * \return the total poses sent by this application
+     */
+    uint64_t GetTotalTxPoses() const;
+
     /**
      * TracedCallback signature for a reception with addresses and SeqTsSizeFragHeader
      *
@@ -148,6 +164,11 @@ class BurstyApplicationClient : public Application
      */
     virtual void ConnectionFailed(Ptr<Socket> socket);
 
+    /**
+     * \brief Send a pose to the server and schedule the next one
+     */
+    void SendPose();
+
     /**
      * \brief Simple burst handler
      * Contains information regarding the current burst sequence number
@@ -161,6 +182,8 @@ class BurstyApplicationClient : public Application
             m_unorderedFragments; //!< The fragments received out-of-order, still to be merged
         Ptr<Packet> m_burstBuffer{
             Create<Packet>(0)}; //!< The buffer containing the ordered received fragments
+        Time m_firstRxTime; //!< Reception time of the first fragment of the current burst
+        PeerDescriptor m_peer; //!< The sender, formatted only when logged
     };
 
     /**
@@ -177,6 +200,31 @@ class BurstyApplicationClient : public Application
                                   const Address& from,
                                   const Address& localAddress);
 
+    /**
+     * \brief Deliver a received burst
+     * \param burst the burst, without header
+     * \param header the header of its last fragment
+     * \param firstRx the reception time of its first fragment
+     * \param localAddress local address
+     */
+    void BurstReceived(const Ptr<Packet>& burst,
+                       const SeqTsSizeFragHeader& header,
+                       Time firstRx,
+                       const Address& localAddress);
+
+    /**
+     * \brief Get the address of this client as seen by the server
+     * \param socket the socket
+     * \param packet a packet received from the server on the socket
+     * \return the local address of the socket, with the destination address
+     *         of the packet if the socket is bound to the any-address
+     *
+     * The server identifies a flow by the address it receives from, which
+     * must be used by the client too, e.g., to join the two halves of a
+     * BurstLatencyBreakdown.
+     */
+    Address GetFlowAddress(Ptr<Socket> socket, Ptr<const Packet> packet) const;
+
     /**
      * \brief Hashing for the Address class
      * Needed to make Address the key of a map.
@@ -213,18 +261,23 @@ class BurstyApplicationClient : public Application
         }
     };
 
-    std::unordered_map<Address, BurstHandler, AddressHash>
-        m_burstHandlerMap; //!< Map of BurstHandlers, assuming a user only has one data stream
+    std::unordered_map<Address, std::vector<BurstHandler>, AddressHash>
+        m_burstHandlerMap; //!< Map of the BurstHandlers of each sender, indexed by stream
 
     // In the case of TCP, each socket accept returns a new socket, so the
     // listening socket is stored separately from the accepted sockets
     Ptr<Socket> m_socket{0};      //!< Listening socket
     Address m_local;              //!< Local address to bind to
     Address m_peer;               //!< Peer address
+    Address m_flowAddress;        //!< Address of this client as seen by the server
     TypeId m_tid;                 //!< Protocol TypeId
     uint64_t m_totRxBursts{0};    //!< Total bursts received
     uint64_t m_totRxFragments{0}; //!< Total fragments received
     uint64_t m_totRxBytes{0};     //!< Total bytes received
+    double m_poseRate{0};         //!< Poses sent per second, 0 for none
+    uint32_t m_poseSize{64};      //!< Size of a pose message including SeqTsSizeFragHeader
+    uint64_t m_totTxPoses{0};     //!< Total poses sent
+    EventId m_poseEvent;          //!< Next pose
 
     // Traced Callback
     /// Callback for tracing the fragment Rx events, includes source, destination addresses, and
@@ -235,6 +288,11 @@ class BurstyApplicationClient : public Application
     /// headers
     TracedCallback<Ptr<const Packet>, const Address&, const Address&, const SeqTsSizeFragHeader&>
         m_rxBurstTrace;
+    /// Callback for the receiver timestamps of a burst
+    TracedCallback<const Address&, const BurstLatencyBreakdown&> m_latencyBreakdownTrace;
+    /// Callback for the poses sent, header included
+    TracedCallback<Ptr<const Packet>, const Address&, const Address&, const SeqTsSizeFragHeader&>
+        m_txPoseTrace;
 
     std::map<Ptr<Socket>, Ptr<Packet>> m_incomplete_packets;
 };
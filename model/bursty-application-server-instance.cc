@@ -19,6 +19,8 @@
 
 #include "bursty-application-server-instance.h"
 
+#include "vr-app-profiler.h"
+
 #include "ns3/address.h"
 #include "ns3/boolean.h"
 #include "ns3/burst-generator.h"
@@ -32,6 +34,7 @@
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/simple-burst-generator.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/socket.h"
@@ -39,6 +42,8 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -141,6 +146,48 @@ BurstyApplicationServerInstance::GetBurstGenerator(void) const
     return m_burstGenerator;
 }
 
+Ptr<SendBufferSampler>
+BurstyApplicationServerInstance::GetSendBufferSampler(void) const
+{
+    return m_sendBufferSampler;
+}
+
+Ptr<HeadMotionModel>
+BurstyApplicationServerInstance::GetHeadMotionModel(void) const
+{
+    return m_headMotionModel;
+}
+
+Ptr<EncoderRateControl>
+BurstyApplicationServerInstance::GetRateControl(void) const
+{
+    return m_rateControl;
+}
+
+Time
+BurstyApplicationServerInstance::GetLastPoseTs(void) const
+{
+    return m_lastPoseTs;
+}
+
+uint64_t
+BurstyApplicationServerInstance::GetTotalRxUplinkMessages(void) const
+{
+    return m_totRxUplink;
+}
+
+void
+BurstyApplicationServerInstance::NotifyHeadPose(const HeadPose& pose)
+{
+    m_headPoseTrace(m_peer, pose);
+}
+
+void
+BurstyApplicationServerInstance::NotifyRateControl(const RateControlSample& sample)
+{
+    m_rateControlTrace(m_peer, sample);
+}
+
 void
 BurstyApplicationServerInstance::DoDispose(void)
 {
@@ -149,6 +196,13 @@ BurstyApplicationServerInstance::DoDispose(void)
     CancelEvents();
     m_socket = 0;
     m_burstGenerator = 0;
+    m_sendBufferSampler = 0;
+    m_headMotionModel = 0;
+    m_rateControl = 0;
+    m_renderTimeRv = 0;
+    m_pipeline.clear();
+    m_streams.clear();
+    m_uplinkBuffer = 0;
 }
 
 void
@@ -158,6 +212,29 @@ BurstyApplicationServerInstance::CancelEvents()
 
     // Cancel next burst event
     Simulator::Cancel(m_nextBurstEvent);
+    for (auto& stream : m_streams)
+    {
+        Simulator::Cancel(stream.nextBurstEvent);
+    }
+    for (auto& frame : m_pipeline)
+    {
+        Simulator::Cancel(frame.emitEvent);
+    }
+
+    if (m_sendBufferSampler)
+    {
+        m_sendBufferSampler->Stop();
+    }
+}
+
+void
+BurstyApplicationServerInstance::SetAllocatedRate(DataRate rate)
+{
+    NS_LOG_FUNCTION(this << rate);
+    NS_ASSERT(m_jointAllocation);
+
+    m_allocatedRate = rate;
+    DynamicCast<VrBurstGenerator>(m_burstGenerator)->SetTargetDataRate(rate);
 }
 
 void
@@ -179,7 +256,7 @@ BurstyApplicationServerInstance::AdaptRate()
 
     DataRate nextDataRate = std::max(
         m_adaptationAlgorithmServer->nextBurstRate(m_socket, m_bytesAddedToSocket, m_txTime),
-        DataRate("3128000"));
+        m_adaptationAlgorithmServer->GetBitrateLadder()->GetMinRate());
 
     m_txTime = Seconds(0);
 
@@ -195,30 +272,26 @@ BurstyApplicationServerInstance::AdaptRate()
         m_txStarted = Simulator::Now();
     }
 
-    DynamicCast<VrBurstGenerator>(m_burstGenerator)
-        ->SetTargetDataRate(std::min(nextDataRate, m_initRate));
-
-    std::stringstream addressStr;
-    if (InetSocketAddress::IsMatchingType(m_peer))
+    DataRate cappedDataRate = std::min(nextDataRate, m_initRate);
+    if (m_jointAllocation)
     {
-        addressStr << InetSocketAddress::ConvertFrom(m_peer).GetIpv4() << " port "
-                   << InetSocketAddress::ConvertFrom(m_peer).GetPort();
-    }
-    else if (Inet6SocketAddress::IsMatchingType(m_peer))
-    {
-        addressStr << Inet6SocketAddress::ConvertFrom(m_peer).GetIpv6() << " port "
-                   << Inet6SocketAddress::ConvertFrom(m_peer).GetPort();
-    }
-    else
-    {
-        addressStr << "UNKNOWN ADDRESS TYPE";
+        // the server decides the rate, the proposed one is only a demand
+        m_demandRate = nextDataRate;
+        if (m_allocatedRate.GetBitRate() > 0)
+        {
+            cappedDataRate = m_allocatedRate;
+        }
     }
+    DynamicCast<VrBurstGenerator>(m_burstGenerator)->SetTargetDataRate(cappedDataRate);
+
+    NS_LOG_INFO("nextNoLimit " << nextDataRate.GetBitRate() / 1e6 << " nextdatarate "
+                               << cappedDataRate.GetBitRate() / 1e6);
+
+    RateDecision decision = m_adaptationAlgorithmServer->GetLastDecision();
+    decision.flow = m_peer;
+    decision.cappedRate = cappedDataRate;
+    m_rateDecisionTrace(decision);
 
-    std::cout << Simulator::Now().GetSeconds() << " peer " << addressStr.str() << " nextNoLimit "
-              << nextDataRate.GetBitRate() / 1.e6 << " nextdatarate "
-              << DynamicCast<VrBurstGenerator>(m_burstGenerator)->GetTargetDataRate().GetBitRate() /
-                     1e6
-              << std::endl;
     m_bytesAddedToSocket = 0;
 }
 
@@ -237,24 +310,8 @@ BurstyApplicationServerInstance::SendBurst()
             AdaptRate();
         }
 
-        std::stringstream addressStr;
-        if (InetSocketAddress::IsMatchingType(m_peer))
-        {
-            addressStr << InetSocketAddress::ConvertFrom(m_peer).GetIpv4() << " port "
-                       << InetSocketAddress::ConvertFrom(m_peer).GetPort();
-        }
-        else if (Inet6SocketAddress::IsMatchingType(m_peer))
-        {
-            addressStr << Inet6SocketAddress::ConvertFrom(m_peer).GetIpv6() << " port "
-                       << Inet6SocketAddress::ConvertFrom(m_peer).GetPort();
-        }
-        else
-        {
-            addressStr << "UNKNOWN ADDRESS TYPE";
-        }
-
         NS_LOG_INFO(Simulator::Now().GetSeconds()
-                    << " peer " << addressStr.str() << " rate "
+                    << " peer " << m_peerDescriptor << " rate "
                     << (DynamicCast<VrBurstGenerator>(GetBurstGenerator()))
                                ->GetTargetDataRate()
                                .GetBitRate() /
@@ -275,11 +332,10 @@ BurstyApplicationServerInstance::SendBurst()
         }
 
         std::tie(burstSize, period) = m_burstGenerator->GenerateBurst();
+        m_frameType = m_burstGenerator->GetLastFrameType();
         NS_LOG_DEBUG("Generated burstSize=" << burstSize << ", period=" << period.As(Time::MS));
         //}
         //
-        SeqTsSizeFragHeader hdrTmp;
-
         uint32_t min_burst = 3000;
 
         if (burstSize < min_burst)
@@ -290,8 +346,17 @@ BurstyApplicationServerInstance::SendBurst()
         NS_ASSERT_MSG(period.IsPositive(),
                       "Period must be non-negative, instead found period=" << period.As(Time::S));
 
-        // send packets for current burst
-        SendFragmentedBurst(burstSize);
+        m_frameStages = FrameStages();
+        m_frameStages.generated = Simulator::Now();
+        m_frameStages.poseTs = m_lastPoseTs;
+        if (m_renderPipeline)
+        {
+            EnterPipeline(burstSize);
+        }
+        else
+        {
+            SendFrame(burstSize, m_burstGenerator->GetLastSubBursts());
+        }
 
         // schedule next burst
         NS_LOG_DEBUG("Next burst scheduled in " << period.As(Time::S));
@@ -311,12 +376,107 @@ BurstyApplicationServerInstance::SendBurst()
     m_nextBurstEvent =
         Simulator::Schedule(period, &BurstyApplicationServerInstance::SendBurst, this);
     DataSend(m_socket, 0);
-    // UintegerValue buf_size;
-    // m_socket->GetAttribute ("SndBufSize", buf_size);
-    // uint64_t buff_occ = buf_size.Get () - m_socket->GetTxAvailable ();
-    // std::cout << Simulator::Now ().GetSeconds () << " SndBufSize " << buf_size.Get () << " avail
-    // "
-    //           << m_socket->GetTxAvailable () << " occup " << buff_occ << std::endl;
+}
+
+void
+BurstyApplicationServerInstance::SendFrame(uint32_t burstSize,
+                                           const std::vector<BurstGenerator::SubBurst>& subBursts)
+{
+    NS_LOG_FUNCTION(this << burstSize);
+
+    // send packets for current burst, or for each of its sub-bursts
+    if (subBursts.empty())
+    {
+        SendFragmentedBurst(burstSize);
+        return;
+    }
+    SeqTsSizeFragHeader hdrTmp;
+    for (const auto& subBurst : subBursts)
+    {
+        m_tile = subBurst.tile;
+        m_tileQuality = subBurst.quality;
+        // a sub-burst needs a header and at least a byte of payload
+        SendFragmentedBurst(std::max(subBurst.size, hdrTmp.GetSerializedSize() + 1));
+    }
+    m_tile = SeqTsSizeFragHeader::NO_TILE;
+    m_tileQuality = 0;
+}
+
+void
+BurstyApplicationServerInstance::EnterPipeline(uint32_t burstSize)
+{
+    NS_LOG_FUNCTION(this << burstSize);
+
+    Time now = Simulator::Now();
+
+    // as a renderer with a bounded input queue, drop the frame when too many
+    // frames wait to be rendered, instead of letting the backlog grow
+    if (m_maxQueuedFrames > 0)
+    {
+        uint32_t queued = 0;
+        for (auto it = m_pipeline.rbegin(); it != m_pipeline.rend() && it->stages.renderStart > now;
+             ++it)
+        {
+            queued++;
+        }
+        if (queued >= m_maxQueuedFrames)
+        {
+            m_droppedFrames++;
+            NS_LOG_LOGIC("Dropping frame of " << burstSize << " B: " << queued
+                                              << " frames waiting for the renderer");
+            return;
+        }
+    }
+
+    PipelinedFrame frame;
+    frame.size = burstSize;
+    frame.subBursts = std::move(m_spareSubBursts);
+    m_burstGenerator->TakeLastSubBursts(frame.subBursts);
+    frame.frameType = m_frameType;
+    frame.stages = m_frameStages;
+
+    // the renderer takes a frame when done with the previous one, unless
+    // PipelineDepth frames are still in flight: then it waits for the oldest one
+    Time renderStart = std::max(now, m_rendererFree);
+    if (m_inFlight.size() == m_pipelineDepth)
+    {
+        renderStart = std::max(renderStart, m_inFlight.front());
+        m_inFlight.pop_front();
+    }
+    frame.stages.renderStart = renderStart;
+    frame.stages.rendered = renderStart + Seconds(std::max(0.0, m_renderTimeRv->GetValue()));
+    frame.stages.encodeStart = std::max(frame.stages.rendered, m_encoderFree);
+    Time encoded =
+        frame.stages.encodeStart + m_encoderThroughput.CalculateBytesTxTime(burstSize);
+    m_rendererFree = frame.stages.rendered;
+    m_encoderFree = encoded;
+    m_inFlight.push_back(encoded);
+
+    NS_LOG_DEBUG("Frame of " << burstSize << " B rendered from " << renderStart.As(Time::MS)
+                             << " to " << frame.stages.rendered.As(Time::MS) << ", encoded from "
+                             << frame.stages.encodeStart.As(Time::MS) << " to "
+                             << encoded.As(Time::MS));
+    // the frames are encoded in order, hence emitted in order
+    frame.emitEvent =
+        Simulator::Schedule(encoded - now, &BurstyApplicationServerInstance::EmitFrame, this);
+    m_pipeline.push_back(std::move(frame));
+}
+
+void
+BurstyApplicationServerInstance::EmitFrame()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_pipeline.empty());
+
+    PipelinedFrame& frame = m_pipeline.front();
+    m_frameType = frame.frameType;
+    m_frameStages = frame.stages;
+    SendFrame(frame.size, frame.subBursts);
+    // keep the storage of the sub-bursts for the next frame
+    m_spareSubBursts = std::move(frame.subBursts);
+    m_pipeline.pop_front();
+
+    DataSend(m_socket, 0);
 }
 
 void
@@ -400,6 +560,7 @@ BurstyApplicationServerInstance::SendFragmentedBurst(uint32_t burstSize)
 
     // Ptr<Packet> burst = Create<Packet> (buffer, burstPayload);
     Ptr<Packet> burst = Create<Packet>(burstPayload);
+    VR_APP_PROFILE(SERVER_INSTANCE, PACKET_CREATION);
     // Trace before adding header, for consistency with BurstSink
     Address from, to;
     m_socket->GetSockName(from);
@@ -410,9 +571,27 @@ BurstyApplicationServerInstance::SendFragmentedBurst(uint32_t burstSize)
     hdrTmp.SetSize(burstPayload);
     hdrTmp.SetFrags(totFrags);
     hdrTmp.SetFragSeq(0);
+    hdrTmp.SetFrameType(m_frameType);
+    hdrTmp.SetTile(m_tile);
+    hdrTmp.SetTileQuality(m_tileQuality);
+    hdrTmp.SetPoseTs(m_frameStages.poseTs);
 
     m_txBurstTrace(burst, from, to, hdrTmp);
 
+    // the fragments are enqueued, and possibly sent, by SendFragment
+    QueuedBurst queuedBurst;
+    queuedBurst.breakdown.seq = m_totTxBursts;
+    queuedBurst.breakdown.size = burstPayload;
+    queuedBurst.breakdown.frags = totFrags;
+    queuedBurst.breakdown.poseSent = m_frameStages.poseTs;
+    queuedBurst.breakdown.generated = m_frameStages.generated;
+    queuedBurst.breakdown.renderStart = m_frameStages.renderStart;
+    queuedBurst.breakdown.rendered = m_frameStages.rendered;
+    queuedBurst.breakdown.encodeStart = m_frameStages.encodeStart;
+    queuedBurst.breakdown.enqueued = Simulator::Now();
+    queuedBurst.remainingFrags = totFrags;
+    m_queuedBursts.push_back(queuedBurst);
+
     uint64_t fragmentStart = 0;
     uint16_t fragmentSeq = 0;
 
@@ -423,6 +602,7 @@ BurstyApplicationServerInstance::SendFragmentedBurst(uint32_t burstSize)
     for (uint32_t i = 0; i < numFullFrags; i++)
     {
         Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, fullFragmentPayload);
+        VR_APP_PROFILE(SERVER_INSTANCE, CREATE_FRAGMENT);
         fragmentStart += fullFragmentPayload;
         SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
     }
@@ -431,6 +611,7 @@ BurstyApplicationServerInstance::SendFragmentedBurst(uint32_t burstSize)
     {
         uint64_t secondToLastFragPayload = secondToLastFragSize - hdrTmp.GetSerializedSize();
         Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, secondToLastFragPayload);
+        VR_APP_PROFILE(SERVER_INSTANCE, CREATE_FRAGMENT);
         fragmentStart += secondToLastFragPayload;
         SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
     }
@@ -439,6 +620,7 @@ BurstyApplicationServerInstance::SendFragmentedBurst(uint32_t burstSize)
     {
         uint64_t lastFragPayload = lastFragSize - hdrTmp.GetSerializedSize();
         Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, lastFragPayload);
+        VR_APP_PROFILE(SERVER_INSTANCE, CREATE_FRAGMENT);
         fragmentStart += lastFragPayload;
         SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
     }
@@ -461,6 +643,10 @@ BurstyApplicationServerInstance::SendFragment(Ptr<Packet> fragment,
     header.SetSize(burstSize);
     header.SetFrags(totFrags);
     header.SetFragSeq(fragmentSeq);
+    header.SetFrameType(m_frameType);
+    header.SetTile(m_tile);
+    header.SetTileQuality(m_tileQuality);
+    header.SetPoseTs(m_frameStages.poseTs);
     // std::cout << "before " << fragment->GetSize () << " headersize " << header.GetSerializedSize
     // ()
     //           << std::endl;
@@ -485,6 +671,7 @@ BurstyApplicationServerInstance::SendFragment(Ptr<Packet> fragment,
     if (m_queue.size() < m_queueSize)
     {
         m_queue.push_back(*fragment);
+        VR_APP_PROFILE(SERVER_INSTANCE, PACKET_COPY);
     }
     else
     {
@@ -504,25 +691,9 @@ BurstyApplicationServerInstance::SendFragment(Ptr<Packet> fragment,
     m_totTxFragments++;
     m_totTxBytes += fragmentSize;
 
-    std::stringstream addressStr;
-    if (InetSocketAddress::IsMatchingType(to))
-    {
-        addressStr << InetSocketAddress::ConvertFrom(to).GetIpv4() << " port "
-                   << InetSocketAddress::ConvertFrom(to).GetPort();
-    }
-    else if (Inet6SocketAddress::IsMatchingType(to))
-    {
-        addressStr << Inet6SocketAddress::ConvertFrom(to).GetIpv6() << " port "
-                   << Inet6SocketAddress::ConvertFrom(to).GetPort();
-    }
-    else
-    {
-        addressStr << "UNKNOWN ADDRESS TYPE";
-    }
-
     NS_LOG_INFO("At time " << Simulator::Now().As(Time::S)
                            << " bursty application sent fragment of " << fragment->GetSize()
-                           << " bytes to " << addressStr.str() << " with header=" << header);
+                           << " bytes to " << m_peerDescriptor << " with header=" << header);
 
     DataSend(m_socket, 0);
 }
@@ -544,39 +715,41 @@ BurstyApplicationServerInstance::DataSend(Ptr<Socket> socket, uint32_t)
     // Ptr<Packet> dummy = Create<Packet> (0);
     // socket->Send (dummy);
 
-    while (!m_queue.empty())
+    while (true)
     {
+        // strict priority, the sub-streams going first at the priority of the video
+        uint32_t index = 0;
+        while (index < m_streams.size() && m_streams[index].queue.empty())
+        {
+            index++;
+        }
+        bool streamFirst = index < m_streams.size() &&
+                           (m_queue.empty() || m_streams[index].priority <= m_videoPriority);
+        if (!streamFirst && m_queue.empty())
+        {
+            break;
+        }
+
         if (m_adaptationAlgorithmServer && m_txStarted == Seconds(0))
         {
             m_txStarted = Simulator::Now();
         }
 
-        uint32_t max_tx_size = socket->GetTxAvailable();
-
-        Ptr<Packet> frame = m_queue.front().Copy();
-        uint32_t init_size = frame->GetSize();
-
-        if (max_tx_size <= init_size)
+        bool sent = streamFirst ? SendStreamMessage(socket, index) : SendVideoFragment(socket);
+        if (!sent)
         {
             // NS_ABORT_MSG ("Socket Send buffer is full");
+            if (m_sendBufferSampler)
+            {
+                m_sendBufferSampler->Update(m_queue.size());
+            }
             return;
         }
+    }
 
-        m_queue.pop_front();
-
-        // if (max_tx_size < init_size)
-        //   {
-        //     NS_LOG_INFO ("Insufficient space in send buffer, fragmenting");
-        //     Ptr<Packet> frag0 = frame->CreateFragment (0, max_tx_size);
-        //     Ptr<Packet> frag1 = frame->CreateFragment (max_tx_size, init_size - max_tx_size);
-
-        //     m_queue.push_front (*frag1);
-        //     frame = frag0;
-        //   }
-
-        socket->SendTo(frame, 0, m_peer);
-        m_bytesAddedToSocket += frame->GetSize();
-        NS_LOG_INFO("Just sent " << frame->GetSerializedSize() << " " << frame->GetSize());
+    if (m_sendBufferSampler)
+    {
+        m_sendBufferSampler->Update(m_queue.size());
     }
 
     if (m_adaptationAlgorithmServer)
@@ -593,6 +766,261 @@ BurstyApplicationServerInstance::DataSend(Ptr<Socket> socket, uint32_t)
     }
 }
 
+bool
+BurstyApplicationServerInstance::SendVideoFragment(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    uint32_t max_tx_size = socket->GetTxAvailable();
+    uint32_t init_size = m_queue.front().GetSize();
+
+    if (max_tx_size <= init_size)
+    {
+        return false;
+    }
+
+    Ptr<Packet> frame = m_queue.front().Copy();
+    VR_APP_PROFILE(SERVER_INSTANCE, PACKET_COPY);
+    m_queue.pop_front();
+
+    // if (max_tx_size < init_size)
+    //   {
+    //     NS_LOG_INFO ("Insufficient space in send buffer, fragmenting");
+    //     Ptr<Packet> frag0 = frame->CreateFragment (0, max_tx_size);
+    //     Ptr<Packet> frag1 = frame->CreateFragment (max_tx_size, init_size - max_tx_size);
+
+    //     m_queue.push_front (*frag1);
+    //     frame = frag0;
+    //   }
+
+    socket->SendTo(frame, 0, m_peer);
+    m_bytesAddedToSocket += frame->GetSize();
+
+    NS_ASSERT(!m_queuedBursts.empty());
+    QueuedBurst& queuedBurst = m_queuedBursts.front();
+    if (queuedBurst.remainingFrags == queuedBurst.breakdown.frags)
+    {
+        queuedBurst.breakdown.firstTx = Simulator::Now();
+    }
+    if (--queuedBurst.remainingFrags == 0)
+    {
+        queuedBurst.breakdown.lastTx = Simulator::Now();
+        m_latencyBreakdownTrace(m_peer, queuedBurst.breakdown);
+        m_queuedBursts.pop_front();
+    }
+    NS_LOG_INFO("Just sent " << frame->GetSerializedSize() << " " << frame->GetSize());
+    return true;
+}
+
+bool
+BurstyApplicationServerInstance::SendStreamMessage(Ptr<Socket> socket, uint32_t index)
+{
+    NS_LOG_FUNCTION(this << socket << index);
+
+    SessionStream& stream = m_streams[index];
+    QueuedMessage& queued = stream.queue.front();
+    uint32_t size = queued.packet->GetSize();
+    if (socket->GetTxAvailable() <= size)
+    {
+        return false;
+    }
+
+    // the socket copies the message, no need to keep a copy of our own
+    socket->SendTo(queued.packet, 0, m_peer);
+    m_bytesAddedToSocket += size;
+
+    queued.breakdown.firstTx = Simulator::Now();
+    queued.breakdown.lastTx = Simulator::Now();
+    m_latencyBreakdownTrace(m_peer, queued.breakdown);
+    stream.queue.pop_front();
+    NS_LOG_INFO("Just sent " << size << " B of stream " << +stream.stream);
+    return true;
+}
+
+void
+BurstyApplicationServerInstance::AddStream(uint8_t stream,
+                                           Ptr<BurstGenerator> generator,
+                                           uint8_t priority)
+{
+    NS_LOG_FUNCTION(this << +stream << generator << +priority);
+    NS_ABORT_MSG_IF(stream == SeqTsSizeFragHeader::VIDEO_STREAM,
+                    "The video is the main stream of the session, not a sub-stream");
+    for (const auto& s : m_streams)
+    {
+        NS_ABORT_MSG_IF(s.stream == stream, "Stream " << +stream << " added twice");
+    }
+
+    SessionStream sessionStream;
+    sessionStream.stream = stream;
+    sessionStream.priority = priority;
+    sessionStream.generator = generator;
+
+    // keep the streams sorted by priority, in order of insertion at equal priority
+    auto it = std::upper_bound(m_streams.begin(),
+                               m_streams.end(),
+                               priority,
+                               [](uint8_t p, const SessionStream& s) { return p < s.priority; });
+    m_streams.insert(it, sessionStream);
+}
+
+int64_t
+BurstyApplicationServerInstance::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    int64_t currentStream = stream;
+    Ptr<VrBurstGenerator> vrGenerator = DynamicCast<VrBurstGenerator>(m_burstGenerator);
+    if (vrGenerator)
+    {
+        currentStream += vrGenerator->AssignStreams(currentStream);
+    }
+    if (m_headMotionModel)
+    {
+        currentStream += m_headMotionModel->AssignStreams(currentStream);
+    }
+    for (const auto& s : m_streams)
+    {
+        if (Ptr<VrBurstGenerator> generator = DynamicCast<VrBurstGenerator>(s.generator))
+        {
+            currentStream += generator->AssignStreams(currentStream);
+        }
+        else if (Ptr<SimpleBurstGenerator> generator =
+                     DynamicCast<SimpleBurstGenerator>(s.generator))
+        {
+            currentStream += generator->AssignStreams(currentStream);
+        }
+    }
+    return currentStream - stream;
+}
+
+void
+BurstyApplicationServerInstance::SendStreamBurst(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+
+    SessionStream& stream = m_streams[index];
+    if (m_isfinishing)
+    {
+        return;
+    }
+    if (!stream.generator->HasNextBurst())
+    {
+        NS_LOG_LOGIC("Generator of stream " << +stream.stream << " has no next burst");
+        return;
+    }
+
+    uint32_t burstSize;
+    Time period;
+    std::tie(burstSize, period) = stream.generator->GenerateBurst();
+    NS_ASSERT_MSG(period.IsPositive(),
+                  "Period must be non-negative, instead found period=" << period.As(Time::S));
+
+    SeqTsSizeFragHeader header;
+    // a message needs a header and at least a byte of payload
+    uint32_t messageSize = std::max(burstSize, header.GetSerializedSize() + 1);
+    NS_ABORT_MSG_IF(messageSize > m_fragSize,
+                    "A message of stream " << +stream.stream << " must fit in a fragment: "
+                                           << messageSize << " > " << m_fragSize);
+    uint64_t payload = messageSize - header.GetSerializedSize();
+
+    header.SetSeq(stream.totTxBursts);
+    header.SetSize(payload);
+    header.SetFrags(1);
+    header.SetFragSeq(0);
+    header.SetFragBytes(messageSize);
+    header.SetStream(stream.stream);
+    header.SetPoseTs(m_lastPoseTs);
+
+    // a single packet, the payload being a zero-filled area of its buffer
+    Ptr<Packet> message = Create<Packet>(payload);
+    VR_APP_PROFILE(SERVER_INSTANCE, PACKET_CREATION);
+    Address from;
+    m_socket->GetSockName(from);
+    m_txBurstTrace(message, from, m_peer, header);
+    message->AddHeader(header);
+    m_txFragmentTrace(message, from, m_peer, header);
+    m_totTxFragments++;
+    m_totTxBytes += messageSize;
+
+    QueuedMessage queued;
+    queued.packet = message;
+    queued.breakdown.seq = stream.totTxBursts;
+    queued.breakdown.size = payload;
+    queued.breakdown.frags = 1;
+    queued.breakdown.stream = stream.stream;
+    queued.breakdown.poseSent = m_lastPoseTs;
+    queued.breakdown.generated = header.GetTs();
+    queued.breakdown.enqueued = Simulator::Now();
+    stream.queue.push_back(queued);
+    stream.totTxBursts++;
+
+    stream.nextBurstEvent =
+        Simulator::Schedule(period, &BurstyApplicationServerInstance::SendStreamBurst, this, index);
+    DataSend(m_socket, 0);
+}
+
+void
+BurstyApplicationServerInstance::ReceiveUplink(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+
+    if (m_uplinkBuffer)
+    {
+        m_uplinkBuffer->AddAtEnd(packet);
+        packet = m_uplinkBuffer;
+        m_uplinkBuffer = 0;
+    }
+
+    SeqTsSizeFragHeader header;
+    while (packet->GetSize() >= header.GetSerializedSize())
+    {
+        packet->PeekHeader(header);
+        if (header.GetFragBytes() < header.GetSerializedSize())
+        {
+            // not a message, e.g., the datagram opening a UDP session
+            NS_LOG_LOGIC("Ignoring " << packet->GetSize() << " B from " << m_peerDescriptor);
+            return;
+        }
+        if (packet->GetSize() == header.GetFragBytes())
+        {
+            // a single whole message, always the case over UDP
+            HandleUplinkMessage(packet, header);
+            return;
+        }
+        if (packet->GetSize() < header.GetFragBytes())
+        {
+            break;
+        }
+        HandleUplinkMessage(packet->CreateFragment(0, header.GetFragBytes()), header);
+        packet = packet->CreateFragment(header.GetFragBytes(),
+                                        packet->GetSize() - header.GetFragBytes());
+        VR_APP_PROFILE_N(SERVER_INSTANCE, CREATE_FRAGMENT, 2);
+    }
+
+    // over TCP, wait for the rest of the message
+    if (packet->GetSize() > 0 && m_socket->GetSocketType() == Socket::NS3_SOCK_STREAM)
+    {
+        m_uplinkBuffer = packet;
+    }
+}
+
+void
+BurstyApplicationServerInstance::HandleUplinkMessage(Ptr<Packet> message,
+                                                     const SeqTsSizeFragHeader& header)
+{
+    NS_LOG_FUNCTION(this << message << header);
+
+    m_totRxUplink++;
+    if (header.GetStream() == SeqTsSizeFragHeader::POSE_STREAM && header.GetTs() > m_lastPoseTs)
+    {
+        // poses might be reordered over UDP: keep the most recent one
+        m_lastPoseTs = header.GetTs();
+    }
+
+    Address local;
+    m_socket->GetSockName(local);
+    m_rxUplinkTrace(message, m_peer, local, header);
+}
+
 uint64_t
 BurstyApplicationServerInstance::GetTotalTxBursts(void) const
 {
@@ -605,6 +1033,12 @@ BurstyApplicationServerInstance::GetTotalTxFragments(void) const
     return m_totTxFragments;
 }
 
+uint64_t
+BurstyApplicationServerInstance::GetDroppedFrames(void) const
+{
+    return m_droppedFrames;
+}
+
 uint64_t
 BurstyApplicationServerInstance::GetTotalTxBytes(void) const
 {
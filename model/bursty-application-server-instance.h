@@ -30,8 +30,15 @@
 #include "vr-burst-generator.h"
 #include "ns3/fuzzy-algorithm-server.h"
 #include "ns3/adaptation-algorithm-server.h"
+#include "ns3/burst-latency-breakdown.h"
+#include "ns3/send-buffer-sampler.h"
+#include "ns3/head-motion-model.h"
+#include "ns3/encoder-rate-control.h"
+#include "ns3/peer-descriptor.h"
+#include "ns3/random-variable-stream.h"
 
 #include <queue>
+#include <vector>
 
 namespace ns3 {
 
@@ -71,7 +78,7 @@ public:
 
   /**
    * \brief Return the total number of transmitted bursts.
-   * \return number of transmitted bursts
+   * \return number of transmitted video bursts, i.e., without the sub-streams
    */
   uint64_t GetTotalTxBursts () const;
 
@@ -81,12 +88,48 @@ public:
    */
   uint64_t GetTotalTxFragments () const;
 
+  /**
+   * \brief Return the frames dropped by the render and encode pipeline.
+   * \return number of frames dropped because MaxQueuedFrames were waiting for the renderer
+   */
+  uint64_t GetDroppedFrames () const;
+
   /**
    * \brief Return the total number of transmitted bytes.
    * \return number of transmitted bytes
    */
   uint64_t GetTotalTxBytes (void) const;
 
+  /**
+   * \brief Returns the send buffer sampler, if enabled
+   * \return pointer to the associated SendBufferSampler, or null
+   */
+  Ptr<SendBufferSampler> GetSendBufferSampler (void) const;
+
+  /**
+   * \brief Returns the head motion model of the user, if enabled
+   * \return pointer to the associated HeadMotionModel, or null
+   */
+  Ptr<HeadMotionModel> GetHeadMotionModel (void) const;
+
+  /**
+   * \brief Returns the rate control of the encoder, if enabled
+   * \return pointer to the associated EncoderRateControl, or null
+   */
+  Ptr<EncoderRateControl> GetRateControl (void) const;
+
+  /**
+   * \brief Return the time the client sent the last pose received
+   * \return the time, zero if no pose was received
+   */
+  Time GetLastPoseTs (void) const;
+
+  /**
+   * \brief Return the number of uplink messages received from the client
+   * \return the number of messages
+   */
+  uint64_t GetTotalRxUplinkMessages (void) const;
+
   void SetIsAdaptive (bool value);
   bool GetIsAdaptive (void) const;
 
@@ -111,6 +154,27 @@ protected:
    */
   virtual void SendBurst ();
 
+  /**
+   * \brief Send a frame, as a burst or as a burst per sub-burst
+   * \param burstSize the size of the frame in Bytes
+   * \param subBursts the sub-bursts of the frame, empty to send it as a single burst
+   */
+  void SendFrame (uint32_t burstSize, const std::vector<BurstGenerator::SubBurst> &subBursts);
+
+  /**
+   * \brief Push the frame just generated into the render and encode pipeline
+   * \param burstSize the size of the frame in Bytes
+   *
+   * The frame is sent by EmitFrame when it is encoded, or dropped if
+   * m_maxQueuedFrames frames are already waiting for the renderer.
+   */
+  void EnterPipeline (uint32_t burstSize);
+
+  /**
+   * \brief Send the oldest frame of the pipeline, just encoded
+   */
+  void EmitFrame (void);
+
   /**
    * \brief Send burst fragmented into multiple packets
    * \param burstSize the size of the burst in Bytes
@@ -127,8 +191,64 @@ protected:
   void SendFragment (Ptr<Packet> fragment, uint64_t burstSize, uint16_t totFrags,
                      uint16_t fragmentSeq);
 
+  /**
+   * \brief Add a sub-stream to the session, sent along with the video
+   * \param stream the stream, see SeqTsSizeFragHeader::StreamType
+   * \param generator the generator of the stream
+   * \param priority the priority of the stream, 0 being the highest
+   */
+  void AddStream (uint8_t stream, Ptr<BurstGenerator> generator, uint8_t priority);
+
+  /**
+   * \brief Assign fixed random variable streams to the generators of the session
+   *
+   * The video generator takes its streams first, then its HeadMotionModel,
+   * if any, then the generators of the sub-streams: call it once the
+   * instance is configured.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \brief Send a message of a sub-stream and schedule the next one
+   * \param index the index of the stream in m_streams
+   */
+  void SendStreamBurst (uint32_t index);
+
+  /**
+   * \brief Hand the oldest video fragment to the socket
+   * \param socket the socket
+   * \return false if the socket has no room for it
+   */
+  bool SendVideoFragment (Ptr<Socket> socket);
+
+  /**
+   * \brief Hand the oldest message of a sub-stream to the socket
+   * \param socket the socket
+   * \param index the index of the stream in m_streams
+   * \return false if the socket has no room for it
+   */
+  bool SendStreamMessage (Ptr<Socket> socket, uint32_t index);
+
+  /**
+   * \brief Handle the data received from the client
+   * \param packet the received data, one or more whole messages over UDP,
+   * any part of the byte stream over TCP
+   */
+  void ReceiveUplink (Ptr<Packet> packet);
+
+  /**
+   * \brief Handle a whole uplink message
+   * \param message the message, including its header
+   * \param header the header of the message
+   */
+  void HandleUplinkMessage (Ptr<Packet> message, const SeqTsSizeFragHeader &header);
+
   Ptr<Socket> m_socket; //!< Associated socket
   Address m_peer; //!< Peer address
+  PeerDescriptor m_peerDescriptor; //!< Peer address, formatted only when logged
   Address m_local; //!< Local address to bind to
   bool m_connected; //!< True if connected
   Ptr<BurstGenerator> m_burstGenerator =
@@ -139,6 +259,20 @@ protected:
   uint64_t m_totTxBursts; //!< Total bursts sent
   uint64_t m_totTxFragments; //!< Total fragments sent
   uint64_t m_totTxBytes; //!< Total bytes sent
+  SeqTsSizeFragHeader::FrameType m_frameType{SeqTsSizeFragHeader::UNSPECIFIED_FRAME}; //!< Type of the current burst
+  uint16_t m_tile{SeqTsSizeFragHeader::NO_TILE}; //!< Tile of the current sub-burst
+  uint8_t m_tileQuality{0}; //!< Quality level of the current sub-burst
+
+  /// Stage timestamps of a frame
+  struct FrameStages
+  {
+    Time generated; //!< the frame was produced by the BurstGenerator
+    Time renderStart; //!< the frame started to be rendered, zero without pipeline
+    Time rendered; //!< the frame was rendered
+    Time encodeStart; //!< the frame started to be encoded
+    Time poseTs; //!< time the client sent the last pose known at the generation
+  };
+  FrameStages m_frameStages; //!< Stage timestamps of the current burst
 
   // Traced Callbacks
   /// Callback for transmitted burst
@@ -147,18 +281,111 @@ protected:
   /// Callback for transmitted fragment
   TracedCallback<Ptr<const Packet>, const Address &, const Address &, const SeqTsSizeFragHeader &>
       m_txFragmentTrace;
+  /// Callback for the sender timestamps of a burst
+  TracedCallback<const Address &, const BurstLatencyBreakdown &> m_latencyBreakdownTrace;
+  /// Callback for rate adaptation decisions
+  TracedCallback<const RateDecision &> m_rateDecisionTrace;
+  /// Callback for the head poses of the user
+  TracedCallback<const Address &, const HeadPose &> m_headPoseTrace;
+  /// Callback for the encoded frames
+  TracedCallback<const Address &, const RateControlSample &> m_rateControlTrace;
+  /// Callback for received uplink messages
+  TracedCallback<Ptr<const Packet>, const Address &, const Address &, const SeqTsSizeFragHeader &>
+      m_rxUplinkTrace;
+
+  /**
+   * \brief Trace sink for the Pose trace source of the head motion model
+   * \param pose the new pose
+   */
+  void NotifyHeadPose (const HeadPose &pose);
+
+  /**
+   * \brief Trace sink for the BufferFullness trace source of the rate control
+   * \param sample the state of the rate control
+   */
+  void NotifyRateControl (const RateControlSample &sample);
 
   void DataSend (Ptr<Socket>, uint32_t); // Called when a new segment is transmitted
   // A structure that contains the generated MPEG frames, for each client.
   std::deque<Packet> m_queue;
   uint32_t m_queueSize = 100000;
 
+  /// A burst whose fragments are still in m_queue
+  struct QueuedBurst
+  {
+    BurstLatencyBreakdown breakdown; //!< timestamps known so far
+    uint16_t remainingFrags; //!< fragments not yet handed to the socket
+  };
+  std::deque<QueuedBurst> m_queuedBursts; //!< bursts in m_queue, in order
+
+  /// A message of a sub-stream waiting for the socket
+  struct QueuedMessage
+  {
+    Ptr<Packet> packet; //!< the message, header included
+    BurstLatencyBreakdown breakdown; //!< timestamps known so far
+  };
+
+  /**
+   * \brief A sub-stream of the session
+   *
+   * The messages of a sub-stream are small: each one is sent as a single
+   * fragment, queued by pointer and handed as is to the socket.
+   */
+  struct SessionStream
+  {
+    uint8_t stream; //!< the stream, see SeqTsSizeFragHeader::StreamType
+    uint8_t priority; //!< 0 is the highest
+    Ptr<BurstGenerator> generator; //!< generator of the messages
+    EventId nextBurstEvent; //!< next message
+    uint64_t totTxBursts{0}; //!< messages generated so far, i.e., the next sequence number
+    std::deque<QueuedMessage> queue; //!< messages waiting for the socket
+  };
+  std::vector<SessionStream> m_streams; //!< sub-streams, by decreasing priority
+  uint8_t m_videoPriority = 1; //!< priority of the video, 0 is the highest
+
+  /// A frame in the render and encode pipeline
+  struct PipelinedFrame
+  {
+    uint32_t size; //!< frame size [B]
+    std::vector<BurstGenerator::SubBurst> subBursts; //!< sub-bursts of the frame, if any
+    SeqTsSizeFragHeader::FrameType frameType; //!< type of the frame
+    FrameStages stages; //!< stage timestamps
+    EventId emitEvent; //!< the frame is encoded
+  };
+  std::deque<PipelinedFrame> m_pipeline; //!< frames being rendered or encoded, in order
+  bool m_renderPipeline = false; //!< Whether frames go through the render and encode pipeline
+  Ptr<RandomVariableStream> m_renderTimeRv; //!< Render time of a frame [s]
+  DataRate m_encoderThroughput{DataRate ("200Mbps")}; //!< Encoded bits per second of encode time
+  uint32_t m_pipelineDepth = 2; //!< Largest number of frames being rendered or encoded
+  uint32_t m_maxQueuedFrames = 4; //!< Largest number of frames waiting for the renderer, 0 for no limit
+  uint64_t m_droppedFrames = 0; //!< Frames dropped with MaxQueuedFrames frames waiting
+  std::vector<BurstGenerator::SubBurst> m_spareSubBursts; //!< storage of the sub-bursts of the next frame
+  Time m_rendererFree; //!< the renderer is done with the frames so far
+  Time m_encoderFree; //!< the encoder is done with the frames so far
+  std::deque<Time> m_inFlight; //!< encode end of the last frames, at most m_pipelineDepth
+
+  Ptr<Packet> m_uplinkBuffer; //!< partial uplink message over TCP, null if none
+  Time m_lastPoseTs; //!< time the client sent the last pose received, zero if none
+  uint64_t m_totRxUplink = 0; //!< uplink messages received
+
   DataRate m_initRate = 0;
   Time m_lastBurstAt = Seconds (0);
   uint64_t m_totTxBytesLast; //!< Total bytes sent
 
   void AdaptRate ();
 
+  /**
+   * \brief Set the rate allocated by the JointRateAllocator of the server
+   * \param rate the allocated rate
+   *
+   * The rate is applied to the burst generator right away.
+   */
+  void SetAllocatedRate (DataRate rate);
+
+  bool m_jointAllocation = false; //!< Whether the rate is set by the JointRateAllocator of the server
+  DataRate m_demandRate = 0; //!< Last rate proposed by the adaptation algorithm
+  DataRate m_allocatedRate = 0; //!< Last rate allocated by the server, zero if none yet
+
   bool m_isfinishing = false;
 
   Ptr<AdaptationAlgorithmServer> m_adaptationAlgorithmServer;
@@ -167,6 +394,10 @@ protected:
 
   Time m_txTime = Seconds(0);
   Time m_txStarted = Seconds(0);
+
+  Ptr<SendBufferSampler> m_sendBufferSampler; //!< Send buffer sampler, null if disabled
+  Ptr<HeadMotionModel> m_headMotionModel; //!< Head motion of the user, null if disabled
+  Ptr<EncoderRateControl> m_rateControl; //!< Rate control of the encoder, null if disabled
 };
 
 } // namespace ns3
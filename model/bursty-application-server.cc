@@ -19,20 +19,26 @@
  */
 #include "bursty-application-server.h"
 
+#include "vr-app-profiler.h"
+
 #include "ns3/address-utils.h"
 #include "ns3/address.h"
 #include "ns3/boolean.h"
+#include "ns3/data-rate.h"
 #include "ns3/double.h"
 #include "ns3/fuzzy-algorithm-server.h"
+#include "ns3/bandwidth-estimator.h"
 #include "ns3/bola.h"
 #include "ns3/festive.h"
 #include "ns3/mpc.h"
 #include "ns3/google-algorithm-server.h"
+#include "ns3/tcp-delivery-rate-algorithm-server.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/socket.h"
@@ -42,6 +48,8 @@
 #include "ns3/udp-socket.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -74,10 +82,27 @@ BurstyApplicationServer::GetTypeId(void)
                           MakeTypeIdChecker())
             .AddAttribute("adaptationAlgorithm",
                           "The adaptation algorithm used, empty string for no adaptation. Other "
-                          "allowed values are FuzzyAlgorithmServer and GoogleAlgorithmServer",
+                          "allowed values are FuzzyAlgorithmServer, GoogleAlgorithmServer, "
+                          "BolaAlgo, MPCAlgo, FestiveAlgorithm and TcpDeliveryRateAlgorithmServer",
                           StringValue(""),
                           MakeStringAccessor(&BurstyApplicationServer::m_adaptationAlgorithm),
                           MakeStringChecker())
+            .AddAttribute("BandwidthEstimator",
+                          "The throughput estimator of the adaptation algorithms, empty string "
+                          "for the default estimator of each algorithm. Other allowed values are "
+                          "EwmaBandwidthEstimator, DualEwmaBandwidthEstimator, "
+                          "HarmonicBandwidthEstimator, SlidingPercentileBandwidthEstimator and "
+                          "KalmanBandwidthEstimator, configured by their default attributes",
+                          StringValue(""),
+                          MakeStringAccessor(&BurstyApplicationServer::m_bandwidthEstimatorType),
+                          MakeStringChecker())
+            .AddAttribute("BitrateLadder",
+                          "The bitrate ladder shared by the adaptation algorithms and the burst "
+                          "generators of all instances, null for the default ladder of each "
+                          "algorithm and unquantized target data rates",
+                          PointerValue(0),
+                          MakePointerAccessor(&BurstyApplicationServer::m_bitrateLadder),
+                          MakePointerChecker<BitrateLadder>())
             .AddAttribute("FragmentSize",
                           "The size of packets sent in a burst including SeqTsSizeFragHeader",
                           UintegerValue(1200),
@@ -88,6 +113,77 @@ BurstyApplicationServer::GetTypeId(void)
                           TimeValue(Seconds(1)),
                           MakeTimeAccessor(&BurstyApplicationServer::m_appDuration),
                           MakeTimeChecker())
+            .AddAttribute("EnableSendBufferSampler",
+                          "If true, each instance samples its send buffer with a "
+                          "SendBufferSampler configured by its default attributes",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BurstyApplicationServer::m_enableSendBufferSampler),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableHeadMotion",
+                          "If true, the frame sizes of each instance are modulated by the head "
+                          "motion of its user, a HeadMotionModel configured by its default "
+                          "attributes",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BurstyApplicationServer::m_enableHeadMotion),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableRateControl",
+                          "If true, the frames of each instance are encoded by an "
+                          "EncoderRateControl configured by its default attributes, which "
+                          "follows the rate adaptation over a few frames",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BurstyApplicationServer::m_enableRateControl),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableRenderPipeline",
+                          "If true, the frames of each instance are rendered and encoded before "
+                          "being sent, see RenderTime, EncoderThroughput and PipelineDepth",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BurstyApplicationServer::m_enableRenderPipeline),
+                          MakeBooleanChecker())
+            .AddAttribute("RenderTime",
+                          "A RandomVariableStream used to pick the render time of a frame [s]",
+                          StringValue("ns3::ConstantRandomVariable[Constant=0.005]"),
+                          MakePointerAccessor(&BurstyApplicationServer::m_renderTimeRv),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("EncoderThroughput",
+                          "The bits the encoder produces per second of encode time: a frame "
+                          "takes its size divided by this throughput to be encoded",
+                          DataRateValue(DataRate("200Mbps")),
+                          MakeDataRateAccessor(&BurstyApplicationServer::m_encoderThroughput),
+                          MakeDataRateChecker())
+            .AddAttribute("PipelineDepth",
+                          "The largest number of frames being rendered or encoded at once: with "
+                          "1, a frame is rendered only after the previous one was encoded",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&BurstyApplicationServer::m_pipelineDepth),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxQueuedFrames",
+                          "The largest number of frames waiting for the renderer: a frame "
+                          "generated while as many are waiting is dropped, as by a renderer with "
+                          "a bounded input queue. If 0, frames generated faster than the pipeline "
+                          "sustains wait without limit, and their latency grows",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&BurstyApplicationServer::m_maxQueuedFrames),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("RateAllocator",
+                          "The joint rate allocator sharing the capacity among adaptive instances, "
+                          "empty string to let each instance adapt on its own. Other allowed "
+                          "values are MaxMinRateAllocator and ProportionalFairRateAllocator",
+                          StringValue(""),
+                          MakeStringAccessor(&BurstyApplicationServer::m_rateAllocatorType),
+                          MakeStringChecker())
+            .AddAttribute("RateAllocationInterval",
+                          "The time between two joint rate allocations. If zero, the rates are "
+                          "allocated once per frame, i.e., every 1 / FrameRate of the fastest "
+                          "VrBurstGenerator of the instances",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyApplicationServer::m_rateAllocationInterval),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("VideoPriority",
+                          "The priority of the video with respect to the sub-streams added with "
+                          "AddStream, 0 being the highest",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&BurstyApplicationServer::m_videoPriority),
+                          MakeUintegerChecker<uint8_t>())
 
             .AddTraceSource("FragmentRx",
                             "A fragment has been received",
@@ -96,6 +192,36 @@ BurstyApplicationServer::GetTypeId(void)
             .AddTraceSource("BurstRx",
                             "A burst has been successfully received",
                             MakeTraceSourceAccessor(&BurstyApplicationServer::m_txBurstTrace),
+                            "ns3::BurstSink::SeqTsSizeFragCallback")
+            .AddTraceSource("BurstLatencyBreakdown",
+                            "The last fragment of a burst has been handed to the socket, the "
+                            "flow is identified by the client address",
+                            MakeTraceSourceAccessor(
+                                &BurstyApplicationServer::m_latencyBreakdownTrace),
+                            "ns3::BurstLatencyBreakdown::TracedCallback")
+            .AddTraceSource("SendBufferSample",
+                            "A send buffer sample has been stored by an instance",
+                            MakeTraceSourceAccessor(
+                                &BurstyApplicationServer::m_sendBufferSampleTrace),
+                            "ns3::SendBufferSample::TracedCallback")
+            .AddTraceSource("RateDecision",
+                            "An instance has chosen a new burst rate",
+                            MakeTraceSourceAccessor(&BurstyApplicationServer::m_rateDecisionTrace),
+                            "ns3::RateDecision::TracedCallback")
+            .AddTraceSource("HeadPose",
+                            "The head motion model of an instance computed a new pose, the flow "
+                            "is identified by the client address",
+                            MakeTraceSourceAccessor(&BurstyApplicationServer::m_headPoseTrace),
+                            "ns3::HeadPose::FlowTracedCallback")
+            .AddTraceSource("RateControl",
+                            "The rate control of an instance encoded a frame, the flow is "
+                            "identified by the client address",
+                            MakeTraceSourceAccessor(&BurstyApplicationServer::m_rateControlTrace),
+                            "ns3::RateControlSample::FlowTracedCallback")
+            .AddTraceSource("UplinkRx",
+                            "An uplink message, e.g., a pose, has been received from a client, "
+                            "header included",
+                            MakeTraceSourceAccessor(&BurstyApplicationServer::m_rxUplinkTrace),
                             "ns3::BurstSink::SeqTsSizeFragCallback");
     return tid;
 }
@@ -173,6 +299,10 @@ BurstyApplicationServer::DoDispose(void)
     NS_LOG_FUNCTION(this);
     m_socket = 0;
     m_socketList.clear();
+    m_rateAllocator = 0;
+    m_bitrateLadder = 0;
+    m_allocationInstances.clear();
+    m_streamConfigs.clear();
 
     // chain up
     Application::DoDispose();
@@ -199,6 +329,32 @@ BurstyApplicationServer::StartApplication() // Called at time specified by Start
                                 MakeCallback(&BurstyApplicationServer::HandleAccept, this));
     m_socket->SetCloseCallbacks(MakeCallback(&BurstyApplicationServer::HandleClose, this),
                                 MakeCallback(&BurstyApplicationServer::HandleError, this));
+
+    if (m_rateAllocatorType == "MaxMinRateAllocator")
+    {
+        m_rateAllocator = CreateObject<MaxMinRateAllocator>();
+    }
+    else if (m_rateAllocatorType == "ProportionalFairRateAllocator")
+    {
+        m_rateAllocator = CreateObject<ProportionalFairRateAllocator>();
+    }
+    else if (m_rateAllocatorType != "")
+    {
+        NS_ABORT_MSG("Wrong rate allocator type: " << m_rateAllocatorType);
+    }
+
+    if (m_rateAllocator)
+    {
+        NS_ABORT_MSG_IF(m_adaptationAlgorithm == "",
+                        "A RateAllocator requires an adaptationAlgorithm to estimate demands");
+        // once per frame, the allocations start with the first instance
+        if (m_rateAllocationInterval.IsStrictlyPositive())
+        {
+            m_rateAllocationEvent = Simulator::Schedule(m_rateAllocationInterval,
+                                                        &BurstyApplicationServer::AllocateRates,
+                                                        this);
+        }
+    }
 }
 
 void
@@ -223,6 +379,99 @@ BurstyApplicationServer::StopApplication() // Called at time specified by Stop
     {
         kv.second.CancelEvents();
     }
+    Simulator::Cancel(m_rateAllocationEvent);
+}
+
+void
+BurstyApplicationServer::SetClientWeight(const Address& peer, double weight)
+{
+    NS_LOG_FUNCTION(this << peer << weight);
+    NS_ABORT_MSG_IF(weight <= 0, "The weight of a client must be positive, instead: " << weight);
+    m_clientWeights[peer] = weight;
+}
+
+Ptr<JointRateAllocator>
+BurstyApplicationServer::GetRateAllocator(void) const
+{
+    return m_rateAllocator;
+}
+
+int64_t
+BurstyApplicationServer::AssignStreams(int64_t stream, uint32_t maxInstances)
+{
+    NS_LOG_FUNCTION(this << stream << maxInstances);
+    m_renderTimeRv->SetStream(stream);
+    m_instanceStream = stream + 1;
+    m_streamInstances = maxInstances;
+    return 1 + maxInstances * STREAMS_PER_INSTANCE;
+}
+
+void
+BurstyApplicationServer::AddStream(uint8_t stream, const ObjectFactory& generator, uint8_t priority)
+{
+    NS_LOG_FUNCTION(this << +stream << +priority);
+    NS_ABORT_MSG_IF(stream == SeqTsSizeFragHeader::VIDEO_STREAM,
+                    "The video is the main stream of the session, not a sub-stream");
+    m_streamConfigs.push_back({stream, generator, priority});
+}
+
+void
+BurstyApplicationServer::AllocateRates(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    m_allocationRequests.clear();
+    m_allocationInstances.clear();
+    double frameRate = 0;
+    for (auto& kv : m_server_instances)
+    {
+        BurstyApplicationServerInstance& instance = kv.second;
+        if (!instance.m_jointAllocation || instance.m_isfinishing)
+        {
+            continue;
+        }
+        Ptr<VrBurstGenerator> generator =
+            DynamicCast<VrBurstGenerator>(instance.GetBurstGenerator());
+        frameRate = std::max(frameRate, generator->GetFrameRate());
+        // skip instances without a demand yet
+        if (instance.m_demandRate.GetBitRate() == 0)
+        {
+            continue;
+        }
+
+        const RateDecision& decision = instance.m_adaptationAlgorithmServer->GetLastDecision();
+        RateAllocationRequest request;
+        request.flow = kv.first;
+        request.demand = instance.m_demandRate;
+        request.measured = decision.measuredRate;
+        request.cap = instance.m_initRate;
+        request.bufferOccupancy = decision.bufferOccupancy;
+        auto weightIt = m_clientWeights.find(kv.first);
+        request.weight = (weightIt != m_clientWeights.end()) ? weightIt->second : 1.0;
+
+        m_allocationRequests.push_back(request);
+        m_allocationInstances.push_back(&instance);
+    }
+
+    m_rateAllocator->Allocate(m_allocationRequests, m_allocatedRates);
+    for (uint32_t i = 0; i < m_allocationInstances.size(); i++)
+    {
+        m_allocationInstances[i]->SetAllocatedRate(m_allocatedRates[i]);
+    }
+
+    if (m_rateAllocationInterval.IsStrictlyPositive())
+    {
+        m_rateAllocationEvent = Simulator::Schedule(m_rateAllocationInterval,
+                                                    &BurstyApplicationServer::AllocateRates,
+                                                    this);
+    }
+    else if (frameRate > 0)
+    {
+        // without running instances, the next one restarts the allocations
+        m_rateAllocationEvent = Simulator::Schedule(Seconds(1 / frameRate),
+                                                    &BurstyApplicationServer::AllocateRates,
+                                                    this);
+    }
 }
 
 void
@@ -232,15 +481,40 @@ BurstyApplicationServer::HandleRead(Ptr<Socket> socket)
 
     // std::cout << m_tid << std::endl;
 
+    Ptr<Packet> packet;
+    Address peer;
     if ((m_socket->GetSocketType() != Socket::NS3_SOCK_STREAM &&
          m_socket->GetSocketType() != Socket::NS3_SOCK_SEQPACKET))
     {
-        Address peer;
-        ;
-
-        Ptr<Packet> packet = socket->RecvFrom(peer);
-
-        CreateInstance(socket, peer);
+        while ((packet = socket->RecvFrom(peer)))
+        {
+            // the first datagram of a client opens its session
+            auto it = m_server_instances.find(peer);
+            if (it == m_server_instances.end())
+            {
+                CreateInstance(socket, peer);
+            }
+            else
+            {
+                it->second.ReceiveUplink(packet);
+            }
+        }
+    }
+    else
+    {
+        socket->GetPeerName(peer);
+        auto it = m_server_instances.find(peer);
+        while ((packet = socket->Recv()))
+        {
+            if (packet->GetSize() == 0)
+            { // EOF
+                break;
+            }
+            if (it != m_server_instances.end())
+            {
+                it->second.ReceiveUplink(packet);
+            }
+        }
     }
 }
 
@@ -312,12 +586,33 @@ BurstyApplicationServer::CreateInstance(Ptr<Socket> socket, Address peer)
     //     std::forward_as_tuple (socket, peer, m_txBurstTrace, m_txFragmentTrace));
 
     // m_server_instances[peer] = Create<BurstyApplicationServerInstance> ();
+    VR_APP_PROFILE(SERVER_INSTANCE, MAP_INSERTION);
     m_server_instances[peer].m_socket = socket;
 
     m_server_instances[peer].m_peer = peer;
+    m_server_instances[peer].m_peerDescriptor.SetAddress(peer, VrAppProfiler::SERVER_INSTANCE);
     m_server_instances[peer].m_txBurstTrace = m_txBurstTrace;
     m_server_instances[peer].m_txFragmentTrace = m_txFragmentTrace;
+    m_server_instances[peer].m_latencyBreakdownTrace = m_latencyBreakdownTrace;
+    m_server_instances[peer].m_rateDecisionTrace = m_rateDecisionTrace;
+    m_server_instances[peer].m_headPoseTrace = m_headPoseTrace;
+    m_server_instances[peer].m_rateControlTrace = m_rateControlTrace;
+    m_server_instances[peer].m_rxUplinkTrace = m_rxUplinkTrace;
     m_server_instances[peer].m_fragSize = m_fragSize;
+    m_server_instances[peer].m_videoPriority = m_videoPriority;
+    NS_ABORT_MSG_IF(m_enableRenderPipeline && m_encoderThroughput.GetBitRate() == 0,
+                    "EncoderThroughput must be positive");
+    m_server_instances[peer].m_renderPipeline = m_enableRenderPipeline;
+    m_server_instances[peer].m_renderTimeRv = m_renderTimeRv;
+    m_server_instances[peer].m_encoderThroughput = m_encoderThroughput;
+    m_server_instances[peer].m_pipelineDepth = m_pipelineDepth;
+    m_server_instances[peer].m_maxQueuedFrames = m_maxQueuedFrames;
+    for (const auto& config : m_streamConfigs)
+    {
+        Ptr<BurstGenerator> generator = config.generator.Create<BurstGenerator>();
+        VR_APP_PROFILE(SERVER_INSTANCE, OBJECT_CREATION);
+        m_server_instances[peer].AddStream(config.stream, generator, config.priority);
+    }
 
     if (m_adaptationAlgorithm == "FuzzyAlgorithmServer")
     {
@@ -340,16 +635,107 @@ BurstyApplicationServer::CreateInstance(Ptr<Socket> socket, Address peer)
         m_server_instances[peer].m_adaptationAlgorithmServer =
             CreateObject<GoogleAlgorithmServer>();
     }
+    else if (m_adaptationAlgorithm == "TcpDeliveryRateAlgorithmServer")
+    {
+        m_server_instances[peer].m_adaptationAlgorithmServer =
+            CreateObject<TcpDeliveryRateAlgorithmServer>();
+    }
     else if (m_adaptationAlgorithm != "")
     {
         NS_ABORT_MSG("Wrong Adaptation Algorithm type");
     }
+    if (m_server_instances[peer].m_adaptationAlgorithmServer)
+    {
+        VR_APP_PROFILE(ALGORITHM, OBJECT_CREATION);
+        m_server_instances[peer].m_jointAllocation = (m_rateAllocator != nullptr);
+
+        Ptr<BandwidthEstimator> estimator;
+        if (m_bandwidthEstimatorType == "EwmaBandwidthEstimator")
+        {
+            estimator = CreateObject<EwmaBandwidthEstimator>();
+        }
+        else if (m_bandwidthEstimatorType == "DualEwmaBandwidthEstimator")
+        {
+            estimator = CreateObject<DualEwmaBandwidthEstimator>();
+        }
+        else if (m_bandwidthEstimatorType == "HarmonicBandwidthEstimator")
+        {
+            estimator = CreateObject<HarmonicBandwidthEstimator>();
+        }
+        else if (m_bandwidthEstimatorType == "SlidingPercentileBandwidthEstimator")
+        {
+            estimator = CreateObject<SlidingPercentileBandwidthEstimator>();
+        }
+        else if (m_bandwidthEstimatorType == "KalmanBandwidthEstimator")
+        {
+            estimator = CreateObject<KalmanBandwidthEstimator>();
+        }
+        else if (m_bandwidthEstimatorType != "")
+        {
+            NS_ABORT_MSG("Wrong bandwidth estimator type: " << m_bandwidthEstimatorType);
+        }
+        if (estimator)
+        {
+            VR_APP_PROFILE(ALGORITHM, OBJECT_CREATION);
+            m_server_instances[peer].m_adaptationAlgorithmServer->SetBandwidthEstimator(estimator);
+        }
+        if (m_bitrateLadder)
+        {
+            m_server_instances[peer].m_adaptationAlgorithmServer->SetBitrateLadder(m_bitrateLadder);
+        }
+    }
 
     Ptr<VrBurstGenerator> vrBurstGenerator =
         DynamicCast<VrBurstGenerator>(m_server_instances[peer].GetBurstGenerator());
+    if (m_bitrateLadder)
+    {
+        vrBurstGenerator->SetBitrateLadder(m_bitrateLadder);
+    }
+    if (m_enableHeadMotion)
+    {
+        Ptr<HeadMotionModel> headMotion = CreateObject<HeadMotionModel>();
+        VR_APP_PROFILE(SERVER_INSTANCE, OBJECT_CREATION);
+        headMotion->TraceConnectWithoutContext(
+            "Pose",
+            MakeCallback(&BurstyApplicationServerInstance::NotifyHeadPose,
+                         &m_server_instances[peer]));
+        vrBurstGenerator->SetHeadMotionModel(headMotion);
+        m_server_instances[peer].m_headMotionModel = headMotion;
+    }
+    if (m_enableRateControl)
+    {
+        Ptr<EncoderRateControl> rateControl = CreateObject<EncoderRateControl>();
+        VR_APP_PROFILE(SERVER_INSTANCE, OBJECT_CREATION);
+        rateControl->TraceConnectWithoutContext(
+            "BufferFullness",
+            MakeCallback(&BurstyApplicationServerInstance::NotifyRateControl,
+                         &m_server_instances[peer]));
+        vrBurstGenerator->SetRateControl(rateControl);
+        m_server_instances[peer].m_rateControl = rateControl;
+    }
 
     m_server_instances[peer].m_initRate = vrBurstGenerator->GetTargetDataRate();
 
+    if (m_streamInstances > 0)
+    {
+        // the head motion and the rate control are set, and the sub-streams added
+        int64_t streams = m_server_instances[peer].AssignStreams(m_instanceStream);
+        NS_ABORT_MSG_IF(streams > STREAMS_PER_INSTANCE,
+                        "Instance uses " << streams << " streams, more than "
+                                         << STREAMS_PER_INSTANCE);
+        m_instanceStream += STREAMS_PER_INSTANCE;
+        m_streamInstances--;
+    }
+
+    if (m_server_instances[peer].m_jointAllocation && m_rateAllocationInterval.IsZero() &&
+        m_rateAllocationEvent.IsExpired())
+    {
+        // allocations once per frame start (or restart) one frame after the first instance
+        m_rateAllocationEvent = Simulator::Schedule(Seconds(1 / vrBurstGenerator->GetFrameRate()),
+                                                    &BurstyApplicationServer::AllocateRates,
+                                                    this);
+    }
+
     Simulator::Schedule(m_appDuration,
                         &BurstyApplicationServerInstance::StopBursts,
                         &m_server_instances[peer]);
@@ -370,7 +756,24 @@ BurstyApplicationServer::CreateInstance(Ptr<Socket> socket, Address peer)
     //                                 "VrAppName", StringValue(vrAppName));
 
     m_server_instances[peer].CancelEvents();
+
+    if (m_enableSendBufferSampler)
+    {
+        Ptr<SendBufferSampler> sampler = CreateObject<SendBufferSampler>();
+        VR_APP_PROFILE(SERVER_INSTANCE, OBJECT_CREATION);
+        sampler->TraceConnectWithoutContext(
+            "Sample",
+            MakeCallback(&TracedCallback<const Address&, const SendBufferSample&>::operator(),
+                         &m_sendBufferSampleTrace));
+        sampler->Attach(socket, peer);
+        m_server_instances[peer].m_sendBufferSampler = sampler;
+    }
+
     m_server_instances[peer].SendBurst();
+    for (uint32_t i = 0; i < m_server_instances[peer].m_streams.size(); i++)
+    {
+        m_server_instances[peer].SendStreamBurst(i);
+    }
 }
 
 void
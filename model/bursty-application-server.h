@@ -22,13 +22,16 @@
 
 #include "ns3/application.h"
 #include "ns3/event-id.h"
+#include "ns3/object-factory.h"
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/socket.h"
 #include "ns3/seq-ts-size-frag-header.h"
+#include "bitrate-ladder.h"
 #include "bursty-application-server-instance.h"
+#include "joint-rate-allocator.h"
 #include <unordered_map>
 
 namespace ns3 {
@@ -111,6 +114,52 @@ public:
 
   std::map<Address, BurstyApplicationServerInstance> GetInstances (void) const;
 
+  /**
+   * \brief Set the weight of a client in the joint rate allocation
+   * \param peer the address of the client
+   * \param weight the weight, positive; clients have weight 1 by default
+   */
+  void SetClientWeight (const Address &peer, double weight);
+
+  /**
+   * \return the joint rate allocator, or null if each instance adapts on its own
+   */
+  Ptr<JointRateAllocator> GetRateAllocator (void) const;
+
+  /**
+   * \brief Add a sub-stream to the session of every client
+   *
+   * Each instance sends the messages of its own generator, created from
+   * the factory, along with the video, with the stream in the
+   * SeqTsSizeFragHeader of the messages. The messages must fit in a
+   * fragment. The instance socket is served in strict priority, the
+   * sub-streams going first at the priority of the video (VideoPriority).
+   * Only the instances created afterwards have the stream.
+   *
+   * \param stream the stream, see SeqTsSizeFragHeader::StreamType, but VIDEO_STREAM
+   * \param generator the factory of the BurstGenerator of the stream
+   * \param priority the priority of the stream, 0 being the highest
+   */
+  void AddStream (uint8_t stream, const ObjectFactory &generator, uint8_t priority);
+
+  /**
+   * \brief Assign fixed random variable streams to the server and its instances
+   *
+   * The render time takes the first stream. Instances are created as
+   * clients connect, so each of the first maxInstances instances takes a
+   * block of STREAMS_PER_INSTANCE streams, in order of creation, covering
+   * its generators and its HeadMotionModel (see
+   * BurstyApplicationServerInstance::AssignStreams). Later instances keep
+   * the streams assigned automatically.
+   *
+   * \param stream first stream index to use
+   * \param maxInstances the number of instances for which streams are reserved
+   * \return the number of stream indices reserved
+   */
+  int64_t AssignStreams (int64_t stream, uint32_t maxInstances);
+
+  static constexpr int64_t STREAMS_PER_INSTANCE = 16; //!< Streams reserved for each instance
+
 protected:
   virtual void DoDispose (void);
 
@@ -169,14 +218,64 @@ protected:
   /// Callback for transmitted fragment
   TracedCallback<Ptr<const Packet>, const Address &, const Address &, const SeqTsSizeFragHeader &>
       m_txFragmentTrace;
+  /// Callback for the sender timestamps of a burst
+  TracedCallback<const Address &, const BurstLatencyBreakdown &> m_latencyBreakdownTrace;
+  /// Callback for rate adaptation decisions of all instances
+  TracedCallback<const RateDecision &> m_rateDecisionTrace;
+  /// Callback for the send buffer samples of all instances
+  TracedCallback<const Address &, const SendBufferSample &> m_sendBufferSampleTrace;
+  /// Callback for the head poses of all instances
+  TracedCallback<const Address &, const HeadPose &> m_headPoseTrace;
+  /// Callback for the encoded frames of all instances
+  TracedCallback<const Address &, const RateControlSample &> m_rateControlTrace;
+  /// Callback for the uplink messages received by all instances
+  TracedCallback<Ptr<const Packet>, const Address &, const Address &, const SeqTsSizeFragHeader &>
+      m_rxUplinkTrace;
   void DataSend (Ptr<Socket>, uint32_t); // Called when a new segment is transmitted
 
   void CreateInstance (Ptr<Socket> socket, Address peer);
 
   std::string m_adaptationAlgorithm = "";
+  std::string m_bandwidthEstimatorType = ""; //!< Throughput estimator, empty for the algorithm default
   uint32_t m_fragSize = 1200; //!< Size of fragments including SeqTsSizeFragHeader
+  Ptr<BitrateLadder> m_bitrateLadder; //!< Ladder shared by all instances, null if none
 
   Time m_appDuration = Seconds (1);
+
+  bool m_enableSendBufferSampler = false; //!< Whether instances sample their send buffer
+  bool m_enableHeadMotion = false; //!< Whether instances modulate their frames with a head motion
+  bool m_enableRateControl = false; //!< Whether instances encode their frames with a rate control
+  bool m_enableRenderPipeline = false; //!< Whether instances render and encode their frames
+  Ptr<RandomVariableStream> m_renderTimeRv; //!< Render time of a frame [s]
+  int64_t m_instanceStream = -1; //!< First stream of the next instance, -1 if not assigned
+  uint32_t m_streamInstances = 0; //!< Instances left with reserved streams
+  DataRate m_encoderThroughput; //!< Encoded bits per second of encode time
+  uint32_t m_pipelineDepth = 2; //!< Largest number of frames being rendered or encoded
+  uint32_t m_maxQueuedFrames = 4; //!< Largest number of frames waiting for the renderer, 0 for no limit
+
+  /**
+   * \brief Allocate the rates of all adaptive instances and schedule the next allocation
+   */
+  void AllocateRates (void);
+
+  std::string m_rateAllocatorType = ""; //!< Joint rate allocator, empty for none
+  Ptr<JointRateAllocator> m_rateAllocator; //!< Joint rate allocator, null if none
+  Time m_rateAllocationInterval; //!< Time between two allocations, zero for once per frame
+  EventId m_rateAllocationEvent; //!< Next allocation
+  std::map<Address, double> m_clientWeights; //!< Weights of the clients, 1 if missing
+  std::vector<RateAllocationRequest> m_allocationRequests; //!< Reused across allocations
+  std::vector<BurstyApplicationServerInstance *> m_allocationInstances; //!< Instances of the requests
+  std::vector<DataRate> m_allocatedRates; //!< Reused across allocations
+
+  /// A sub-stream of the sessions
+  struct StreamConfig
+  {
+    uint8_t stream; //!< the stream
+    ObjectFactory generator; //!< factory of the generator of each instance
+    uint8_t priority; //!< 0 is the highest
+  };
+  std::vector<StreamConfig> m_streamConfigs; //!< sub-streams of the new instances
+  uint8_t m_videoPriority = 1; //!< priority of the video, 0 is the highest
 };
 
 } // namespace ns3
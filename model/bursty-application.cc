@@ -37,6 +37,8 @@
 #include "ns3/boolean.h"
 #include "ns3/burst-generator.h"
 #include "bursty-application.h"
+#include "vr-app-profiler.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -156,6 +158,7 @@ BurstyApplication::StartApplication ()
           NS_FATAL_ERROR ("Failed to bind socket");
         }
 
+      m_peerDescriptor.SetAddress (m_peer, VrAppProfiler::BURSTY_APPLICATION);
       m_socket->Connect (m_peer);
       m_socket->SetAllowBroadcast (true);
       // m_socket->ShutdownRecv ();
@@ -218,6 +221,7 @@ BurstyApplication::SendBurst ()
     }
 
   std::tie (burstSize, period) = m_burstGenerator->GenerateBurst ();
+  m_frameType = m_burstGenerator->GetLastFrameType ();
   NS_LOG_DEBUG ("Generated burstSize=" << burstSize << ", period=" << period.As (Time::MS));
   //}
   //
@@ -233,8 +237,24 @@ BurstyApplication::SendBurst ()
   NS_ASSERT_MSG (period.IsPositive (),
                  "Period must be non-negative, instead found period=" << period.As (Time::S));
 
-  // send packets for current burst
-  SendFragmentedBurst (burstSize);
+  // send packets for current burst, or for each of its sub-bursts
+  const std::vector<BurstGenerator::SubBurst> &subBursts = m_burstGenerator->GetLastSubBursts ();
+  if (subBursts.empty ())
+    {
+      SendFragmentedBurst (burstSize);
+    }
+  else
+    {
+      for (const auto &subBurst : subBursts)
+        {
+          m_tile = subBurst.tile;
+          m_tileQuality = subBurst.quality;
+          // a sub-burst needs a header and at least a byte of payload
+          SendFragmentedBurst (std::max (subBurst.size, hdrTmp.GetSerializedSize () + 1));
+        }
+      m_tile = SeqTsSizeFragHeader::NO_TILE;
+      m_tileQuality = 0;
+    }
 
   // schedule next burst
   NS_LOG_DEBUG ("Next burst scheduled in " << period.As (Time::S));
@@ -297,6 +317,7 @@ BurstyApplication::SendFragmentedBurst (uint32_t burstSize)
                                        << lastFragSize << " B");
 
   Ptr<Packet> burst = Create<Packet> (burstPayload);
+  VR_APP_PROFILE (BURSTY_APPLICATION, PACKET_CREATION);
   // Trace before adding header, for consistency with BurstSink
   Address from, to;
   m_socket->GetSockName (from);
@@ -307,6 +328,9 @@ BurstyApplication::SendFragmentedBurst (uint32_t burstSize)
   hdrTmp.SetSize (burstPayload);
   hdrTmp.SetFrags (totFrags);
   hdrTmp.SetFragSeq (0);
+  hdrTmp.SetFrameType (m_frameType);
+  hdrTmp.SetTile (m_tile);
+  hdrTmp.SetTileQuality (m_tileQuality);
 
   m_txBurstTrace (burst, from, to, hdrTmp);
 
@@ -319,6 +343,7 @@ BurstyApplication::SendFragmentedBurst (uint32_t burstSize)
       for (uint32_t i = 0; i < numFullFrags; i++)
         {
           Ptr<Packet> fragment = burst->CreateFragment (fragmentStart, fullFragmentPayload);
+          VR_APP_PROFILE (BURSTY_APPLICATION, CREATE_FRAGMENT);
           fragmentStart += fullFragmentPayload;
           SendFragment (fragment, burstPayload, totFrags, fragmentSeq++);
         }
@@ -327,6 +352,7 @@ BurstyApplication::SendFragmentedBurst (uint32_t burstSize)
         {
           uint64_t secondToLastFragPayload = secondToLastFragSize - hdrTmp.GetSerializedSize ();
           Ptr<Packet> fragment = burst->CreateFragment (fragmentStart, secondToLastFragPayload);
+          VR_APP_PROFILE (BURSTY_APPLICATION, CREATE_FRAGMENT);
           fragmentStart += secondToLastFragPayload;
           SendFragment (fragment, burstPayload, totFrags, fragmentSeq++);
         }
@@ -335,6 +361,7 @@ BurstyApplication::SendFragmentedBurst (uint32_t burstSize)
         {
           uint64_t lastFragPayload = lastFragSize - hdrTmp.GetSerializedSize ();
           Ptr<Packet> fragment = burst->CreateFragment (fragmentStart, lastFragPayload);
+          VR_APP_PROFILE (BURSTY_APPLICATION, CREATE_FRAGMENT);
           fragmentStart += lastFragPayload;
           SendFragment (fragment, burstPayload, totFrags, fragmentSeq++);
         }
@@ -355,6 +382,9 @@ BurstyApplication::SendFragment (Ptr<Packet> fragment, uint64_t burstSize, uint1
   header.SetSize (burstSize);
   header.SetFrags (totFrags);
   header.SetFragSeq (fragmentSeq);
+  header.SetFrameType (m_frameType);
+  header.SetTile (m_tile);
+  header.SetTileQuality (m_tileQuality);
   header.SetFragBytes (fragment->GetSize () + header.GetSerializedSize ());
   fragment->AddHeader (header);
 
@@ -370,6 +400,7 @@ BurstyApplication::SendFragment (Ptr<Packet> fragment, uint64_t burstSize, uint1
   if (m_queue.size () < m_queueSize)
     {
       m_queue.push_back (*fragment);
+      VR_APP_PROFILE (BURSTY_APPLICATION, PACKET_COPY);
     }
   // int actual = m_socket->Send (fragment);
   // if (uint32_t (actual) == fragmentSize)
@@ -383,25 +414,9 @@ BurstyApplication::SendFragment (Ptr<Packet> fragment, uint64_t burstSize, uint1
   m_totTxFragments++;
   m_totTxBytes += fragmentSize;
 
-  std::stringstream addressStr;
-  if (InetSocketAddress::IsMatchingType (m_peer))
-    {
-      addressStr << InetSocketAddress::ConvertFrom (m_peer).GetIpv4 () << " port "
-                 << InetSocketAddress::ConvertFrom (m_peer).GetPort ();
-    }
-  else if (Inet6SocketAddress::IsMatchingType (m_peer))
-    {
-      addressStr << Inet6SocketAddress::ConvertFrom (m_peer).GetIpv6 () << " port "
-                 << Inet6SocketAddress::ConvertFrom (m_peer).GetPort ();
-    }
-  else
-    {
-      addressStr << "UNKNOWN ADDRESS TYPE";
-    }
-
   NS_LOG_INFO ("At time " << Simulator::Now ().As (Time::S)
                           << " bursty application sent fragment of " << fragment->GetSize ()
-                          << " bytes to " << addressStr.str () << " with header=" << header);
+                          << " bytes to " << m_peerDescriptor << " with header=" << header);
 
   DataSend (m_socket, 0);
 }
@@ -422,6 +437,7 @@ BurstyApplication::DataSend (Ptr<Socket> socket, uint32_t)
       uint32_t max_tx_size = socket->GetTxAvailable ();
 
       Ptr<Packet> frame = m_queue.front ().Copy ();
+      VR_APP_PROFILE (BURSTY_APPLICATION, PACKET_COPY);
       uint32_t init_size = frame->GetSize ();
 
       if (max_tx_size <= init_size)
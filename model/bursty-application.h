@@ -27,6 +27,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/traced-callback.h"
 #include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/peer-descriptor.h"
 
 #include <queue>
 
@@ -173,6 +174,7 @@ protected:
 
   Ptr<Socket> m_socket; //!< Associated socket
   Address m_peer; //!< Peer address
+  PeerDescriptor m_peerDescriptor; //!< Peer address, formatted only when logged
   Address m_local; //!< Local address to bind to
   bool m_connected; //!< True if connected
   Ptr<BurstGenerator> m_burstGenerator; //!< Burst generator class
@@ -182,6 +184,9 @@ protected:
   uint64_t m_totTxBursts; //!< Total bursts sent
   uint64_t m_totTxFragments; //!< Total fragments sent
   uint64_t m_totTxBytes; //!< Total bytes sent
+  SeqTsSizeFragHeader::FrameType m_frameType{SeqTsSizeFragHeader::UNSPECIFIED_FRAME}; //!< Type of the current burst
+  uint16_t m_tile{SeqTsSizeFragHeader::NO_TILE}; //!< Tile of the current sub-burst
+  uint8_t m_tileQuality{0}; //!< Quality level of the current sub-burst
 
   // Traced Callbacks
   /// Callback for transmitted burst
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "encoder-rate-control.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EncoderRateControl");
+
+NS_OBJECT_ENSURE_REGISTERED(EncoderRateControl);
+
+TypeId
+EncoderRateControl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EncoderRateControl")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<EncoderRateControl>()
+            .AddAttribute("BufferSize",
+                          "The size of the VBV buffer, as a time at the target data rate of the "
+                          "first frame",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&EncoderRateControl::m_bufferDuration),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("InitialQp",
+                          "The quantization parameter of the first frame",
+                          DoubleValue(26),
+                          MakeDoubleAccessor(&EncoderRateControl::m_initialQp),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MinQp",
+                          "The finest quantization parameter",
+                          DoubleValue(10),
+                          MakeDoubleAccessor(&EncoderRateControl::m_minQp),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MaxQp",
+                          "The coarsest quantization parameter",
+                          DoubleValue(51),
+                          MakeDoubleAccessor(&EncoderRateControl::m_maxQp),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MaxQpStep",
+                          "The largest change of the quantization parameter between two frames",
+                          DoubleValue(2),
+                          MakeDoubleAccessor(&EncoderRateControl::m_maxQpStep),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("ReactionFrames",
+                          "The frames over which the buffer fullness is brought back to its "
+                          "target",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&EncoderRateControl::m_reactionFrames),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("TargetFullness",
+                          "The target buffer fullness, as a fraction of the buffer size, which "
+                          "is also the initial one",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&EncoderRateControl::m_targetFullness),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddTraceSource("BufferFullness",
+                            "A frame was encoded",
+                            MakeTraceSourceAccessor(&EncoderRateControl::m_fullnessTrace),
+                            "ns3::RateControlSample::TracedCallback");
+    return tid;
+}
+
+EncoderRateControl::EncoderRateControl()
+    : m_targetRate(DataRate("20Mbps")),
+      m_started(false),
+      m_refRate(0),
+      m_bufferSize(0),
+      m_qp(0),
+      m_fullness(0),
+      m_overflows(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EncoderRateControl::~EncoderRateControl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EncoderRateControl::SetTargetDataRate(DataRate rate)
+{
+    NS_LOG_FUNCTION(this << rate);
+    NS_ABORT_MSG_IF(rate.GetBitRate() == 0, "Target data rate must be positive");
+    m_targetRate = rate;
+}
+
+DataRate
+EncoderRateControl::GetTargetDataRate() const
+{
+    return m_targetRate;
+}
+
+uint32_t
+EncoderRateControl::EncodeFrame(uint32_t frameSize, Time interval)
+{
+    NS_LOG_FUNCTION(this << frameSize << interval);
+
+    double rate = m_targetRate.GetBitRate() / 8.0;
+    if (!m_started)
+    {
+        NS_ABORT_MSG_IF(m_minQp > m_maxQp,
+                        "MinQp=" << m_minQp << " must not exceed MaxQp=" << m_maxQp);
+        m_started = true;
+        m_refRate = rate;
+        m_bufferSize = GetBufferSize();
+        m_qp = std::max(m_minQp, std::min(m_initialQp, m_maxQp));
+        m_fullness = m_targetFullness * m_bufferSize;
+    }
+
+    double bytes = frameSize * m_refRate / rate * std::exp2((m_initialQp - m_qp) / 6);
+    if (m_fullness + bytes > m_bufferSize)
+    {
+        // re-encode with a coarser QP, down to the size at MaxQp
+        double coarsest = bytes * std::exp2((m_qp - m_maxQp) / 6);
+        bytes = std::max(m_bufferSize - m_fullness, coarsest);
+        if (m_fullness + bytes > m_bufferSize)
+        {
+            m_overflows++;
+        }
+    }
+    uint32_t encoded = static_cast<uint32_t>(bytes);
+    m_fullness = std::max(0.0, m_fullness + encoded - rate * interval.GetSeconds());
+
+    UpdateQp(interval);
+
+    NS_LOG_DEBUG("Frame of " << frameSize << " B encoded in " << encoded << " B, fullness "
+                             << m_fullness << "/" << m_bufferSize << " B, next QP " << m_qp);
+    m_fullnessTrace({Simulator::Now(), encoded, m_fullness, m_bufferSize, m_qp, m_targetRate});
+    return encoded;
+}
+
+void
+EncoderRateControl::UpdateQp(Time interval)
+{
+    if (interval.IsStrictlyPositive())
+    {
+        m_interval = interval;
+    }
+    if (m_interval.IsZero())
+    {
+        return;
+    }
+
+    // the data rate bringing the fullness to its target in ReactionFrames frames
+    double rate = m_targetRate.GetBitRate() / 8.0;
+    double excess = m_fullness - m_targetFullness * m_bufferSize;
+    double desired = rate - excess / (m_reactionFrames * m_interval.GetSeconds());
+    double qp = desired > 0 ? m_initialQp - 6 * std::log2(desired / m_refRate) : m_maxQp;
+
+    double step = std::max(-m_maxQpStep, std::min(qp - m_qp, m_maxQpStep));
+    m_qp = std::max(m_minQp, std::min(m_qp + step, m_maxQp));
+}
+
+double
+EncoderRateControl::GetFullness() const
+{
+    return m_fullness;
+}
+
+double
+EncoderRateControl::GetBufferSize() const
+{
+    if (m_started)
+    {
+        return m_bufferSize;
+    }
+    return m_bufferDuration.GetSeconds() * m_targetRate.GetBitRate() / 8.0;
+}
+
+double
+EncoderRateControl::GetQp() const
+{
+    return m_qp;
+}
+
+uint64_t
+EncoderRateControl::GetOverflows() const
+{
+    return m_overflows;
+}
+
+} // namespace ns3
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ENCODER_RATE_CONTROL_H
+#define ENCODER_RATE_CONTROL_H
+
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief The state of an EncoderRateControl after encoding a frame
+ */
+struct RateControlSample
+{
+    Time time;           //!< time the frame was encoded
+    uint32_t frameSize;  //!< size of the encoded frame [B]
+    double fullness;     //!< VBV buffer fullness after the frame [B]
+    double bufferSize;   //!< VBV buffer size [B]
+    double qp;           //!< quantization parameter of the next frame
+    DataRate targetRate; //!< target data rate
+
+    /**
+     * TracedCallback signature for rate control samples.
+     *
+     * \param [in] sample the sample
+     */
+    typedef void (*TracedCallback)(const RateControlSample& sample);
+
+    /**
+     * TracedCallback signature for the rate control samples of a flow.
+     *
+     * \param [in] flow the address of the peer
+     * \param [in] sample the sample
+     */
+    typedef void (*FlowTracedCallback)(const Address& flow, const RateControlSample& sample);
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Rate control of a video encoder, with a leaky-bucket VBV buffer
+ *
+ * Set on a VrBurstGenerator, it sits between the target data rate chosen by
+ * the adaptation and the frames: the generator samples the size of a frame
+ * at the target data rate, i.e., the complexity of the scene, and the rate
+ * control encodes it at its current quantization parameter (QP). The bits
+ * grow by a factor 2 every 6 QP steps: the encoded size is the sampled one
+ * times R(QP) / target, with R(QP) = R0 2^((InitialQp - QP) / 6) and R0 the
+ * target data rate at the first frame.
+ *
+ * The encoded frames fill a VBV buffer, which drains at the target data
+ * rate. Its size is set once, as BufferSize at R0, like the VBV size of an
+ * encoder configured at the start of a session. A frame that would overflow
+ * it is re-encoded with a coarser QP, to fit in the buffer, but not beyond
+ * MaxQp. After each frame, the QP moves towards the one whose data rate
+ * brings the fullness back to TargetFullness of the buffer in
+ * ReactionFrames frames, by at most MaxQpStep, within [MinQp, MaxQp].
+ *
+ * Hence, as in real encoders, a new target data rate is reached over a few
+ * frames, with an overshoot on complex scenes, rather than at the next
+ * frame. Each frame costs a constant-time update, and the state after it is
+ * fired through the BufferFullness trace source.
+ */
+class EncoderRateControl : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    EncoderRateControl();
+    ~EncoderRateControl() override;
+
+    /**
+     * \brief Set the target data rate, at which the VBV buffer drains
+     * \param rate the target data rate
+     */
+    void SetTargetDataRate(DataRate rate);
+
+    /**
+     * \return the target data rate
+     */
+    DataRate GetTargetDataRate() const;
+
+    /**
+     * \brief Encode a frame
+     * \param frameSize the size of the frame at the target data rate [B]
+     * \param interval the time until the next frame
+     * \return the size of the encoded frame [B]
+     */
+    uint32_t EncodeFrame(uint32_t frameSize, Time interval);
+
+    /**
+     * \return the VBV buffer fullness [B]
+     */
+    double GetFullness() const;
+
+    /**
+     * \return the VBV buffer size, at the current target data rate before the first frame [B]
+     */
+    double GetBufferSize() const;
+
+    /**
+     * \return the quantization parameter of the next frame
+     */
+    double GetQp() const;
+
+    /**
+     * \return the number of frames which overflowed the VBV buffer even at MaxQp
+     */
+    uint64_t GetOverflows() const;
+
+  private:
+    /**
+     * \brief Update the QP after a frame
+     * \param interval the time until the next frame
+     */
+    void UpdateQp(Time interval);
+
+    Time m_bufferDuration;     //!< VBV buffer size, as a time at R0
+    double m_initialQp;        //!< QP at the first frame
+    double m_minQp;            //!< finest QP
+    double m_maxQp;            //!< coarsest QP
+    double m_maxQpStep;        //!< largest QP change between two frames
+    uint32_t m_reactionFrames; //!< frames to bring the fullness back to its target
+    double m_targetFullness;   //!< target fullness, as a fraction of the buffer size
+
+    DataRate m_targetRate; //!< target data rate
+    bool m_started;        //!< whether a frame was encoded
+    double m_refRate;      //!< target data rate at the first frame, R0 [B/s]
+    double m_bufferSize;   //!< VBV buffer size [B]
+    double m_qp;           //!< QP of the next frame
+    double m_fullness;     //!< VBV buffer fullness [B]
+    Time m_interval;       //!< last positive interval between two frames
+    uint64_t m_overflows;  //!< frames which overflowed the buffer
+
+    /// Encoded frames
+    ns3::TracedCallback<const RateControlSample&> m_fullnessTrace;
+};
+
+} // namespace ns3
+
+#endif /* ENCODER_RATE_CONTROL_H */
@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "head-motion-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/csv-reader.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HeadMotionModel");
+
+NS_OBJECT_ENSURE_REGISTERED(HeadMotionModel);
+
+namespace
+{
+
+/**
+ * \brief Wrap an angle to [-180, 180)
+ * \param angle the angle, in degrees
+ * \return the wrapped angle
+ */
+double
+WrapAngle(double angle)
+{
+    angle = std::fmod(angle + 180, 360);
+    if (angle < 0)
+    {
+        angle += 360;
+    }
+    return angle - 180;
+}
+
+/**
+ * \brief Expected norm of two independent zero-mean Gaussian variables
+ *
+ * With (x, y) = r (s1 cos t, s2 sin t), r Rayleigh and t uniform, the
+ * expectation is E[r] = sqrt(pi/2) times the average of
+ * sqrt(s1^2 cos^2 t + s2^2 sin^2 t) over t, computed with the midpoint rule.
+ *
+ * \param s1 the standard deviation of the first variable
+ * \param s2 the standard deviation of the second variable
+ * \return the expected norm
+ */
+double
+MeanGaussianNorm(double s1, double s2)
+{
+    const int points = 64;
+    double sum = 0;
+    for (int i = 0; i < points; ++i)
+    {
+        double t = (i + 0.5) * M_PI / 2 / points; // a quarter is enough by symmetry
+        sum += std::hypot(s1 * std::cos(t), s2 * std::sin(t));
+    }
+    return std::sqrt(M_PI / 2) * sum / points;
+}
+
+} // namespace
+
+TypeId
+HeadMotionModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HeadMotionModel")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<HeadMotionModel>()
+            .AddAttribute("YawSpeedStd",
+                          "The standard deviation of the yaw angular velocity [deg/s]",
+                          DoubleValue(30),
+                          MakeDoubleAccessor(&HeadMotionModel::m_yawSpeedStd),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("PitchSpeedStd",
+                          "The standard deviation of the pitch angular velocity [deg/s]",
+                          DoubleValue(10),
+                          MakeDoubleAccessor(&HeadMotionModel::m_pitchSpeedStd),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("CorrelationTime",
+                          "The correlation time of the angular velocities",
+                          TimeValue(MilliSeconds(300)),
+                          MakeTimeAccessor(&HeadMotionModel::m_correlationTime),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("MaxPitch",
+                          "The largest absolute pitch, where the head bounces back [deg]",
+                          DoubleValue(60),
+                          MakeDoubleAccessor(&HeadMotionModel::m_maxPitch),
+                          MakeDoubleChecker<double>(0, 90))
+            .AddAttribute("TraceFile",
+                          "A CSV file with a pose trace replacing the stochastic model, see Load",
+                          StringValue(""),
+                          MakeStringAccessor(&HeadMotionModel::Load),
+                          MakeStringChecker())
+            .AddTraceSource("Pose",
+                            "A new pose has been computed",
+                            MakeTraceSourceAccessor(&HeadMotionModel::m_poseTrace),
+                            "ns3::HeadPose::TracedCallback");
+    return tid;
+}
+
+HeadMotionModel::HeadMotionModel()
+    : m_traceIndex(0),
+      m_traceDistance(0),
+      m_initialized(false),
+      m_yawSpeed(0),
+      m_pitchSpeed(0),
+      m_meanSpeed(0),
+      m_pose{Seconds(0), 0, 0, 0}
+{
+    NS_LOG_FUNCTION(this);
+    m_rv = CreateObject<NormalRandomVariable>();
+}
+
+HeadMotionModel::~HeadMotionModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HeadMotionModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_rv = 0;
+    Object::DoDispose();
+}
+
+int64_t
+HeadMotionModel::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_rv->SetStream(stream);
+    return 1;
+}
+
+void
+HeadMotionModel::Load(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (filename.empty())
+    {
+        return;
+    }
+
+    CsvReader csv(filename);
+    while (csv.FetchNextRow())
+    {
+        double time;
+        double yaw;
+        double pitch;
+        if (csv.IsBlankRow() || !csv.GetValue(0, time) || !csv.GetValue(1, yaw) ||
+            !csv.GetValue(2, pitch))
+        {
+            continue;
+        }
+        AddSample(Seconds(time), yaw, pitch);
+    }
+    NS_ABORT_MSG_IF(m_trace.empty(), "No pose in file " << filename);
+    NS_LOG_INFO("Loaded " << m_trace.size() << " poses from file " << filename);
+}
+
+void
+HeadMotionModel::AddSample(Time time, double yaw, double pitch)
+{
+    NS_ABORT_MSG_IF(m_initialized, "Poses must be added before the first GetPose");
+    if (m_trace.empty())
+    {
+        // the trace starts at its first sample
+        m_traceStart = time;
+        m_trace.push_back({0, WrapAngle(yaw), pitch, 0});
+        return;
+    }
+
+    double t = (time - m_traceStart).GetSeconds();
+    Sample& last = m_trace.back();
+    NS_ABORT_MSG_IF(t <= last.time, "Pose at " << time.As(Time::S) << " is not after the last one");
+
+    double distance = std::hypot(WrapAngle(yaw - last.yaw), pitch - last.pitch);
+    last.speed = distance / (t - last.time);
+    m_traceDistance += distance;
+    m_trace.push_back({t, WrapAngle(yaw), pitch, 0});
+}
+
+double
+HeadMotionModel::GetMeanSpeed() const
+{
+    if (m_initialized)
+    {
+        return m_meanSpeed;
+    }
+    if (m_trace.empty())
+    {
+        return MeanGaussianNorm(m_yawSpeedStd, m_pitchSpeedStd);
+    }
+    double duration = m_trace.back().time;
+    return duration > 0 ? m_traceDistance / duration : 0;
+}
+
+const HeadPose&
+HeadMotionModel::GetLastPose() const
+{
+    return m_pose;
+}
+
+const HeadPose&
+HeadMotionModel::GetPose(Time time)
+{
+    if (!m_initialized)
+    {
+        Initialize(time);
+    }
+    else if (time > m_pose.time)
+    {
+        if (m_trace.empty())
+        {
+            AdvanceStochastic((time - m_pose.time).GetSeconds());
+        }
+        else
+        {
+            AdvanceTrace(time - m_start);
+        }
+        m_pose.time = time;
+    }
+    else
+    {
+        NS_ASSERT_MSG(time == m_pose.time, "Poses must be requested in chronological order");
+        return m_pose;
+    }
+
+    NS_LOG_LOGIC("Pose at " << time.As(Time::S) << ": yaw=" << m_pose.yaw
+                            << ", pitch=" << m_pose.pitch << ", speed=" << m_pose.speed);
+    m_poseTrace(m_pose);
+    return m_pose;
+}
+
+void
+HeadMotionModel::Initialize(Time time)
+{
+    NS_LOG_FUNCTION(this << time);
+    m_meanSpeed = GetMeanSpeed();
+    m_initialized = true;
+    m_start = time;
+    m_pose.time = time;
+
+    if (m_trace.empty())
+    {
+        // start facing forward, with velocities from their stationary distribution
+        m_yawSpeed = m_yawSpeedStd * m_rv->GetValue();
+        m_pitchSpeed = m_pitchSpeedStd * m_rv->GetValue();
+        m_pose.yaw = 0;
+        m_pose.pitch = 0;
+        m_pose.speed = std::hypot(m_yawSpeed, m_pitchSpeed);
+    }
+    else
+    {
+        m_traceIndex = 0;
+        AdvanceTrace(Seconds(0));
+    }
+}
+
+void
+HeadMotionModel::AdvanceStochastic(double dt)
+{
+    // exact sampling of the Ornstein-Uhlenbeck processes after dt
+    double tau = m_correlationTime.GetSeconds();
+    double a = tau > 0 ? std::exp(-dt / tau) : 0;
+    double b = std::sqrt(1 - a * a);
+    double yawSpeed = a * m_yawSpeed + b * m_yawSpeedStd * m_rv->GetValue();
+    double pitchSpeed = a * m_pitchSpeed + b * m_pitchSpeedStd * m_rv->GetValue();
+
+    // trapezoidal integration of the orientation
+    m_pose.yaw = WrapAngle(m_pose.yaw + (m_yawSpeed + yawSpeed) / 2 * dt);
+    m_pose.pitch += (m_pitchSpeed + pitchSpeed) / 2 * dt;
+    if (std::abs(m_pose.pitch) > m_maxPitch)
+    {
+        double limit = std::copysign(m_maxPitch, m_pose.pitch);
+        m_pose.pitch = std::max(-m_maxPitch, std::min(2 * limit - m_pose.pitch, m_maxPitch));
+        pitchSpeed = -pitchSpeed;
+    }
+
+    m_yawSpeed = yawSpeed;
+    m_pitchSpeed = pitchSpeed;
+    m_pose.speed = std::hypot(yawSpeed, pitchSpeed);
+}
+
+void
+HeadMotionModel::AdvanceTrace(Time time)
+{
+    double duration = m_trace.back().time;
+    double t = duration > 0 ? std::fmod(time.GetSeconds(), duration) : 0;
+    if (t < m_trace[m_traceIndex].time)
+    {
+        // the trace looped
+        m_traceIndex = 0;
+    }
+    while (m_traceIndex + 1 < m_trace.size() && m_trace[m_traceIndex + 1].time <= t)
+    {
+        ++m_traceIndex;
+    }
+
+    const Sample& sample = m_trace[m_traceIndex];
+    m_pose.yaw = sample.yaw;
+    m_pose.pitch = sample.pitch;
+    m_pose.speed = sample.speed;
+    if (m_traceIndex + 1 < m_trace.size())
+    {
+        const Sample& next = m_trace[m_traceIndex + 1];
+        double fraction = (t - sample.time) / (next.time - sample.time);
+        m_pose.yaw = WrapAngle(sample.yaw + fraction * WrapAngle(next.yaw - sample.yaw));
+        m_pose.pitch = sample.pitch + fraction * (next.pitch - sample.pitch);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HEAD_MOTION_MODEL_H
+#define HEAD_MOTION_MODEL_H
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief The orientation and angular speed of the head of a user
+ */
+struct HeadPose
+{
+    Time time;    //!< time of the pose
+    double yaw;   //!< yaw, in degrees within [-180, 180)
+    double pitch; //!< pitch, in degrees within [-90, 90]
+    double speed; //!< angular speed, in degrees per second
+
+    /**
+     * TracedCallback signature for head poses.
+     *
+     * \param [in] pose the pose
+     */
+    typedef void (*TracedCallback)(const HeadPose& pose);
+
+    /**
+     * TracedCallback signature for the head poses of a flow.
+     *
+     * \param [in] flow the address of the peer
+     * \param [in] pose the pose
+     */
+    typedef void (*FlowTracedCallback)(const Address& flow, const HeadPose& pose);
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Head rotation of a VR user, evaluated on demand
+ *
+ * The pose is advanced only when it is requested with GetPose, e.g., by a
+ * VrBurstGenerator once per frame, so that the model schedules no event and
+ * costs O(1) per evaluation, whatever the time since the previous one.
+ *
+ * Without a trace, the yaw and pitch angular velocities are independent
+ * Ornstein-Uhlenbeck processes with zero mean, standard deviations
+ * YawSpeedStd and PitchSpeedStd, and correlation time CorrelationTime,
+ * sampled exactly at the requested times. The orientation integrates the
+ * velocities, the yaw wrapping around and the pitch bouncing at MaxPitch.
+ *
+ * With a trace (TraceFile, or AddSample), the poses of the trace are
+ * linearly interpolated, the angular speed being constant between two
+ * samples, and the trace loops. Each row of the file holds the time [s], the
+ * yaw and the pitch [degrees]; rows where they are not numbers (comments,
+ * header) are skipped.
+ *
+ * The angular speed is the norm of the yaw and pitch velocities. The model
+ * starts at the first request, and every new pose is fired through the Pose
+ * trace source.
+ */
+class HeadMotionModel : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    HeadMotionModel();
+    ~HeadMotionModel() override;
+
+    /**
+     * \brief Get the pose at a given time
+     * \param time the time, not before the previous request
+     * \return the pose
+     */
+    const HeadPose& GetPose(Time time);
+
+    /**
+     * \return the last pose returned by GetPose
+     */
+    const HeadPose& GetLastPose() const;
+
+    /**
+     * \brief Get the long-run average of the angular speed
+     *
+     * For the stochastic model, it is the expected norm of the two Gaussian
+     * velocities; for a trace, the angular distance covered by the trace
+     * over its duration.
+     *
+     * \return the average angular speed, in degrees per second
+     */
+    double GetMeanSpeed() const;
+
+    /**
+     * \brief Load a pose trace from a CSV file
+     * \param filename the file, ignored if empty
+     */
+    void Load(std::string filename);
+
+    /**
+     * \brief Append a pose to the trace
+     * \param time the time of the pose, after the previous one
+     * \param yaw the yaw, in degrees
+     * \param pitch the pitch, in degrees
+     */
+    void AddSample(Time time, double yaw, double pitch);
+
+    /**
+     * \brief Assign a fixed random variable stream number to the random variables used by this
+     * model
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A pose of the trace
+    struct Sample
+    {
+        double time;  //!< time since the first sample, in seconds
+        double yaw;   //!< yaw, in degrees
+        double pitch; //!< pitch, in degrees
+        double speed; //!< angular speed until the next sample, in degrees per second
+    };
+
+    /**
+     * \brief Start the model at the first request
+     * \param time the time of the first request
+     */
+    void Initialize(Time time);
+
+    /**
+     * \brief Advance the Ornstein-Uhlenbeck velocities and integrate the orientation
+     * \param dt the time since the last pose, in seconds
+     */
+    void AdvanceStochastic(double dt);
+
+    /**
+     * \brief Interpolate the trace
+     * \param time the time since the start of the model
+     */
+    void AdvanceTrace(Time time);
+
+    double m_yawSpeedStd;   //!< standard deviation of the yaw velocity [deg/s]
+    double m_pitchSpeedStd; //!< standard deviation of the pitch velocity [deg/s]
+    Time m_correlationTime; //!< correlation time of the velocities
+    double m_maxPitch;      //!< largest absolute pitch [deg]
+
+    Ptr<NormalRandomVariable> m_rv; //!< standard normal variates
+
+    std::vector<Sample> m_trace; //!< pose trace, empty for the stochastic model
+    Time m_traceStart;           //!< time of the first sample of the trace
+    std::size_t m_traceIndex;    //!< sample of the last pose
+    double m_traceDistance;      //!< angular distance covered by the trace [deg]
+
+    bool m_initialized;  //!< whether the model started
+    Time m_start;        //!< time of the first request
+    double m_yawSpeed;   //!< current yaw velocity [deg/s]
+    double m_pitchSpeed; //!< current pitch velocity [deg/s]
+    double m_meanSpeed;  //!< average angular speed, set when the model starts [deg/s]
+    HeadPose m_pose;     //!< last pose
+
+    /// New poses
+    ns3::TracedCallback<const HeadPose&> m_poseTrace;
+};
+
+} // namespace ns3
+
+#endif /* HEAD_MOTION_MODEL_H */
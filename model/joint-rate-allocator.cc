@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "joint-rate-allocator.h"
+
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("JointRateAllocator");
+
+NS_OBJECT_ENSURE_REGISTERED(JointRateAllocator);
+NS_OBJECT_ENSURE_REGISTERED(MaxMinRateAllocator);
+NS_OBJECT_ENSURE_REGISTERED(ProportionalFairRateAllocator);
+
+TypeId
+JointRateAllocator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::JointRateAllocator")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddAttribute("Capacity",
+                          "The capacity shared by the clients. If zero, it is estimated as the "
+                          "sum of the throughputs measured by the clients (their demand, limited "
+                          "by their cap, until one is measured)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&JointRateAllocator::m_capacity),
+                          MakeDataRateChecker())
+            .AddAttribute("MinRate",
+                          "The minimum rate allocated to a client",
+                          DataRateValue(DataRate("3128000bps")),
+                          MakeDataRateAccessor(&JointRateAllocator::m_minRate),
+                          MakeDataRateChecker())
+            .AddAttribute("BacklogDrainTime",
+                          "The time within which the send buffer of a client should drain: its "
+                          "saturation rate is lowered by its buffer occupancy over this time, "
+                          "zero to ignore the buffers",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&JointRateAllocator::m_backlogDrainTime),
+                          MakeTimeChecker(Seconds(0)))
+            .AddTraceSource("Allocation",
+                            "The capacity has been allocated among the clients",
+                            MakeTraceSourceAccessor(&JointRateAllocator::m_allocationTrace),
+                            "ns3::JointRateAllocator::AllocationTracedCallback");
+    return tid;
+}
+
+JointRateAllocator::JointRateAllocator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+JointRateAllocator::~JointRateAllocator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+JointRateAllocator::Allocate(const std::vector<RateAllocationRequest>& requests,
+                             std::vector<DataRate>& rates)
+{
+    NS_LOG_FUNCTION(this << requests.size());
+
+    uint32_t n = requests.size();
+    rates.assign(n, DataRate(0));
+    if (n == 0)
+    {
+        return;
+    }
+
+    double capacity = m_capacity.GetBitRate();
+    bool estimateCapacity = (capacity == 0);
+    double totWeight = 0;
+    double totFloor = 0;
+    m_order.resize(n);
+    m_weights.resize(n);
+    m_headroom.resize(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        m_order[i] = i;
+        m_weights[i] = GetWeight(requests[i]);
+        NS_ABORT_MSG_IF(m_weights[i] <= 0,
+                        "The weight of a client must be positive, instead: " << m_weights[i]);
+        totWeight += m_weights[i];
+
+        // a client needs no more than its demand, and is never given more than its cap
+        double limit = std::min(requests[i].demand, requests[i].cap).GetBitRate();
+        double floor = std::min(requests[i].cap, m_minRate).GetBitRate();
+        if (estimateCapacity)
+        {
+            capacity += requests[i].measured.GetBitRate() > 0
+                            ? std::min(requests[i].measured, requests[i].cap).GetBitRate()
+                            : limit;
+        }
+        // a client with a backlog needs less, so that its send buffer drains
+        if (m_backlogDrainTime.IsStrictlyPositive())
+        {
+            limit -= requests[i].bufferOccupancy * 8.0 / m_backlogDrainTime.GetSeconds();
+        }
+        rates[i] = DataRate(uint64_t(floor));
+        m_headroom[i] = std::max(limit - floor, 0.0);
+        totFloor += floor;
+    }
+
+    // the floors are reserved first, scaled down if they exceed the capacity
+    if (totFloor > capacity)
+    {
+        NS_LOG_DEBUG("MinRate of " << n << " clients exceeds the capacity " << capacity);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            rates[i] = DataRate(uint64_t(rates[i].GetBitRate() * capacity / totFloor));
+        }
+        totFloor = capacity;
+    }
+
+    // clients with the lowest headroom per unit of weight are saturated first
+    std::sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+        return m_headroom[a] * m_weights[b] < m_headroom[b] * m_weights[a];
+    });
+
+    double remaining = capacity - totFloor;
+    for (uint32_t i : m_order)
+    {
+        double share = remaining * m_weights[i] / totWeight;
+        double extra = std::min(m_headroom[i], share);
+        remaining -= extra;
+        totWeight -= m_weights[i];
+
+        rates[i] = DataRate(rates[i].GetBitRate() + uint64_t(extra));
+        NS_LOG_DEBUG("Client " << requests[i].flow << " demand " << requests[i].demand
+                               << " cap " << requests[i].cap << " weight " << m_weights[i]
+                               << ": allocated " << rates[i]);
+    }
+
+    m_allocationTrace(requests, rates);
+}
+
+TypeId
+MaxMinRateAllocator::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MaxMinRateAllocator")
+                            .SetParent<JointRateAllocator>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<MaxMinRateAllocator>();
+    return tid;
+}
+
+double
+MaxMinRateAllocator::GetWeight(const RateAllocationRequest& request) const
+{
+    return request.weight;
+}
+
+TypeId
+ProportionalFairRateAllocator::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ProportionalFairRateAllocator")
+                            .SetParent<JointRateAllocator>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<ProportionalFairRateAllocator>();
+    return tid;
+}
+
+double
+ProportionalFairRateAllocator::GetWeight(const RateAllocationRequest& request) const
+{
+    DataRate linkRate = request.measured.GetBitRate() > 0 ? request.measured : request.demand;
+    return request.weight * std::max<uint64_t>(linkRate.GetBitRate(), 1);
+}
+
+} // namespace ns3
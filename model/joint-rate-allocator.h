@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JOINT_RATE_ALLOCATOR_H
+#define JOINT_RATE_ALLOCATOR_H
+
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief The state of a client, as seen by a JointRateAllocator
+ */
+struct RateAllocationRequest
+{
+    Address flow;             //!< the address of the client
+    DataRate demand;          //!< rate proposed by the adaptation algorithm of the client
+    DataRate measured;        //!< throughput measured by the adaptation algorithm
+    DataRate cap;             //!< maximum rate of the client
+    uint64_t bufferOccupancy; //!< bytes waiting in the send buffer of the client
+    double weight;            //!< weight of the client
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Shares the capacity of a server among all its clients
+ *
+ * Instead of letting each BurstyApplicationServerInstance adapt on its own,
+ * BurstyApplicationServer periodically collects the demand of every client
+ * and asks the allocator to split the available capacity among them.
+ *
+ * The capacity is either fixed by the Capacity attribute or, if zero,
+ * estimated as the sum of the throughputs measured by the clients, each
+ * limited by its cap (or its demand, until a throughput is measured): the
+ * adaptation algorithms keep probing the network on their own, while the
+ * allocator redistributes the aggregate among clients, moving the capacity
+ * a client does not use to the ones asking for more.
+ *
+ * Each client is first given a floor of MinRate (or its cap, if lower); if
+ * the floors exceed the capacity, they are scaled down to fit it. The rest
+ * of the capacity is shared with a weighted water-filling, where each client
+ * saturates at min(demand, cap), lowered by the rate draining its send
+ * buffer within BacklogDrainTime: clients are sorted by headroom / weight
+ * once, the headroom being the saturation rate above the floor, and each
+ * receives min(headroom, weight * level) on top of its floor, where the level
+ * is the share left by the clients before it, i.e., a single O(N log N) pass.
+ * Hence the capacity a client does not need is passed on to the others, and
+ * the rates never sum to more than the capacity. Subclasses choose the
+ * weights.
+ */
+class JointRateAllocator : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    JointRateAllocator();
+    ~JointRateAllocator() override;
+
+    /**
+     * \brief Allocate the capacity among the clients
+     * \param requests the state of each client
+     * \param rates the allocated rates, in the same order as requests
+     */
+    void Allocate(const std::vector<RateAllocationRequest>& requests,
+                  std::vector<DataRate>& rates);
+
+    /**
+     * TracedCallback signature for allocations.
+     *
+     * \param [in] requests the state of each client
+     * \param [in] rates the allocated rates
+     */
+    typedef void (*AllocationTracedCallback)(const std::vector<RateAllocationRequest>& requests,
+                                             const std::vector<DataRate>& rates);
+
+  protected:
+    /**
+     * \param request the state of a client
+     * \return the weight of the client in the water-filling, positive
+     */
+    virtual double GetWeight(const RateAllocationRequest& request) const = 0;
+
+  private:
+    DataRate m_capacity;     //!< capacity to share, zero to estimate it from the throughputs
+    DataRate m_minRate;      //!< minimum rate of each client
+    Time m_backlogDrainTime; //!< time to drain the send buffers, zero to ignore them
+
+    std::vector<uint32_t> m_order;  //!< clients sorted by headroom / weight, reused across calls
+    std::vector<double> m_weights;  //!< weights of the clients, reused across calls
+    std::vector<double> m_headroom; //!< saturation rates above the floors, reused across calls
+
+    /// Allocation performed
+    ns3::TracedCallback<const std::vector<RateAllocationRequest>&, const std::vector<DataRate>&>
+        m_allocationTrace;
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Weighted max-min fair allocation
+ *
+ * The weight of each client is its configured weight: with equal weights all
+ * clients get the same rate, unless limited by their cap.
+ */
+class MaxMinRateAllocator : public JointRateAllocator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+  protected:
+    double GetWeight(const RateAllocationRequest& request) const override;
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Proportional-fair allocation on a shared channel
+ *
+ * When clients share the airtime of the same AP or gNB, the proportional-fair
+ * allocation gives each client the same share of airtime, i.e., rates
+ * proportional to the link rates. The throughput measured by the adaptation
+ * algorithm of each client is used as a proxy of its link rate, so the
+ * weight is the configured weight times the measured throughput (or the
+ * demand, until a throughput has been measured).
+ */
+class ProportionalFairRateAllocator : public JointRateAllocator
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+  protected:
+    double GetWeight(const RateAllocationRequest& request) const override;
+};
+
+} // namespace ns3
+
+#endif /* JOINT_RATE_ALLOCATOR_H */
@@ -30,7 +30,7 @@
 #include <ns3/object-factory.h>
 #include <cmath>
 #include <iostream>
-#include <algorithm>    // upper_bound
+#include <algorithm>    // upper_bound, min
 
 namespace ns3 {
 
@@ -141,7 +141,13 @@ MixtureRandomVariable::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::MixtureRandomVariable")
                           .SetParent<RandomVariableStream> ()
                           .SetGroupName ("Core")
-                          .AddConstructor<MixtureRandomVariable> ();
+                          .AddConstructor<MixtureRandomVariable> ()
+                          .AddAttribute ("Fused",
+                                         "Sample mixtures of logistic or of normal random variables "
+                                         "inline, from the stream of the mixture",
+                                         BooleanValue (false),
+                                         MakeBooleanAccessor (&MixtureRandomVariable::m_fused),
+                                         MakeBooleanChecker ());
   return tid;
 }
 
@@ -153,7 +159,6 @@ MixtureRandomVariable::MixtureRandomVariable (void)
 MixtureRandomVariable::~MixtureRandomVariable (void)
 {
   NS_LOG_FUNCTION (this);
-  m_wCdf = 0;
   m_rvs.clear ();
 }
 
@@ -164,15 +169,171 @@ MixtureRandomVariable::SetRvs (std::vector<double> weightsCdf,
   NS_LOG_FUNCTION (this);
   NS_ABORT_MSG_IF (weightsCdf.size () != rvs.size (),
                    "CDF of weights and random variables must have the same size");
+  NS_ABORT_MSG_IF (rvs.empty (), "A mixture needs at least one random variable");
 
   m_rvs = rvs;
 
-  // create empirical random variable to ease the extraction of m_rvs
-  m_wCdf =
-      CreateObjectWithAttributes<EmpiricalRandomVariable> ("Interpolate", BooleanValue (false));
-  for (uint32_t i = 0; i < weightsCdf.size (); i++)
+  // Vose's alias method: column i keeps component i with probability
+  // m_aliasProb[i], and yields m_alias[i] otherwise
+  uint32_t n = weightsCdf.size ();
+  double total = weightsCdf.back ();
+  NS_ABORT_MSG_UNLESS (total > 0, "The CDF of weights must end with a positive value");
+  std::vector<double> scaled (n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (uint32_t i = 0; i < n; i++)
     {
-      m_wCdf->CDF (i, weightsCdf[i]);
+      double weight = weightsCdf[i] - (i > 0 ? weightsCdf[i - 1] : 0);
+      NS_ABORT_MSG_IF (weight < 0, "The CDF of weights must be non-decreasing");
+      scaled[i] = weight * n / total;
+      (scaled[i] < 1 ? small : large).push_back (i);
+    }
+
+  m_aliasProb.assign (n, 1);
+  m_alias.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_alias[i] = i;
+    }
+  while (!small.empty () && !large.empty ())
+    {
+      uint32_t s = small.back ();
+      small.pop_back ();
+      uint32_t l = large.back ();
+      m_aliasProb[s] = scaled[s];
+      m_alias[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1)
+        {
+          large.pop_back ();
+          small.push_back (l);
+        }
+    }
+  // the columns left in either list are full, up to rounding errors
+
+  // the inline path needs components of a single family
+  m_components.clear ();
+  m_family = GENERIC;
+  if (DynamicCast<LogisticRandomVariable> (rvs.front ()))
+    {
+      m_family = LOGISTIC;
+    }
+  else if (DynamicCast<NormalRandomVariable> (rvs.front ()))
+    {
+      m_family = NORMAL;
+    }
+  for (uint32_t i = 0; i < n && m_family != GENERIC; i++)
+    {
+      Ptr<LogisticRandomVariable> logistic = DynamicCast<LogisticRandomVariable> (rvs[i]);
+      Ptr<NormalRandomVariable> normal = DynamicCast<NormalRandomVariable> (rvs[i]);
+      if (m_family == LOGISTIC && logistic)
+        {
+          m_components.push_back (
+              {logistic->GetLocation (), logistic->GetScale (), logistic->GetBound ()});
+        }
+      else if (m_family == NORMAL && normal)
+        {
+          m_components.push_back (
+              {normal->GetMean (), std::sqrt (normal->GetVariance ()), normal->GetBound ()});
+        }
+      else
+        {
+          m_family = GENERIC;
+          m_components.clear ();
+        }
+    }
+  NS_LOG_LOGIC ("Mixture of " << n << " random variables, family=" << m_family);
+}
+
+int64_t
+MixtureRandomVariable::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+
+  SetStream (stream);
+  int64_t currentStream = stream + 1;
+  for (const auto &rv : m_rvs)
+    {
+      Ptr<MixtureRandomVariable> mixture = DynamicCast<MixtureRandomVariable> (rv);
+      if (mixture)
+        {
+          currentStream += mixture->AssignStreams (currentStream);
+        }
+      else
+        {
+          rv->SetStream (currentStream++);
+        }
+    }
+  return currentStream - stream;
+}
+
+uint32_t
+MixtureRandomVariable::SampleIndex (void)
+{
+  // a single uniform value gives both the column and the coin
+  double v = Peek ()->RandU01 ();
+  if (IsAntithetic ())
+    {
+      v = (1 - v);
+    }
+  double x = v * m_alias.size ();
+  uint32_t column = std::min (static_cast<uint32_t> (x), static_cast<uint32_t> (m_alias.size () - 1));
+  return (x - column) < m_aliasProb[column] ? column : m_alias[column];
+}
+
+double
+MixtureRandomVariable::SampleFused (uint32_t idx)
+{
+  const Component &c = m_components[idx];
+  while (1)
+    {
+      double x;
+      if (m_family == LOGISTIC)
+        {
+          // same inverse CDF as LogisticRandomVariable
+          double v = Peek ()->RandU01 ();
+          if (IsAntithetic ())
+            {
+              v = (1 - v);
+            }
+          x = c.location + c.scale * std::log (v / (1 - v));
+        }
+      else
+        {
+          // polar method, as NormalRandomVariable
+          if (!m_hasNextNormal)
+            {
+              double w;
+              double u1;
+              double u2;
+              do
+                {
+                  u1 = 2 * Peek ()->RandU01 () - 1;
+                  u2 = 2 * Peek ()->RandU01 () - 1;
+                  if (IsAntithetic ())
+                    {
+                      u1 = -u1;
+                      u2 = -u2;
+                    }
+                  w = u1 * u1 + u2 * u2;
+                }
+              while (w >= 1 || w == 0);
+              double y = std::sqrt ((-2 * std::log (w)) / w);
+              m_nextNormal = u2 * y;
+              m_hasNextNormal = true;
+              x = c.location + c.scale * u1 * y;
+            }
+          else
+            {
+              m_hasNextNormal = false;
+              x = c.location + c.scale * m_nextNormal;
+            }
+        }
+
+      if (std::fabs (x - c.location) <= c.bound)
+        {
+          return x;
+        }
     }
 }
 
@@ -188,10 +349,35 @@ MixtureRandomVariable::GetValue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  uint32_t rvIdx = m_wCdf->GetInteger ();
+  uint32_t rvIdx = SampleIndex ();
+  if (m_fused && m_family != GENERIC)
+    {
+      return SampleFused (rvIdx);
+    }
   double value = m_rvs[rvIdx]->GetValue ();
 
   return value;
 }
 
+void
+MixtureRandomVariable::GetValues (std::vector<double> &values)
+{
+  NS_LOG_FUNCTION (this << values.size ());
+
+  if (m_fused && m_family != GENERIC)
+    {
+      for (double &value : values)
+        {
+          value = SampleFused (SampleIndex ());
+        }
+    }
+  else
+    {
+      for (double &value : values)
+        {
+          value = m_rvs[SampleIndex ()]->GetValue ();
+        }
+    }
+}
+
 } // namespace ns3
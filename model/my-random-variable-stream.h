@@ -25,6 +25,7 @@
 #include <ns3/object.h>
 #include <ns3/attribute-helper.h>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3 {
 /**
@@ -159,6 +160,21 @@ private:
  *   x->SetRvs (weightsCdf, rvs);
  *   double value = x->GetValue ();
  * \endcode
+ *
+ * The component is selected in O(1) with a Walker/Vose alias table, built
+ * once by SetRvs, from a single uniform draw of this stream, whatever the
+ * number of components.
+ *
+ * If Fused is true and all the components are LogisticRandomVariable or all
+ * are NormalRandomVariable, their parameters are copied by SetRvs and the
+ * values are sampled inline from the stream of the mixture, without any
+ * virtual call: later changes to the attributes of the components are then
+ * ignored, as are their streams and antithetic flags. GetValues draws a
+ * batch of values, with a tight loop in that case.
+ *
+ * AssignStreams assigns a stream to the selector and to every component, so
+ * that a mixture is reproducible whatever the other random variables of the
+ * simulation.
  */
 class MixtureRandomVariable : public RandomVariableStream
 {
@@ -184,6 +200,22 @@ public:
    */
   void SetRvs (std::vector<double> weightsCdf, std::vector<Ptr<RandomVariableStream> > rvs);
 
+  /**
+   * \brief Fill a vector with values drawn from the distribution
+   * \param values the vector, whose size is the number of values to draw
+   */
+  void GetValues (std::vector<double> &values);
+
+  /**
+   * \brief Assign fixed random variable stream numbers to the selector and to the components
+   *
+   * Components which are mixtures themselves assign streams recursively.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned
+   */
+  int64_t AssignStreams (int64_t stream);
+
   // Inherited from RandomVariableStream
   /**
    * \brief Get the next random value as a double drawn from the distribution.
@@ -197,8 +229,43 @@ public:
   virtual uint32_t GetInteger (void) override;
 
 private:
-  Ptr<EmpiricalRandomVariable> m_wCdf{0}; //!< The random variable that extracts the index of one of the RandomVariablStreams
+  /// Distribution family shared by all the components
+  enum Family
+  {
+    GENERIC, //!< mixed or other families, sampled through the components
+    LOGISTIC, //!< LogisticRandomVariable components
+    NORMAL //!< NormalRandomVariable components
+  };
+
+  /// Parameters of a component of a fused mixture
+  struct Component
+  {
+    double location; //!< location (logistic) or mean (normal)
+    double scale; //!< scale (logistic) or standard deviation (normal)
+    double bound; //!< bound around the location
+  };
+
+  /**
+   * \brief Select a component with the alias table
+   * \return the index of the component
+   */
+  uint32_t SampleIndex (void);
+
+  /**
+   * \brief Sample a component of a fused mixture from the stream of the mixture
+   * \param idx the index of the component
+   * \return the value
+   */
+  double SampleFused (uint32_t idx);
+
+  bool m_fused; //!< Whether mixtures of the same family are sampled inline
   std::vector<Ptr<RandomVariableStream>> m_rvs; //!< The vector of RandomVariableStreams to draw from
+  std::vector<double> m_aliasProb; //!< Probability of keeping each column of the alias table
+  std::vector<uint32_t> m_alias; //!< Alias of each column of the alias table
+  Family m_family{GENERIC}; //!< Family of the components
+  std::vector<Component> m_components; //!< Parameters of the components, if not GENERIC
+  double m_nextNormal{0}; //!< Cached standard normal value of the polar method
+  bool m_hasNextNormal{false}; //!< Whether m_nextNormal is valid
 
 }; // class MixtureRandomVariable
 
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "peer-descriptor.h"
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+PeerDescriptor::PeerDescriptor()
+    : m_component(VrAppProfiler::BURSTY_APPLICATION),
+      m_formatted(false)
+{
+}
+
+PeerDescriptor::PeerDescriptor(const Address& address, VrAppProfiler::Component component)
+    : m_address(address),
+      m_component(component),
+      m_formatted(false)
+{
+}
+
+void
+PeerDescriptor::SetAddress(const Address& address, VrAppProfiler::Component component)
+{
+    m_address = address;
+    m_component = component;
+    m_text.clear();
+    m_formatted = false;
+}
+
+const Address&
+PeerDescriptor::GetAddress() const
+{
+    return m_address;
+}
+
+const std::string&
+PeerDescriptor::Get() const
+{
+    if (!m_formatted)
+    {
+        std::stringstream addressStr;
+#ifdef NS3_VR_APP_PROFILING_ENABLED
+        VrAppProfiler::Count(m_component, VrAppProfiler::STRINGSTREAM);
+#endif
+        if (InetSocketAddress::IsMatchingType(m_address))
+        {
+            addressStr << InetSocketAddress::ConvertFrom(m_address).GetIpv4() << " port "
+                       << InetSocketAddress::ConvertFrom(m_address).GetPort();
+        }
+        else if (Inet6SocketAddress::IsMatchingType(m_address))
+        {
+            addressStr << Inet6SocketAddress::ConvertFrom(m_address).GetIpv6() << " port "
+                       << Inet6SocketAddress::ConvertFrom(m_address).GetPort();
+        }
+        else
+        {
+            addressStr << "UNKNOWN ADDRESS TYPE";
+        }
+        m_text = addressStr.str();
+        m_formatted = true;
+    }
+    return m_text;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const PeerDescriptor& peer)
+{
+    return os << peer.Get();
+}
+
+} // namespace ns3
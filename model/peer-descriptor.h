@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PEER_DESCRIPTOR_H
+#define PEER_DESCRIPTOR_H
+
+#include "vr-app-profiler.h"
+
+#include "ns3/address.h"
+
+#include <ostream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Human readable description of a peer, formatted on first use
+ *
+ * The description has the form "<IPv4 or IPv6 address> port <port>", or
+ * "UNKNOWN ADDRESS TYPE" for other address types. It is formatted the first
+ * time it is printed and then cached, so a descriptor stored with the state of
+ * a flow costs nothing when logging is disabled, and a single formatting per
+ * flow when it is enabled. Each formatting is counted by VrAppProfiler as a
+ * STRINGSTREAM of the component owning the descriptor.
+ */
+class PeerDescriptor
+{
+  public:
+    PeerDescriptor();
+
+    /**
+     * \brief Constructor
+     * \param address the address of the peer
+     * \param component the component owning the descriptor, for VrAppProfiler
+     */
+    PeerDescriptor(const Address& address, VrAppProfiler::Component component);
+
+    /**
+     * \brief Set the address of the peer, discarding the cached description
+     * \param address the address of the peer
+     * \param component the component owning the descriptor, for VrAppProfiler
+     */
+    void SetAddress(const Address& address, VrAppProfiler::Component component);
+
+    /**
+     * \return the address of the peer
+     */
+    const Address& GetAddress() const;
+
+    /**
+     * \return the description of the peer
+     */
+    const std::string& Get() const;
+
+  private:
+    Address m_address;                     //!< the address of the peer
+    VrAppProfiler::Component m_component;  //!< the component owning the descriptor
+    mutable std::string m_text;            //!< the cached description
+    mutable bool m_formatted;              //!< whether m_text is valid
+};
+
+/**
+ * \brief Stream insertion operator
+ * \param os the output stream
+ * \param peer the peer descriptor
+ * \return the output stream
+ */
+std::ostream& operator<<(std::ostream& os, const PeerDescriptor& peer);
+
+} // namespace ns3
+
+#endif /* PEER_DESCRIPTOR_H */
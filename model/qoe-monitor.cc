@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "qoe-monitor.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QoeMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(QoeMonitor);
+
+TypeId
+QoeMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::QoeMonitor")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<QoeMonitor>()
+            .AddAttribute("Duration",
+                          "The duration over which the throughput is averaged, i.e., the "
+                          "simulationTime parameter of the scenario",
+                          TimeValue(Seconds(10)),
+                          MakeTimeAccessor(&QoeMonitor::m_duration),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("NumFlows",
+                          "The number of flows the throughput is divided by. If 0, the number "
+                          "of flows from which at least one burst was received is used",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&QoeMonitor::m_numFlows),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FrameInterval",
+                          "The time each frame is displayed for, used to compute freeze times",
+                          TimeValue(Seconds(1.0 / 60)),
+                          MakeTimeAccessor(&QoeMonitor::m_frameInterval),
+                          MakeTimeChecker())
+            .AddAttribute("KeyByDestination",
+                          "If true, flows are identified by the receiver address of the trace, "
+                          "otherwise by the sender address",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&QoeMonitor::m_keyByDestination),
+                          MakeBooleanChecker())
+            .AddTraceSource("FrameQoe",
+                            "A burst was received and the QoE was updated",
+                            MakeTraceSourceAccessor(&QoeMonitor::m_frameQoeTrace),
+                            "ns3::QoeMonitor::FrameQoeCallback");
+    return tid;
+}
+
+QoeMonitor::QoeMonitor()
+    : m_numFlows(0),
+      m_keyByDestination(false),
+      m_rxBursts(0),
+      m_txBursts(0),
+      m_rxMegabits(0),
+      m_delaySumMs(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+QoeMonitor::~QoeMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QoeMonitor::BurstRx(Ptr<const Packet> burst,
+                    const Address& from,
+                    const Address& to,
+                    const SeqTsSizeFragHeader& header)
+{
+    if (header.GetStream() != SeqTsSizeFragHeader::VIDEO_STREAM)
+    {
+        return;
+    }
+    const Address& flow = m_keyByDestination ? to : from;
+    Time now = Simulator::Now();
+    Time delay = now - header.GetTs();
+
+    m_rxBursts++;
+    m_rxMegabits += header.GetSize() * 8 / 1e6;
+    m_delaySumMs += delay.GetNanoSeconds() / 1e6;
+
+    FlowState& state = m_flows[flow];
+    Time freeze;
+    if (state.rxBursts > 0)
+    {
+        Time gap = now - state.lastRx;
+        if (gap > m_frameInterval)
+        {
+            freeze = gap - m_frameInterval;
+            state.freezeTime += freeze;
+        }
+    }
+    if (header.GetSeq() >= state.nextSeq)
+    {
+        state.skippedFrames += header.GetSeq() - state.nextSeq;
+        state.nextSeq = header.GetSeq() + 1;
+    }
+    state.rxBursts++;
+    state.lastRx = now;
+
+    m_frameQoeTrace(flow, delay, freeze, GetQoe());
+}
+
+void
+QoeMonitor::BurstTx(Ptr<const Packet> burst,
+                    const Address& from,
+                    const Address& to,
+                    const SeqTsSizeFragHeader& header)
+{
+    if (header.GetStream() == SeqTsSizeFragHeader::VIDEO_STREAM)
+    {
+        m_txBursts++;
+    }
+}
+
+void
+QoeMonitor::AddTxBursts(uint64_t bursts)
+{
+    NS_LOG_FUNCTION(this << bursts);
+    m_txBursts += bursts;
+}
+
+double
+QoeMonitor::GetQoe() const
+{
+    if (m_rxBursts == 0)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    uint32_t flows = m_numFlows > 0 ? m_numFlows : m_flows.size();
+    double throughputMbps = m_rxMegabits / m_duration.GetSeconds() / flows;
+    double qoe = 60 * std::log10(throughputMbps) - m_delaySumMs / m_rxBursts;
+    // until a transmitted burst is counted, the success rate is unknown
+    if (m_txBursts > 0)
+    {
+        qoe -= (1 - double(m_rxBursts) / m_txBursts) * 1000;
+    }
+    return qoe;
+}
+
+QoeMonitor::Summary
+QoeMonitor::GetSummary() const
+{
+    Summary summary;
+    summary.rxBursts = m_rxBursts;
+    summary.txBursts = m_txBursts;
+    summary.flows = m_numFlows > 0 ? m_numFlows : m_flows.size();
+
+    // same corner cases as compute_qoe
+    summary.successRate = (m_rxBursts > 0 && m_txBursts > 0) ? double(m_rxBursts) / m_txBursts : 0;
+    summary.stallPenalty = (1 - summary.successRate) * 1000;
+
+    Time freezeTime;
+    summary.skippedFrames = 0;
+    for (const auto& flow : m_flows)
+    {
+        freezeTime += flow.second.freezeTime;
+        summary.skippedFrames += flow.second.skippedFrames;
+    }
+
+    if (m_rxBursts > 0)
+    {
+        summary.throughputMbps = m_rxMegabits / m_duration.GetSeconds() / summary.flows;
+        summary.avgDelayMs = m_delaySumMs / m_rxBursts;
+        summary.freezeTimeMs = freezeTime.GetNanoSeconds() / 1e6 / m_flows.size();
+        summary.qoe =
+            60 * std::log10(summary.throughputMbps) - summary.avgDelayMs - summary.stallPenalty;
+    }
+    else
+    {
+        summary.throughputMbps = std::numeric_limits<double>::quiet_NaN();
+        summary.avgDelayMs = std::numeric_limits<double>::quiet_NaN();
+        summary.freezeTimeMs = 0;
+        summary.qoe = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return summary;
+}
+
+void
+QoeMonitor::WriteSummary(std::ostream& os) const
+{
+    Summary summary = GetSummary();
+    os << "Qoe,Throughput_Mbps,AvgDelay_ms,SuccessRate,StallPenalty,FreezeTime_ms,"
+          "SkippedFrames,RxBursts,TxBursts,Flows"
+       << std::endl;
+    os.precision(12);
+    os << summary.qoe << "," << summary.throughputMbps << "," << summary.avgDelayMs << ","
+       << summary.successRate << "," << summary.stallPenalty << "," << summary.freezeTimeMs << ","
+       << summary.skippedFrames << "," << summary.rxBursts << "," << summary.txBursts << ","
+       << summary.flows << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QOE_MONITOR_H
+#define QOE_MONITOR_H
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <ostream>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Computes the QoE of VR flows incrementally from BurstRx traces
+ *
+ * The QoE metric is the same as the one computed by compute_qoe in
+ * examples/adaptive-sem-simulations.py:
+ *
+ *   QoE = 60 * log10(throughput) - avgDelay - (1 - successRate) * 1000
+ *
+ * where throughput [Mbps] is the received burst payload divided by Duration
+ * and by the number of flows, avgDelay [ms] is the mean burst delay and
+ * successRate is the ratio between received and transmitted bursts.
+ *
+ * Frame-level metrics are also tracked for each flow:
+ * - freeze time: a frame is displayed for FrameInterval, thus each time the
+ *   gap between two consecutive received bursts exceeds FrameInterval the
+ *   display freezes for the exceeding time;
+ * - skipped frames: bursts whose sequence number was never received.
+ *
+ * Connect BurstRx to the BurstRx trace source of BurstSink or
+ * BurstyApplicationClient. Transmitted bursts are counted either by
+ * connecting BurstTx to the transmitting application, or with AddTxBursts
+ * at the end of the simulation. Only the video bursts of multiplexed
+ * sessions are counted.
+ */
+class QoeMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QoeMonitor();
+    ~QoeMonitor() override;
+
+    /// End-of-run QoE summary
+    struct Summary
+    {
+        double qoe;               //!< QoE, as computed by compute_qoe
+        double throughputMbps;    //!< average throughput per flow [Mbps]
+        double avgDelayMs;        //!< average burst delay [ms]
+        double successRate;       //!< ratio between received and transmitted bursts
+        double stallPenalty;      //!< stall penalty, i.e., (1 - successRate) * 1000
+        double freezeTimeMs;      //!< average freeze time per flow [ms]
+        uint64_t skippedFrames;   //!< total number of skipped frames
+        uint64_t rxBursts;        //!< total number of received bursts
+        uint64_t txBursts;        //!< total number of transmitted bursts
+        uint32_t flows;           //!< number of flows used to normalize the throughput
+    };
+
+    /**
+     * TracedCallback signature for per-frame QoE samples.
+     *
+     * \param [in] flow the address identifying the flow
+     * \param [in] delay the burst delay
+     * \param [in] freeze the freeze time caused by this frame
+     * \param [in] qoe the QoE of the run so far
+     */
+    typedef void (*FrameQoeCallback)(const Address& flow, Time delay, Time freeze, double qoe);
+
+    /**
+     * \brief Trace sink for received bursts
+     * \param burst the received burst
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the burst header
+     */
+    void BurstRx(Ptr<const Packet> burst,
+                 const Address& from,
+                 const Address& to,
+                 const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Trace sink for transmitted bursts
+     * \param burst the transmitted burst
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the burst header
+     */
+    void BurstTx(Ptr<const Packet> burst,
+                 const Address& from,
+                 const Address& to,
+                 const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Account for bursts transmitted without using the BurstTx sink
+     * \param bursts the number of transmitted bursts
+     */
+    void AddTxBursts(uint64_t bursts);
+
+    /**
+     * \brief Get the QoE of the run so far
+     *
+     * While no transmitted burst is counted (AddTxBursts only called at the
+     * end), the success rate is unknown and the stall penalty is left out.
+     *
+     * \return the QoE, or NaN if no burst was received
+     */
+    double GetQoe() const;
+
+    /**
+     * \brief Get the summary of the run so far
+     * \return the summary
+     */
+    Summary GetSummary() const;
+
+    /**
+     * \brief Write the summary as a two-line CSV (header and values)
+     * \param os the output stream
+     */
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    /// Per-flow state
+    struct FlowState
+    {
+        uint64_t rxBursts{0};      //!< received bursts
+        uint64_t nextSeq{0};       //!< next expected burst sequence number
+        Time lastRx;               //!< reception time of the last burst
+        Time freezeTime;           //!< accumulated freeze time
+        uint64_t skippedFrames{0}; //!< bursts never received
+    };
+
+    Time m_duration;        //!< duration used to compute the throughput
+    uint32_t m_numFlows;    //!< number of flows, 0 to use the observed ones
+    Time m_frameInterval;   //!< display time of a frame
+    bool m_keyByDestination; //!< whether flows are identified by the receiver address
+
+    std::map<Address, FlowState> m_flows; //!< per-flow state
+    uint64_t m_rxBursts;     //!< received bursts
+    uint64_t m_txBursts;     //!< transmitted bursts
+    double m_rxMegabits;     //!< received burst payload [Mb]
+    double m_delaySumMs;     //!< sum of burst delays [ms]
+
+    /// Per-frame QoE samples
+    TracedCallback<const Address&, Time, Time, double> m_frameQoeTrace;
+};
+
+} // namespace ns3
+
+#endif /* QOE_MONITOR_H */
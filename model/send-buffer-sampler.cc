@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "send-buffer-sampler.h"
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SendBufferSampler");
+
+NS_OBJECT_ENSURE_REGISTERED(SendBufferSampler);
+
+TypeId
+SendBufferSampler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SendBufferSampler")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<SendBufferSampler>()
+            .AddAttribute("Interval",
+                          "The sampling interval. If zero, a sample is taken every time the "
+                          "sampled values change",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&SendBufferSampler::m_interval),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("Capacity",
+                          "The number of samples kept in memory, older samples are overwritten",
+                          UintegerValue(4096),
+                          MakeUintegerAccessor(&SendBufferSampler::m_capacity),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Downsample",
+                          "Only one sample every Downsample is stored and traced",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&SendBufferSampler::m_downsample),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Sample",
+                            "A sample has been stored",
+                            MakeTraceSourceAccessor(&SendBufferSampler::m_sampleTrace),
+                            "ns3::SendBufferSample::TracedCallback");
+    return tid;
+}
+
+SendBufferSampler::SendBufferSampler()
+    : m_capacity(4096),
+      m_downsample(1),
+      m_isTcp(false),
+      m_sndBufSize(0),
+      m_bytesInFlight(0),
+      m_queueFragments(0),
+      m_last{Seconds(0), 0, 0, 0},
+      m_taken(0),
+      m_head(0),
+      m_wrapped(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SendBufferSampler::~SendBufferSampler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SendBufferSampler::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    m_socket = nullptr;
+    Object::DoDispose();
+}
+
+void
+SendBufferSampler::Attach(Ptr<Socket> socket, const Address& flow)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Stop();
+    m_socket = socket;
+    m_flow = flow;
+    m_ring.resize(m_capacity);
+    m_head = 0;
+    m_wrapped = false;
+
+    Ptr<TcpSocketBase> tcp = DynamicCast<TcpSocketBase>(socket);
+    m_isTcp = (tcp != nullptr);
+    if (m_isTcp)
+    {
+        UintegerValue sndBufSize;
+        tcp->GetAttribute("SndBufSize", sndBufSize);
+        m_sndBufSize = sndBufSize.Get();
+        tcp->TraceConnectWithoutContext(
+            "BytesInFlight",
+            MakeCallback(&SendBufferSampler::BytesInFlightChanged, this));
+    }
+
+    if (!m_interval.IsZero())
+    {
+        m_sampleEvent =
+            Simulator::Schedule(m_interval, &SendBufferSampler::PeriodicSample, this);
+    }
+}
+
+void
+SendBufferSampler::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_sampleEvent);
+    if (m_isTcp && m_socket)
+    {
+        // the socket may outlive the sampler
+        m_socket->TraceDisconnectWithoutContext(
+            "BytesInFlight",
+            MakeCallback(&SendBufferSampler::BytesInFlightChanged, this));
+    }
+}
+
+void
+SendBufferSampler::Update(uint32_t queueFragments)
+{
+    m_queueFragments = queueFragments;
+    if (m_interval.IsZero())
+    {
+        TakeSample(true);
+    }
+}
+
+void
+SendBufferSampler::BytesInFlightChanged(uint32_t oldValue, uint32_t newValue)
+{
+    m_bytesInFlight = newValue;
+    if (m_interval.IsZero())
+    {
+        TakeSample(true);
+    }
+}
+
+void
+SendBufferSampler::PeriodicSample()
+{
+    TakeSample(false);
+    m_sampleEvent = Simulator::Schedule(m_interval, &SendBufferSampler::PeriodicSample, this);
+}
+
+void
+SendBufferSampler::TakeSample(bool onlyOnChange)
+{
+    SendBufferSample sample;
+    sample.time = Simulator::Now();
+    sample.sndBufOccupancy = m_isTcp ? m_sndBufSize - m_socket->GetTxAvailable() : 0;
+    sample.bytesInFlight = m_bytesInFlight;
+    sample.queueFragments = m_queueFragments;
+
+    if (onlyOnChange && m_taken > 0 && sample.sndBufOccupancy == m_last.sndBufOccupancy &&
+        sample.bytesInFlight == m_last.bytesInFlight &&
+        sample.queueFragments == m_last.queueFragments)
+    {
+        return;
+    }
+    m_last = sample;
+
+    if (m_taken++ % m_downsample != 0)
+    {
+        return;
+    }
+
+    m_ring[m_head] = sample;
+    if (++m_head == m_ring.size())
+    {
+        m_head = 0;
+        m_wrapped = true;
+    }
+    m_sampleTrace(m_flow, sample);
+}
+
+std::vector<SendBufferSample>
+SendBufferSampler::GetSamples() const
+{
+    std::vector<SendBufferSample> samples;
+    if (m_wrapped)
+    {
+        samples.reserve(m_ring.size());
+        samples.insert(samples.end(), m_ring.begin() + m_head, m_ring.end());
+    }
+    samples.insert(samples.end(), m_ring.begin(), m_ring.begin() + m_head);
+    return samples;
+}
+
+void
+SendBufferSampler::Dump(std::ostream& os, bool header) const
+{
+    if (header)
+    {
+        os << "Flow,Time_ns,SndBufOccupancy,BytesInFlight,QueueFragments" << std::endl;
+    }
+
+    std::stringstream flow;
+    if (InetSocketAddress::IsMatchingType(m_flow))
+    {
+        flow << InetSocketAddress::ConvertFrom(m_flow).GetIpv4();
+    }
+    else if (Inet6SocketAddress::IsMatchingType(m_flow))
+    {
+        flow << Inet6SocketAddress::ConvertFrom(m_flow).GetIpv6();
+    }
+    else
+    {
+        flow << m_flow;
+    }
+
+    for (const auto& sample : GetSamples())
+    {
+        os << flow.str() << "," << sample.time.GetNanoSeconds() << "," << sample.sndBufOccupancy
+           << "," << sample.bytesInFlight << "," << sample.queueFragments << "\n";
+    }
+}
+
+} // namespace ns3
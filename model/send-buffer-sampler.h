@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SEND_BUFFER_SAMPLER_H
+#define SEND_BUFFER_SAMPLER_H
+
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+class Socket;
+
+/**
+ * \ingroup applications
+ *
+ * \brief A sample of the send-side state of a flow
+ */
+struct SendBufferSample
+{
+    Time time;                //!< sampling time
+    uint32_t sndBufOccupancy; //!< bytes in the TCP send buffer
+    uint32_t bytesInFlight;   //!< bytes sent but not yet acknowledged
+    uint32_t queueFragments;  //!< fragments waiting in the application queue
+
+    /**
+     * TracedCallback signature for send buffer samples.
+     *
+     * \param [in] flow the address of the peer
+     * \param [in] sample the sample
+     */
+    typedef void (*TracedCallback)(const Address& flow, const SendBufferSample& sample);
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Samples the send buffer of a socket into a preallocated ring buffer
+ *
+ * The sampler tracks the occupancy of the TCP send buffer (SndBufSize minus
+ * GetTxAvailable), the bytes in flight (from the BytesInFlight trace source
+ * of TcpSocketBase) and the number of fragments waiting in the application
+ * queue, which the owner reports with Update.
+ *
+ * If Interval is zero a sample is taken every time one of the values changes,
+ * otherwise the values are sampled periodically. Only one sample every
+ * Downsample is stored: stored samples are fired through the Sample trace
+ * source and kept in a ring buffer of Capacity entries, which can be dumped at
+ * the end of the run. For UDP sockets only the queue depth is meaningful.
+ */
+class SendBufferSampler : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SendBufferSampler();
+    ~SendBufferSampler() override;
+
+    /**
+     * \brief Start sampling a socket
+     * \param socket the sending socket
+     * \param flow the address of the peer, used to identify the flow
+     *
+     * SndBufSize is read once here.
+     */
+    void Attach(Ptr<Socket> socket, const Address& flow);
+
+    /**
+     * \brief Stop sampling, and disconnect from the trace sources of the socket
+     */
+    void Stop();
+
+    /**
+     * \brief Report the current depth of the application queue
+     * \param queueFragments the fragments waiting in the application queue
+     *
+     * Call it every time the queue changes or data is handed to the socket.
+     */
+    void Update(uint32_t queueFragments);
+
+    /**
+     * \return the stored samples, from the oldest to the newest
+     */
+    std::vector<SendBufferSample> GetSamples() const;
+
+    /**
+     * \brief Write the stored samples as CSV
+     * \param os the output stream
+     * \param header whether to write the CSV header
+     */
+    void Dump(std::ostream& os, bool header = true) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Trace sink for the BytesInFlight trace source of TcpSocketBase
+     * \param oldValue the previous value
+     * \param newValue the new value
+     */
+    void BytesInFlightChanged(uint32_t oldValue, uint32_t newValue);
+
+    /**
+     * \brief Take a periodic sample and schedule the next one
+     */
+    void PeriodicSample();
+
+    /**
+     * \brief Take a sample
+     * \param onlyOnChange whether to skip the sample if nothing changed
+     */
+    void TakeSample(bool onlyOnChange);
+
+    Time m_interval;       //!< sampling interval, zero to sample on change
+    uint32_t m_capacity;   //!< size of the ring buffer
+    uint32_t m_downsample; //!< store one sample every m_downsample
+
+    Ptr<Socket> m_socket;  //!< sampled socket
+    Address m_flow;        //!< peer address
+    bool m_isTcp;          //!< whether the socket is a TcpSocketBase
+    uint32_t m_sndBufSize; //!< SndBufSize of the socket
+    EventId m_sampleEvent; //!< next periodic sample
+
+    uint32_t m_bytesInFlight;  //!< last bytes in flight
+    uint32_t m_queueFragments; //!< last application queue depth
+    SendBufferSample m_last;   //!< last sample taken
+    uint64_t m_taken;          //!< samples taken, stored or not
+
+    std::vector<SendBufferSample> m_ring; //!< stored samples
+    uint32_t m_head;                      //!< index of the next slot to write
+    bool m_wrapped;                       //!< whether the ring was filled at least once
+
+    /// Stored samples
+    ns3::TracedCallback<const Address&, const SendBufferSample&> m_sampleTrace;
+};
+
+} // namespace ns3
+
+#endif /* SEND_BUFFER_SAMPLER_H */
@@ -84,19 +84,81 @@ SeqTsSizeFragHeader::GetFragBytes (void) const
   return m_fragBytes;
 }
 
+void
+SeqTsSizeFragHeader::SetFrameType (FrameType frameType)
+{
+  m_frameType = frameType;
+}
+
+SeqTsSizeFragHeader::FrameType
+SeqTsSizeFragHeader::GetFrameType (void) const
+{
+  return m_frameType;
+}
+
+void
+SeqTsSizeFragHeader::SetTile (uint16_t tile)
+{
+  m_tile = tile;
+}
+
+uint16_t
+SeqTsSizeFragHeader::GetTile (void) const
+{
+  return m_tile;
+}
+
+void
+SeqTsSizeFragHeader::SetTileQuality (uint8_t quality)
+{
+  m_tileQuality = quality;
+}
+
+uint8_t
+SeqTsSizeFragHeader::GetTileQuality (void) const
+{
+  return m_tileQuality;
+}
+
+void
+SeqTsSizeFragHeader::SetStream (uint8_t stream)
+{
+  m_stream = stream;
+}
+
+uint8_t
+SeqTsSizeFragHeader::GetStream (void) const
+{
+  return m_stream;
+}
+
+void
+SeqTsSizeFragHeader::SetPoseTs (Time poseTs)
+{
+  m_poseTs = poseTs;
+}
+
+Time
+SeqTsSizeFragHeader::GetPoseTs (void) const
+{
+  return m_poseTs;
+}
+
 void
 SeqTsSizeFragHeader::Print (std::ostream &os) const
 {
   NS_LOG_FUNCTION (this << &os);
   os << "(fragSeq=" << m_fragSeq << ", frags=" << m_frags << ", fragBytes=" << m_fragBytes
-     << ") AND ";
+     << ", frameType=" << +m_frameType << ", tile=" << m_tile
+     << ", tileQuality=" << +m_tileQuality << ", stream=" << +m_stream
+     << ", poseTs=" << m_poseTs.As (Time::S) << ") AND ";
   SeqTsSizeHeader::Print (os);
 }
 
 uint32_t
 SeqTsSizeFragHeader::GetSerializedSize (void) const
 {
-  return SeqTsSizeHeader::GetSerializedSize () + 2 + 2 + 8;
+  return SeqTsSizeHeader::GetSerializedSize () + 2 + 2 + 8 + 1 + 2 + 1 + 1 + 8;
 }
 
 void
@@ -107,6 +169,11 @@ SeqTsSizeFragHeader::Serialize (Buffer::Iterator start) const
   i.WriteHtonU64 (m_fragBytes);
   i.WriteHtonU16 (m_fragSeq);
   i.WriteHtonU16 (m_frags);
+  i.WriteU8 (m_frameType);
+  i.WriteHtonU16 (m_tile);
+  i.WriteU8 (m_tileQuality);
+  i.WriteU8 (m_stream);
+  i.WriteHtonU64 (m_poseTs.GetTimeStep ());
   SeqTsSizeHeader::Serialize (i);
 }
 
@@ -118,6 +185,11 @@ SeqTsSizeFragHeader::Deserialize (Buffer::Iterator start)
   m_fragBytes = i.ReadNtohU64 ();
   m_fragSeq = i.ReadNtohU16 ();
   m_frags = i.ReadNtohU16 ();
+  m_frameType = static_cast<FrameType> (i.ReadU8 ());
+  m_tile = i.ReadNtohU16 ();
+  m_tileQuality = i.ReadU8 ();
+  m_stream = i.ReadU8 ();
+  m_poseTs = TimeStep (i.ReadNtohU64 ());
   SeqTsSizeHeader::Deserialize (i);
   return GetSerializedSize ();
 }
@@ -31,12 +31,48 @@ namespace ns3 {
  * the timestamp and the size of class \c SeqTsSizeFragHeader.
  * Fragment sequence and number of fragments can be used to track large fragments packets over protocols
  * not guaranteeing packet ordering, e.g., BurstyApplication over UDP.
+ * The frame type tells schedulers and FEC which bursts are intra-coded, if
+ * the burst generator has a frame structure (see VrBurstGenerator).
+ * The tile and its quality level identify the sub-bursts of tiled frames
+ * (see TiledVrBurstGenerator), the tiles of a frame sharing its timestamp.
+ * The stream identifies the sub-stream of a multiplexed session (see
+ * BurstyApplicationServer::AddStream), each with its own sequence numbers,
+ * and the pose timestamp tells when the client sent the last pose known to
+ * the server when the burst was generated.
  *
  * \sa ns3::SeqTsHeader
  */
 class SeqTsSizeFragHeader : public SeqTsSizeHeader
 {
 public:
+  /**
+   * \brief Type of the video frame carried by a burst
+   */
+  enum FrameType : uint8_t
+  {
+    UNSPECIFIED_FRAME = 0, //!< the generator has no frame structure
+    I_FRAME = 1, //!< intra-coded frame, e.g., at the start of a GOP or at a scene cut
+    P_FRAME = 2, //!< predicted frame
+    INTRA_REFRESH_FRAME = 3 //!< predicted frame carrying a slice of the intra refresh
+  };
+
+  /**
+   * \brief Sub-stream of a multiplexed session
+   *
+   * Other values may be used for application-defined streams.
+   */
+  enum StreamType : uint8_t
+  {
+    VIDEO_STREAM = 0, //!< video frames, the main stream of the session
+    AUDIO_STREAM = 1, //!< audio frames
+    HAPTIC_STREAM = 2, //!< haptic feedback
+    POSE_STREAM = 3, //!< uplink head and controller poses
+    INPUT_STREAM = 4 //!< uplink controller input
+  };
+
+  /// Tile of the bursts which are not a tile of a frame
+  static const uint16_t NO_TILE = 0xffff;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -84,6 +120,66 @@ public:
    */
   uint64_t GetFragBytes (void) const;
 
+  /**
+   * \brief Set the type of the frame carried by the burst
+   * \param frameType the frame type
+   */
+  void SetFrameType (FrameType frameType);
+
+  /**
+   * \brief Get the type of the frame carried by the burst
+   * \return the frame type
+   */
+  FrameType GetFrameType (void) const;
+
+  /**
+   * \brief Set the tile carried by the burst
+   * \param tile the index of the tile in its frame, or NO_TILE
+   */
+  void SetTile (uint16_t tile);
+
+  /**
+   * \brief Get the tile carried by the burst
+   * \return the index of the tile in its frame, or NO_TILE
+   */
+  uint16_t GetTile (void) const;
+
+  /**
+   * \brief Set the quality level of the tile carried by the burst
+   * \param quality the quality level, higher is better
+   */
+  void SetTileQuality (uint8_t quality);
+
+  /**
+   * \brief Get the quality level of the tile carried by the burst
+   * \return the quality level, higher is better
+   */
+  uint8_t GetTileQuality (void) const;
+
+  /**
+   * \brief Set the sub-stream of the burst
+   * \param stream the stream, VIDEO_STREAM for single-stream applications
+   */
+  void SetStream (uint8_t stream);
+
+  /**
+   * \brief Get the sub-stream of the burst
+   * \return the stream
+   */
+  uint8_t GetStream (void) const;
+
+  /**
+   * \brief Set the time the pose used to generate the burst was sent
+   * \param poseTs the time, zero if no pose was received
+   */
+  void SetPoseTs (Time poseTs);
+
+  /**
+   * \brief Get the time the pose used to generate the burst was sent
+   * \return the time, zero if no pose was received
+   */
+  Time GetPoseTs (void) const;
+
   // Inherited
   virtual TypeId GetInstanceTypeId (void) const override;
   virtual void Print (std::ostream &os) const override;
@@ -95,6 +191,11 @@ private:
   uint16_t m_fragSeq{0}; //!< The sequence number of the fragment
   uint16_t m_frags{0}; //!< The total number of fragments in the burst
   uint64_t m_fragBytes{0}; //!< The total number of bytes in the fragment
+  FrameType m_frameType{UNSPECIFIED_FRAME}; //!< The type of the frame carried by the burst
+  uint16_t m_tile{NO_TILE}; //!< The tile carried by the burst
+  uint8_t m_tileQuality{0}; //!< The quality level of the tile
+  uint8_t m_stream{VIDEO_STREAM}; //!< The sub-stream of the burst
+  Time m_poseTs; //!< The time the pose used to generate the burst was sent
 };
 
 } // namespace ns3
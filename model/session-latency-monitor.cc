@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "session-latency-monitor.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SessionLatencyMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(SessionLatencyMonitor);
+
+TypeId
+SessionLatencyMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SessionLatencyMonitor")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<SessionLatencyMonitor>()
+            .AddTraceSource("Latency",
+                            "A burst of a stream was received",
+                            MakeTraceSourceAccessor(&SessionLatencyMonitor::m_latencyTrace),
+                            "ns3::SessionLatencyMonitor::LatencyCallback");
+    return tid;
+}
+
+SessionLatencyMonitor::SessionLatencyMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SessionLatencyMonitor::~SessionLatencyMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SessionLatencyMonitor::Breakdown(const Address& flow, const BurstLatencyBreakdown& breakdown)
+{
+    Add(breakdown.stream, breakdown.completed - breakdown.generated, breakdown.GetMotionToPhoton());
+}
+
+void
+SessionLatencyMonitor::UplinkRx(Ptr<const Packet> message,
+                                const Address& from,
+                                const Address& to,
+                                const SeqTsSizeFragHeader& header)
+{
+    Add(header.GetStream(), Simulator::Now() - header.GetTs(), Time(0));
+}
+
+void
+SessionLatencyMonitor::Add(uint8_t stream, Time latency, Time motionToPhoton)
+{
+    if (stream >= m_streams.size())
+    {
+        m_streams.resize(stream + 1);
+    }
+    StreamStats& stats = m_streams[stream];
+
+    int64_t ns = latency.GetNanoSeconds();
+    stats.bursts++;
+    stats.latencySum += ns;
+    stats.latencyMax = std::max(stats.latencyMax, ns);
+    if (motionToPhoton.IsStrictlyPositive())
+    {
+        ns = motionToPhoton.GetNanoSeconds();
+        stats.motionToPhotonBursts++;
+        stats.motionToPhotonSum += ns;
+        stats.motionToPhotonMax = std::max(stats.motionToPhotonMax, ns);
+    }
+
+    NS_LOG_DEBUG("Stream " << +stream << ": latency " << latency.As(Time::MS)
+                           << ", motion-to-photon " << motionToPhoton.As(Time::MS));
+    m_latencyTrace(stream, latency, motionToPhoton);
+}
+
+std::vector<SessionLatencyMonitor::StreamSummary>
+SessionLatencyMonitor::GetSummary() const
+{
+    std::vector<StreamSummary> summaries;
+    for (uint32_t stream = 0; stream < m_streams.size(); ++stream)
+    {
+        const StreamStats& stats = m_streams[stream];
+        if (stats.bursts == 0)
+        {
+            continue;
+        }
+        StreamSummary summary;
+        summary.stream = stream;
+        summary.bursts = stats.bursts;
+        summary.meanLatencyMs = stats.latencySum / 1e6 / stats.bursts;
+        summary.maxLatencyMs = stats.latencyMax / 1e6;
+        summary.motionToPhotonBursts = stats.motionToPhotonBursts;
+        summary.meanMotionToPhotonMs =
+            stats.motionToPhotonBursts > 0
+                ? stats.motionToPhotonSum / 1e6 / stats.motionToPhotonBursts
+                : 0;
+        summary.maxMotionToPhotonMs = stats.motionToPhotonMax / 1e6;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+void
+SessionLatencyMonitor::WriteSummary(std::ostream& os) const
+{
+    os << "Stream,Bursts,MeanLatency_ms,MaxLatency_ms,MotionToPhotonBursts,"
+          "MeanMotionToPhoton_ms,MaxMotionToPhoton_ms"
+       << std::endl;
+    os.precision(12);
+    for (const auto& summary : GetSummary())
+    {
+        os << +summary.stream << "," << summary.bursts << "," << summary.meanLatencyMs << ","
+           << summary.maxLatencyMs << "," << summary.motionToPhotonBursts << ","
+           << summary.meanMotionToPhotonMs << "," << summary.maxMotionToPhotonMs << std::endl;
+    }
+}
+
+} // namespace ns3
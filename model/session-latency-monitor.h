@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SESSION_LATENCY_MONITOR_H
+#define SESSION_LATENCY_MONITOR_H
+
+#include "ns3/address.h"
+#include "ns3/burst-latency-breakdown.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/traced-callback.h"
+
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Per-stream latency of multiplexed VR sessions
+ *
+ * The latency of a burst is the time from its generation until its last
+ * fragment was received. For the bursts generated after the server received
+ * a pose, the monitor also estimates the motion-to-photon latency, from the
+ * time the client sent the pose until the burst was received, i.e., assuming
+ * that a frame is displayed as soon as it is received.
+ *
+ * Connect Breakdown to the BurstLatencyBreakdown trace source of
+ * BurstyApplicationClient, for the downlink streams, and UplinkRx to the
+ * UplinkRx trace source of BurstyApplicationServer, for the uplink ones,
+ * e.g., the poses. The statistics of all the flows are aggregated by
+ * stream, hence uplink and downlink streams should have different stream
+ * identifiers, as those of SeqTsSizeFragHeader::StreamType. The statistics
+ * are running sums in an array indexed by stream, so that high-rate streams
+ * cost no allocation.
+ */
+class SessionLatencyMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SessionLatencyMonitor();
+    ~SessionLatencyMonitor() override;
+
+    /// End-of-run summary of a stream
+    struct StreamSummary
+    {
+        uint8_t stream;                //!< the stream
+        uint64_t bursts;               //!< received bursts
+        double meanLatencyMs;          //!< average latency [ms]
+        double maxLatencyMs;           //!< maximum latency [ms]
+        uint64_t motionToPhotonBursts; //!< bursts generated from a pose
+        double meanMotionToPhotonMs;   //!< average motion-to-photon latency [ms]
+        double maxMotionToPhotonMs;    //!< maximum motion-to-photon latency [ms]
+    };
+
+    /**
+     * TracedCallback signature for received bursts.
+     *
+     * \param [in] stream the stream of the burst
+     * \param [in] latency the latency of the burst
+     * \param [in] motionToPhoton the motion-to-photon latency, zero if the
+     * burst was not generated from a pose
+     */
+    typedef void (*LatencyCallback)(uint8_t stream, Time latency, Time motionToPhoton);
+
+    /**
+     * \brief Trace sink for the receiver breakdowns of the downlink bursts
+     * \param flow the flow
+     * \param breakdown the receiver timestamps
+     */
+    void Breakdown(const Address& flow, const BurstLatencyBreakdown& breakdown);
+
+    /**
+     * \brief Trace sink for the uplink messages received by the server
+     * \param message the message
+     * \param from the client address
+     * \param to the server address
+     * \param header the header of the message
+     */
+    void UplinkRx(Ptr<const Packet> message,
+                  const Address& from,
+                  const Address& to,
+                  const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Get the summary of the run so far
+     * \return the summary of each stream with at least a burst, by stream
+     */
+    std::vector<StreamSummary> GetSummary() const;
+
+    /**
+     * \brief Write the summary as CSV, a header and a row per stream
+     * \param os the output stream
+     */
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    /**
+     * \brief Account for a received burst
+     * \param stream the stream
+     * \param latency the latency
+     * \param motionToPhoton the motion-to-photon latency, zero if none
+     */
+    void Add(uint8_t stream, Time latency, Time motionToPhoton);
+
+    /// Running statistics of a stream
+    struct StreamStats
+    {
+        uint64_t bursts{0};               //!< received bursts
+        int64_t latencySum{0};            //!< sum of the latencies [ns]
+        int64_t latencyMax{0};            //!< maximum latency [ns]
+        uint64_t motionToPhotonBursts{0}; //!< bursts generated from a pose
+        int64_t motionToPhotonSum{0};     //!< sum of the motion-to-photon latencies [ns]
+        int64_t motionToPhotonMax{0};     //!< maximum motion-to-photon latency [ns]
+    };
+
+    std::vector<StreamStats> m_streams; //!< statistics, indexed by stream
+
+    /// Received bursts
+    TracedCallback<uint8_t, Time, Time> m_latencyTrace;
+};
+
+} // namespace ns3
+
+#endif /* SESSION_LATENCY_MONITOR_H */
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tile-quality-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TileQualityMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(TileQualityMonitor);
+
+TypeId
+TileQualityMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TileQualityMonitor")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<TileQualityMonitor>()
+            .AddAttribute("Generator",
+                          "The TiledVrBurstGenerator of the flow",
+                          PointerValue(0),
+                          MakePointerAccessor(&TileQualityMonitor::SetGenerator),
+                          MakePointerChecker<TiledVrBurstGenerator>())
+            .AddTraceSource("Frame",
+                            "A frame was displayed",
+                            MakeTraceSourceAccessor(&TileQualityMonitor::m_frameTrace),
+                            "ns3::TileQualityMonitor::FrameCallback");
+    return tid;
+}
+
+TileQualityMonitor::TileQualityMonitor()
+    : m_tiles(0),
+      m_frames(0),
+      m_qualitySum(0),
+      m_viewportTiles(0),
+      m_missingTiles(0),
+      m_lateTiles(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TileQualityMonitor::~TileQualityMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TileQualityMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_generator = 0;
+    Object::DoDispose();
+}
+
+void
+TileQualityMonitor::SetGenerator(Ptr<TiledVrBurstGenerator> generator)
+{
+    NS_LOG_FUNCTION(this << generator);
+    m_generator = generator;
+    m_tiles = generator ? generator->GetRows() * generator->GetColumns() : 0;
+    m_pending.clear();
+    m_freeSlots.clear();
+    m_rxLevels.clear();
+}
+
+void
+TileQualityMonitor::BurstTx(Ptr<const Packet> burst,
+                            const Address& from,
+                            const Address& to,
+                            const SeqTsSizeFragHeader& header)
+{
+    if (header.GetTile() == SeqTsSizeFragHeader::NO_TILE)
+    {
+        return;
+    }
+    NS_ABORT_MSG_UNLESS(m_generator, "The generator of the flow must be set");
+    NS_ASSERT(header.GetTile() < m_tiles);
+
+    // the tiles of a frame are sent together: a new timestamp is a new frame
+    if (!m_pending.empty() && m_pending.back().generated == header.GetTs())
+    {
+        return;
+    }
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = m_rxLevels.size() / m_tiles;
+        m_rxLevels.resize(m_rxLevels.size() + m_tiles);
+    }
+    std::fill_n(m_rxLevels.begin() + slot * m_tiles, m_tiles, NOT_RECEIVED);
+    m_pending.push_back({header.GetTs(), slot});
+}
+
+void
+TileQualityMonitor::BurstRx(Ptr<const Packet> burst,
+                            const Address& from,
+                            const Address& to,
+                            const SeqTsSizeFragHeader& header)
+{
+    if (header.GetTile() == SeqTsSizeFragHeader::NO_TILE || !m_generator)
+    {
+        return;
+    }
+    if (Simulator::Now() > header.GetTs() + m_generator->GetPredictionHorizon())
+    {
+        m_lateTiles++;
+        return;
+    }
+
+    // the frame is among the last ones
+    for (auto it = m_pending.rbegin(); it != m_pending.rend(); ++it)
+    {
+        if (it->generated == header.GetTs())
+        {
+            m_rxLevels[it->slot * m_tiles + header.GetTile()] = header.GetTileQuality();
+            return;
+        }
+    }
+    NS_LOG_WARN("Tile " << header.GetTile() << " of an unknown frame generated at "
+                        << header.GetTs().As(Time::S));
+}
+
+void
+TileQualityMonitor::Pose(const HeadPose& pose)
+{
+    if (!m_generator)
+    {
+        return;
+    }
+    Time horizon = m_generator->GetPredictionHorizon();
+    while (!m_pending.empty() && m_pending.front().generated + horizon <= pose.time)
+    {
+        Display(pose);
+    }
+}
+
+void
+TileQualityMonitor::Display(const HeadPose& pose)
+{
+    const PendingFrame& frame = m_pending.front();
+    m_generator->GetTileLevels(pose.yaw, pose.pitch, 0, m_viewport);
+
+    const uint8_t* rxLevels = m_rxLevels.data() + frame.slot * m_tiles;
+    uint32_t viewportTiles = 0;
+    uint32_t missingTiles = 0;
+    double quality = 0;
+    for (uint32_t tile = 0; tile < m_tiles; ++tile)
+    {
+        if (m_viewport[tile] != TiledVrBurstGenerator::HIGH_QUALITY)
+        {
+            continue;
+        }
+        viewportTiles++;
+        if (rxLevels[tile] == NOT_RECEIVED)
+        {
+            missingTiles++;
+        }
+        else
+        {
+            quality += static_cast<double>(rxLevels[tile]) / TiledVrBurstGenerator::HIGH_QUALITY;
+        }
+    }
+
+    if (viewportTiles > 0)
+    {
+        double viewportQuality = quality / viewportTiles;
+        double missingTileRate = static_cast<double>(missingTiles) / viewportTiles;
+        m_frames++;
+        m_qualitySum += viewportQuality;
+        m_viewportTiles += viewportTiles;
+        m_missingTiles += missingTiles;
+        NS_LOG_DEBUG("Frame generated at " << frame.generated.As(Time::S)
+                                           << ": viewport quality=" << viewportQuality
+                                           << ", missing tile rate=" << missingTileRate);
+        m_frameTrace(frame.generated, viewportQuality, missingTileRate);
+    }
+
+    m_freeSlots.push_back(frame.slot);
+    m_pending.pop_front();
+}
+
+TileQualityMonitor::Summary
+TileQualityMonitor::GetSummary() const
+{
+    Summary summary;
+    summary.frames = m_frames;
+    summary.viewportQuality = m_frames > 0 ? m_qualitySum / m_frames : 0;
+    summary.missingTileRate =
+        m_viewportTiles > 0 ? static_cast<double>(m_missingTiles) / m_viewportTiles : 0;
+    summary.viewportTiles = m_viewportTiles;
+    summary.missingTiles = m_missingTiles;
+    summary.lateTiles = m_lateTiles;
+    return summary;
+}
+
+void
+TileQualityMonitor::WriteSummary(std::ostream& os) const
+{
+    Summary summary = GetSummary();
+    os << "Frames,ViewportQuality,MissingTileRate,ViewportTiles,MissingTiles,LateTiles"
+       << std::endl;
+    os.precision(12);
+    os << summary.frames << "," << summary.viewportQuality << "," << summary.missingTileRate
+       << "," << summary.viewportTiles << "," << summary.missingTiles << ","
+       << summary.lateTiles << std::endl;
+}
+
+} // namespace ns3
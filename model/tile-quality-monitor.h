@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TILE_QUALITY_MONITOR_H
+#define TILE_QUALITY_MONITOR_H
+
+#include "ns3/address.h"
+#include "ns3/head-motion-model.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/seq-ts-size-frag-header.h"
+#include "ns3/tiled-vr-burst-generator.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Viewport quality of a tiled VR flow, from the receiver side
+ *
+ * A frame of a TiledVrBurstGenerator is displayed PredictionHorizon after
+ * its generation, with the viewport of the user at that time. Its tiles
+ * received by then count at their quality level, the others are missing.
+ * For each frame, the monitor computes:
+ * - the viewport quality, the average over the tiles of the actual viewport
+ *   of their quality level divided by HIGH_QUALITY, a missing tile counting
+ *   as 0: it is 1 if the whole viewport was received in high quality;
+ * - the missing tile rate, the fraction of the tiles of the actual viewport
+ *   which were not received in time.
+ *
+ * A monitor follows a single flow: connect BurstTx to the BurstTx trace
+ * source of the transmitting application, BurstRx to the BurstRx trace
+ * source of the receiver, and Pose to the Pose trace source of the
+ * HeadMotionModel of the generator. Frames are identified by the timestamp
+ * shared by their tiles, and evaluated with the first pose at or after their
+ * display time, i.e., at most a frame interval later; frames whose display
+ * time was not reached by a pose are not counted.
+ *
+ * The received tiles of the frames waiting for display are kept in a flat
+ * array of one byte per tile, whose rows are recycled.
+ */
+class TileQualityMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TileQualityMonitor();
+    ~TileQualityMonitor() override;
+
+    /// End-of-run summary
+    struct Summary
+    {
+        uint64_t frames;         //!< displayed frames
+        double viewportQuality;  //!< average viewport quality
+        double missingTileRate;  //!< fraction of missing viewport tiles
+        uint64_t viewportTiles;  //!< total number of viewport tiles
+        uint64_t missingTiles;   //!< total number of missing viewport tiles
+        uint64_t lateTiles;      //!< tiles received after the display time
+    };
+
+    /**
+     * TracedCallback signature for displayed frames.
+     *
+     * \param [in] generated the generation time of the frame
+     * \param [in] viewportQuality the viewport quality of the frame
+     * \param [in] missingTileRate the fraction of missing viewport tiles
+     */
+    typedef void (*FrameCallback)(Time generated, double viewportQuality, double missingTileRate);
+
+    /**
+     * \brief Set the generator of the flow, describing the grid of tiles
+     * \param generator the generator
+     */
+    void SetGenerator(Ptr<TiledVrBurstGenerator> generator);
+
+    /**
+     * \brief Trace sink for transmitted bursts
+     * \param burst the transmitted burst
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the burst header
+     */
+    void BurstTx(Ptr<const Packet> burst,
+                 const Address& from,
+                 const Address& to,
+                 const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Trace sink for received bursts
+     * \param burst the received burst
+     * \param from the sender address
+     * \param to the receiver address
+     * \param header the burst header
+     */
+    void BurstRx(Ptr<const Packet> burst,
+                 const Address& from,
+                 const Address& to,
+                 const SeqTsSizeFragHeader& header);
+
+    /**
+     * \brief Trace sink for the poses of the user
+     * \param pose the pose
+     */
+    void Pose(const HeadPose& pose);
+
+    /**
+     * \brief Get the summary of the run so far
+     * \return the summary
+     */
+    Summary GetSummary() const;
+
+    /**
+     * \brief Write the summary as a two-line CSV (header and values)
+     * \param os the output stream
+     */
+    void WriteSummary(std::ostream& os) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A frame waiting for its display time
+    struct PendingFrame
+    {
+        Time generated; //!< generation time, shared by the tiles
+        uint32_t slot;  //!< row of m_rxLevels
+    };
+
+    /**
+     * \brief Evaluate the oldest pending frame
+     * \param pose the pose at its display time
+     */
+    void Display(const HeadPose& pose);
+
+    /// Level of a tile which was not received
+    static const uint8_t NOT_RECEIVED = 0xff;
+
+    Ptr<TiledVrBurstGenerator> m_generator; //!< generator of the flow
+    uint32_t m_tiles;                       //!< tiles per frame
+
+    std::deque<PendingFrame> m_pending; //!< frames waiting for their display time
+    std::vector<uint32_t> m_freeSlots;  //!< unused rows of m_rxLevels
+    std::vector<uint8_t> m_rxLevels;    //!< received level of each tile of the pending frames
+    std::vector<uint8_t> m_viewport;    //!< levels of the tiles for the actual viewport
+
+    uint64_t m_frames;         //!< displayed frames
+    double m_qualitySum;       //!< sum of the viewport qualities
+    uint64_t m_viewportTiles;  //!< viewport tiles of the displayed frames
+    uint64_t m_missingTiles;   //!< missing viewport tiles
+    uint64_t m_lateTiles;      //!< tiles received after their display time
+
+    /// Displayed frames
+    TracedCallback<Time, double, double> m_frameTrace;
+};
+
+} // namespace ns3
+
+#endif /* TILE_QUALITY_MONITOR_H */
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tiled-vr-burst-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TiledVrBurstGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(TiledVrBurstGenerator);
+
+namespace
+{
+
+/**
+ * \brief Wrap an angle to [-180, 180)
+ * \param angle the angle, in degrees
+ * \return the wrapped angle
+ */
+double
+WrapAngle(double angle)
+{
+    angle = std::fmod(angle + 180, 360);
+    if (angle < 0)
+    {
+        angle += 360;
+    }
+    return angle - 180;
+}
+
+/**
+ * \brief Quality level of a tile along one axis
+ * \param distance the angular distance from the center of the viewport to the tile [deg]
+ * \param halfFov half the field of view along the axis [deg]
+ * \param margin the margin of medium quality [deg]
+ * \return the quality level
+ */
+uint8_t
+AxisLevel(double distance, double halfFov, double margin)
+{
+    if (distance < halfFov)
+    {
+        return TiledVrBurstGenerator::HIGH_QUALITY;
+    }
+    if (distance < halfFov + margin)
+    {
+        return TiledVrBurstGenerator::MEDIUM_QUALITY;
+    }
+    return TiledVrBurstGenerator::LOW_QUALITY;
+}
+
+} // namespace
+
+TypeId
+TiledVrBurstGenerator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TiledVrBurstGenerator")
+            .SetParent<VrBurstGenerator>()
+            .SetGroupName("Applications")
+            .AddConstructor<TiledVrBurstGenerator>()
+            .AddAttribute("Rows",
+                          "The number of rows of tiles, covering the pitch from 90 to -90 degrees",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&TiledVrBurstGenerator::m_rows),
+                          MakeUintegerChecker<uint32_t>(1, 180))
+            .AddAttribute("Columns",
+                          "The number of columns of tiles, covering the yaw from -180 to 180 "
+                          "degrees",
+                          UintegerValue(12),
+                          MakeUintegerAccessor(&TiledVrBurstGenerator::m_columns),
+                          MakeUintegerChecker<uint32_t>(1, 360))
+            .AddAttribute("HorizontalFov",
+                          "The horizontal field of view of the headset [deg]",
+                          DoubleValue(100),
+                          MakeDoubleAccessor(&TiledVrBurstGenerator::m_horizontalFov),
+                          MakeDoubleChecker<double>(0, 360))
+            .AddAttribute("VerticalFov",
+                          "The vertical field of view of the headset [deg]",
+                          DoubleValue(90),
+                          MakeDoubleAccessor(&TiledVrBurstGenerator::m_verticalFov),
+                          MakeDoubleChecker<double>(0, 180))
+            .AddAttribute("Margin",
+                          "The margin of medium quality tiles around the viewport [deg]",
+                          DoubleValue(15),
+                          MakeDoubleAccessor(&TiledVrBurstGenerator::m_margin),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MarginWeight",
+                          "The size of a medium quality tile relative to a high quality one",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&TiledVrBurstGenerator::m_marginWeight),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("OutsideWeight",
+                          "The size of a low quality tile relative to a high quality one, "
+                          "0 not to send them",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&TiledVrBurstGenerator::m_outsideWeight),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("PredictionHorizon",
+                          "How far ahead the viewport is predicted, e.g., the motion-to-photon "
+                          "latency",
+                          TimeValue(MilliSeconds(50)),
+                          MakeTimeAccessor(&TiledVrBurstGenerator::m_predictionHorizon),
+                          MakeTimeChecker(Seconds(0)));
+    return tid;
+}
+
+TiledVrBurstGenerator::TiledVrBurstGenerator()
+    : m_havePose(false),
+      m_lastYaw(0),
+      m_lastPitch(0),
+      m_yawRate(0),
+      m_pitchRate(0),
+      m_viewYaw(0),
+      m_viewPitch(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TiledVrBurstGenerator::~TiledVrBurstGenerator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+TiledVrBurstGenerator::GetRows() const
+{
+    return m_rows;
+}
+
+uint32_t
+TiledVrBurstGenerator::GetColumns() const
+{
+    return m_columns;
+}
+
+Time
+TiledVrBurstGenerator::GetPredictionHorizon() const
+{
+    return m_predictionHorizon;
+}
+
+const std::vector<BurstGenerator::SubBurst>&
+TiledVrBurstGenerator::GetLastSubBursts() const
+{
+    return m_subBursts;
+}
+
+void
+TiledVrBurstGenerator::TakeLastSubBursts(std::vector<SubBurst>& subBursts)
+{
+    // the next frame clears the vector, keeping its storage
+    m_subBursts.swap(subBursts);
+}
+
+void
+TiledVrBurstGenerator::GetTileLevels(double yaw,
+                                     double pitch,
+                                     double margin,
+                                     std::vector<uint8_t>& levels) const
+{
+    levels.resize(m_rows * m_columns);
+
+    // the levels of the columns go in the first row, which is computed last
+    double columnWidth = 360.0 / m_columns;
+    for (uint32_t c = 0; c < m_columns; ++c)
+    {
+        double center = -180 + (c + 0.5) * columnWidth;
+        double distance = std::max(0.0, std::abs(WrapAngle(center - yaw)) - columnWidth / 2);
+        levels[c] = AxisLevel(distance, m_horizontalFov / 2, margin);
+    }
+
+    double rowHeight = 180.0 / m_rows;
+    for (uint32_t r = m_rows; r-- > 0;)
+    {
+        double center = 90 - (r + 0.5) * rowHeight;
+        double distance = std::max(0.0, std::abs(center - pitch) - rowHeight / 2);
+        uint8_t rowLevel = AxisLevel(distance, m_verticalFov / 2, margin);
+        uint8_t* row = levels.data() + r * m_columns;
+        for (uint32_t c = 0; c < m_columns; ++c)
+        {
+            row[c] = std::min(rowLevel, levels[c]);
+        }
+    }
+}
+
+void
+TiledVrBurstGenerator::PredictViewport()
+{
+    Ptr<HeadMotionModel> model = GetHeadMotionModel();
+    if (!model)
+    {
+        return;
+    }
+
+    // VrBurstGenerator::GenerateBurst already advanced the model to now
+    const HeadPose& pose = model->GetLastPose();
+    if (m_havePose && pose.time > m_lastPoseTime)
+    {
+        double dt = (pose.time - m_lastPoseTime).GetSeconds();
+        m_yawRate = WrapAngle(pose.yaw - m_lastYaw) / dt;
+        m_pitchRate = (pose.pitch - m_lastPitch) / dt;
+    }
+    m_havePose = true;
+    m_lastPoseTime = pose.time;
+    m_lastYaw = pose.yaw;
+    m_lastPitch = pose.pitch;
+
+    double horizon = m_predictionHorizon.GetSeconds();
+    m_viewYaw = WrapAngle(pose.yaw + m_yawRate * horizon);
+    m_viewPitch = std::max(-90.0, std::min(pose.pitch + m_pitchRate * horizon, 90.0));
+}
+
+std::pair<uint32_t, Time>
+TiledVrBurstGenerator::GenerateBurst()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t frameSize;
+    Time period;
+    std::tie(frameSize, period) = VrBurstGenerator::GenerateBurst();
+
+    PredictViewport();
+    GetTileLevels(m_viewYaw, m_viewPitch, m_margin, m_levels);
+
+    const double weights[] = {m_outsideWeight, m_marginWeight, 1};
+    double totalWeight = 0;
+    for (uint8_t level : m_levels)
+    {
+        totalWeight += weights[level];
+    }
+
+    // split the frame, the last tile taking the rounding errors
+    m_subBursts.clear();
+    uint32_t allocated = 0;
+    for (uint32_t tile = 0; tile < m_levels.size(); ++tile)
+    {
+        double weight = weights[m_levels[tile]];
+        if (weight > 0)
+        {
+            uint32_t size = static_cast<uint32_t>(frameSize * weight / totalWeight);
+            m_subBursts.push_back({size, static_cast<uint16_t>(tile), m_levels[tile]});
+            allocated += size;
+        }
+    }
+    if (!m_subBursts.empty())
+    {
+        m_subBursts.back().size += frameSize - allocated;
+    }
+
+    NS_LOG_DEBUG("Viewport yaw=" << m_viewYaw << ", pitch=" << m_viewPitch << ": "
+                                 << m_subBursts.size() << " tiles");
+    return std::make_pair(frameSize, period);
+}
+
+} // namespace ns3
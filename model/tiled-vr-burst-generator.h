@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TILED_VR_BURST_GENERATOR_H
+#define TILED_VR_BURST_GENERATOR_H
+
+#include "ns3/vr-burst-generator.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Viewport-adaptive generator of tiled 360 degrees VR frames
+ *
+ * The size and the time of each frame are drawn by VrBurstGenerator, with
+ * all its options, then the frame is split into the tiles of an
+ * equirectangular grid of Rows x Columns tiles, reported as sub-bursts
+ * (see BurstGenerator::GetLastSubBursts) that the applications send as
+ * bursts of their own.
+ *
+ * Each tile is encoded at one of three quality levels:
+ * - HIGH_QUALITY, if it overlaps the predicted viewport, a HorizontalFov x
+ *   VerticalFov rectangle;
+ * - MEDIUM_QUALITY, if it overlaps the predicted viewport enlarged by Margin
+ *   on each side;
+ * - LOW_QUALITY otherwise.
+ *
+ * A tile takes a share of the frame proportional to the weight of its
+ * quality, 1, MarginWeight or OutsideWeight respectively, so that the data
+ * rate is still the target data rate; tiles with a null weight are not sent.
+ *
+ * The viewport is predicted PredictionHorizon ahead, by linear extrapolation
+ * of the last two poses of the HeadMotionModel of the generator; it stays
+ * ahead (yaw and pitch equal to 0) without a model. The overlap is computed
+ * separately for the yaw and the pitch, ignoring the widening of the
+ * viewport in yaw close to the poles, and all the per-tile state is held
+ * in flat arrays allocated when the grid changes.
+ */
+class TiledVrBurstGenerator : public VrBurstGenerator
+{
+  public:
+    /**
+     * \brief Quality level of a tile, as reported in the sub-bursts
+     */
+    enum TileQuality : uint8_t
+    {
+        LOW_QUALITY = 0,    //!< outside of the viewport and of its margin
+        MEDIUM_QUALITY = 1, //!< in the margin around the viewport
+        HIGH_QUALITY = 2    //!< in the viewport
+    };
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TiledVrBurstGenerator();
+    ~TiledVrBurstGenerator() override;
+
+    std::pair<uint32_t, Time> GenerateBurst() override;
+
+    /**
+     * \return the tiles of the last frame, in increasing tile order
+     */
+    const std::vector<SubBurst>& GetLastSubBursts() const override;
+
+    /**
+     * \brief Swap the tiles of the last frame with subBursts
+     * \param subBursts the vector receiving the tiles
+     */
+    void TakeLastSubBursts(std::vector<SubBurst>& subBursts) override;
+
+    /**
+     * \return the number of rows of the grid
+     */
+    uint32_t GetRows() const;
+
+    /**
+     * \return the number of columns of the grid
+     */
+    uint32_t GetColumns() const;
+
+    /**
+     * \return the time the viewport is predicted ahead
+     */
+    Time GetPredictionHorizon() const;
+
+    /**
+     * \brief Get the quality level of every tile for a viewport
+     *
+     * Tile r * Columns + c is the one of row r, from the top, and column c,
+     * from yaw -180 degrees.
+     *
+     * \param yaw the yaw of the center of the viewport [deg]
+     * \param pitch the pitch of the center of the viewport [deg]
+     * \param margin the margin of medium quality around the viewport [deg]
+     * \param levels the levels of the tiles, resized to the number of tiles
+     */
+    void GetTileLevels(double yaw, double pitch, double margin, std::vector<uint8_t>& levels) const;
+
+  private:
+    /**
+     * \brief Predict the viewport from the head motion model
+     */
+    void PredictViewport();
+
+    uint32_t m_rows;          //!< rows of the grid
+    uint32_t m_columns;       //!< columns of the grid
+    double m_horizontalFov;   //!< horizontal field of view [deg]
+    double m_verticalFov;     //!< vertical field of view [deg]
+    double m_margin;          //!< margin of medium quality around the viewport [deg]
+    double m_marginWeight;    //!< relative size of a medium quality tile
+    double m_outsideWeight;   //!< relative size of a low quality tile
+    Time m_predictionHorizon; //!< time the viewport is predicted ahead
+
+    bool m_havePose;      //!< whether a pose was observed
+    Time m_lastPoseTime;  //!< time of the last pose
+    double m_lastYaw;     //!< yaw of the last pose [deg]
+    double m_lastPitch;   //!< pitch of the last pose [deg]
+    double m_yawRate;     //!< estimated yaw velocity [deg/s]
+    double m_pitchRate;   //!< estimated pitch velocity [deg/s]
+    double m_viewYaw;     //!< yaw of the predicted viewport [deg]
+    double m_viewPitch;   //!< pitch of the predicted viewport [deg]
+
+    std::vector<uint8_t> m_levels;     //!< quality level of each tile of the last frame
+    std::vector<SubBurst> m_subBursts; //!< tiles of the last frame
+};
+
+} // namespace ns3
+
+#endif /* TILED_VR_BURST_GENERATOR_H */
@@ -22,7 +22,7 @@
 
 #include "burst-sink-tcp.h"
 #include "ns3/data-rate.h"
-#include "ns3/fuzzy-algorithm.h"
+#include "ns3/receiver-rate-controller.h"
 
 namespace ns3 {
 
@@ -63,6 +63,10 @@ class Packet;
  * 
  * Traces are sent when a fragment is received and when a whole burst is
  * successfully received.
+ *
+ * Every received fragment is also passed to the ReceiverRateController of its
+ * sender, created from the RateController attribute, and the resulting target
+ * rate is sent back in a VrAdaptiveHeader.
  * 
  */
 class VrAdaptiveBurstSinkTcp : public BurstSinkTcp
@@ -92,7 +96,8 @@ private:
 
   virtual void HandleRead (Ptr<Socket> socket);
 
-  std::map<Address, FuzzyAlgorithm> m_fuzzyAlgorithms;
+  TypeId m_rateControllerTid; //!< type of the rate controllers
+  std::map<Address, Ptr<ReceiverRateController>> m_rateControllers; //!< one per sender
   Ptr<Socket> m_tempSocket;
 };
 
@@ -17,7 +17,9 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  */
+#include "ns3/fuzzy-algorithm.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/simulator.h"
 #include "ns3/udp-socket-factory.h"
 #include "vr-adaptive-burst-sink.h"
@@ -42,6 +44,12 @@ VrAdaptiveBurstSink::GetTypeId (void)
           .AddAttribute ("Protocol", "The type id of the protocol to use for the rx socket.",
                          TypeIdValue (UdpSocketFactory::GetTypeId ()),
                          MakeTypeIdAccessor (&VrAdaptiveBurstSink::m_tid), MakeTypeIdChecker ())
+          .AddAttribute ("RateController",
+                         "The type id of the ReceiverRateController computing the target rate "
+                         "of each sender.",
+                         TypeIdValue (FuzzyAlgorithm::GetTypeId ()),
+                         MakeTypeIdAccessor (&VrAdaptiveBurstSink::m_rateControllerTid),
+                         MakeTypeIdChecker ())
           .AddTraceSource ("FragmentRx", "A fragment has been received",
                            MakeTraceSourceAccessor (&VrAdaptiveBurstSink::m_rxFragmentTrace),
                            "ns3::BurstSink::SeqTsSizeFragCallback")
@@ -67,7 +75,14 @@ VrAdaptiveBurstSink::FragmentReceived (BurstHandler &burstHandler, const Ptr<Pac
 {
   NS_LOG_FUNCTION (this << f);
 
-  DataRate arate = m_fuzzyAlgorithms[from].fragmentReceived (f);
+  Ptr<ReceiverRateController> &controller = m_rateControllers[from];
+  if (!controller)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (m_rateControllerTid);
+      controller = factory.Create<ReceiverRateController> ();
+    }
+  DataRate arate = controller->fragmentReceived (f);
 
   Ptr<Packet> packet = Create<Packet> (100);
   VrAdaptiveHeader responseHeader;
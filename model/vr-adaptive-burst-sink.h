@@ -21,7 +21,7 @@
 #define VR_ADAPTIVE_BURST_SINK_H
 
 #include "burst-sink.h"
-#include "ns3/fuzzy-algorithm.h"
+#include "ns3/receiver-rate-controller.h"
 
 namespace ns3 {
 
@@ -62,6 +62,10 @@ class Packet;
  * 
  * Traces are sent when a fragment is received and when a whole burst is
  * successfully received.
+ *
+ * Every received fragment is also passed to the ReceiverRateController of its
+ * sender, created from the RateController attribute, and the resulting target
+ * rate is sent back in a VrAdaptiveHeader.
  * 
  */
 class VrAdaptiveBurstSink : public BurstSink
@@ -89,7 +93,8 @@ private:
   void FragmentReceived (BurstHandler &burstHandler, const Ptr<Packet> &f, const Address &from,
                          const Address &localAddress);
 
-  std::map<Address, FuzzyAlgorithm> m_fuzzyAlgorithms;
+  TypeId m_rateControllerTid; //!< type of the rate controllers
+  std::map<Address, Ptr<ReceiverRateController>> m_rateControllers; //!< one per sender
   Ptr<Socket> m_tempSocket;
 };
 
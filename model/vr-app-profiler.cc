@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "vr-app-profiler.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("VrAppProfiler");
+
+bool VrAppProfiler::m_enabled = false;
+bool VrAppProfiler::m_reportScheduled = false;
+Time VrAppProfiler::m_start;
+uint64_t VrAppProfiler::m_counters[VrAppProfiler::N_COMPONENTS][VrAppProfiler::N_OPERATIONS] = {};
+
+void
+VrAppProfiler::Enable(bool reportAtDestroy)
+{
+    NS_LOG_FUNCTION(reportAtDestroy);
+    if (!IsCompiledIn())
+    {
+        NS_LOG_WARN("Profiling hooks are not compiled in: configure with "
+                    "-DNS3_VR_APP_PROFILING=ON to enable them in optimized builds");
+    }
+
+    Reset();
+    m_enabled = true;
+    m_start = Simulator::Now();
+    if (reportAtDestroy && !m_reportScheduled)
+    {
+        Simulator::ScheduleDestroy(&VrAppProfiler::ReportAtDestroy);
+        m_reportScheduled = true;
+    }
+}
+
+void
+VrAppProfiler::Disable()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    m_enabled = false;
+}
+
+bool
+VrAppProfiler::IsEnabled()
+{
+    return m_enabled;
+}
+
+bool
+VrAppProfiler::IsCompiledIn()
+{
+#ifdef NS3_VR_APP_PROFILING_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+VrAppProfiler::Reset()
+{
+    for (auto& component : m_counters)
+    {
+        for (auto& counter : component)
+        {
+            counter = 0;
+        }
+    }
+}
+
+uint64_t
+VrAppProfiler::Get(Component component, Operation operation)
+{
+    NS_ASSERT(component < N_COMPONENTS && operation < N_OPERATIONS);
+    return m_counters[component][operation];
+}
+
+const char*
+VrAppProfiler::GetComponentName(Component component)
+{
+    switch (component)
+    {
+    case BURSTY_APPLICATION:
+        return "BurstyApplication";
+    case BURST_SINK:
+        return "BurstSink";
+    case SERVER_INSTANCE:
+        return "BurstyApplicationServerInstance";
+    case CLIENT:
+        return "BurstyApplicationClient";
+    case GENERATOR:
+        return "BurstGenerator";
+    case ALGORITHM:
+        return "AdaptationAlgorithm";
+    default:
+        NS_ABORT_MSG("Unknown component " << component);
+    }
+    return "";
+}
+
+const char*
+VrAppProfiler::GetOperationName(Operation operation)
+{
+    switch (operation)
+    {
+    case OBJECT_CREATION:
+        return "Objects";
+    case PACKET_CREATION:
+        return "Packets";
+    case PACKET_COPY:
+        return "PacketCopies";
+    case CREATE_FRAGMENT:
+        return "CreateFragment";
+    case MAP_INSERTION:
+        return "MapInsertions";
+    case STRINGSTREAM:
+        return "Stringstreams";
+    default:
+        NS_ABORT_MSG("Unknown operation " << operation);
+    }
+    return "";
+}
+
+void
+VrAppProfiler::Report(std::ostream& os)
+{
+    double simSeconds = (Simulator::Now() - m_start).GetSeconds();
+
+    os << "VrAppProfiler: " << simSeconds << " simulated seconds";
+    if (!IsCompiledIn())
+    {
+        os << " (hooks not compiled in, all counters are zero)";
+    }
+    os << std::endl;
+
+    // absolute counts, then per simulated second
+    os << std::left << std::setw(34) << "Component";
+    for (int op = 0; op < N_OPERATIONS; op++)
+    {
+        os << std::right << std::setw(16) << GetOperationName(static_cast<Operation>(op));
+    }
+    os << std::right << std::setw(16) << "Allocations" << std::endl;
+
+    for (int c = 0; c < N_COMPONENTS; c++)
+    {
+        // every counted operation allocates at least one object on the heap
+        uint64_t allocations = 0;
+        os << std::left << std::setw(34) << GetComponentName(static_cast<Component>(c));
+        for (int op = 0; op < N_OPERATIONS; op++)
+        {
+            allocations += m_counters[c][op];
+            os << std::right << std::setw(16) << m_counters[c][op];
+        }
+        os << std::right << std::setw(16) << allocations << std::endl;
+
+        if (simSeconds > 0)
+        {
+            os << std::left << std::setw(34) << "  per simulated second" << std::fixed
+               << std::setprecision(1);
+            for (int op = 0; op < N_OPERATIONS; op++)
+            {
+                os << std::right << std::setw(16) << m_counters[c][op] / simSeconds;
+            }
+            os << std::right << std::setw(16) << allocations / simSeconds << std::endl;
+            os << std::defaultfloat << std::setprecision(6);
+        }
+    }
+}
+
+void
+VrAppProfiler::ReportAtDestroy()
+{
+    m_reportScheduled = false;
+    if (m_enabled)
+    {
+        Report(std::cout);
+    }
+}
+
+} // namespace ns3
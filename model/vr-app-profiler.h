@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef VR_APP_PROFILER_H
+#define VR_APP_PROFILER_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * \file
+ * \ingroup applications
+ *
+ * The profiling hooks are compiled in when NS3_VR_APP_PROFILING is defined
+ * (CMake option NS3_VR_APP_PROFILING) and in the builds with logging enabled.
+ * Otherwise VR_APP_PROFILE expands to nothing and the hot paths are left
+ * untouched.
+ */
+#if defined(NS3_VR_APP_PROFILING) || defined(NS3_LOG_ENABLE)
+#define NS3_VR_APP_PROFILING_ENABLED
+#endif
+
+namespace ns3
+{
+
+/**
+ * \ingroup applications
+ *
+ * \brief Counts the allocations and copies done by the components of the module
+ *
+ * Counters are plain integers indexed by (component, operation) and are only
+ * updated after Enable has been called, so that a build with profiling
+ * compiled in pays a single branch per hook when profiling is off.
+ * The counts are reported in absolute terms and per simulated second, either
+ * explicitly with Report or automatically when the simulator is destroyed.
+ */
+class VrAppProfiler
+{
+  public:
+    /// Instrumented components
+    enum Component
+    {
+        BURSTY_APPLICATION = 0,
+        BURST_SINK,
+        SERVER_INSTANCE,
+        CLIENT,
+        GENERATOR,
+        ALGORITHM,
+        N_COMPONENTS
+    };
+
+    /// Counted operations
+    enum Operation
+    {
+        OBJECT_CREATION = 0, //!< CreateObject of an ns3::Object
+        PACKET_CREATION,     //!< Create<Packet>
+        PACKET_COPY,         //!< Packet::Copy or Packet copy construction
+        CREATE_FRAGMENT,     //!< Packet::CreateFragment
+        MAP_INSERTION,       //!< insertion in a std::map or std::unordered_map
+        STRINGSTREAM,        //!< construction of a std::stringstream
+        N_OPERATIONS
+    };
+
+    /**
+     * \brief Start counting
+     * \param reportAtDestroy whether to print the report on std::cout when the
+     *        simulator is destroyed
+     *
+     * The counters are reset, and the simulated time of the report starts now.
+     */
+    static void Enable(bool reportAtDestroy = true);
+
+    /**
+     * \brief Stop counting, the counters are kept
+     */
+    static void Disable();
+
+    /**
+     * \return whether the counters are being updated
+     */
+    static bool IsEnabled();
+
+    /**
+     * \return whether the hooks were compiled in
+     */
+    static bool IsCompiledIn();
+
+    /**
+     * \brief Reset all counters to zero
+     */
+    static void Reset();
+
+    /**
+     * \brief Count an operation
+     * \param component the component doing the operation
+     * \param operation the operation
+     * \param count the number of operations
+     */
+    static void Count(Component component, Operation operation, uint64_t count = 1)
+    {
+        if (m_enabled)
+        {
+            m_counters[component][operation] += count;
+        }
+    }
+
+    /**
+     * \param component the component
+     * \param operation the operation
+     * \return the number of operations counted since the last reset
+     */
+    static uint64_t Get(Component component, Operation operation);
+
+    /**
+     * \brief Write the counters as a table, one row per component
+     * \param os the output stream
+     *
+     * The rates are computed over the simulated time elapsed since Enable.
+     */
+    static void Report(std::ostream& os);
+
+    /**
+     * \param component the component
+     * \return the name of the component
+     */
+    static const char* GetComponentName(Component component);
+
+    /**
+     * \param operation the operation
+     * \return the name of the operation
+     */
+    static const char* GetOperationName(Operation operation);
+
+  private:
+    /**
+     * \brief Print the report on std::cout, scheduled at simulator destruction
+     */
+    static void ReportAtDestroy();
+
+    static bool m_enabled;                                  //!< whether counting is enabled
+    static bool m_reportScheduled;                          //!< whether the report is scheduled
+    static Time m_start;                                    //!< simulated time of Enable
+    static uint64_t m_counters[N_COMPONENTS][N_OPERATIONS]; //!< the counters
+};
+
+} // namespace ns3
+
+#ifdef NS3_VR_APP_PROFILING_ENABLED
+/**
+ * \ingroup applications
+ * \brief Count one operation of a component
+ * \param component a VrAppProfiler::Component, without the class qualifier
+ * \param operation a VrAppProfiler::Operation, without the class qualifier
+ */
+#define VR_APP_PROFILE(component, operation)                                                      \
+    ns3::VrAppProfiler::Count(ns3::VrAppProfiler::component, ns3::VrAppProfiler::operation)
+
+/**
+ * \ingroup applications
+ * \brief Count several operations of a component
+ * \param component a VrAppProfiler::Component, without the class qualifier
+ * \param operation a VrAppProfiler::Operation, without the class qualifier
+ * \param count the number of operations
+ */
+#define VR_APP_PROFILE_N(component, operation, count)                                             \
+    ns3::VrAppProfiler::Count(ns3::VrAppProfiler::component,                                      \
+                              ns3::VrAppProfiler::operation,                                      \
+                              count)
+#else
+#define VR_APP_PROFILE(component, operation)
+#define VR_APP_PROFILE_N(component, operation, count)
+#endif /* NS3_VR_APP_PROFILING_ENABLED */
+
+#endif /* VR_APP_PROFILER_H */
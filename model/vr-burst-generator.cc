@@ -24,8 +24,16 @@
 #include "ns3/enum.h"
 #include "ns3/nstime.h"
 #include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/csv-reader.h"
+#include "ns3/simulator.h"
 #include "vr-burst-generator.h"
+#include "vr-app-profiler.h"
 #include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -43,11 +51,18 @@ VrBurstGenerator::GetTypeId (void)
           .AddConstructor<VrBurstGenerator> ()
           .AddAttribute ("FrameRate",
                          "The frame rate of the VR application [FPS]. "
-                         "Only 30 and 60 FPS are currently supported.",
+                         "The model is interpolated between the fitted frame rates.",
                          DoubleValue (60),
                          MakeDoubleAccessor (&VrBurstGenerator::SetFrameRate,
                                              &VrBurstGenerator::GetFrameRate),
                          MakeDoubleChecker<double> (0))
+          .AddAttribute ("BitrateLadder",
+                         "The bitrate ladder the target data rate is quantized to, "
+                         "null to use any target data rate.",
+                         PointerValue (0),
+                         MakePointerAccessor (&VrBurstGenerator::SetBitrateLadder,
+                                              &VrBurstGenerator::GetBitrateLadder),
+                         MakePointerChecker<BitrateLadder> ())
           .AddAttribute ("TargetDataRate",
                          "The target data rate that the VR application will try to achieve.",
                          DataRateValue (DataRate ("20Mbps")),
@@ -57,17 +72,83 @@ VrBurstGenerator::GetTypeId (void)
           .AddAttribute ("VrAppName",
                          "The VR application on which the model is based upon. Check the documentation for further information.",
                          EnumValue (VrAppName::VirusPopper),
-                         MakeEnumAccessor<VrAppName> (&VrBurstGenerator::m_appName),
+                         MakeEnumAccessor<VrAppName> (&VrBurstGenerator::SetVrAppName,
+                                                      &VrBurstGenerator::GetVrAppName),
                          MakeEnumChecker (VrAppName::VirusPopper, "VirusPopper",
                                           VrAppName::Minecraft, "Minecraft",
                                           VrAppName::GoogleEarthVrCities, "GoogleEarthVrCities",
-                                          VrAppName::GoogleEarthVrTour, "GoogleEarthVrTour"));
+                                          VrAppName::GoogleEarthVrTour, "GoogleEarthVrTour"))
+          .AddAttribute ("CoefficientFile",
+                         "A CSV file with model coefficients fitted at more frame rates, "
+                         "see SetCoefficientFile",
+                         StringValue (""),
+                         MakeStringAccessor (&VrBurstGenerator::SetCoefficientFile,
+                                             &VrBurstGenerator::GetCoefficientFile),
+                         MakeStringChecker ())
+          .AddAttribute ("Correlated",
+                         "If true, frame sizes and inter-frame intervals follow an AR(2) process "
+                         "fitted on the traces of the application, otherwise they are i.i.d.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&VrBurstGenerator::SetCorrelated,
+                                              &VrBurstGenerator::GetCorrelated),
+                         MakeBooleanChecker ())
+          .AddAttribute ("HeadMotionModel",
+                         "The head motion modulating the frame sizes, null for none",
+                         PointerValue (0),
+                         MakePointerAccessor (&VrBurstGenerator::SetHeadMotionModel,
+                                              &VrBurstGenerator::GetHeadMotionModel),
+                         MakePointerChecker<HeadMotionModel> ())
+          .AddAttribute ("MotionSensitivity",
+                         "The relative change of the frame size per relative change of the "
+                         "angular speed of the head, with respect to its average",
+                         DoubleValue (0.5),
+                         MakeDoubleAccessor (&VrBurstGenerator::m_motionSensitivity),
+                         MakeDoubleChecker<double> (0, 1))
+          .AddAttribute ("MinFrameSize",
+                         "The smallest frame size modulated by the HeadMotionModel, applied "
+                         "before the rate control: with a MotionSensitivity of 1, a still head "
+                         "would otherwise produce empty frames. Unused without a HeadMotionModel",
+                         UintegerValue (3000),
+                         MakeUintegerAccessor (&VrBurstGenerator::m_minFrameSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("RateControl",
+                         "The rate control encoding the frames, null for frames following the "
+                         "target data rate right away",
+                         PointerValue (0),
+                         MakePointerAccessor (&VrBurstGenerator::SetRateControl,
+                                              &VrBurstGenerator::GetRateControl),
+                         MakePointerChecker<EncoderRateControl> ())
+          .AddAttribute ("GopLength",
+                         "The frames per GOP, or per intra refresh period, 0 for no periodic "
+                         "intra data",
+                         UintegerValue (0),
+                         MakeUintegerAccessor (&VrBurstGenerator::m_gopLength),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("GopMode",
+                         "The encoding of the intra data of a GOP",
+                         EnumValue (VrBurstGenerator::FULL_INTRA),
+                         MakeEnumAccessor (&VrBurstGenerator::m_gopMode),
+                         MakeEnumChecker (VrBurstGenerator::FULL_INTRA, "FullIntra",
+                                          VrBurstGenerator::INTRA_REFRESH, "IntraRefresh"))
+          .AddAttribute ("IntraSizeRatio",
+                         "The ratio between the sizes of I and P frames",
+                         DoubleValue (5),
+                         MakeDoubleAccessor (&VrBurstGenerator::m_intraSizeRatio),
+                         MakeDoubleChecker<double> (1))
+          .AddAttribute ("SceneCutProbability",
+                         "The probability that a frame is a scene cut, forcing an I frame",
+                         DoubleValue (0),
+                         MakeDoubleAccessor (&VrBurstGenerator::m_sceneCutProbability),
+                         MakeDoubleChecker<double> (0, 1));
   return tid;
 }
 
 VrBurstGenerator::VrBurstGenerator ()
 {
   NS_LOG_FUNCTION (this);
+  UpdateCoefficients ();
+  m_innovationRv = CreateObject<NormalRandomVariable> ();
+  m_sceneCutRv = CreateObject<UniformRandomVariable> ();
 }
 
 VrBurstGenerator::~VrBurstGenerator ()
@@ -79,9 +160,20 @@ int64_t
 VrBurstGenerator::AssignStreams (int64_t stream)
 {
   NS_LOG_FUNCTION (this << stream);
-  m_periodRv->SetStream (stream);
-  m_frameSizeRv->SetStream (stream + 1);
-  return 2;
+  int64_t currentStream = stream;
+  m_periodRv->SetStream (currentStream++);
+  m_frameSizeRv->SetStream (currentStream++);
+  // only the variables in use take a stream, so that the streams following
+  // an i.i.d. generator are the same as before correlation and GOPs existed
+  if (m_correlated)
+    {
+      m_innovationRv->SetStream (currentStream++);
+    }
+  if (m_sceneCutProbability > 0)
+    {
+      m_sceneCutRv->SetStream (currentStream++);
+    }
+  return currentStream - stream;
 }
 
 void
@@ -89,8 +181,13 @@ VrBurstGenerator::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
 
+  m_bitrateLadder = 0;
   m_periodRv = 0;
   m_frameSizeRv = 0;
+  m_innovationRv = 0;
+  m_sceneCutRv = 0;
+  m_headMotionModel = 0;
+  m_rateControl = 0;
 
   // chain up
   BurstGenerator::DoDispose ();
@@ -101,10 +198,10 @@ VrBurstGenerator::SetFrameRate (double frameRate)
 {
   NS_LOG_FUNCTION (this << frameRate);
 
-  NS_ABORT_MSG_UNLESS (frameRate == 30 || frameRate == 60,
-                       "Frame rate must be either 30 or 60 FPS, instead frameRate=" << frameRate);
+  NS_ABORT_MSG_UNLESS (frameRate > 0, "Frame rate must be positive, instead frameRate=" << frameRate);
   m_frameRate = frameRate;
 
+  UpdateCoefficients ();
   SetupModel ();
 }
 
@@ -121,7 +218,11 @@ VrBurstGenerator::SetTargetDataRate (DataRate targetDataRate)
 
   NS_ABORT_MSG_IF (targetDataRate.GetBitRate () <= 0,
                    "Target data rate must be positive, instead: " << targetDataRate);
-  m_targetDataRate = targetDataRate;
+  m_targetDataRate = m_bitrateLadder ? m_bitrateLadder->Quantize (targetDataRate) : targetDataRate;
+  if (m_rateControl)
+    {
+      m_rateControl->SetTargetDataRate (m_targetDataRate);
+    }
 
   SetupModel ();
 }
@@ -132,12 +233,74 @@ VrBurstGenerator::GetTargetDataRate (void) const
   return m_targetDataRate;
 }
 
+void
+VrBurstGenerator::SetBitrateLadder (Ptr<BitrateLadder> ladder)
+{
+  NS_LOG_FUNCTION (this << ladder);
+
+  m_bitrateLadder = ladder;
+  if (m_bitrateLadder)
+    {
+      SetTargetDataRate (m_targetDataRate);
+    }
+}
+
+Ptr<BitrateLadder>
+VrBurstGenerator::GetBitrateLadder (void) const
+{
+  return m_bitrateLadder;
+}
+
+void
+VrBurstGenerator::SetCorrelated (bool correlated)
+{
+  NS_LOG_FUNCTION (this << correlated);
+  m_correlated = correlated;
+}
+
+bool
+VrBurstGenerator::GetCorrelated (void) const
+{
+  return m_correlated;
+}
+
+void
+VrBurstGenerator::SetHeadMotionModel (Ptr<HeadMotionModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_headMotionModel = model;
+}
+
+Ptr<HeadMotionModel>
+VrBurstGenerator::GetHeadMotionModel (void) const
+{
+  return m_headMotionModel;
+}
+
+void
+VrBurstGenerator::SetRateControl (Ptr<EncoderRateControl> rateControl)
+{
+  NS_LOG_FUNCTION (this << rateControl);
+  m_rateControl = rateControl;
+  if (m_rateControl)
+    {
+      m_rateControl->SetTargetDataRate (m_targetDataRate);
+    }
+}
+
+Ptr<EncoderRateControl>
+VrBurstGenerator::GetRateControl (void) const
+{
+  return m_rateControl;
+}
+
 void
 VrBurstGenerator::SetVrAppName (VrBurstGenerator::VrAppName vrAppName)
 {
   NS_LOG_FUNCTION (this << vrAppName);
 
   m_appName = vrAppName;
+  UpdateCoefficients ();
   SetupModel ();
 }
 
@@ -160,114 +323,323 @@ VrBurstGenerator::GenerateBurst ()
 {
   NS_LOG_FUNCTION (this);
 
-  // sample current frame size
-  uint32_t frameSize = m_frameSizeRv->GetInteger ();
+  uint32_t frameSize;
+  Time period;
+  if (m_correlated)
+    {
+      frameSize = static_cast<uint32_t> (SampleCorrelated (m_frameSizeRv, m_frameSizeAr));
+      period = Seconds (SampleCorrelated (m_periodRv, m_periodAr));
+    }
+  else
+    {
+      // sample current frame size
+      frameSize = m_frameSizeRv->GetInteger ();
+
+      // sample period before next frame
+      period = Seconds (m_periodRv->GetValue ());
+    }
 
-  // sample period before next frame
-  Time period = Seconds (m_periodRv->GetValue ());
+  double weight = NextFrameWeight ();
+  if (weight != 1)
+    {
+      frameSize = static_cast<uint32_t> (frameSize * weight);
+    }
+
+  if (m_headMotionModel)
+    {
+      double speed = m_headMotionModel->GetPose (Simulator::Now ()).speed;
+      double meanSpeed = m_headMotionModel->GetMeanSpeed ();
+      if (meanSpeed > 0)
+        {
+          frameSize = static_cast<uint32_t> (
+              frameSize * (1 + m_motionSensitivity * (speed / meanSpeed - 1)));
+        }
+      frameSize = std::max (frameSize, m_minFrameSize);
+    }
   NS_ABORT_MSG_IF (!period.IsPositive (),
                    "Period must be non-negative, instead found period=" << period.As (Time::S));
 
-  NS_LOG_DEBUG ("Frame size: " << frameSize << " B, period: " << period.As (Time::S));
+  if (m_rateControl)
+    {
+      frameSize = m_rateControl->EncodeFrame (frameSize, period);
+    }
+
+  NS_LOG_DEBUG ("Frame size: " << frameSize << " B, period: " << period.As (Time::S)
+                                << ", type: " << +m_lastFrameType);
   return std::make_pair (frameSize, period);
 }
 
+SeqTsSizeFragHeader::FrameType
+VrBurstGenerator::GetLastFrameType (void) const
+{
+  return m_lastFrameType;
+}
+
+double
+VrBurstGenerator::NextFrameWeight (void)
+{
+  if (m_gopLength == 0 && m_sceneCutProbability == 0)
+    {
+      m_lastFrameType = SeqTsSizeFragHeader::UNSPECIFIED_FRAME;
+      return 1;
+    }
+
+  // long-run fraction of I frames: the inverse of the average distance between
+  // two I frames, truncated by the end of the GOP in full intra mode
+  bool refresh = m_gopMode == INTRA_REFRESH && m_gopLength > 0;
+  double q = m_sceneCutProbability;
+  double intraFraction = q;
+  if (!refresh && m_gopLength > 0)
+    {
+      intraFraction = q > 0 ? q / (1 - std::pow (1 - q, m_gopLength)) : 1.0 / m_gopLength;
+    }
+  double otherWeight = refresh ? 1 + (m_intraSizeRatio - 1) / m_gopLength : 1;
+  // keep the average frame size of the model
+  double scale = 1 / (intraFraction * m_intraSizeRatio + (1 - intraFraction) * otherWeight);
+
+  bool sceneCut = q > 0 && m_sceneCutRv->GetValue () < q;
+  bool gopStart = !refresh && m_gopLength > 0 && m_framesSinceIntra >= m_gopLength;
+  if (m_framesSinceIntra == 0 || sceneCut || gopStart)
+    {
+      m_framesSinceIntra = 1;
+      m_lastFrameType = SeqTsSizeFragHeader::I_FRAME;
+      return m_intraSizeRatio * scale;
+    }
+
+  m_framesSinceIntra++;
+  m_lastFrameType =
+      refresh ? SeqTsSizeFragHeader::INTRA_REFRESH_FRAME : SeqTsSizeFragHeader::P_FRAME;
+  return otherWeight * scale;
+}
+
 void
-VrBurstGenerator::SetupModel ()
+VrBurstGenerator::SetAr2Coefficients (Ar2Process &process, double phi1, double phi2)
 {
-  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (std::abs (phi2) < 1 && phi1 + phi2 < 1 && phi2 - phi1 < 1,
+                 "Non stationary AR(2) process: phi1=" << phi1 << ", phi2=" << phi2);
+  process.phi1 = phi1;
+  process.phi2 = phi2;
+  // innovation variance giving a unit marginal variance
+  double rho1 = phi1 / (1 - phi2);
+  double rho2 = phi1 * rho1 + phi2;
+  process.sigma = std::sqrt (1 - phi1 * rho1 - phi2 * rho2);
+}
 
-  double alpha{0};
-  double beta{0};
-  double gamma{0};
-  double delta{0};
-  double epsilon{0};
+double
+VrBurstGenerator::SampleCorrelated (Ptr<LogisticRandomVariable> rv, Ar2Process &process)
+{
+  double z = process.phi1 * process.z1 + process.phi2 * process.z2 +
+             process.sigma * m_innovationRv->GetValue ();
+  process.z2 = process.z1;
+  process.z1 = z;
+
+  // Gaussian copula: the logistic CDF truncated to [location - bound, location + bound]
+  // evaluated at the sample is Phi (z)
+  double scale = rv->GetScale ();
+  double lower = 1 / (1 + std::exp (rv->GetBound () / scale));
+  double u = lower + (1 - 2 * lower) * 0.5 * std::erfc (-z / std::sqrt (2.0));
+  u = std::min (std::max (u, 1e-12), 1 - 1e-12);
+  return rv->GetLocation () + scale * std::log (u / (1 - u));
+}
 
-  switch (m_appName)
+void
+VrBurstGenerator::SetCoefficientFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+
+  m_coefficientFile = filename;
+  m_fileCoefficients.clear ();
+  if (!filename.empty ())
     {
-    case VrAppName::VirusPopper:
-      alpha = 0.17843005544386825;
-      beta = -0.24033549;
-      if (m_frameRate == 60)
+      CsvReader csv (filename);
+      while (csv.FetchNextRow ())
         {
-          gamma = 0.03720502322046791;
-        }
-      else if (m_frameRate == 30)
-        {
-          delta = 0.014333111298430356;
-          epsilon = 0.17636808;
-        }
-      else
-        {
-          NS_ABORT_MSG ("Unexpected frame rate: " << m_frameRate);
+          std::string appName;
+          ModelCoefficients fit;
+          if (csv.IsBlankRow () || !csv.GetValue (0, appName) || !csv.GetValue (1, fit.frameRate) ||
+              !csv.GetValue (2, fit.alpha) || !csv.GetValue (3, fit.beta) ||
+              !csv.GetValue (4, fit.delta) || !csv.GetValue (5, fit.epsilon) ||
+              !csv.GetValue (6, fit.sizePhi1) || !csv.GetValue (7, fit.sizePhi2) ||
+              !csv.GetValue (8, fit.ifiPhi1) || !csv.GetValue (9, fit.ifiPhi2))
+            {
+              continue;
+            }
+          VrAppName app;
+          if (appName == "VirusPopper")
+            {
+              app = VrAppName::VirusPopper;
+            }
+          else if (appName == "Minecraft")
+            {
+              app = VrAppName::Minecraft;
+            }
+          else if (appName == "GoogleEarthVrCities")
+            {
+              app = VrAppName::GoogleEarthVrCities;
+            }
+          else if (appName == "GoogleEarthVrTour")
+            {
+              app = VrAppName::GoogleEarthVrTour;
+            }
+          else
+            {
+              NS_ABORT_MSG ("Unknown application " << appName << " in file " << filename);
+            }
+          NS_ABORT_MSG_UNLESS (fit.frameRate > 0 && fit.alpha > 0 && fit.delta > 0,
+                               "Invalid coefficients of " << appName << " at " << fit.frameRate
+                                                          << " FPS in file " << filename);
+          m_fileCoefficients.emplace_back (app, fit);
         }
+      NS_ABORT_MSG_IF (m_fileCoefficients.empty (), "No coefficients in file " << filename);
+    }
+
+  UpdateCoefficients ();
+  SetupModel ();
+}
+
+std::string
+VrBurstGenerator::GetCoefficientFile (void) const
+{
+  return m_coefficientFile;
+}
+
+void
+VrBurstGenerator::UpdateCoefficients (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // fits on the bundled traces: the IFI dispersion does not depend on the
+  // data rate at 60 FPS
+  std::vector<ModelCoefficients> fits;
+  switch (m_appName)
+    {
+    case VrAppName::VirusPopper:
+      fits.push_back ({30, 0.17843005544386825, -0.24033549, 0.014333111298430356, 0.17636808,
+                       0.6015, 0.1249, -0.4288, -0.1534});
+      fits.push_back ({60, 0.17843005544386825, -0.24033549, 0.03720502322046791, 0,
+                       0.3531, 0.1989, -0.5254, -0.2380});
       break;
 
     case VrAppName::Minecraft:
-      alpha = 0.18570635904452573;
-      beta = -0.18721216;
-      if (m_frameRate == 60)
-        {
-          gamma = 0.07132669841811076;
-        }
-      else if (m_frameRate == 30)
-        {
-          delta = 0.024192743507827373;
-          epsilon = 0.22666163;
-        }
-      else
-        {
-          NS_ABORT_MSG ("Unexpected frame rate: " << m_frameRate);
-        }
+      fits.push_back ({30, 0.18570635904452573, -0.18721216, 0.024192743507827373, 0.22666163,
+                       0.5410, 0.1485, -0.5431, -0.4237});
+      fits.push_back ({60, 0.18570635904452573, -0.18721216, 0.07132669841811076, 0,
+                       0.4401, 0.1883, -0.6701, -0.5705});
       break;
 
     case VrAppName::GoogleEarthVrCities:
-      alpha = 0.259684566301378;
-      beta = -0.25390119;
-      if (m_frameRate == 60)
-        {
-          gamma = 0.034571656202610615;
-        }
-      else if (m_frameRate == 30)
-        {
-          delta = 0.008953037116942649;
-          epsilon = 0.3119082;
-        }
-      else
-        {
-          NS_ABORT_MSG ("Unexpected frame rate: " << m_frameRate);
-        }
+      fits.push_back ({30, 0.259684566301378, -0.25390119, 0.008953037116942649, 0.3119082,
+                       0.3867, 0.3283, -0.4530, -0.1060});
+      fits.push_back ({60, 0.259684566301378, -0.25390119, 0.034571656202610615, 0,
+                       0.3606, 0.2257, -0.6226, -0.2979});
       break;
 
     case VrAppName::GoogleEarthVrTour:
-      alpha = 0.25541435742159037;
-      beta = -0.20308171;
-      if (m_frameRate == 60)
+      fits.push_back ({30, 0.25541435742159037, -0.20308171, 0.010559650431826953, 0.27560183,
+                       0.5057, 0.2894, -0.4427, -0.1067});
+      fits.push_back ({60, 0.25541435742159037, -0.20308171, 0.03468230656563422, 0,
+                       0.3568, 0.2399, -0.6080, -0.2859});
+      break;
+
+    default:
+      NS_ABORT_MSG ("m_appName was not recognized");
+      break;
+    }
+
+  // the fits of the file replace the bundled ones at the same frame rate
+  for (const auto &entry : m_fileCoefficients)
+    {
+      if (entry.first != m_appName)
         {
-          gamma = 0.03468230656563422;
+          continue;
         }
-      else if (m_frameRate == 30)
+      auto it = std::find_if (fits.begin (), fits.end (), [&entry] (const ModelCoefficients &fit) {
+        return fit.frameRate == entry.second.frameRate;
+      });
+      if (it != fits.end ())
         {
-          delta = 0.010559650431826953;
-          epsilon = 0.27560183;
+          *it = entry.second;
         }
       else
         {
-          NS_ABORT_MSG ("Unexpected frame rate: " << m_frameRate);
+          fits.push_back (entry.second);
         }
-      break;
+    }
+  std::sort (fits.begin (), fits.end (),
+             [] (const ModelCoefficients &a, const ModelCoefficients &b) {
+               return a.frameRate < b.frameRate;
+             });
+
+  m_coefficients = Interpolate (fits, m_frameRate);
+  NS_LOG_DEBUG ("Coefficients at " << m_frameRate << " FPS: alpha=" << m_coefficients.alpha
+                                   << ", beta=" << m_coefficients.beta
+                                   << ", delta=" << m_coefficients.delta
+                                   << ", epsilon=" << m_coefficients.epsilon);
+
+  // the coefficients of the AR(2) processes are updated, not their state,
+  // so that the correlation carries over changes of the model
+  SetAr2Coefficients (m_frameSizeAr, m_coefficients.sizePhi1, m_coefficients.sizePhi2);
+  SetAr2Coefficients (m_periodAr, m_coefficients.ifiPhi1, m_coefficients.ifiPhi2);
+}
 
-    default:
-      NS_ABORT_MSG ("m_appName was not recognized");
-      break;
+VrBurstGenerator::ModelCoefficients
+VrBurstGenerator::Interpolate (const std::vector<ModelCoefficients> &fits, double frameRate)
+{
+  NS_ASSERT (!fits.empty ());
+  if (fits.size () == 1)
+    {
+      return fits.front ();
     }
 
+  // segment of the two closest fits, the first or last one when extrapolating
+  std::size_t i = 0;
+  while (i + 2 < fits.size () && fits[i + 1].frameRate <= frameRate)
+    {
+      i++;
+    }
+  const ModelCoefficients &lo = fits[i];
+  const ModelCoefficients &hi = fits[i + 1];
+  if (frameRate == hi.frameRate)
+    {
+      return hi;
+    }
+  double t = std::log (frameRate / lo.frameRate) / std::log (hi.frameRate / lo.frameRate);
+  auto linear = [t] (double a, double b) { return a + t * (b - a); };
+  auto logLinear = [t] (double a, double b) { return a * std::pow (b / a, t); };
+
+  ModelCoefficients c;
+  c.frameRate = frameRate;
+  c.alpha = logLinear (lo.alpha, hi.alpha);
+  c.beta = linear (lo.beta, hi.beta);
+  c.delta = logLinear (lo.delta, hi.delta);
+  c.epsilon = linear (lo.epsilon, hi.epsilon);
+
+  // keep the extrapolated AR(2) processes stationary, with some margin
+  auto stationary = [] (double &phi1, double &phi2) {
+    phi2 = std::min (std::max (phi2, -0.95), 0.95);
+    double bound = 0.95 * (1 - phi2);
+    phi1 = std::min (std::max (phi1, -bound), bound);
+  };
+  c.sizePhi1 = linear (lo.sizePhi1, hi.sizePhi1);
+  c.sizePhi2 = linear (lo.sizePhi2, hi.sizePhi2);
+  stationary (c.sizePhi1, c.sizePhi2);
+  c.ifiPhi1 = linear (lo.ifiPhi1, hi.ifiPhi1);
+  c.ifiPhi2 = linear (lo.ifiPhi2, hi.ifiPhi2);
+  stationary (c.ifiPhi1, c.ifiPhi2);
+  return c;
+}
+
+void
+VrBurstGenerator::SetupModel ()
+{
+  NS_LOG_FUNCTION (this);
+
   double fsAvg = m_targetDataRate.GetBitRate () / 8.0 / m_frameRate; // expected frame size [B]
   double ifiAvg = 1.0 / m_frameRate; // expected inter frame interarrival [s]
   double targetRate_mbps = m_targetDataRate.GetBitRate () / 1e6;
 
   // Model frame size stats
-  double fsDispersion = alpha * std::pow (targetRate_mbps, beta);
+  double fsDispersion = m_coefficients.alpha * std::pow (targetRate_mbps, m_coefficients.beta);
   double fsScale = fsAvg * fsDispersion;
   NS_LOG_DEBUG ("Frame size: loc=" << fsAvg << ", scale=" << fsScale
                                    << " (dispersion=" << fsDispersion << ")");
@@ -275,21 +647,10 @@ VrBurstGenerator::SetupModel ()
   m_frameSizeRv = CreateObjectWithAttributes<LogisticRandomVariable> ("Location", DoubleValue (fsAvg),
                                                                       "Scale", DoubleValue (fsScale),
                                                                       "Bound", DoubleValue (fsAvg));
+  VR_APP_PROFILE (GENERATOR, OBJECT_CREATION);
 
   // Model IFI stats
-  double ifiDispersion;
-  if (m_frameRate == 60)
-    {
-      ifiDispersion = gamma;
-    }
-  else if (m_frameRate == 30)
-    {
-      ifiDispersion = delta * std::pow (targetRate_mbps, epsilon);
-    }
-  else
-    {
-      NS_ABORT_MSG ("Unexpected frame rate: " << m_frameRate);
-    }
+  double ifiDispersion = m_coefficients.delta * std::pow (targetRate_mbps, m_coefficients.epsilon);
   double ifiScale = ifiAvg * ifiDispersion;
   NS_LOG_DEBUG ("IFI: loc=" << ifiAvg << ", scale=" << ifiScale
                             << " (dispersion=" << ifiDispersion << ")");
@@ -297,6 +658,7 @@ VrBurstGenerator::SetupModel ()
   m_periodRv = CreateObjectWithAttributes<LogisticRandomVariable> ("Location", DoubleValue (ifiAvg),
                                                                    "Scale", DoubleValue (ifiScale),
                                                                    "Bound", DoubleValue (ifiAvg));
+  VR_APP_PROFILE (GENERATOR, OBJECT_CREATION);
 }
 
 } // Namespace ns3
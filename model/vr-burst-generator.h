@@ -20,10 +20,16 @@
 #ifndef VR_BURST_GENERATOR_H
 #define VR_BURST_GENERATOR_H
 
+#include <ns3/bitrate-ladder.h>
 #include <ns3/burst-generator.h>
 #include <ns3/data-rate.h>
+#include <ns3/encoder-rate-control.h>
+#include <ns3/head-motion-model.h>
 #include <ns3/my-random-variable-stream.h>
 
+#include <string>
+#include <vector>
+
 namespace ns3 {
 
 /** 
@@ -38,7 +44,55 @@ namespace ns3 {
  * of the application.
  * Further details on the model used can be found in the reference
  * paper (see README.md).
- * 
+ *
+ * The model was fitted at 30 and 60 FPS. At any other frame rate, its
+ * coefficients are interpolated, or extrapolated, linearly in the logarithm
+ * of the frame rate between the two closest fitted frame rates: the
+ * dispersions of frame sizes and intervals log-linearly, their exponents and
+ * the AR(2) coefficients linearly, the latter being clamped to a stationary
+ * process. More fitted frame rates, e.g., from traces of 72, 90 or 120 FPS
+ * headsets, can be added with a coefficient file (see SetCoefficientFile).
+ * The coefficients are resolved when the application, the frame rate or the
+ * coefficient file change, so that neither a change of the target data rate
+ * nor the generation of a frame pays for the interpolation.
+ *
+ * By default, frame sizes and inter-frame intervals are i.i.d. If Correlated
+ * is true, each of them follows an AR(2) process in the Gaussian domain,
+ * mapped through a Gaussian copula onto the same bounded logistic marginal:
+ * z_n = phi1 z_{n-1} + phi2 z_{n-2} + sigma e_n with e_n standard normal and
+ * sigma such that z_n is standard normal, and the sample is the inverse CDF
+ * of the logistic distribution at Phi (z_n). The marginals, hence the
+ * average data rate, are unchanged, while sustained high-motion periods
+ * (positively correlated frame sizes) and the jitter compensation of the
+ * encoder (negatively correlated intervals) are reproduced. The coefficients
+ * were fitted with Yule-Walker on the normal scores of the traces in
+ * BurstGeneratorTraces, averaging the autocorrelations over the data rates
+ * of each application and frame rate.
+ *
+ * If a HeadMotionModel is set, the size of each frame is scaled by
+ * 1 + MotionSensitivity * (speed / mean speed - 1), the angular speed of the
+ * head being evaluated at the generation of the frame: fast rotations
+ * produce larger frames, slow ones smaller frames, and the average data rate
+ * is unchanged. The modulated sizes are then raised to MinFrameSize, before
+ * the rate control encodes them.
+ *
+ * If GopLength is positive, or SceneCutProbability is, the frames follow a
+ * GOP structure, each frame being tagged with its type (see
+ * GetLastFrameType). With FULL_INTRA, an I frame IntraSizeRatio times larger
+ * than a P frame starts every GOP of GopLength frames; with INTRA_REFRESH,
+ * the intra data is spread over the GopLength frames of the refresh period,
+ * each of them 1 + (IntraSizeRatio - 1) / GopLength times larger than a P
+ * frame. In both modes, each frame is a scene cut with probability
+ * SceneCutProbability, forcing an I frame (and restarting the GOP), and the
+ * first frame is an I frame. The size sampled from the model of the
+ * application is scaled so that the average frame size, hence the data
+ * rate, is unchanged, i.e., the P frames are smaller than the average.
+ *
+ * If an EncoderRateControl is set, the target data rate is that of its VBV
+ * buffer, and each frame, sampled at the target data rate and scaled as
+ * above, is then encoded by the rate control, so that a new target is
+ * followed over a few frames, as by a real encoder, instead of at the next
+ * frame.
  */
 class VrBurstGenerator : public BurstGenerator
 {
@@ -55,6 +109,14 @@ public:
     GoogleEarthVrTour
   };
 
+  /**
+   * Encoding of the intra data of a GOP
+   */
+  enum GopMode {
+    FULL_INTRA = 0, //!< every GOP starts with an I frame
+    INTRA_REFRESH //!< the intra data is spread over the frames of the GOP
+  };
+
   VrBurstGenerator ();
   virtual ~VrBurstGenerator ();
 
@@ -68,11 +130,18 @@ public:
    * \return always true
    */
   virtual bool HasNextBurst (void) override;
+  /**
+   * \return the type of the last frame, UNSPECIFIED_FRAME without GOP structure
+   */
+  virtual SeqTsSizeFragHeader::FrameType GetLastFrameType (void) const override;
 
   /**
   * \brief Assign a fixed random variable stream number to the random variables
   * used by this model.
   *
+  * The frame sizes and periods take two streams, plus one if Correlated and
+  * one if SceneCutProbability is positive: call it after setting them.
+  *
   * \param stream first stream index to use
   * \return the number of stream indices assigned by this model
   */
@@ -101,6 +170,48 @@ public:
    */
   DataRate GetTargetDataRate (void) const;
 
+  /**
+   * Set the bitrate ladder the target data rate is quantized to
+   * \param ladder the ladder, null to use any target data rate
+   */
+  void SetBitrateLadder (Ptr<BitrateLadder> ladder);
+  /**
+   * Get the bitrate ladder the target data rate is quantized to
+   * \return the ladder, null if none
+   */
+  Ptr<BitrateLadder> GetBitrateLadder (void) const;
+
+  /**
+   * Enable temporally correlated frame sizes and inter-frame intervals
+   * \param correlated whether to use the AR(2) copula model
+   */
+  void SetCorrelated (bool correlated);
+  /**
+   * \return whether frame sizes and inter-frame intervals are correlated
+   */
+  bool GetCorrelated (void) const;
+
+  /**
+   * Set the head motion modulating the frame sizes
+   * \param model the head motion model, null to disable the modulation
+   */
+  void SetHeadMotionModel (Ptr<HeadMotionModel> model);
+  /**
+   * \return the head motion model modulating the frame sizes, or null
+   */
+  Ptr<HeadMotionModel> GetHeadMotionModel (void) const;
+
+  /**
+   * Set the rate control encoding the frames
+   * \param rateControl the rate control, null for frames following the
+   *        target data rate right away
+   */
+  void SetRateControl (Ptr<EncoderRateControl> rateControl);
+  /**
+   * \return the rate control encoding the frames, or null
+   */
+  Ptr<EncoderRateControl> GetRateControl (void) const;
+
   /**
    * Set the app name of the VR application
    * \param vrAppName the app name
@@ -112,6 +223,26 @@ public:
    */
   VrAppName GetVrAppName (void) const;
 
+  /**
+   * Load fitted model coefficients from a CSV file
+   *
+   * Each row holds the application (as the VrAppName attribute), the frame
+   * rate it was fitted at [FPS], the frame size dispersion at 1 Mbps (alpha)
+   * and its exponent with the data rate in Mbps (beta), the inter-frame
+   * interval dispersion at 1 Mbps (delta) and its exponent (epsilon), and the
+   * AR(2) coefficients phi1 and phi2 of the frame sizes, then of the
+   * intervals. Rows where the numbers cannot be read, e.g., a header, are
+   * skipped. The rows are added to the coefficients fitted on the bundled
+   * traces, replacing those at the same application and frame rate.
+   *
+   * \param filename the file, empty for the bundled coefficients only
+   */
+  void SetCoefficientFile (std::string filename);
+  /**
+   * \return the file the model coefficients were loaded from, if any
+   */
+  std::string GetCoefficientFile (void) const;
+
 protected:
   virtual void DoDispose (void) override;
 
@@ -124,12 +255,101 @@ private:
    */
   void SetupModel (void);
 
+  /**
+   * Coefficients of the model of an application, fitted at a frame rate
+   */
+  struct ModelCoefficients
+  {
+    double frameRate; //!< frame rate of the fit [FPS]
+    double alpha; //!< frame size dispersion at 1 Mbps
+    double beta; //!< exponent of the frame size dispersion with the data rate
+    double delta; //!< IFI dispersion at 1 Mbps
+    double epsilon; //!< exponent of the IFI dispersion with the data rate
+    double sizePhi1; //!< lag-1 AR(2) coefficient of the frame size
+    double sizePhi2; //!< lag-2 AR(2) coefficient of the frame size
+    double ifiPhi1; //!< lag-1 AR(2) coefficient of the IFI
+    double ifiPhi2; //!< lag-2 AR(2) coefficient of the IFI
+  };
+
+  /**
+   * Resolve the coefficients of the application at the frame rate, and
+   * update those of the AR(2) processes
+   */
+  void UpdateCoefficients (void);
+
+  /**
+   * Interpolate coefficients in the logarithm of the frame rate
+   * \param fits the coefficients fitted at different frame rates, sorted by frame rate
+   * \param frameRate the frame rate [FPS]
+   * \return the coefficients at the frame rate
+   */
+  static ModelCoefficients Interpolate (const std::vector<ModelCoefficients> &fits,
+                                        double frameRate);
+
+  /**
+   * AR(2) process in the Gaussian domain, with unit marginal variance
+   */
+  struct Ar2Process
+  {
+    double phi1{0}; //!< lag-1 coefficient
+    double phi2{0}; //!< lag-2 coefficient
+    double sigma{1}; //!< standard deviation of the innovation
+    double z1{0}; //!< last value
+    double z2{0}; //!< value before the last one
+  };
+
+  /**
+   * Set the coefficients of an AR(2) process, keeping its state
+   * \param process the process
+   * \param phi1 the lag-1 coefficient
+   * \param phi2 the lag-2 coefficient
+   */
+  static void SetAr2Coefficients (Ar2Process &process, double phi1, double phi2);
+
+  /**
+   * Sample a correlated value with the (bounded) logistic marginal of a random variable
+   * \param rv the random variable giving the marginal
+   * \param process the AR(2) process correlating the samples
+   * \return the sample
+   */
+  double SampleCorrelated (Ptr<LogisticRandomVariable> rv, Ar2Process &process);
+
+  /**
+   * Choose the type of the next frame of the GOP structure
+   * \return the factor scaling the size sampled from the model of the application
+   */
+  double NextFrameWeight (void);
+
   double m_frameRate{60}; //!< The frame rate of the VR application [FPS]
   DataRate m_targetDataRate{50}; //!< The target data rate of the VR application
   VrAppName m_appName{VirusPopper}; //!< The name of the VR application
 
+  std::string m_coefficientFile; //!< File the coefficients were loaded from, if any
+  std::vector<std::pair<VrAppName, ModelCoefficients>> m_fileCoefficients; //!< Coefficients from the file
+  ModelCoefficients m_coefficients; //!< Coefficients of the application at the frame rate
+
+  Ptr<BitrateLadder> m_bitrateLadder{0}; //!< The ladder the target data rate is quantized to, if any
   Ptr<LogisticRandomVariable> m_periodRv{0}; //!< RNG for period duration [s]
   Ptr<LogisticRandomVariable> m_frameSizeRv{0}; //!< RNG for frame size [B]
+
+  bool m_correlated{false}; //!< Whether frame sizes and intervals are correlated
+  Ptr<NormalRandomVariable> m_innovationRv{0}; //!< RNG for the innovations of the AR(2) processes
+  Ar2Process m_periodAr; //!< AR(2) process of the period
+  Ar2Process m_frameSizeAr; //!< AR(2) process of the frame size
+
+  Ptr<HeadMotionModel> m_headMotionModel{0}; //!< Head motion modulating the frame sizes, if any
+  double m_motionSensitivity{0.5}; //!< Relative change of the frame size per relative change of the speed
+  uint32_t m_minFrameSize{3000}; //!< Smallest frame size with a head motion, before the rate control [B]
+
+  Ptr<EncoderRateControl> m_rateControl{0}; //!< Rate control encoding the frames, if any
+
+  uint32_t m_gopLength{0}; //!< Frames per GOP, 0 for no periodic intra data
+  GopMode m_gopMode{FULL_INTRA}; //!< Encoding of the intra data of a GOP
+  double m_intraSizeRatio{5}; //!< Ratio between the sizes of I and P frames
+  double m_sceneCutProbability{0}; //!< Probability that a frame is a scene cut
+  Ptr<UniformRandomVariable> m_sceneCutRv{0}; //!< RNG for the scene cuts
+  uint32_t m_framesSinceIntra{0}; //!< Frames since the last I frame included, 0 before the first
+  SeqTsSizeFragHeader::FrameType m_lastFrameType{SeqTsSizeFragHeader::UNSPECIFIED_FRAME}; //!< Type of the last frame
 };
 
 } // namespace ns3